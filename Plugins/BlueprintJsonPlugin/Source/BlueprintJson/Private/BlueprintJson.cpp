@@ -1,9 +1,43 @@
 // Copyright Pandores Marketplace 2021. All Rights Reserved.
 
 #include "BlueprintJson.h"
+#include "BlueprintJsonStats.h"
 
 DEFINE_LOG_CATEGORY(LogBlueprintJson);
 
+LLM_DEFINE_TAG(BlueprintJson);
+
+std::atomic<int64> FBlueprintJsonCounters::NumWrappersCreated{ 0 };
+
+#if BLUEPRINTJSON_PROFILING
+DEFINE_BLUEPRINTJSON_STAT(Parser);
+DEFINE_BLUEPRINTJSON_STAT(ParseJson);
+DEFINE_BLUEPRINTJSON_STAT(Stringify);
+DEFINE_BLUEPRINTJSON_STAT(CreateObject);
+DEFINE_BLUEPRINTJSON_STAT(CreateValue);
+DEFINE_BLUEPRINTJSON_STAT(UnflattenObject);
+DEFINE_BLUEPRINTJSON_STAT(GetFieldAsArray);
+DEFINE_BLUEPRINTJSON_STAT(CreateArrayView);
+DEFINE_BLUEPRINTJSON_STAT(GetTypedArray);
+DEFINE_BLUEPRINTJSON_STAT(GetFieldAsObject);
+DEFINE_BLUEPRINTJSON_STAT(GetAllProperties);
+DEFINE_BLUEPRINTJSON_STAT(SetArrayField);
+DEFINE_BLUEPRINTJSON_STAT(BreakFields);
+DEFINE_BLUEPRINTJSON_STAT(MakeObject);
+DEFINE_BLUEPRINTJSON_STAT(LoadFile);
+DEFINE_BLUEPRINTJSON_STAT(ParseAsync);
+DEFINE_BLUEPRINTJSON_STAT(SaveAsync);
+
+DEFINE_STAT(STAT_BlueprintJson_BytesParsed);
+DEFINE_STAT(STAT_BlueprintJson_BytesWritten);
+DEFINE_STAT(STAT_BlueprintJson_LiveObjects);
+DEFINE_STAT(STAT_BlueprintJson_LiveValues);
+
+#if CPUPROFILERTRACE_ENABLED
+UE_TRACE_CHANNEL_DEFINE(BlueprintJsonChannel);
+#endif
+#endif
+
 #define LOCTEXT_NAMESPACE "FBlueprintJsonModule"
 
 void FBlueprintJsonModule::StartupModule()
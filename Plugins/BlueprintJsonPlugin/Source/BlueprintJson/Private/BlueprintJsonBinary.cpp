@@ -0,0 +1,526 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#include "BlueprintJsonBinary.h"
+#include "BlueprintJson.h"
+#include "BlueprintJsonParser.h"
+#include "BlueprintJsonValues.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+
+namespace
+{
+	constexpr uint8 Magic[] = { 'B', 'J', 'S', 'B' };
+
+	enum class EBinaryTag : uint8
+	{
+		Null,
+		False,
+		True,
+		Integer,
+		Double,
+		String,
+		Array,
+		Object
+	};
+
+	/* Field names are case sensitive here, unlike FJsonObject's, so each object keeps its own. */
+	struct FCaseSensitiveNameKeyFuncs : TDefaultMapKeyFuncs<FString, int32, false>
+	{
+		static FORCEINLINE bool Matches(const FString& A, const FString& B)
+		{
+			return A.Equals(B, ESearchCase::CaseSensitive);
+		}
+
+		static FORCEINLINE uint32 GetKeyHash(const FString& Key)
+		{
+			return FCrc::StrCrc32(*Key);
+		}
+	};
+
+	/* Largest integer a double represents exactly. */
+	constexpr int64 MaxExactDoubleInteger = 1ll << 53;
+
+	class FBinaryWriter
+	{
+	public:
+		explicit FBinaryWriter(TArray<uint8>& InData)
+			: Data(InData)
+		{}
+
+		void WriteByte(const uint8 Byte)
+		{
+			Data.Add(Byte);
+		}
+
+		void WriteVarInt(uint64 Value)
+		{
+			while (Value >= 0x80)
+			{
+				Data.Add(static_cast<uint8>(Value) | 0x80);
+				Value >>= 7;
+			}
+			Data.Add(static_cast<uint8>(Value));
+		}
+
+		void WriteBytes(const void* const Bytes, const int32 Num)
+		{
+			Data.Append(static_cast<const uint8*>(Bytes), Num);
+		}
+
+		void WriteUtf8(const UTF8CHAR* const Chars, const int32 Num)
+		{
+			WriteVarInt(Num);
+			WriteBytes(Chars, Num);
+		}
+
+		void WriteString(const FStringView String)
+		{
+			const FTCHARToUTF8 Converter(String.GetData(), String.Len());
+			WriteUtf8(reinterpret_cast<const UTF8CHAR*>(Converter.Get()), Converter.Length());
+		}
+
+		TArray<uint8>& Data;
+	};
+
+	/* Writes values to Body while collecting field names, which are written before it. */
+	class FValueWriter
+	{
+	public:
+		explicit FValueWriter(TArray<uint8>& InBody)
+			: Body(InBody)
+		{}
+
+		void WriteValue(const TSharedPtr<FJsonValue>& Value)
+		{
+			if (!Value)
+			{
+				Body.WriteByte(static_cast<uint8>(EBinaryTag::Null));
+				return;
+			}
+
+			switch (Value->Type)
+			{
+			case EJson::Boolean:
+				Body.WriteByte(static_cast<uint8>(Value->AsBool() ? EBinaryTag::True : EBinaryTag::False));
+				break;
+
+			case EJson::Number:
+				WriteNumber(*Value);
+				break;
+
+			case EJson::String:
+				WriteString(*Value);
+				break;
+
+			case EJson::Array:
+			{
+				const TArray<TSharedPtr<FJsonValue>>& Values = Value->AsArray();
+				Body.WriteByte(static_cast<uint8>(EBinaryTag::Array));
+				Body.WriteVarInt(Values.Num());
+				for (const TSharedPtr<FJsonValue>& Element : Values)
+				{
+					WriteValue(Element);
+				}
+				break;
+			}
+
+			case EJson::Object:
+				WriteObject(*Value);
+				break;
+
+			default:
+				Body.WriteByte(static_cast<uint8>(EBinaryTag::Null));
+				break;
+			}
+		}
+
+		/* Returns the field names in the order of their index. */
+		const TArray<FString>& GetNames() const { return Names; }
+
+	private:
+		void WriteNumber(const FJsonValue& Value)
+		{
+			double Double = 0.;
+			Value.TryGetNumber(Double);
+
+			// Integers are written exactly, lazy numbers above 2^53 included.
+			int64 Integer = 0;
+			if (FMath::Abs(Double) < 9.2e18 && FMath::Frac(Double) == 0. && Value.TryGetNumber(Integer) && static_cast<double>(Integer) == Double)
+			{
+				Body.WriteByte(static_cast<uint8>(EBinaryTag::Integer));
+				Body.WriteVarInt((static_cast<uint64>(Integer) << 1) ^ static_cast<uint64>(Integer >> 63));
+				return;
+			}
+
+			Body.WriteByte(static_cast<uint8>(EBinaryTag::Double));
+			Body.WriteBytes(&Double, sizeof(Double));
+		}
+
+		void WriteString(const FJsonValue& Value)
+		{
+			Body.WriteByte(static_cast<uint8>(EBinaryTag::String));
+
+			// UTF-8 lazy strings are copied as is.
+			FUtf8StringView Utf8View;
+			const FJsonValueLazyString* const LazyString = FJsonValueLazyString::Cast(&Value);
+			if (LazyString && LazyString->TryGetUtf8StringView(Utf8View))
+			{
+				Body.WriteUtf8(Utf8View.GetData(), Utf8View.Len());
+				return;
+			}
+
+			Body.WriteString(Value.AsString());
+		}
+
+		void WriteObject(const FJsonValue& Value)
+		{
+			Body.WriteByte(static_cast<uint8>(EBinaryTag::Object));
+
+			// Flat objects are written without creating their FJsonObject.
+			if (const FJsonValueFlatObject* const FlatObject = FJsonValueFlatObject::Cast(&Value))
+			{
+				Body.WriteVarInt(FlatObject->Num());
+				FlatObject->ForEachField([this](const FStringView FieldName, const TSharedPtr<FJsonValue>& FieldValue)
+				{
+					WriteField(FieldName, FieldValue);
+				});
+				return;
+			}
+
+			const TSharedPtr<FJsonObject> Object = Value.AsObject();
+			Body.WriteVarInt(Object ? Object->Values.Num() : 0);
+			if (Object)
+			{
+				for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : Object->Values)
+				{
+					WriteField(Field.Key, Field.Value);
+				}
+			}
+		}
+
+		void WriteField(const FStringView FieldName, const TSharedPtr<FJsonValue>& FieldValue)
+		{
+			const FString Name(FieldName);
+			int32* Index = NameIndices.Find(Name);
+			if (!Index)
+			{
+				Index = &NameIndices.Add(Name, Names.Num());
+				Names.Add(Name);
+			}
+
+			Body.WriteVarInt(*Index);
+			WriteValue(FieldValue);
+		}
+
+		FBinaryWriter Body;
+
+		TMap<FString, int32, FDefaultSetAllocator, FCaseSensitiveNameKeyFuncs> NameIndices;
+		TArray<FString> Names;
+	};
+
+	class FBinaryReader
+	{
+	public:
+		FBinaryReader(const TConstArrayView<uint8> InData, const EJsonParseOptions InOptions)
+			: Data(InData)
+			, Position(0)
+			, bFlatObjects(EnumHasAnyFlags(InOptions, EJsonParseOptions::FlatObjects))
+		{}
+
+		TSharedPtr<FJsonValue> ReadDocument()
+		{
+			if (Data.Num() <= static_cast<int32>(sizeof(Magic)) || FMemory::Memcmp(Data.GetData(), Magic, sizeof(Magic)) != 0)
+			{
+				Fail(TEXT("not a binary JSON document"));
+				return nullptr;
+			}
+			Position = sizeof(Magic);
+
+			const uint8 DataVersion = Data[Position++];
+			if (DataVersion != FBlueprintJsonBinary::Version)
+			{
+				Fail(FString::Printf(TEXT("version %d, expected %d"), DataVersion, FBlueprintJsonBinary::Version));
+				return nullptr;
+			}
+
+			uint64 NumNames = 0;
+			if (!ReadVarInt(NumNames) || NumNames > static_cast<uint64>(Data.Num()))
+			{
+				Fail(TEXT("invalid field name table"));
+				return nullptr;
+			}
+
+			Names.Reserve(static_cast<int32>(NumNames));
+			for (uint64 i = 0; i < NumNames; ++i)
+			{
+				FString Name;
+				if (!ReadString(Name))
+				{
+					return nullptr;
+				}
+				Names.Add(MoveTemp(Name));
+			}
+
+			TSharedPtr<FJsonValue> Root = ReadValue(0);
+			if (Root && Position != Data.Num())
+			{
+				Fail(TEXT("unexpected data after the root value"));
+				return nullptr;
+			}
+
+			return Root;
+		}
+
+		const FString& GetError() const { return Error; }
+
+	private:
+		TSharedPtr<FJsonValue> ReadValue(const int32 Depth)
+		{
+			if (Depth > FBlueprintJsonParser::MaxDepth)
+			{
+				Fail(TEXT("maximum depth exceeded"));
+				return nullptr;
+			}
+
+			if (Position >= Data.Num())
+			{
+				Fail(TEXT("truncated data"));
+				return nullptr;
+			}
+
+			switch (static_cast<EBinaryTag>(Data[Position++]))
+			{
+			case EBinaryTag::Null:  return MakeShared<FJsonValueNull>();
+			case EBinaryTag::False: return MakeShared<FJsonValueBoolean>(false);
+			case EBinaryTag::True:  return MakeShared<FJsonValueBoolean>(true);
+
+			case EBinaryTag::Integer:
+			{
+				uint64 ZigZag = 0;
+				if (!ReadVarInt(ZigZag))
+				{
+					return nullptr;
+				}
+
+				const int64 Integer = static_cast<int64>(ZigZag >> 1) ^ -static_cast<int64>(ZigZag & 1);
+
+				// FJsonValueNumberString keeps integers a double can't represent exact.
+				if (Integer > MaxExactDoubleInteger || Integer < -MaxExactDoubleInteger)
+				{
+					return MakeShared<FJsonValueNumberString>(LexToString(Integer));
+				}
+				return MakeShared<FJsonValueNumber>(static_cast<double>(Integer));
+			}
+
+			case EBinaryTag::Double:
+			{
+				double Double = 0.;
+				if (Position + static_cast<int32>(sizeof(Double)) > Data.Num())
+				{
+					Fail(TEXT("truncated number"));
+					return nullptr;
+				}
+				FMemory::Memcpy(&Double, Data.GetData() + Position, sizeof(Double));
+				Position += sizeof(Double);
+				return MakeShared<FJsonValueNumber>(Double);
+			}
+
+			case EBinaryTag::String:
+			{
+				FString String;
+				return ReadString(String) ? MakeShared<FJsonValueString>(MoveTemp(String)) : nullptr;
+			}
+
+			case EBinaryTag::Array:
+			{
+				uint64 Num = 0;
+				if (!ReadCount(Num))
+				{
+					return nullptr;
+				}
+
+				TArray<TSharedPtr<FJsonValue>> Values;
+				Values.Reserve(static_cast<int32>(Num));
+				for (uint64 i = 0; i < Num; ++i)
+				{
+					TSharedPtr<FJsonValue> Value = ReadValue(Depth + 1);
+					if (!Value)
+					{
+						return nullptr;
+					}
+					Values.Add(MoveTemp(Value));
+				}
+				return MakeShared<FJsonValueArray>(MoveTemp(Values));
+			}
+
+			case EBinaryTag::Object:
+				return ReadObject(Depth);
+
+			default:
+				Fail(TEXT("invalid value type"));
+				return nullptr;
+			}
+		}
+
+		TSharedPtr<FJsonValue> ReadObject(const int32 Depth)
+		{
+			uint64 Num = 0;
+			if (!ReadCount(Num))
+			{
+				return nullptr;
+			}
+
+			TSharedPtr<FJsonValueFlatObject> FlatObject;
+			TSharedPtr<FJsonObject> Object;
+
+			if (bFlatObjects && Num <= FJsonValueFlatObject::MaxFlatFields)
+			{
+				FlatObject = MakeShared<FJsonValueFlatObject>();
+			}
+			else
+			{
+				Object = MakeShared<FJsonObject>();
+				Object->Values.Reserve(static_cast<int32>(Num));
+			}
+
+			for (uint64 i = 0; i < Num; ++i)
+			{
+				uint64 NameIndex = 0;
+				if (!ReadVarInt(NameIndex) || NameIndex >= static_cast<uint64>(Names.Num()))
+				{
+					Fail(TEXT("invalid field name index"));
+					return nullptr;
+				}
+
+				TSharedPtr<FJsonValue> Value = ReadValue(Depth + 1);
+				if (!Value)
+				{
+					return nullptr;
+				}
+
+				const FString& Name = Names[static_cast<int32>(NameIndex)];
+				if (FlatObject)
+				{
+					FlatObject->AddField(Name, Value);
+				}
+				else
+				{
+					Object->Values.Add(Name, MoveTemp(Value));
+				}
+			}
+
+			if (FlatObject)
+			{
+				return FlatObject;
+			}
+			return MakeShared<FJsonValueObject>(MoveTemp(Object));
+		}
+
+		bool ReadVarInt(uint64& OutValue)
+		{
+			OutValue = 0;
+			for (int32 Shift = 0; Shift < 64; Shift += 7)
+			{
+				if (Position >= Data.Num())
+				{
+					Fail(TEXT("truncated data"));
+					return false;
+				}
+
+				const uint8 Byte = Data[Position++];
+				OutValue |= static_cast<uint64>(Byte & 0x7F) << Shift;
+				if (!(Byte & 0x80))
+				{
+					return true;
+				}
+			}
+
+			Fail(TEXT("invalid integer"));
+			return false;
+		}
+
+		/* Reads a number of elements, each one is at least a byte long. */
+		bool ReadCount(uint64& OutNum)
+		{
+			if (!ReadVarInt(OutNum))
+			{
+				return false;
+			}
+
+			if (OutNum > static_cast<uint64>(Data.Num() - Position))
+			{
+				Fail(TEXT("invalid element count"));
+				return false;
+			}
+			return true;
+		}
+
+		bool ReadString(FString& OutString)
+		{
+			uint64 Length = 0;
+			if (!ReadVarInt(Length) || Length > static_cast<uint64>(Data.Num() - Position))
+			{
+				Fail(TEXT("truncated string"));
+				return false;
+			}
+
+			const FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR*>(Data.GetData() + Position), static_cast<int32>(Length));
+			OutString = FString(Converter.Length(), Converter.Get());
+			Position += static_cast<int32>(Length);
+			return true;
+		}
+
+		void Fail(const FString& Message)
+		{
+			if (Error.IsEmpty())
+			{
+				Error = FString::Printf(TEXT("%s at byte %d"), *Message, Position);
+			}
+		}
+
+		const TConstArrayView<uint8> Data;
+		int32 Position;
+		const bool bFlatObjects;
+
+		TArray<FString> Names;
+		FString Error;
+	};
+}
+
+/* static */ void FBlueprintJsonBinary::Write(const TSharedPtr<FJsonValue>& Value, TArray<uint8>& OutData)
+{
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	TArray<uint8> Body;
+	FValueWriter ValueWriter(Body);
+	ValueWriter.WriteValue(Value);
+
+	FBinaryWriter Writer(OutData);
+	Writer.WriteBytes(Magic, sizeof(Magic));
+	Writer.WriteByte(Version);
+
+	const TArray<FString>& Names = ValueWriter.GetNames();
+	Writer.WriteVarInt(Names.Num());
+	for (const FString& Name : Names)
+	{
+		Writer.WriteString(Name);
+	}
+
+	Writer.WriteBytes(Body.GetData(), Body.Num());
+}
+
+/* static */ TSharedPtr<FJsonValue> FBlueprintJsonBinary::Read(const TConstArrayView<uint8> Data, const EJsonParseOptions Options, FString* const OutError)
+{
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	FBinaryReader Reader(Data, Options);
+
+	TSharedPtr<FJsonValue> Value = Reader.ReadDocument();
+
+	if (!Value && OutError)
+	{
+		*OutError = Reader.GetError();
+	}
+
+	return Value;
+}
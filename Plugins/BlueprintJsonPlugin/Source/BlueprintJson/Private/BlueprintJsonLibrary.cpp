@@ -2,6 +2,9 @@
 
 #include "BlueprintJsonLibrary.h"
 #include "BlueprintJsonWrapper.h"
+#include "BlueprintJsonPropertyConverter.h"
+#include "BlueprintJsonStats.h"
+#include "BlueprintJsonWriter.h"
 #include "Misc/FileHelper.h"
 #include "JsonObjectConverter.h"
 
@@ -15,11 +18,381 @@ TArray<float> UJsonLibrary::GetFieldAsFloatArray(UPARAM(Ref) FLightJsonObject& O
 	return Object.GetFieldAsFloatArray(FieldName);
 }
 
+TArray<int32> UJsonLibrary::GetFieldAsInt32Array(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName)
+{
+	return Object.GetFieldAsInt32Array(FieldName);
+}
+
+TArray<FString> UJsonLibrary::GetFieldAsStringArray(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName)
+{
+	return Object.GetFieldAsStringArray(FieldName);
+}
+
+TArray<FLightJsonValue> UJsonLibrary::GetFieldAsArray(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName)
+{
+	return Object.GetFieldAsArray(FieldName);
+}
+
+bool UJsonLibrary::GetFieldAsBoolean(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName)
+{
+	return Object.GetFieldAsBoolean(FieldName);
+}
+
+FVector UJsonLibrary::GetFieldAsVector(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName)
+{
+	return Object.GetFieldAsVector(FieldName);
+}
+
+FLightJsonValue UJsonLibrary::GetFieldAsValue(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName)
+{
+	return Object.GetFieldAsValue(FieldName);
+}
+
+FLightJsonValue UJsonLibrary::GetValueAtPath(UPARAM(Ref) FLightJsonObject& Object, const FString& Path)
+{
+	return Object.GetValueAtPath(Path);
+}
+
+bool UJsonLibrary::HasField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName)
+{
+	return Object.HasField(FieldName);
+}
+
+bool UJsonLibrary::IsFieldNull(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName)
+{
+	return Object.IsFieldNull(FieldName);
+}
+
+TArray<FString> UJsonLibrary::GetFieldNames(UPARAM(Ref) FLightJsonObject& Object)
+{
+	return Object.GetFieldNames();
+}
+
+int32 UJsonLibrary::GetNumFields(UPARAM(Ref) FLightJsonObject& Object)
+{
+	return Object.Num();
+}
+
+bool UJsonLibrary::IsLightObjectValid(UPARAM(Ref) FLightJsonObject& Object)
+{
+	return Object.IsValid();
+}
+
+FLightJsonObject UJsonLibrary::CreateLightJsonObject()
+{
+	return FLightJsonObject::Create();
+}
+
+FLightJsonObject UJsonLibrary::ParseLightJson(const FString& Json, const int32 Options, bool& bSuccess)
+{
+	FString Error;
+	FLightJsonObject Object = FLightJsonObject::Parse(CopyTemp(Json), static_cast<EJsonParseOptions>(Options), &Error);
+
+	bSuccess = Object.IsValid();
+	if (!bSuccess)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("%s"), *Error);
+	}
+
+	return Object;
+}
+
+bool UJsonLibrary::StringifyLightJsonObject(UPARAM(Ref) FLightJsonObject& Object, FString& OutJsonString)
+{
+	if (!Object.IsValid())
+	{
+		UE_LOG(LogBlueprintJson, Error, TEXT("Passed an invalid light object to StringifyLightJsonObject."));
+		return false;
+	}
+	return Object.ToString(OutJsonString);
+}
+
 UJsonObject* UJsonLibrary::ConvertLightObject(UPARAM(Ref) FLightJsonObject& Object)
 {
 	return UJsonObject::FromLightObject(Object);
 }
 
+EJsonType UJsonLibrary::GetValueType(const FLightJsonValue& Value)
+{
+	return Value.GetType();
+}
+
+FString UJsonLibrary::LightValue_ToString(const FLightJsonValue& Value)
+{
+	return Value.AsString();
+}
+
+float UJsonLibrary::LightValue_ToFloat(const FLightJsonValue& Value)
+{
+	return Value.AsFloat();
+}
+
+int64 UJsonLibrary::LightValue_ToInteger64(const FLightJsonValue& Value)
+{
+	return Value.AsInt64();
+}
+
+bool UJsonLibrary::LightValue_ToBool(const FLightJsonValue& Value)
+{
+	return Value.AsBool();
+}
+
+FLightJsonObject UJsonLibrary::LightValue_ToObject(const FLightJsonValue& Value)
+{
+	return Value.AsObject();
+}
+
+int32 UJsonLibrary::LightValue_ToInteger(const FLightJsonValue& Value)
+{
+	return Value.AsInt32();
+}
+
+TArray<FLightJsonValue> UJsonLibrary::LightValue_ToArray(const FLightJsonValue& Value)
+{
+	return Value.AsArray();
+}
+
+UJsonValue* UJsonLibrary::LightValue_ToJsonValue(const FLightJsonValue& Value)
+{
+	return UJsonValue::CreateFromRaw(Value.GetRawValue());
+}
+
+bool UJsonLibrary::LightValue_IsNull(const FLightJsonValue& Value)
+{
+	return Value.IsNull();
+}
+
+bool UJsonLibrary::StringifyLightJsonValue(const FLightJsonValue& Value, FString& OutJsonString)
+{
+	if (!Value.IsValid())
+	{
+		UE_LOG(LogBlueprintJson, Error, TEXT("Passed an invalid light value to StringifyLightJsonValue."));
+		return false;
+	}
+	return Value.ToString(OutJsonString);
+}
+
+bool UInternalJsonLibrary::JO_NextField(UJsonObject* const JsonObject, int32& Cursor, FString& FieldName, FLightJsonValue& FieldValue)
+{
+	if (!JsonObject)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("For Each Field in JSON Object: Null object passed."));
+		return false;
+	}
+
+	TSharedPtr<FJsonValue> RawValue;
+	if (!JsonObject->NextField(Cursor, FieldName, RawValue))
+	{
+		return false;
+	}
+
+	FieldValue = FLightJsonValue(MoveTemp(RawValue));
+	return true;
+}
+
+bool UInternalJsonLibrary::JO_BreakFields(UJsonObject* const JsonObject, const TArray<FString>& FieldNames)
+{
+	// Only called through the custom thunk.
+	check(0);
+	return false;
+}
+
+DEFINE_FUNCTION(UInternalJsonLibrary::execJO_BreakFields)
+{
+	BLUEPRINTJSON_SCOPE(BreakFields);
+
+	P_GET_OBJECT(UJsonObject, JsonObject);
+	P_GET_TARRAY_REF(FString, FieldNames);
+
+	struct FFieldOutput
+	{
+		const FProperty* Property;
+		void* Address;
+	};
+
+	// Outputs must all be read from the stack before P_FINISH.
+	TArray<FFieldOutput, TInlineAllocator<16>> Outputs;
+	Outputs.Reserve(FieldNames.Num());
+
+	for (int32 Index = 0; Index < FieldNames.Num(); ++Index)
+	{
+		Stack.MostRecentProperty = nullptr;
+		Stack.MostRecentPropertyAddress = nullptr;
+		Stack.MostRecentPropertyContainer = nullptr;
+		Stack.StepCompiledIn<FProperty>(nullptr);
+
+		Outputs.Add({ Stack.MostRecentProperty, Stack.MostRecentPropertyAddress });
+	}
+
+	P_FINISH;
+
+	P_NATIVE_BEGIN;
+
+	bool bAllFound = JsonObject != nullptr;
+	if (!JsonObject)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Break JSON Object: Null object passed."));
+	}
+	else
+	{
+		for (int32 Index = 0; Index < FieldNames.Num(); ++Index)
+		{
+			bAllFound &= FBlueprintJsonPropertyConverter::ReadValue(JsonObject->FindField(FieldNames[Index]), Outputs[Index].Property, Outputs[Index].Address);
+		}
+	}
+
+	*static_cast<bool*>(RESULT_PARAM) = bAllFound;
+
+	P_NATIVE_END;
+}
+
+UJsonObject* UInternalJsonLibrary::JO_MakeObject(const TArray<FString>& FieldNames)
+{
+	// Only called through the custom thunk.
+	check(0);
+	return nullptr;
+}
+
+DEFINE_FUNCTION(UInternalJsonLibrary::execJO_MakeObject)
+{
+	BLUEPRINTJSON_SCOPE(MakeObject);
+
+	P_GET_TARRAY_REF(FString, FieldNames);
+
+	TArray<TPair<FString, TSharedPtr<FJsonValue>>> Fields;
+	Fields.Reserve(FieldNames.Num());
+
+	for (const FString& FieldName : FieldNames)
+	{
+		Stack.MostRecentProperty = nullptr;
+		Stack.MostRecentPropertyAddress = nullptr;
+		Stack.MostRecentPropertyContainer = nullptr;
+		Stack.StepCompiledIn<FProperty>(nullptr);
+
+		Fields.Emplace(FieldName, FBlueprintJsonPropertyConverter::WriteValue(Stack.MostRecentProperty, Stack.MostRecentPropertyAddress));
+	}
+
+	P_FINISH;
+
+	P_NATIVE_BEGIN;
+	*static_cast<UJsonObject**>(RESULT_PARAM) = UJsonObject::CreateFromRawFields(MoveTemp(Fields));
+	P_NATIVE_END;
+}
+
+void UInternalJsonLibrary::JO_AddField_Set(UJsonObject* const JsonObject, const FString& FieldName, const TSet<int32>& FieldValue)
+{
+	// Only called through the custom thunk.
+	check(0);
+}
+
+DEFINE_FUNCTION(UInternalJsonLibrary::execJO_AddField_Set)
+{
+	P_GET_OBJECT(UJsonObject, JsonObject);
+	P_GET_PROPERTY_REF(FStrProperty, FieldName);
+
+	Stack.MostRecentProperty = nullptr;
+	Stack.MostRecentPropertyAddress = nullptr;
+	Stack.StepCompiledIn<FSetProperty>(nullptr);
+
+	const FSetProperty* const SetProperty = CastField<FSetProperty>(Stack.MostRecentProperty);
+	const void* const SetAddress = Stack.MostRecentPropertyAddress;
+
+	P_FINISH;
+
+	P_NATIVE_BEGIN;
+
+	if (!JsonObject)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to add field to JSON Object: Null object passed."));
+	}
+	else if (SetProperty && SetAddress)
+	{
+		FScriptSetHelper Helper(SetProperty, SetAddress);
+
+		TArray<TSharedPtr<FJsonValue>> Values;
+		Values.Reserve(Helper.Num());
+
+		// The set is sparse, skip the invalid indices.
+		for (int32 Index = 0, Remaining = Helper.Num(); Remaining > 0; ++Index)
+		{
+			if (Helper.IsValidIndex(Index))
+			{
+				Values.Emplace(FBlueprintJsonPropertyConverter::WriteValue(Helper.GetElementProperty(), Helper.GetElementPtr(Index)));
+				--Remaining;
+			}
+		}
+
+		JsonObject->SetRawField(FieldName, MakeShared<FJsonValueArray>(MoveTemp(Values)));
+	}
+
+	P_NATIVE_END;
+}
+
+void UInternalJsonLibrary::JO_AddField_Map(UJsonObject* const JsonObject, const FString& FieldName, const TMap<FString, int32>& FieldValue)
+{
+	// Only called through the custom thunk.
+	check(0);
+}
+
+DEFINE_FUNCTION(UInternalJsonLibrary::execJO_AddField_Map)
+{
+	P_GET_OBJECT(UJsonObject, JsonObject);
+	P_GET_PROPERTY_REF(FStrProperty, FieldName);
+
+	Stack.MostRecentProperty = nullptr;
+	Stack.MostRecentPropertyAddress = nullptr;
+	Stack.StepCompiledIn<FMapProperty>(nullptr);
+
+	const FMapProperty* const MapProperty = CastField<FMapProperty>(Stack.MostRecentProperty);
+	const void* const MapAddress = Stack.MostRecentPropertyAddress;
+
+	P_FINISH;
+
+	P_NATIVE_BEGIN;
+
+	if (!JsonObject)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to add field to JSON Object: Null object passed."));
+	}
+	else if (MapProperty && MapAddress)
+	{
+		FScriptMapHelper Helper(MapProperty, MapAddress);
+
+		const FStrProperty*  const StrKeyProperty  = CastField<FStrProperty> (Helper.GetKeyProperty());
+		const FNameProperty* const NameKeyProperty = CastField<FNameProperty>(Helper.GetKeyProperty());
+
+		if (!StrKeyProperty && !NameKeyProperty)
+		{
+			UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to add field %s to JSON Object: Map keys must be String or Name."), *FieldName);
+		}
+		else
+		{
+			TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+			Object->Values.Reserve(Helper.Num());
+
+			// The map is sparse, skip the invalid indices.
+			for (int32 Index = 0, Remaining = Helper.Num(); Remaining > 0; ++Index)
+			{
+				if (Helper.IsValidIndex(Index))
+				{
+					const void* const KeyPtr = Helper.GetKeyPtr(Index);
+
+					FString Key = StrKeyProperty
+						? StrKeyProperty->GetPropertyValue(KeyPtr)
+						: NameKeyProperty->GetPropertyValue(KeyPtr).ToString();
+
+					Object->Values.Emplace(MoveTemp(Key), FBlueprintJsonPropertyConverter::WriteValue(Helper.GetValueProperty(), Helper.GetValuePtr(Index)));
+					--Remaining;
+				}
+			}
+
+			JsonObject->SetRawField(FieldName, MakeShared<FJsonValueObject>(MoveTemp(Object)));
+		}
+	}
+
+	P_NATIVE_END;
+}
+
 FString UJsonLibrary::GetFieldAsString(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName) 
 {
 	return Object.GetFieldAsString(FieldName);
@@ -126,28 +499,11 @@ int64 UJsonLibrary::JsonValue_ToInteger64(UJsonValue* Object)
 
 FVector UJsonLibrary::JsonValue_ToVector(UJsonValue* Object)
 {
-	FVector Value;
+	FVector Value = FVector::ZeroVector;
 
-	if (!Object)
+	if (Object && !UJsonValue::ReadRawJsonValue(Object->GetRawValue(), Value))
 	{
-		const TSharedPtr<FJsonObject>* JsonObject;
-		if (Object->GetRawValue()->TryGetObject(JsonObject))
-		{
-			if ((*JsonObject)->HasTypedField<EJson::Number>(TEXT("X")))
-			{
-				Value.X = (*JsonObject)->GetNumberField(TEXT("X"));
-			}
-
-			if ((*JsonObject)->HasTypedField<EJson::Number>(TEXT("Y")))
-			{
-				Value.Y = (*JsonObject)->GetNumberField(TEXT("Y"));
-			}
-
-			if ((*JsonObject)->HasTypedField<EJson::Number>(TEXT("Z")))
-			{
-				Value.Z = (*JsonObject)->GetNumberField(TEXT("Z"));
-			}
-		}
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get Vector from JsonValue but the real type is %s."), *Object->GetStringType());
 	}
 
 	return Value;
@@ -155,28 +511,11 @@ FVector UJsonLibrary::JsonValue_ToVector(UJsonValue* Object)
 
 FRotator UJsonLibrary::JsonValue_ToRotator(UJsonValue* Object)
 {
-	FRotator Value;
+	FRotator Value = FRotator::ZeroRotator;
 
-	if (!Object)
+	if (Object && !UJsonValue::ReadRawJsonValue(Object->GetRawValue(), Value))
 	{
-		const TSharedPtr<FJsonObject>* JsonObject;
-		if (Object->GetRawValue()->TryGetObject(JsonObject))
-		{
-			if ((*JsonObject)->HasTypedField<EJson::Number>(TEXT("Pitch")))
-			{
-				Value.Pitch = (*JsonObject)->GetNumberField(TEXT("Pitch"));
-			}
-
-			if ((*JsonObject)->HasTypedField<EJson::Number>(TEXT("Yaw")))
-			{
-				Value.Yaw = (*JsonObject)->GetNumberField(TEXT("Yaw"));
-			}
-
-			if ((*JsonObject)->HasTypedField<EJson::Number>(TEXT("Roll")))
-			{
-				Value.Roll = (*JsonObject)->GetNumberField(TEXT("Roll"));
-			}
-		}
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get Rotator from JsonValue but the real type is %s."), *Object->GetStringType());
 	}
 
 	return Value;
@@ -186,74 +525,36 @@ FTransform UJsonLibrary::JsonValue_ToTransform(UJsonValue* Object)
 {
 	FTransform Value;
 
-	if (Object)
+	if (Object && !UJsonValue::ReadRawJsonValue(Object->GetRawValue(), Value))
 	{
-		const TSharedPtr<FJsonObject>* JsonObject;
-		if (Object->GetRawValue()->TryGetObject(JsonObject))
-		{
-			const auto GetVector = [&JsonObject](const FString& Field) -> FVector
-			{
-				FVector Location;
-				const TSharedPtr<FJsonObject>* LocationObject;
-				if ((*JsonObject)->TryGetObjectField(*Field, LocationObject))
-				{
-					if ((*LocationObject)->HasTypedField<EJson::Number>(TEXT("X")))
-					{
-						Location.X = (*LocationObject)->GetNumberField(TEXT("X"));
-					}
-
-					if ((*JsonObject)->HasTypedField<EJson::Number>(TEXT("Y")))
-					{
-						Location.Y = (*LocationObject)->GetNumberField(TEXT("Y"));
-					}
-
-					if ((*JsonObject)->HasTypedField<EJson::Number>(TEXT("Z")))
-					{
-						Location.Z = (*LocationObject)->GetNumberField(TEXT("Z"));
-					}
-				}
-				return Location;
-			};
-
-			FRotator Rotation;
-			const TSharedPtr<FJsonObject>* LocationObject;
-			if ((*JsonObject)->TryGetObjectField(TEXT("Rotation"), LocationObject))
-			{
-				if ((*LocationObject)->HasTypedField<EJson::Number>(TEXT("Pitch")))
-				{
-					Rotation.Pitch = (*LocationObject)->GetNumberField(TEXT("Pitch"));
-				}
-
-				if ((*LocationObject)->HasTypedField<EJson::Number>(TEXT("Yaw")))
-				{
-					Rotation.Yaw = (*LocationObject)->GetNumberField(TEXT("Yaw"));
-				}
-
-				if ((*LocationObject)->HasTypedField<EJson::Number>(TEXT("Roll")))
-				{
-					Rotation.Roll = (*LocationObject)->GetNumberField(TEXT("Roll"));
-				}
-			}
-
-			Value.SetLocation(GetVector(TEXT("Location")));
-			Value.SetScale3D (GetVector(TEXT("Scale3D")));
-			Value.SetRotation(Rotation.Quaternion());
-		}
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get Transform from JsonValue but the real type is %s."), *Object->GetStringType());
 	}
 
 	return Value;
 }
 
+void UJsonLibrary::SetJsonMathEncoding(const EJsonMathEncoding Encoding)
+{
+	UJsonValue::SetMathEncoding(Encoding);
+}
+
+EJsonMathEncoding UJsonLibrary::GetJsonMathEncoding()
+{
+	return UJsonValue::GetMathEncoding();
+}
+
 TArray<UJsonValue*> UJsonLibrary::JsonValue_ToArray(UJsonValue* Object)
 {
+	BLUEPRINTJSON_SCOPE(GetFieldAsArray);
+
 	TArray<UJsonValue*> Arr;
 
 	if (Object)
 	{
 		if (Object->GetRawValue()->Type == EJson::Array)
 		{
-			TArray<TSharedPtr<FJsonValue>> Values = Object->GetRawValue()->AsArray();
-			
+			const TArray<TSharedPtr<FJsonValue>>& Values = Object->GetRawValue()->AsArray();
+
 			Arr.Reserve(Values.Num());
 
 			for (const auto& Val : Values)
@@ -270,13 +571,28 @@ TArray<UJsonValue*> UJsonLibrary::JsonValue_ToArray(UJsonValue* Object)
 	return Arr;
 }
 
+UJsonArrayView* UJsonLibrary::JsonValue_ToArrayView(UJsonValue* Object)
+{
+	if (!Object)
+	{
+		return nullptr;
+	}
+
+	UJsonArrayView* const View = UJsonArrayView::CreateFromRaw(Object->GetRawValue());
+	if (!View)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get Array from JsonValue but the real type is %s."), *Object->GetStringType());
+	}
+	return View;
+}
+
 UJsonObject* UJsonLibrary::JsonValue_ToObject(UJsonValue* Object)
 {
 	if (Object)
 	{
 		if (Object->GetRawValue()->Type == EJson::Object)
 		{
-			return UJsonObject::CreateFromRaw(Object->GetRawValue()->AsObject());
+			return UJsonObject::CreateFromRawValue(Object->GetRawValue());
 		}
 
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get Object from JsonValue but the real type is %s."), *Object->GetStringType());
@@ -287,6 +603,8 @@ UJsonObject* UJsonLibrary::JsonValue_ToObject(UJsonValue* Object)
 
 UJsonObject* UJsonLibrary::LoadJsonFile(const FString& FilePath)
 {
+	BLUEPRINTJSON_SCOPE(LoadFile);
+
 	FString Data;
 	if (!FFileHelper::LoadFileToString(Data, *FilePath))
 	{
@@ -310,6 +628,12 @@ bool UJsonLibrary::StringifyJsonObject(UJsonObject* const Object, FString& OutJs
 
 bool UJsonLibrary::StringifyJsonObject(const TSharedPtr<FJsonObject> Object, FString& OutJsonString)
 {
+	BLUEPRINTJSON_SCOPE(Stringify);
+
 	TSharedRef< TJsonWriter<> > Writer = TJsonWriterFactory<>::Create(&OutJsonString);
-	return FJsonSerializer::Serialize(Object.ToSharedRef(), Writer);
+	const bool bSuccess = FBlueprintJsonWriter::Serialize(Object.ToSharedRef(), Writer);
+
+	BLUEPRINTJSON_INC_STAT_BY(BytesWritten, OutJsonString.Len());
+
+	return bSuccess;
 }
@@ -0,0 +1,406 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#include "BlueprintJson.h"
+#include "BlueprintJsonWrapper.h"
+#include "BlueprintJsonValues.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+#include "UObject/ReferencerFinder.h"
+#include "UObject/Package.h"
+
+namespace
+{
+	constexpr int32 NumJsonTypes = static_cast<int32>(EJson::Object) + 1;
+
+	/* Approximate memory and nodes of JSON trees. */
+	struct FDomStats
+	{
+		SIZE_T Bytes = 0;
+		int64  Nodes[NumJsonTypes] = {};
+
+		int64 GetNumNodes() const
+		{
+			int64 Num = 0;
+			for (const int64 Count : Nodes)
+			{
+				Num += Count;
+			}
+			return Num;
+		}
+
+		void Add(const FDomStats& Other)
+		{
+			Bytes += Other.Bytes;
+			for (int32 Type = 0; Type < NumJsonTypes; ++Type)
+			{
+				Nodes[Type] += Other.Nodes[Type];
+			}
+		}
+	};
+
+	/* A tree held by one or more live wrappers. */
+	struct FDocument
+	{
+		/* The node of the wrappers, kept alive for the walk as UJsonObject::GetRawValue() may create it. */
+		TSharedPtr<FJsonValue> Value;
+		TArray<UObject*> Wrappers;
+		FDomStats Stats;
+
+		/* Document the tree is part of, INDEX_NONE if it is a root. */
+		int32 Container = INDEX_NONE;
+	};
+
+	/* Identifies the node of a wrapper. The object values are identified by their FJsonObject, shared by the UJsonObject and the fields holding it. */
+	const void* GetNodeKey(const FJsonValue& Value)
+	{
+		if (Value.Type == EJson::Object && !FJsonValueFlatObject::Cast(&Value))
+		{
+			const TSharedPtr<FJsonObject>* Object = nullptr;
+			if (Value.TryGetObject(Object) && Object->IsValid())
+			{
+				return Object->Get();
+			}
+		}
+		return &Value;
+	}
+
+	/* Sums the memory of a document, counting each node and source buffer once, and marks the documents found in it as contained. */
+	class FDocumentWalker
+	{
+	public:
+		FDocumentWalker(const TMap<const void*, int32>& InDocumentIndices, TArray<FDocument>& InDocuments, const int32 InDocument)
+			: DocumentIndices(InDocumentIndices)
+			, Documents(InDocuments)
+			, Document(InDocument)
+		{}
+
+		void Walk(const FJsonValue& Value)
+		{
+			if (!Visit(GetNodeKey(Value)))
+			{
+				return;
+			}
+
+			++Stats.Nodes[static_cast<int32>(Value.Type)];
+
+			switch (Value.Type)
+			{
+			case EJson::String:
+				if (const FJsonValueLazyString* const LazyString = FJsonValueLazyString::Cast(&Value))
+				{
+					Stats.Bytes += sizeof(FJsonValueLazyString);
+					AddSource(LazyString->GetSource());
+				}
+				else
+				{
+					// The copy has the length of the string, slack aside.
+					FString String;
+					Value.TryGetString(String);
+					Stats.Bytes += sizeof(FJsonValueString) + String.GetAllocatedSize();
+				}
+				break;
+
+			case EJson::Number:
+				if (const FJsonValueLazyNumber* const LazyNumber = FJsonValueLazyNumber::Cast(&Value))
+				{
+					Stats.Bytes += sizeof(FJsonValueLazyNumber);
+					AddSource(LazyNumber->GetSource());
+				}
+				else
+				{
+					Stats.Bytes += sizeof(FJsonValueNumber);
+				}
+				break;
+
+			case EJson::Boolean:
+				Stats.Bytes += sizeof(FJsonValueBoolean);
+				break;
+
+			case EJson::Array:
+			{
+				const TArray<TSharedPtr<FJsonValue>>& Array = Value.AsArray();
+				Stats.Bytes += sizeof(FJsonValueArray) + Array.GetAllocatedSize();
+				for (const TSharedPtr<FJsonValue>& Element : Array)
+				{
+					if (Element)
+					{
+						Walk(*Element);
+					}
+				}
+				break;
+			}
+
+			case EJson::Object:
+				if (const FJsonValueFlatObject* const FlatObject = FJsonValueFlatObject::Cast(&Value))
+				{
+					Stats.Bytes += sizeof(FJsonValueFlatObject) + FlatObject->GetAllocatedSize();
+					FlatObject->ForEachField([this](FStringView, const TSharedPtr<FJsonValue>& FieldValue) -> void
+					{
+						if (FieldValue)
+						{
+							Walk(*FieldValue);
+						}
+					});
+				}
+				else
+				{
+					Stats.Bytes += sizeof(FJsonValueObject);
+					if (const TSharedPtr<FJsonObject>& Object = Value.AsObject())
+					{
+						WalkObject(*Object);
+					}
+				}
+				break;
+
+			default:
+				Stats.Bytes += sizeof(FJsonValueNull);
+				break;
+			}
+		}
+
+		FDomStats Stats;
+
+	private:
+		void WalkObject(const FJsonObject& Object)
+		{
+			Stats.Bytes += sizeof(FJsonObject) + Object.Values.GetAllocatedSize();
+			for (const auto& Field : Object.Values)
+			{
+				Stats.Bytes += Field.Key.GetAllocatedSize();
+				if (Field.Value)
+				{
+					Walk(*Field.Value);
+				}
+			}
+		}
+
+		/* Returns false if the node was already walked. */
+		bool Visit(const void* const Key)
+		{
+			bool bAlreadyVisited = false;
+			Visited.Add(Key, &bAlreadyVisited);
+			if (bAlreadyVisited)
+			{
+				return false;
+			}
+
+			if (const int32* const Index = DocumentIndices.Find(Key); Index && *Index != Document)
+			{
+				Documents[*Index].Container = Document;
+			}
+			return true;
+		}
+
+		/* The buffer of a parsed document is shared by its lazy values. */
+		void AddSource(const FJsonSourceBuffer& Source)
+		{
+			bool bAlreadyCounted = false;
+			Sources.Add(&Source, &bAlreadyCounted);
+			if (!bAlreadyCounted)
+			{
+				Stats.Bytes += sizeof(FJsonSourceBuffer) + Source.GetAllocatedSize();
+			}
+		}
+
+		const TMap<const void*, int32>& DocumentIndices;
+		TArray<FDocument>& Documents;
+		const int32 Document;
+
+		TSet<const void*> Visited;
+		TSet<const FJsonSourceBuffer*> Sources;
+	};
+
+	FString FormatBytes(const SIZE_T Bytes)
+	{
+		if (Bytes >= 1024 * 1024)
+		{
+			return FString::Printf(TEXT("%.2f MB"), Bytes / (1024. * 1024.));
+		}
+		return FString::Printf(TEXT("%.2f KB"), Bytes / 1024.);
+	}
+
+	FString FormatNodes(const FDomStats& Stats)
+	{
+		return FString::Printf(TEXT("%lld nodes: %lld objects, %lld arrays, %lld strings, %lld numbers, %lld booleans, %lld nulls"),
+			Stats.GetNumNodes(),
+			Stats.Nodes[static_cast<int32>(EJson::Object)],
+			Stats.Nodes[static_cast<int32>(EJson::Array)],
+			Stats.Nodes[static_cast<int32>(EJson::String)],
+			Stats.Nodes[static_cast<int32>(EJson::Number)],
+			Stats.Nodes[static_cast<int32>(EJson::Boolean)],
+			Stats.Nodes[static_cast<int32>(EJson::Null)] + Stats.Nodes[static_cast<int32>(EJson::None)]);
+	}
+
+	/* Describes the objects keeping the wrappers of a document alive, JSON wrappers excluded. */
+	FString DescribeOwners(const TArray<UObject*>& Wrappers)
+	{
+		constexpr int32 MaxOwners = 3;
+
+		TArray<FString> Owners;
+		int32 NumOwners = 0;
+
+		const auto AddOwner = [&Owners, &NumOwners](const UObject* const Owner) -> void
+		{
+			if (NumOwners++ < MaxOwners)
+			{
+				Owners.Add(Owner->GetFullName());
+			}
+		};
+
+		const TSet<UObject*> Ignored(Wrappers);
+		for (UObject* const Referencer : FReferencerFinder::GetAllReferencers(Wrappers, &Ignored))
+		{
+			if (!Referencer->IsA<UJsonObject>() && !Referencer->IsA<UJsonValue>())
+			{
+				AddOwner(Referencer);
+			}
+		}
+
+		for (const UObject* const Wrapper : Wrappers)
+		{
+			const UObject* const Outer = Wrapper->GetOuter();
+			if (Outer && Outer != GetTransientPackage() && !Outer->IsA<UJsonObject>() && !Outer->IsA<UJsonValue>())
+			{
+				AddOwner(Outer);
+			}
+			if (Wrapper->IsRooted())
+			{
+				AddOwner(Wrapper);
+			}
+		}
+
+		if (NumOwners == 0)
+		{
+			return TEXT("no UObject, held from native code or awaiting garbage collection");
+		}
+		if (NumOwners > MaxOwners)
+		{
+			Owners.Add(FString::Printf(TEXT("%d more"), NumOwners - MaxOwners));
+		}
+		return FString::Join(Owners, TEXT(", "));
+	}
+
+	void ReportMemory(const int32 TopN)
+	{
+		TArray<FDocument> Documents;
+		TMap<const void*, int32> DocumentIndices;
+
+		int32 NumObjects = 0;
+		int32 NumValues  = 0;
+
+		const auto AddWrapper = [&Documents, &DocumentIndices](UObject* const Wrapper, TSharedPtr<FJsonValue>&& Value) -> void
+		{
+			if (!Value)
+			{
+				return;
+			}
+
+			int32& Index = DocumentIndices.FindOrAdd(GetNodeKey(*Value), INDEX_NONE);
+			if (Index == INDEX_NONE)
+			{
+				Index = Documents.AddDefaulted();
+				Documents[Index].Value = MoveTemp(Value);
+			}
+			Documents[Index].Wrappers.Add(Wrapper);
+		};
+
+		for (TObjectIterator<UJsonObject> It; It; ++It)
+		{
+			if (IsValid(*It))
+			{
+				++NumObjects;
+				AddWrapper(*It, It->GetRawValue());
+			}
+		}
+
+		for (TObjectIterator<UJsonValue> It; It; ++It)
+		{
+			if (IsValid(*It))
+			{
+				++NumValues;
+				AddWrapper(*It, It->GetRawValue());
+			}
+		}
+
+		// A document walked first can be found in a later one, so roots are only known once every document is walked.
+		for (int32 Index = 0; Index < Documents.Num(); ++Index)
+		{
+			if (Documents[Index].Container == INDEX_NONE)
+			{
+				FDocumentWalker Walker(DocumentIndices, Documents, Index);
+				Walker.Walk(*Documents[Index].Value);
+				Documents[Index].Stats = Walker.Stats;
+			}
+		}
+
+		TArray<int32> Roots;
+		TMap<int32, TArray<UObject*>> RootWrappers;
+		for (int32 Index = 0; Index < Documents.Num(); ++Index)
+		{
+			// Follows the containers up to the root, bounded in case of documents containing each other.
+			int32 Root = Index;
+			for (int32 Depth = 0; Documents[Root].Container != INDEX_NONE && Depth < Documents.Num(); ++Depth)
+			{
+				Root = Documents[Root].Container;
+			}
+
+			if (Root == Index)
+			{
+				Roots.Add(Index);
+			}
+			RootWrappers.FindOrAdd(Root).Append(Documents[Index].Wrappers);
+		}
+
+		FDomStats Total;
+		for (const int32 Root : Roots)
+		{
+			Total.Add(Documents[Root].Stats);
+		}
+
+		Roots.Sort([&Documents](const int32 A, const int32 B) -> bool
+		{
+			return Documents[A].Stats.Bytes > Documents[B].Stats.Bytes;
+		});
+
+		UE_LOG(LogBlueprintJson, Display, TEXT("%d UJsonObject and %d UJsonValue retain %d documents, %s."),
+			NumObjects, NumValues, Roots.Num(), *FormatBytes(Total.Bytes));
+		UE_LOG(LogBlueprintJson, Display, TEXT("%s."), *FormatNodes(Total));
+
+		const int32 NumShown = FMath::Min(TopN, Roots.Num());
+		if (NumShown > 0)
+		{
+			UE_LOG(LogBlueprintJson, Display, TEXT("Largest documents:"));
+		}
+
+		for (int32 Rank = 0; Rank < NumShown; ++Rank)
+		{
+			const FDocument&        Document = Documents[Roots[Rank]];
+			const TArray<UObject*>&  Wrappers = RootWrappers.FindChecked(Roots[Rank]);
+
+			UE_LOG(LogBlueprintJson, Display, TEXT("#%d %s, %s, %d wrappers, root %s. Owners: %s."),
+				Rank + 1,
+				*FormatBytes(Document.Stats.Bytes),
+				*FormatNodes(Document.Stats),
+				Wrappers.Num(),
+				*Document.Wrappers[0]->GetName(),
+				*DescribeOwners(Wrappers));
+		}
+	}
+}
+
+static FAutoConsoleCommand CmdMemReport(
+	TEXT("BlueprintJson.MemReport"),
+	TEXT("Walks the live UJsonObject and UJsonValue and logs the approximate memory of the JSON they retain per root document, ")
+	TEXT("the nodes by type and the largest documents with the objects referencing them.\n")
+	TEXT("Usage: BlueprintJson.MemReport [TopN=10]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		int32 TopN = 10;
+		if (Args.Num() > 0)
+		{
+			LexFromString(TopN, *Args[0]);
+		}
+		ReportMemory(FMath::Max(TopN, 0));
+	}));
@@ -4,6 +4,7 @@
 #include "BlueprintJson.h"
 #include "BlueprintJsonWrapper.h"
 #include "BlueprintJsonLibrary.h"
+#include "BlueprintJsonStats.h"
 #include "Async/TaskGraphInterfaces.h"
 #include "Async/Async.h"
 #include "Misc/FileHelper.h"
@@ -53,6 +54,7 @@ void UJsonLoadAsyncFromFileProxy::Activate()
 	{
 		TWeakObjectPtr<ThisClass> Self = Proxy;
 		Proxy->JsonObject = Async(EAsyncExecution::ThreadPool, [Json]() -> UJsonObject* {
+			BLUEPRINTJSON_SCOPE(ParseAsync);
 			bool bSuccess = false;
 			return UJsonObject::ParseJson(Json, bSuccess);
 		}, [Self]() {
@@ -88,6 +90,7 @@ void UJsonSaveAsyncProxy::Activate()
 		TSharedPtr<FJsonObject> RawObject = ObjectToSave->GetRawObject();
 		AsyncTask(ENamedThreads::AnyThread, [FilePath = MoveTemp(this->FilePath), RawObject = MoveTemp(RawObject), Self = MoveTemp(Self)]() mutable -> void
 		{
+			BLUEPRINTJSON_SCOPE(SaveAsync);
 			FString Data;
 			const bool bSuccess = UJsonLibrary::StringifyJsonObject(RawObject, Data);
 			SaveStringToFile(MoveTemp(Self), Data, FilePath, bSuccess);
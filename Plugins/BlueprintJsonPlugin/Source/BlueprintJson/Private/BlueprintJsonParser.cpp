@@ -0,0 +1,574 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#include "BlueprintJsonParser.h"
+#include "BlueprintJson.h"
+#include "BlueprintJsonValues.h"
+#include "BlueprintJsonStats.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+
+namespace
+{
+	/**
+	 *  Recursive descent parser over a contiguous character buffer.
+	 *  Offsets stored in lazy values are relative to the start of the source buffer.
+	 **/
+	template<typename CharType>
+	class TJsonDomParser
+	{
+	public:
+		TJsonDomParser(FJsonSourceBufferRef InSource, const CharType* const InData, const int32 InLength, const EJsonParseOptions InOptions)
+			: Source(MoveTemp(InSource))
+			, Data(InData)
+			, Length(InLength)
+			, Position(0)
+			, Options(InOptions)
+		{}
+
+		TSharedPtr<FJsonValue> ParseDocument()
+		{
+			SkipWhitespace();
+
+			TSharedPtr<FJsonValue> Root = ParseValue(0);
+
+			if (Root)
+			{
+				SkipWhitespace();
+				if (Position != Length)
+				{
+					Fail(TEXT("unexpected data after the root value"));
+					return nullptr;
+				}
+			}
+
+			return Root;
+		}
+
+		const FString& GetError() const { return Error; }
+
+	private:
+		FORCEINLINE bool HasOption(const EJsonParseOptions Option) const
+		{
+			return EnumHasAnyFlags(Options, Option);
+		}
+
+		FORCEINLINE void SkipWhitespace()
+		{
+			while (Position < Length)
+			{
+				const CharType Char = Data[Position];
+				if (Char != ' ' && Char != '\t' && Char != '\n' && Char != '\r')
+				{
+					break;
+				}
+				++Position;
+			}
+		}
+
+		bool Fail(const TCHAR* const Message)
+		{
+			if (Error.IsEmpty())
+			{
+				Error = FString::Printf(TEXT("Invalid JSON at offset %d: %s."), Position, Message);
+			}
+			return false;
+		}
+
+		bool Consume(const ANSICHAR* const Literal)
+		{
+			int32 Index = 0;
+			for (; Literal[Index]; ++Index)
+			{
+				if (Position + Index >= Length || Data[Position + Index] != Literal[Index])
+				{
+					return Fail(TEXT("invalid literal"));
+				}
+			}
+			Position += Index;
+			return true;
+		}
+
+		TSharedPtr<FJsonValue> ParseValue(const int32 Depth)
+		{
+			if (Position >= Length)
+			{
+				Fail(TEXT("unexpected end of document"));
+				return nullptr;
+			}
+
+			switch (Data[Position])
+			{
+			case '{': return ParseObjectValue(Depth + 1);
+			case '[':
+			{
+				TArray<TSharedPtr<FJsonValue>> Values;
+				return ParseArray(Depth + 1, Values) ? MakeShared<FJsonValueArray>(MoveTemp(Values)) : nullptr;
+			}
+			case '"': return ParseStringValue();
+			case 't': return Consume("true")  ? MakeShared<FJsonValueBoolean>(true)  : nullptr;
+			case 'f': return Consume("false") ? MakeShared<FJsonValueBoolean>(false) : nullptr;
+			case 'n': return Consume("null")  ? MakeShared<FJsonValueNull>()         : nullptr;
+			default:  return ParseNumber();
+			}
+		}
+
+		TSharedPtr<FJsonValue> ParseObjectValue(const int32 Depth)
+		{
+			// Small objects are kept flat. They only switch to the hashed
+			// FJsonObject if they outgrow FJsonValueFlatObject::MaxFlatFields.
+			TSharedPtr<FJsonValueFlatObject> FlatObject;
+			TSharedPtr<FJsonObject> Object;
+
+			if (HasOption(EJsonParseOptions::FlatObjects))
+			{
+				FlatObject = MakeShared<FJsonValueFlatObject>();
+			}
+			else
+			{
+				Object = MakeShared<FJsonObject>();
+			}
+
+			const bool bParsed = ParseFields(Depth, [&FlatObject, &Object](const FStringView FieldName, TSharedPtr<FJsonValue>&& Value)
+			{
+				if (FlatObject)
+				{
+					if (FlatObject->AddField(FieldName, Value))
+					{
+						return;
+					}
+
+					Object = FlatObject->ToJsonObject();
+					FlatObject.Reset();
+				}
+
+				Object->Values.Emplace(FString(FieldName), MoveTemp(Value));
+			});
+
+			if (!bParsed)
+			{
+				return nullptr;
+			}
+
+			if (FlatObject)
+			{
+				return FlatObject;
+			}
+
+			return MakeShared<FJsonValueObject>(MoveTemp(Object));
+		}
+
+		/* Parses the fields of an object starting at its opening brace, and passes them to AddField. */
+		template<typename FunctorType>
+		bool ParseFields(const int32 Depth, FunctorType&& AddField)
+		{
+			if (Depth > FBlueprintJsonParser::MaxDepth)
+			{
+				return Fail(TEXT("maximum depth exceeded"));
+			}
+
+			++Position; // '{'
+
+			SkipWhitespace();
+			if (Position < Length && Data[Position] == '}')
+			{
+				++Position;
+				return true;
+			}
+
+			while (true)
+			{
+				SkipWhitespace();
+				if (Position >= Length || Data[Position] != '"')
+				{
+					return Fail(TEXT("expected a field name"));
+				}
+
+				FStringView FieldName;
+				if (!ParseFieldName(FieldName))
+				{
+					return false;
+				}
+
+				SkipWhitespace();
+				if (Position >= Length || Data[Position] != ':')
+				{
+					return Fail(TEXT("expected ':' after a field name"));
+				}
+				++Position;
+				SkipWhitespace();
+
+				// A name decoded into FieldNameBuffer would be overwritten by nested objects.
+				FString NestedFieldName;
+				if (bFieldNameInBuffer && Position < Length && (Data[Position] == '{' || Data[Position] == '['))
+				{
+					NestedFieldName = FieldName;
+					FieldName = NestedFieldName;
+				}
+
+				TSharedPtr<FJsonValue> Value = ParseValue(Depth);
+				if (!Value)
+				{
+					return false;
+				}
+
+				AddField(FieldName, MoveTemp(Value));
+
+				SkipWhitespace();
+				if (Position < Length && Data[Position] == ',')
+				{
+					++Position;
+					continue;
+				}
+				if (Position < Length && Data[Position] == '}')
+				{
+					++Position;
+					return true;
+				}
+
+				return Fail(TEXT("expected ',' or '}' in object"));
+			}
+		}
+
+		/**
+		 * Parses a field name without allocating when possible: names without escapes
+		 * point into the source when it's TCHAR, others are decoded into FieldNameBuffer.
+		 */
+		bool ParseFieldName(FStringView& OutFieldName)
+		{
+			int32 Begin = 0, End = 0;
+			bool bHasEscapes = false;
+			if (!ScanString(Begin, End, bHasEscapes))
+			{
+				return false;
+			}
+
+			const TStringView<CharType> Body(Data + Begin, End - Begin);
+
+			if constexpr (std::is_same_v<CharType, TCHAR>)
+			{
+				if (!bHasEscapes)
+				{
+					bFieldNameInBuffer = false;
+					OutFieldName = Body;
+					return true;
+				}
+			}
+
+			bFieldNameInBuffer = true;
+			FieldNameBuffer.Reset();
+			if (bHasEscapes)
+			{
+				FJsonValueLazyString::AppendUnescaped(Body, FieldNameBuffer);
+			}
+			else
+			{
+				FieldNameBuffer = FString(Body);
+			}
+
+			OutFieldName = FieldNameBuffer;
+			return true;
+		}
+
+		bool ParseArray(const int32 Depth, TArray<TSharedPtr<FJsonValue>>& OutValues)
+		{
+			if (Depth > FBlueprintJsonParser::MaxDepth)
+			{
+				return Fail(TEXT("maximum depth exceeded"));
+			}
+
+			++Position; // '['
+
+			SkipWhitespace();
+			if (Position < Length && Data[Position] == ']')
+			{
+				++Position;
+				return true;
+			}
+
+			while (true)
+			{
+				SkipWhitespace();
+
+				TSharedPtr<FJsonValue> Value = ParseValue(Depth);
+				if (!Value)
+				{
+					return false;
+				}
+
+				OutValues.Emplace(MoveTemp(Value));
+
+				SkipWhitespace();
+				if (Position < Length && Data[Position] == ',')
+				{
+					++Position;
+					continue;
+				}
+				if (Position < Length && Data[Position] == ']')
+				{
+					++Position;
+					return true;
+				}
+
+				return Fail(TEXT("expected ',' or ']' in array"));
+			}
+		}
+
+		FORCEINLINE static bool IsHexDigit(const CharType Char)
+		{
+			return (Char >= '0' && Char <= '9') || (Char >= 'a' && Char <= 'f') || (Char >= 'A' && Char <= 'F');
+		}
+
+		/**
+		 * Validates a string starting at its opening quote and moves past its closing quote.
+		 * OutBegin and OutEnd delimit the string's body, without the quotes.
+		 */
+		bool ScanString(int32& OutBegin, int32& OutEnd, bool& bOutHasEscapes)
+		{
+			++Position; // '"'
+
+			OutBegin = Position;
+			bOutHasEscapes = false;
+
+			while (Position < Length)
+			{
+				const CharType Char = Data[Position];
+
+				if (Char == '"')
+				{
+					OutEnd = Position++;
+					return true;
+				}
+
+				if (static_cast<uint32>(Char) < 0x20)
+				{
+					return Fail(TEXT("control character in string"));
+				}
+
+				if (Char != '\\')
+				{
+					++Position;
+					continue;
+				}
+
+				bOutHasEscapes = true;
+
+				if (Position + 1 >= Length)
+				{
+					break;
+				}
+
+				switch (Data[Position + 1])
+				{
+				case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+					Position += 2;
+					break;
+				case 'u':
+					if (Position + 6 > Length || !IsHexDigit(Data[Position + 2]) || !IsHexDigit(Data[Position + 3]) || !IsHexDigit(Data[Position + 4]) || !IsHexDigit(Data[Position + 5]))
+					{
+						return Fail(TEXT("invalid unicode escape"));
+					}
+					Position += 6;
+					break;
+				default:
+					return Fail(TEXT("invalid escape sequence"));
+				}
+			}
+
+			return Fail(TEXT("unterminated string"));
+		}
+
+		/* Parses a string starting at its opening quote into OutString. */
+		bool ParseString(FString& OutString)
+		{
+			int32 Begin = 0, End = 0;
+			bool bHasEscapes = false;
+			if (!ScanString(Begin, End, bHasEscapes))
+			{
+				return false;
+			}
+
+			const TStringView<CharType> Body(Data + Begin, End - Begin);
+
+			OutString.Reset();
+			if (bHasEscapes)
+			{
+				FJsonValueLazyString::AppendUnescaped(Body, OutString);
+			}
+			else
+			{
+				OutString = FString(Body);
+			}
+			return true;
+		}
+
+		TSharedPtr<FJsonValue> ParseStringValue()
+		{
+			if (HasOption(EJsonParseOptions::LazyStrings))
+			{
+				int32 Begin = 0, End = 0;
+				bool bHasEscapes = false;
+				if (!ScanString(Begin, End, bHasEscapes))
+				{
+					return nullptr;
+				}
+				return MakeShared<FJsonValueLazyString>(Source, Begin, End - Begin, bHasEscapes);
+			}
+
+			FString String;
+			return ParseString(String) ? MakeShared<FJsonValueString>(MoveTemp(String)) : nullptr;
+		}
+
+		TSharedPtr<FJsonValue> ParseNumber()
+		{
+			const int32 Begin = Position;
+			bool bIsInteger = true;
+
+			const auto SkipDigits = [this]() -> int32
+			{
+				const int32 DigitsBegin = Position;
+				while (Position < Length && Data[Position] >= '0' && Data[Position] <= '9')
+				{
+					++Position;
+				}
+				return Position - DigitsBegin;
+			};
+
+			if (Data[Position] == '-')
+			{
+				++Position;
+			}
+
+			if (Position < Length && Data[Position] == '0')
+			{
+				++Position;
+			}
+			else if (SkipDigits() == 0)
+			{
+				Fail(TEXT("unexpected character"));
+				return nullptr;
+			}
+
+			if (Position < Length && Data[Position] == '.')
+			{
+				++Position;
+				bIsInteger = false;
+				if (SkipDigits() == 0)
+				{
+					Fail(TEXT("expected digits after '.'"));
+					return nullptr;
+				}
+			}
+
+			if (Position < Length && (Data[Position] == 'e' || Data[Position] == 'E'))
+			{
+				++Position;
+				bIsInteger = false;
+				if (Position < Length && (Data[Position] == '+' || Data[Position] == '-'))
+				{
+					++Position;
+				}
+				if (SkipDigits() == 0)
+				{
+					Fail(TEXT("expected digits in exponent"));
+					return nullptr;
+				}
+			}
+
+			const int32 LexemeLength = Position - Begin;
+
+			if (HasOption(EJsonParseOptions::LazyNumbers))
+			{
+				return MakeShared<FJsonValueLazyNumber>(Source, Begin, LexemeLength, bIsInteger);
+			}
+
+			return MakeShared<FJsonValueNumber>(FJsonValueLazyNumber::ParseDouble(TStringView<CharType>(Data + Begin, LexemeLength)));
+		}
+
+	private:
+		FJsonSourceBufferRef Source;
+
+		const CharType* const Data;
+		const int32 Length;
+		int32 Position;
+
+		const EJsonParseOptions Options;
+
+		/* Storage for field names that can't be viewed in place. */
+		FString FieldNameBuffer;
+		bool    bFieldNameInBuffer = false;
+
+		FString Error;
+	};
+
+	TSharedPtr<FJsonValue> ParseSource(const FJsonSourceBufferRef& Source, const EJsonParseOptions Options, FString* const OutError)
+	{
+		const auto Parse = [&](const auto Text) -> TSharedPtr<FJsonValue>
+		{
+			using CharType = typename TRemoveCV<typename TRemovePointer<decltype(Text.GetData())>::Type>::Type;
+
+			TJsonDomParser<CharType> Parser(Source, Text.GetData(), Text.Len(), Options);
+
+			TSharedPtr<FJsonValue> Root = Parser.ParseDocument();
+
+			if (!Root && OutError)
+			{
+				*OutError = Parser.GetError();
+			}
+
+			return Root;
+		};
+
+		return Source->VisitSlice(0, Source->Num(), Parse);
+	}
+
+	TSharedPtr<FJsonObject> GetRootObject(TSharedPtr<FJsonValue> Root, FString* const OutError)
+	{
+		if (!Root)
+		{
+			return nullptr;
+		}
+
+		if (Root->Type != EJson::Object)
+		{
+			if (OutError)
+			{
+				*OutError = TEXT("Invalid JSON: the root value is not an object.");
+			}
+			return nullptr;
+		}
+
+		return Root->AsObject();
+	}
+}
+
+/* static */ TSharedPtr<FJsonValue> FBlueprintJsonParser::ParseValue(FString&& Json, const EJsonParseOptions Options, FString* const OutError)
+{
+	BLUEPRINTJSON_SCOPE(Parser);
+	BLUEPRINTJSON_INC_STAT_BY(BytesParsed, Json.Len());
+
+	return ParseSource(MakeShared<const FJsonSourceBuffer, ESPMode::ThreadSafe>(MoveTemp(Json)), Options, OutError);
+}
+
+/* static */ TSharedPtr<FJsonValue> FBlueprintJsonParser::ParseValue(TArray<uint8>&& Utf8Json, const EJsonParseOptions Options, FString* const OutError)
+{
+	BLUEPRINTJSON_SCOPE(Parser);
+	BLUEPRINTJSON_INC_STAT_BY(BytesParsed, Utf8Json.Num());
+
+	// Skip the byte order mark, if any.
+	if (Utf8Json.Num() >= 3 && Utf8Json[0] == 0xEF && Utf8Json[1] == 0xBB && Utf8Json[2] == 0xBF)
+	{
+		Utf8Json.RemoveAt(0, 3, EAllowShrinking::No);
+	}
+
+	return ParseSource(MakeShared<const FJsonSourceBuffer, ESPMode::ThreadSafe>(MoveTemp(Utf8Json)), Options, OutError);
+}
+
+/* static */ TSharedPtr<FJsonObject> FBlueprintJsonParser::ParseObject(FString&& Json, const EJsonParseOptions Options, FString* const OutError)
+{
+	return GetRootObject(ParseValue(MoveTemp(Json), Options, OutError), OutError);
+}
+
+/* static */ TSharedPtr<FJsonObject> FBlueprintJsonParser::ParseObject(TArray<uint8>&& Utf8Json, const EJsonParseOptions Options, FString* const OutError)
+{
+	return GetRootObject(ParseValue(MoveTemp(Utf8Json), Options, OutError), OutError);
+}
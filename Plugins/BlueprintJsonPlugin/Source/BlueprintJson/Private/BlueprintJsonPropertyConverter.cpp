@@ -0,0 +1,221 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#include "BlueprintJsonPropertyConverter.h"
+#include "BlueprintJson.h"
+#include "BlueprintJsonWrapper.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "JsonObjectConverter.h"
+
+/* static */ bool FBlueprintJsonPropertyConverter::ReadValue(const TSharedPtr<FJsonValue>& Value, const FProperty* const Property, void* const Address)
+{
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	if (!Value || !Property || !Address)
+	{
+		return false;
+	}
+
+	if (const FBoolProperty* const BoolProperty = CastField<FBoolProperty>(Property))
+	{
+		bool bValue = false;
+		if (!Value->TryGetBool(bValue))
+		{
+			return false;
+		}
+		BoolProperty->SetPropertyValue(Address, bValue);
+		return true;
+	}
+
+	if (const FNumericProperty* const NumericProperty = CastField<FNumericProperty>(Property))
+	{
+		if (NumericProperty->IsFloatingPoint())
+		{
+			double Number = 0.;
+			if (!Value->TryGetNumber(Number))
+			{
+				return false;
+			}
+			NumericProperty->SetFloatingPointPropertyValue(Address, Number);
+			return true;
+		}
+
+		// uint64 values above the int64 range don't fit the signed path.
+		if (NumericProperty->IsA<FUInt64Property>())
+		{
+			uint64 Number = 0;
+			if (!Value->TryGetNumber(Number))
+			{
+				return false;
+			}
+			NumericProperty->SetIntPropertyValue(Address, Number);
+			return true;
+		}
+
+		int64 Number = 0;
+		if (!Value->TryGetNumber(Number))
+		{
+			return false;
+		}
+		NumericProperty->SetIntPropertyValue(Address, Number);
+		return true;
+	}
+
+	if (const FStrProperty* const StrProperty = CastField<FStrProperty>(Property))
+	{
+		return Value->TryGetString(*StrProperty->GetPropertyValuePtr(Address));
+	}
+
+	if (const FNameProperty* const NameProperty = CastField<FNameProperty>(Property))
+	{
+		FString String;
+		if (!Value->TryGetString(String))
+		{
+			return false;
+		}
+		NameProperty->SetPropertyValue(Address, FName(String));
+		return true;
+	}
+
+	if (const FTextProperty* const TextProperty = CastField<FTextProperty>(Property))
+	{
+		FString String;
+		if (!Value->TryGetString(String))
+		{
+			return false;
+		}
+		TextProperty->SetPropertyValue(Address, FText::FromString(MoveTemp(String)));
+		return true;
+	}
+
+	if (const FObjectProperty* const ObjectProperty = CastField<FObjectProperty>(Property))
+	{
+		if (ObjectProperty->PropertyClass->IsChildOf<UJsonObject>())
+		{
+			UJsonObject* const Object = UJsonObject::CreateFromRawValue(Value);
+			ObjectProperty->SetObjectPropertyValue(Address, Object);
+			return Object != nullptr;
+		}
+
+		if (ObjectProperty->PropertyClass->IsChildOf<UJsonValue>())
+		{
+			ObjectProperty->SetObjectPropertyValue(Address, UJsonValue::CreateFromRaw(Value));
+			return true;
+		}
+
+		return false;
+	}
+
+	if (const FStructProperty* const StructProperty = CastField<FStructProperty>(Property))
+	{
+		if (StructProperty->Struct == FLightJsonValue::StaticStruct())
+		{
+			*static_cast<FLightJsonValue*>(Address) = FLightJsonValue(Value);
+			return true;
+		}
+
+		if (StructProperty->Struct == FLightJsonObject::StaticStruct())
+		{
+			const TSharedPtr<FJsonObject>* Object = nullptr;
+			if (!Value->TryGetObject(Object))
+			{
+				return false;
+			}
+			*static_cast<FLightJsonObject*>(Address) = FLightJsonObject(*Object);
+			return true;
+		}
+
+		// Math types accept both encodings written by the UJsonValue creators.
+#define JSON_STRUCT_CASE(Type) if (StructProperty->Struct == TBaseStructure<Type>::Get()) return UJsonValue::ReadRawJsonValue(Value, *static_cast<Type*>(Address));
+		JSON_STRUCT_CASE(FVector);
+		JSON_STRUCT_CASE(FVector2D);
+		JSON_STRUCT_CASE(FRotator);
+		JSON_STRUCT_CASE(FTransform);
+		JSON_STRUCT_CASE(FLinearColor);
+		JSON_STRUCT_CASE(FColor);
+		JSON_STRUCT_CASE(FQuat);
+#undef JSON_STRUCT_CASE
+	}
+
+	return FJsonObjectConverter::JsonValueToUProperty(Value, const_cast<FProperty*>(Property), Address, 0, 0);
+}
+
+/* static */ TSharedPtr<FJsonValue> FBlueprintJsonPropertyConverter::WriteValue(const FProperty* const Property, const void* const Address)
+{
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	if (!Property || !Address)
+	{
+		return MakeShared<FJsonValueNull>();
+	}
+
+	if (const FBoolProperty* const BoolProperty = CastField<FBoolProperty>(Property))
+	{
+		return MakeShared<FJsonValueBoolean>(BoolProperty->GetPropertyValue(Address));
+	}
+
+	if (const FNumericProperty* const NumericProperty = CastField<FNumericProperty>(Property))
+	{
+		if (NumericProperty->IsFloatingPoint())
+		{
+			return MakeShared<FJsonValueNumber>(NumericProperty->GetFloatingPointPropertyValue(Address));
+		}
+		if (NumericProperty->IsA<FUInt64Property>())
+		{
+			return UJsonValue::MakeUInteger64Value(NumericProperty->GetUnsignedIntPropertyValue(Address));
+		}
+		return UJsonValue::MakeInteger64Value(NumericProperty->GetSignedIntPropertyValue(Address));
+	}
+
+	if (const FStrProperty* const StrProperty = CastField<FStrProperty>(Property))
+	{
+		return MakeShared<FJsonValueString>(StrProperty->GetPropertyValue(Address));
+	}
+
+	if (const FNameProperty* const NameProperty = CastField<FNameProperty>(Property))
+	{
+		return MakeShared<FJsonValueString>(NameProperty->GetPropertyValue(Address).ToString());
+	}
+
+	if (const FTextProperty* const TextProperty = CastField<FTextProperty>(Property))
+	{
+		return MakeShared<FJsonValueString>(TextProperty->GetPropertyValue(Address).ToString());
+	}
+
+	if (const FObjectProperty* const ObjectProperty = CastField<FObjectProperty>(Property))
+	{
+		TSharedPtr<FJsonValue> Value = UJsonValue::CreateRawJsonValue(ObjectProperty->GetObjectPropertyValue(Address));
+		return Value ? Value : MakeShared<FJsonValueNull>();
+	}
+
+	if (const FStructProperty* const StructProperty = CastField<FStructProperty>(Property))
+	{
+		const UScriptStruct* const Struct = StructProperty->Struct;
+
+		if (Struct == FLightJsonValue::StaticStruct())
+		{
+			const TSharedPtr<FJsonValue>& Value = static_cast<const FLightJsonValue*>(Address)->GetRawValue();
+			return Value ? Value : MakeShared<FJsonValueNull>();
+		}
+
+		if (Struct == FLightJsonObject::StaticStruct())
+		{
+			const TSharedPtr<FJsonObject>& Object = static_cast<const FLightJsonObject*>(Address)->GetRawObject();
+			return Object ? StaticCastSharedRef<FJsonValue>(MakeShared<FJsonValueObject>(Object)) : MakeShared<FJsonValueNull>();
+		}
+
+		// Math types use the same layout as the UJsonValue creators.
+#define JSON_STRUCT_CASE(Type) if (Struct == TBaseStructure<Type>::Get()) return UJsonValue::CreateRawJsonValue(*static_cast<const Type*>(Address));
+		JSON_STRUCT_CASE(FVector);
+		JSON_STRUCT_CASE(FVector2D);
+		JSON_STRUCT_CASE(FRotator);
+		JSON_STRUCT_CASE(FTransform);
+		JSON_STRUCT_CASE(FLinearColor);
+		JSON_STRUCT_CASE(FColor);
+		JSON_STRUCT_CASE(FQuat);
+#undef JSON_STRUCT_CASE
+	}
+
+	TSharedPtr<FJsonValue> Value = FJsonObjectConverter::UPropertyToJsonValue(const_cast<FProperty*>(Property), Address);
+	return Value ? Value : MakeShared<FJsonValueNull>();
+}
@@ -0,0 +1,21 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FJsonValue;
+
+/**
+ *  Converts between raw JSON values and Blueprint properties, for the native
+ *  calls of the custom nodes that read their pins from the VM stack.
+ **/
+class FBlueprintJsonPropertyConverter
+{
+public:
+    /* Writes Value to the property at Address. Returns false if the value is null or of the wrong type. */
+    static bool ReadValue(const TSharedPtr<FJsonValue>& Value, const FProperty* const Property, void* const Address);
+
+    /* Creates a raw value from the property at Address. Null objects become the JSON Null value. */
+    static TSharedPtr<FJsonValue> WriteValue(const FProperty* const Property, const void* const Address);
+};
@@ -0,0 +1,84 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "BlueprintJson.h"
+
+/**
+ *  Stats and Unreal Insights scopes of the module, compiled out of shipping builds.
+ *
+ *  "stat BlueprintJson" shows the time and calls per frame of each instrumented
+ *  function, the bytes parsed and written, and the live wrappers. In Insights,
+ *  the scopes are on the BlueprintJson channel, e.g. -trace=cpu,BlueprintJson.
+ *
+ *  The scopes also tag their allocations with the BlueprintJson LLM tag, in
+ *  every build LLM is compiled in.
+ **/
+#ifndef BLUEPRINTJSON_PROFILING
+#define BLUEPRINTJSON_PROFILING !UE_BUILD_SHIPPING
+#endif
+
+#if BLUEPRINTJSON_PROFILING
+
+DECLARE_STATS_GROUP(TEXT("BlueprintJson"), STATGROUP_BlueprintJson, STATCAT_Advanced);
+
+/* A cycle counter and a per frame call counter. */
+#define DECLARE_BLUEPRINTJSON_STAT(Name, Description) \
+    DECLARE_CYCLE_STAT_EXTERN(TEXT(Description), STAT_BlueprintJson_##Name, STATGROUP_BlueprintJson, ); \
+    DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT(Description) TEXT(" Calls"), STAT_BlueprintJson_##Name##Calls, STATGROUP_BlueprintJson, )
+
+#define DEFINE_BLUEPRINTJSON_STAT(Name) \
+    DEFINE_STAT(STAT_BlueprintJson_##Name); \
+    DEFINE_STAT(STAT_BlueprintJson_##Name##Calls)
+
+DECLARE_BLUEPRINTJSON_STAT(Parser,           "Parser");
+DECLARE_BLUEPRINTJSON_STAT(ParseJson,        "Parse JSON");
+DECLARE_BLUEPRINTJSON_STAT(Stringify,        "Stringify");
+DECLARE_BLUEPRINTJSON_STAT(CreateObject,     "Create Object");
+DECLARE_BLUEPRINTJSON_STAT(CreateValue,      "Create Value");
+DECLARE_BLUEPRINTJSON_STAT(UnflattenObject,  "Unflatten Object");
+DECLARE_BLUEPRINTJSON_STAT(GetFieldAsArray,  "Get Field as Array");
+DECLARE_BLUEPRINTJSON_STAT(CreateArrayView,  "Create Array View");
+DECLARE_BLUEPRINTJSON_STAT(GetTypedArray,    "Get Field as Typed Array");
+DECLARE_BLUEPRINTJSON_STAT(GetFieldAsObject, "Get Field as Object");
+DECLARE_BLUEPRINTJSON_STAT(GetAllProperties, "Get All Properties");
+DECLARE_BLUEPRINTJSON_STAT(SetArrayField,    "Set Array Field");
+DECLARE_BLUEPRINTJSON_STAT(BreakFields,      "Break Object");
+DECLARE_BLUEPRINTJSON_STAT(MakeObject,       "Make Object");
+DECLARE_BLUEPRINTJSON_STAT(LoadFile,         "Load File");
+DECLARE_BLUEPRINTJSON_STAT(ParseAsync,       "Parse Async");
+DECLARE_BLUEPRINTJSON_STAT(SaveAsync,        "Save Async");
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bytes Parsed"),  STAT_BlueprintJson_BytesParsed,  STATGROUP_BlueprintJson, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bytes Written"), STAT_BlueprintJson_BytesWritten, STATGROUP_BlueprintJson, );
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live JSON Objects"), STAT_BlueprintJson_LiveObjects, STATGROUP_BlueprintJson, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live JSON Values"),  STAT_BlueprintJson_LiveValues,  STATGROUP_BlueprintJson, );
+
+#if CPUPROFILERTRACE_ENABLED
+UE_TRACE_CHANNEL_EXTERN(BlueprintJsonChannel);
+#define BLUEPRINTJSON_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(BlueprintJson_##Name, BlueprintJsonChannel)
+#else
+#define BLUEPRINTJSON_TRACE_SCOPE(Name)
+#endif
+
+/* Times the rest of the scope, counts the call and tags its allocations. Name is one of the stats declared above. */
+#define BLUEPRINTJSON_SCOPE(Name) \
+    LLM_SCOPE_BYTAG(BlueprintJson); \
+    BLUEPRINTJSON_TRACE_SCOPE(Name); \
+    SCOPE_CYCLE_COUNTER(STAT_BlueprintJson_##Name); \
+    INC_DWORD_STAT(STAT_BlueprintJson_##Name##Calls)
+
+#define BLUEPRINTJSON_INC_STAT_BY(Stat, Amount) INC_DWORD_STAT_BY(STAT_BlueprintJson_##Stat, Amount)
+#define BLUEPRINTJSON_DEC_STAT(Stat)            DEC_DWORD_STAT(STAT_BlueprintJson_##Stat)
+
+#else
+
+#define BLUEPRINTJSON_SCOPE(Name) LLM_SCOPE_BYTAG(BlueprintJson)
+#define BLUEPRINTJSON_INC_STAT_BY(Stat, Amount)
+#define BLUEPRINTJSON_DEC_STAT(Stat)
+
+#endif
@@ -0,0 +1,626 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#include "BlueprintJsonValues.h"
+#include "BlueprintJson.h"
+
+namespace
+{
+	/* Sentinels of FJsonValueTagged. Only their addresses are compared, the distinct values keep the linker from folding them. */
+	const uint8 LazyNumberKind = 1;
+	const uint8 LazyStringKind = 2;
+	const uint8 FlatObjectKind = 3;
+
+	template<typename CharType>
+	bool TryParseUnsignedIntegerImpl(const TStringView<CharType> Lexeme, uint64& OutValue)
+	{
+		if (Lexeme.IsEmpty())
+		{
+			return false;
+		}
+
+		uint64 Value = 0;
+		for (const CharType Char : Lexeme)
+		{
+			if (Char < '0' || Char > '9')
+			{
+				return false;
+			}
+
+			const uint64 Digit = Char - '0';
+			if (Value > (MAX_uint64 - Digit) / 10)
+			{
+				return false;
+			}
+			Value = Value * 10 + Digit;
+		}
+
+		OutValue = Value;
+		return true;
+	}
+
+	template<typename CharType>
+	bool TryParseIntegerImpl(TStringView<CharType> Lexeme, int64& OutValue)
+	{
+		const bool bNegative = !Lexeme.IsEmpty() && Lexeme[0] == '-';
+		if (bNegative)
+		{
+			Lexeme.RightChopInline(1);
+		}
+
+		uint64 Magnitude = 0;
+		if (!TryParseUnsignedIntegerImpl(Lexeme, Magnitude))
+		{
+			return false;
+		}
+
+		if (bNegative)
+		{
+			if (Magnitude > static_cast<uint64>(MAX_int64) + 1)
+			{
+				return false;
+			}
+			OutValue = static_cast<int64>(0 - Magnitude);
+		}
+		else
+		{
+			if (Magnitude > static_cast<uint64>(MAX_int64))
+			{
+				return false;
+			}
+			OutValue = static_cast<int64>(Magnitude);
+		}
+
+		return true;
+	}
+
+	template<typename CharType>
+	double ParseDoubleImpl(const TStringView<CharType> Lexeme)
+	{
+		// Integers that fit in the mantissa don't need the generic conversion.
+		int64 Integer = 0;
+		if (Lexeme.Len() <= 15 && TryParseIntegerImpl(Lexeme, Integer))
+		{
+			return static_cast<double>(Integer);
+		}
+
+		// Atod needs a null terminated string. JSON numbers are ASCII so a narrow
+		// stack buffer is enough for every lexeme that isn't absurdly long.
+		ANSICHAR Buffer[128];
+		if (Lexeme.Len() < UE_ARRAY_COUNT(Buffer))
+		{
+			for (int32 Index = 0; Index < Lexeme.Len(); ++Index)
+			{
+				Buffer[Index] = static_cast<ANSICHAR>(Lexeme[Index]);
+			}
+			Buffer[Lexeme.Len()] = '\0';
+			return FCStringAnsi::Atod(Buffer);
+		}
+
+		return FCString::Atod(*FString(Lexeme));
+	}
+
+	FORCEINLINE void AppendCodePoint(FString& Out, uint32 CodePoint)
+	{
+		if (CodePoint > 0xFFFF && sizeof(TCHAR) == 2)
+		{
+			CodePoint -= 0x10000;
+			Out.AppendChar(static_cast<TCHAR>(0xD800 + (CodePoint >> 10)));
+			Out.AppendChar(static_cast<TCHAR>(0xDC00 + (CodePoint & 0x3FF)));
+		}
+		else
+		{
+			Out.AppendChar(static_cast<TCHAR>(CodePoint));
+		}
+	}
+
+	FORCEINLINE void AppendRun(FString& Out, const FStringView Run)
+	{
+		Out.AppendChars(Run.GetData(), Run.Len());
+	}
+
+	FORCEINLINE void AppendRun(FString& Out, const FUtf8StringView Run)
+	{
+		if (!Run.IsEmpty())
+		{
+			const auto Converted = StringCast<TCHAR>(Run.GetData(), Run.Len());
+			Out.AppendChars(Converted.Get(), Converted.Length());
+		}
+	}
+
+	template<typename CharType>
+	uint32 ReadHex4(const CharType* const Digits)
+	{
+		uint32 Value = 0;
+		for (int32 Index = 0; Index < 4; ++Index)
+		{
+			const CharType Char = Digits[Index];
+			Value <<= 4;
+			if      (Char >= '0' && Char <= '9') Value |= Char - '0';
+			else if (Char >= 'a' && Char <= 'f') Value |= Char - 'a' + 10;
+			else if (Char >= 'A' && Char <= 'F') Value |= Char - 'A' + 10;
+		}
+		return Value;
+	}
+
+	template<typename CharType>
+	void AppendUnescapedImpl(const TStringView<CharType> Escaped, FString& Out)
+	{
+		const CharType* const Data = Escaped.GetData();
+		const int32 Length = Escaped.Len();
+
+		Out.Reserve(Out.Len() + Length);
+
+		int32 RunBegin = 0;
+		int32 Position = 0;
+		while (Position < Length)
+		{
+			if (Data[Position] != '\\')
+			{
+				++Position;
+				continue;
+			}
+
+			AppendRun(Out, TStringView<CharType>(Data + RunBegin, Position - RunBegin));
+
+			const CharType Escape = Data[Position + 1];
+			Position += 2;
+
+			switch (Escape)
+			{
+			case 'b': Out.AppendChar(TEXT('\b')); break;
+			case 'f': Out.AppendChar(TEXT('\f')); break;
+			case 'n': Out.AppendChar(TEXT('\n')); break;
+			case 'r': Out.AppendChar(TEXT('\r')); break;
+			case 't': Out.AppendChar(TEXT('\t')); break;
+			case 'u':
+			{
+				uint32 CodePoint = ReadHex4(Data + Position);
+				Position += 4;
+
+				// Combine surrogate pairs into a single code point.
+				if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF && Position + 6 <= Length && Data[Position] == '\\' && Data[Position + 1] == 'u')
+				{
+					const uint32 LowSurrogate = ReadHex4(Data + Position + 2);
+					if (LowSurrogate >= 0xDC00 && LowSurrogate <= 0xDFFF)
+					{
+						CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+						Position += 6;
+					}
+				}
+
+				AppendCodePoint(Out, CodePoint);
+				break;
+			}
+			default: Out.AppendChar(static_cast<TCHAR>(Escape)); break; // '"', '\\' and '/'
+			}
+
+			RunBegin = Position;
+		}
+
+		AppendRun(Out, TStringView<CharType>(Data + RunBegin, Length - RunBegin));
+	}
+}
+
+FJsonValueLazyNumber::FJsonValueLazyNumber(FJsonSourceBufferRef InSource, const int32 InOffset, const int32 InLength, const bool bInIsInteger)
+	: FJsonValueTagged(&LazyNumberKind)
+	, Source(MoveTemp(InSource))
+	, Offset(InOffset)
+	, Length(InLength)
+	, bIsInteger(bInIsInteger)
+	, Decoded(0.)
+	, bDecoded(false)
+{
+	Type = EJson::Number;
+}
+
+/* static */ const FJsonValueLazyNumber* FJsonValueLazyNumber::Cast(const FJsonValue* const Value)
+{
+	if (Value && Value->Type == EJson::Number && IsKind(Value, &LazyNumberKind))
+	{
+		return static_cast<const FJsonValueLazyNumber*>(Value);
+	}
+	return nullptr;
+}
+
+double FJsonValueLazyNumber::DecodeDouble() const
+{
+	if (bDecoded.load(std::memory_order_acquire))
+	{
+		return Decoded.load(std::memory_order_relaxed);
+	}
+
+	const double Value = Source->VisitSlice(Offset, Length, [](const auto Lexeme) { return ParseDouble(Lexeme); });
+
+	Decoded.store(Value, std::memory_order_relaxed);
+	bDecoded.store(true, std::memory_order_release);
+
+	return Value;
+}
+
+FString FJsonValueLazyNumber::GetLexeme() const
+{
+	return Source->VisitSlice(Offset, Length, [](const auto Lexeme) { return FString(Lexeme); });
+}
+
+bool FJsonValueLazyNumber::TryGetNumber(double& OutNumber) const
+{
+	OutNumber = DecodeDouble();
+	return true;
+}
+
+bool FJsonValueLazyNumber::TryGetNumber(int64& OutNumber) const
+{
+	if (bIsInteger && Source->VisitSlice(Offset, Length, [&OutNumber](const auto Lexeme) { return TryParseInteger(Lexeme, OutNumber); }))
+	{
+		return true;
+	}
+
+	// Same behaviour as FJsonValueNumber for fractional or out of range values.
+	const double Value = DecodeDouble();
+	if (Value >= static_cast<double>(MIN_int64) && Value < static_cast<double>(MAX_int64))
+	{
+		OutNumber = static_cast<int64>(FMath::RoundHalfFromZero(Value));
+		return true;
+	}
+	return false;
+}
+
+bool FJsonValueLazyNumber::TryGetNumber(uint64& OutNumber) const
+{
+	if (bIsInteger && Source->VisitSlice(Offset, Length, [&OutNumber](const auto Lexeme) { return TryParseUnsignedInteger(Lexeme, OutNumber); }))
+	{
+		return true;
+	}
+
+	const double Value = DecodeDouble();
+	if (Value >= 0. && Value < static_cast<double>(MAX_uint64))
+	{
+		OutNumber = static_cast<uint64>(FMath::RoundHalfFromZero(Value));
+		return true;
+	}
+	return false;
+}
+
+bool FJsonValueLazyNumber::TryGetString(FString& OutString) const
+{
+	OutString = GetLexeme();
+	return true;
+}
+
+bool FJsonValueLazyNumber::TryGetBool(bool& OutBool) const
+{
+	OutBool = DecodeDouble() != 0.;
+	return true;
+}
+
+/* static */ bool FJsonValueLazyNumber::TryParseUnsignedInteger(FStringView Lexeme, uint64& OutValue)
+{
+	return TryParseUnsignedIntegerImpl(Lexeme, OutValue);
+}
+
+/* static */ bool FJsonValueLazyNumber::TryParseUnsignedInteger(FUtf8StringView Lexeme, uint64& OutValue)
+{
+	return TryParseUnsignedIntegerImpl(Lexeme, OutValue);
+}
+
+/* static */ bool FJsonValueLazyNumber::TryParseInteger(FStringView Lexeme, int64& OutValue)
+{
+	return TryParseIntegerImpl(Lexeme, OutValue);
+}
+
+/* static */ bool FJsonValueLazyNumber::TryParseInteger(FUtf8StringView Lexeme, int64& OutValue)
+{
+	return TryParseIntegerImpl(Lexeme, OutValue);
+}
+
+/* static */ double FJsonValueLazyNumber::ParseDouble(FStringView Lexeme)
+{
+	return ParseDoubleImpl(Lexeme);
+}
+
+/* static */ double FJsonValueLazyNumber::ParseDouble(FUtf8StringView Lexeme)
+{
+	return ParseDoubleImpl(Lexeme);
+}
+
+FJsonValueLazyString::FJsonValueLazyString(FJsonSourceBufferRef InSource, const int32 InOffset, const int32 InLength, const bool bInHasEscapes)
+	: FJsonValueTagged(&LazyStringKind)
+	, Source(MoveTemp(InSource))
+	, Offset(InOffset)
+	, Length(InLength)
+	, bHasEscapes(bInHasEscapes)
+{
+	Type = EJson::String;
+}
+
+/* static */ const FJsonValueLazyString* FJsonValueLazyString::Cast(const FJsonValue* const Value)
+{
+	if (Value && Value->Type == EJson::String && IsKind(Value, &LazyStringKind))
+	{
+		return static_cast<const FJsonValueLazyString*>(Value);
+	}
+	return nullptr;
+}
+
+bool FJsonValueLazyString::TryGetString(FString& OutString) const
+{
+	OutString.Reset();
+	Source->VisitSlice(Offset, Length, [this, &OutString](const auto Body)
+	{
+		if (bHasEscapes)
+		{
+			AppendUnescaped(Body, OutString);
+		}
+		else
+		{
+			AppendRun(OutString, Body);
+		}
+	});
+	return true;
+}
+
+bool FJsonValueLazyString::TryGetNumber(double& OutNumber) const
+{
+	// Same conversion as FJsonValueString.
+	FString Value;
+	TryGetString(Value);
+
+	if (Value.IsNumeric())
+	{
+		OutNumber = FCString::Atod(*Value);
+		return true;
+	}
+	return false;
+}
+
+bool FJsonValueLazyString::TryGetBool(bool& OutBool) const
+{
+	FString Value;
+	TryGetString(Value);
+
+	OutBool = Value.ToBool();
+	return true;
+}
+
+bool FJsonValueLazyString::TryGetStringView(FStringView& OutView) const
+{
+	if (bHasEscapes || Source->IsUtf8())
+	{
+		return false;
+	}
+
+	OutView = Source->Slice(Offset, Length);
+	return true;
+}
+
+bool FJsonValueLazyString::TryGetUtf8StringView(FUtf8StringView& OutView) const
+{
+	if (bHasEscapes || !Source->IsUtf8())
+	{
+		return false;
+	}
+
+	OutView = Source->SliceUtf8(Offset, Length);
+	return true;
+}
+
+/* static */ void FJsonValueLazyString::AppendUnescaped(FStringView Escaped, FString& OutString)
+{
+	AppendUnescapedImpl(Escaped, OutString);
+}
+
+/* static */ void FJsonValueLazyString::AppendUnescaped(FUtf8StringView Escaped, FString& OutString)
+{
+	AppendUnescapedImpl(Escaped, OutString);
+}
+
+FJsonValueFlatObject::FJsonValueFlatObject()
+	: FJsonValueTagged(&FlatObjectKind)
+	, bMaterialized(false)
+{
+	Type = EJson::Object;
+	FMemory::Memzero(Tags);
+}
+
+/* static */ const FJsonValueFlatObject* FJsonValueFlatObject::Cast(const FJsonValue* const Value)
+{
+	if (Value && Value->Type == EJson::Object && IsKind(Value, &FlatObjectKind))
+	{
+		return static_cast<const FJsonValueFlatObject*>(Value);
+	}
+	return nullptr;
+}
+
+/* static */ uint32 FJsonValueFlatObject::MakeTag(const FStringView FieldName)
+{
+	// Length in the high byte, then the first two characters folded to lower case.
+	const uint32 Length = FMath::Min(FieldName.Len(), 0xFF);
+	const uint32 First  = FieldName.Len() > 0 ? static_cast<uint32>(FChar::ToLower(FieldName[0])) & 0xFFF : 0;
+	const uint32 Second = FieldName.Len() > 1 ? static_cast<uint32>(FChar::ToLower(FieldName[1])) & 0xFFF : 0;
+
+	return (Length << 24) | (First << 12) | Second;
+}
+
+int32 FJsonValueFlatObject::FindFieldIndex(const FStringView FieldName) const
+{
+	const int32 NumFields = Fields.Num();
+	if (NumFields == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const uint32 Tag = MakeTag(FieldName);
+
+	// One bit per field whose tag matches.
+	uint32 Candidates = 0;
+
+	const VectorRegister4Int Needle = VectorIntSet1(static_cast<int32>(Tag));
+	for (int32 Block = 0; Block * 4 < NumFields; ++Block)
+	{
+		const VectorRegister4Int BlockTags = VectorIntLoad(Tags + Block * 4);
+		const uint32 Matches = static_cast<uint32>(VectorMaskBits(VectorCastIntToFloat(VectorIntCompareEQ(BlockTags, Needle))));
+		Candidates |= Matches << (Block * 4);
+	}
+
+	Candidates &= (1u << NumFields) - 1;
+
+	while (Candidates)
+	{
+		const int32 Index = static_cast<int32>(FMath::CountTrailingZeros(Candidates));
+		if (GetFieldName(Fields[Index]).Equals(FieldName, ESearchCase::IgnoreCase))
+		{
+			return Index;
+		}
+		Candidates &= Candidates - 1;
+	}
+
+	return INDEX_NONE;
+}
+
+bool FJsonValueFlatObject::AddField(const FStringView FieldName, const TSharedPtr<FJsonValue>& FieldValue)
+{
+	check(!bMaterialized.load(std::memory_order_relaxed));
+
+	const int32 Existing = FindFieldIndex(FieldName);
+	if (Existing != INDEX_NONE)
+	{
+		Fields[Existing].Value = FieldValue;
+		return true;
+	}
+
+	const int32 Index = Fields.Num();
+	if (Index >= MaxFlatFields)
+	{
+		return false;
+	}
+
+	if (Index == 0)
+	{
+		// Most objects are small, avoid growing the arrays several times.
+		Fields.Reserve(4);
+		NameChars.Reserve(32);
+	}
+
+	Fields.Add({ FieldValue, NameChars.Num(), FieldName.Len() });
+	NameChars.Append(FieldName.GetData(), FieldName.Len());
+	Tags[Index] = MakeTag(FieldName);
+
+	return true;
+}
+
+const FJsonObject* FJsonValueFlatObject::GetMaterializedObject() const
+{
+	return bMaterialized.load(std::memory_order_acquire) ? Materialized.Get() : nullptr;
+}
+
+SIZE_T FJsonValueFlatObject::GetAllocatedSize() const
+{
+	SIZE_T Size = Fields.GetAllocatedSize() + NameChars.GetAllocatedSize();
+
+	if (const FJsonObject* const Object = GetMaterializedObject())
+	{
+		Size += sizeof(FJsonObject) + Object->Values.GetAllocatedSize();
+		for (const auto& Field : Object->Values)
+		{
+			Size += Field.Key.GetAllocatedSize();
+		}
+	}
+
+	return Size;
+}
+
+TSharedPtr<FJsonValue> FJsonValueFlatObject::TryGetField(const FStringView FieldName) const
+{
+	if (const FJsonObject* const Object = GetMaterializedObject())
+	{
+		if (const TSharedPtr<FJsonValue>* const Value = Object->Values.FindByHash(GetTypeHash(FieldName), FieldName))
+		{
+			return *Value;
+		}
+		return nullptr;
+	}
+
+	const int32 Index = FindFieldIndex(FieldName);
+	return Index != INDEX_NONE ? Fields[Index].Value : nullptr;
+}
+
+int32 FJsonValueFlatObject::Num() const
+{
+	if (const FJsonObject* const Object = GetMaterializedObject())
+	{
+		return Object->Values.Num();
+	}
+	return Fields.Num();
+}
+
+bool FJsonValueFlatObject::NextField(int32& Cursor, FStringView& OutFieldName, TSharedPtr<FJsonValue>& OutFieldValue) const
+{
+	// The copy is filled in insertion order so its element ids match our indices,
+	// iterating over it once created continues at the same field.
+	if (const FJsonObject* const Object = GetMaterializedObject())
+	{
+		return NextField(*Object, Cursor, OutFieldName, OutFieldValue);
+	}
+
+	if (!Fields.IsValidIndex(Cursor))
+	{
+		return false;
+	}
+
+	const FField& Field = Fields[Cursor++];
+
+	OutFieldName  = GetFieldName(Field);
+	OutFieldValue = Field.Value;
+
+	return true;
+}
+
+/* static */ bool FJsonValueFlatObject::NextField(const FJsonObject& Object, int32& Cursor, FStringView& OutFieldName, TSharedPtr<FJsonValue>& OutFieldValue)
+{
+	// The map is sparse, skip removed elements.
+	for (const int32 MaxIndex = Object.Values.GetMaxIndex(); Cursor >= 0 && Cursor < MaxIndex; ++Cursor)
+	{
+		const FSetElementId Id = FSetElementId::FromInteger(Cursor);
+		if (Object.Values.IsValidId(Id))
+		{
+			const auto& Pair = Object.Values.Get(Id);
+
+			OutFieldName  = Pair.Key;
+			OutFieldValue = Pair.Value;
+
+			++Cursor;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+TSharedPtr<FJsonObject> FJsonValueFlatObject::ToJsonObject() const
+{
+	TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+
+	Object->Values.Reserve(Num());
+	ForEachField([&Object](const FStringView FieldName, const TSharedPtr<FJsonValue>& FieldValue)
+	{
+		Object->Values.Emplace(FString(FieldName), FieldValue);
+	});
+
+	return Object;
+}
+
+bool FJsonValueFlatObject::TryGetObject(const TSharedPtr<FJsonObject>*& OutObject) const
+{
+	if (!bMaterialized.load(std::memory_order_acquire))
+	{
+		UE::TUniqueLock Lock(MaterializeMutex);
+		if (!bMaterialized.load(std::memory_order_relaxed))
+		{
+			Materialized = ToJsonObject();
+			bMaterialized.store(true, std::memory_order_release);
+		}
+	}
+
+	OutObject = &Materialized;
+	return true;
+}
@@ -2,9 +2,13 @@
 
 #include "BlueprintJsonWrapper.h"
 #include "BlueprintJson.h"
+#include "BlueprintJsonStats.h"
 #include "Dom/JsonValue.h"
 #include "Dom/JsonObject.h"
 #include "BlueprintJsonLibrary.h"
+#include "BlueprintJsonParser.h"
+#include "BlueprintJsonValues.h"
+#include "BlueprintJsonWriter.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
 
@@ -74,11 +78,15 @@ int32 FLightJsonObject::GetFieldAsInt32(const FString& FieldName) const
 
 int64 FLightJsonObject::GetFieldAsInt64(const FString& FieldName) const
 {
-	if (Object && Object->HasTypedField<EJson::Number>(FieldName))
+	int64 Value = 0;
+	if (Object)
 	{
-		return Object->GetNumberField(FieldName);
+		if (const TSharedPtr<FJsonValue> Field = Object->TryGetField(FieldName))
+		{
+			Field->TryGetNumber(Value);
+		}
 	}
-	return {};
+	return Value;
 }
 
 FLightJsonObject FLightJsonObject::GetFieldAsObject(const FString& FieldName) const
@@ -140,13 +148,617 @@ TArray<float> FLightJsonObject::GetFieldAsFloatArray(const FString& FieldName) c
 	return Result;
 }
 
+TArray<int32> FLightJsonObject::GetFieldAsInt32Array(const FString& FieldName) const
+{
+	TArray<int32> Result;
+
+	const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+	if (Object && Object->TryGetArrayField(FieldName, Values))
+	{
+		Result.Reserve(Values->Num());
+
+		for (const TSharedPtr<FJsonValue>& Value : *Values)
+		{
+			int32 Number = 0;
+			if (!Value->TryGetNumber(Number))
+			{
+				UE_LOG(LogBlueprintJson, Warning, TEXT("failed to convert a JSON value to Number while converting a field as JSON int32 Array."));
+				continue;
+			}
+			Result.Emplace(Number);
+		}
+	}
+
+	return Result;
+}
+
+TArray<FString> FLightJsonObject::GetFieldAsStringArray(const FString& FieldName) const
+{
+	TArray<FString> Result;
+
+	const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+	if (Object && Object->TryGetArrayField(FieldName, Values))
+	{
+		Result.Reserve(Values->Num());
+
+		for (const TSharedPtr<FJsonValue>& Value : *Values)
+		{
+			FString String;
+			if (!Value->TryGetString(String))
+			{
+				UE_LOG(LogBlueprintJson, Warning, TEXT("failed to convert a JSON value to String while converting a field as JSON String Array."));
+				continue;
+			}
+			Result.Emplace(MoveTemp(String));
+		}
+	}
+
+	return Result;
+}
+
+TArray<FLightJsonValue> FLightJsonObject::GetFieldAsArray(const FString& FieldName) const
+{
+	TArray<FLightJsonValue> Result;
+
+	const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+	if (Object && Object->TryGetArrayField(FieldName, Values))
+	{
+		Result.Reserve(Values->Num());
+
+		for (const TSharedPtr<FJsonValue>& Value : *Values)
+		{
+			Result.Emplace(Value);
+		}
+	}
+
+	return Result;
+}
+
+bool FLightJsonObject::GetFieldAsBoolean(const FString& FieldName) const
+{
+	bool bValue = false;
+	if (Object)
+	{
+		Object->TryGetBoolField(FieldName, bValue);
+	}
+	return bValue;
+}
+
+FVector FLightJsonObject::GetFieldAsVector(const FString& FieldName) const
+{
+	FVector Value = FVector::ZeroVector;
+	if (Object)
+	{
+		UJsonValue::ReadRawJsonValue(Object->TryGetField(FieldName), Value);
+	}
+	return Value;
+}
+
+FLightJsonValue FLightJsonObject::GetFieldAsValue(const FString& FieldName) const
+{
+	if (Object)
+	{
+		return Object->TryGetField(FieldName);
+	}
+	return {};
+}
+
+FLightJsonValue FLightJsonObject::GetValueAtPath(const FString& Path) const
+{
+	TSharedPtr<FJsonValue> Value;
+	FStringView Remaining(Path);
+
+	while (!Remaining.IsEmpty())
+	{
+		int32 NameLength = 0;
+		while (NameLength < Remaining.Len() && Remaining[NameLength] != TEXT('.') && Remaining[NameLength] != TEXT('['))
+		{
+			++NameLength;
+		}
+
+		if (NameLength > 0)
+		{
+			// The first name is a field of this object, the next ones of the value reached so far.
+			const TSharedPtr<FJsonObject>* Parent = &Object;
+			if ((Value && !Value->TryGetObject(Parent)) || !Parent->IsValid())
+			{
+				return {};
+			}
+
+			Value = (*Parent)->TryGetField(FString(Remaining.Left(NameLength)));
+			if (!Value)
+			{
+				return {};
+			}
+			Remaining.RightChopInline(NameLength);
+		}
+
+		if (Remaining.StartsWith(TEXT('[')))
+		{
+			int32 Close = INDEX_NONE;
+			if (!Remaining.FindChar(TEXT(']'), Close))
+			{
+				return {};
+			}
+
+			const FString IndexString(Remaining.Mid(1, Close - 1));
+			const int32 Index = FCString::Atoi(*IndexString);
+
+			const TArray<TSharedPtr<FJsonValue>>* Elements = nullptr;
+			if (!IndexString.IsNumeric() || !Value || !Value->TryGetArray(Elements) || !Elements->IsValidIndex(Index))
+			{
+				return {};
+			}
+
+			Value = (*Elements)[Index];
+			Remaining.RightChopInline(Close + 1);
+		}
+		else if (Remaining.StartsWith(TEXT('.')))
+		{
+			Remaining.RightChopInline(1);
+		}
+	}
+
+	return Value;
+}
+
+bool FLightJsonObject::HasField(const FString& FieldName) const
+{
+	return Object && Object->HasField(FieldName);
+}
+
+bool FLightJsonObject::IsFieldNull(const FString& FieldName) const
+{
+	const TSharedPtr<FJsonValue> Value = Object ? Object->TryGetField(FieldName) : nullptr;
+	return !Value || Value->IsNull();
+}
+
+int32 FLightJsonObject::Num() const
+{
+	return Object ? Object->Values.Num() : 0;
+}
+
+TArray<FString> FLightJsonObject::GetFieldNames() const
+{
+	TArray<FString> Names;
+	if (Object)
+	{
+		Object->Values.GenerateKeyArray(Names);
+	}
+	return Names;
+}
+
+bool FLightJsonObject::NextField(int32& Cursor, FString& OutFieldName, FLightJsonValue& OutFieldValue) const
+{
+	FStringView FieldName;
+	TSharedPtr<FJsonValue> FieldValue;
+
+	if (!Object || !FJsonValueFlatObject::NextField(*Object, Cursor, FieldName, FieldValue))
+	{
+		return false;
+	}
+
+	// Keeps the buffer of the previous name.
+	OutFieldName.Reset(FieldName.Len());
+	OutFieldName.Append(FieldName);
+
+	OutFieldValue = FLightJsonValue(MoveTemp(FieldValue));
+	return true;
+}
+
+/* static */ FLightJsonObject FLightJsonObject::Create()
+{
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	return FLightJsonObject(MakeShared<FJsonObject>());
+}
+
+/* static */ FLightJsonObject FLightJsonObject::Parse(FString&& Json, const EJsonParseOptions Options, FString* const OutError)
+{
+	BLUEPRINTJSON_SCOPE(ParseJson);
+
+	return FBlueprintJsonParser::ParseObject(MoveTemp(Json), Options, OutError);
+}
+
+bool FLightJsonObject::ToString(FString& OutJsonString) const
+{
+	return Object && UJsonLibrary::StringifyJsonObject(Object, OutJsonString);
+}
+
+void FLightJsonObject::SetRawField(const FString& FieldName, const TSharedPtr<FJsonValue>& FieldValue)
+{
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	if (!Object)
+	{
+		Object = MakeShared<FJsonObject>();
+	}
+	Object->SetField(FieldName, FieldValue);
+}
+
+void FLightJsonObject::SetStringField(const FString& FieldName, const FString& FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::CreateRawJsonValue(FieldValue));
+}
+
+void FLightJsonObject::SetIntegerField(const FString& FieldName, const int32 FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::CreateRawJsonValue(FieldValue));
+}
+
+void FLightJsonObject::SetInteger64Field(const FString& FieldName, const int64 FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::MakeInteger64Value(FieldValue));
+}
+
+void FLightJsonObject::SetFloatField(const FString& FieldName, const float FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::CreateRawJsonValue(FieldValue));
+}
+
+void FLightJsonObject::SetBooleanField(const FString& FieldName, const bool FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::CreateRawJsonValue(FieldValue));
+}
+
+void FLightJsonObject::SetObjectField(const FString& FieldName, const FLightJsonObject& FieldValue)
+{
+	if (!FieldValue.Object)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Invalid object passed to SetObjectField."));
+		return;
+	}
+	SetRawField(FieldName, MakeShared<FJsonValueObject>(FieldValue.Object));
+}
+
+void FLightJsonObject::SetArrayField(const FString& FieldName, const TArray<FLightJsonValue>& FieldValue)
+{
+	SetRawField(FieldName, FLightJsonValue::MakeArray(FieldValue).GetRawValue());
+}
+
+void FLightJsonObject::SetField(const FString& FieldName, const FLightJsonValue& FieldValue)
+{
+	if (!FieldValue.IsValid())
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Invalid value passed to SetField."));
+		return;
+	}
+	SetRawField(FieldName, FieldValue.GetRawValue());
+}
+
+void FLightJsonObject::SetNullField(const FString& FieldName)
+{
+	SetRawField(FieldName, MakeShared<FJsonValueNull>());
+}
+
+void FLightJsonObject::SetVectorField(const FString& FieldName, const FVector& FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::CreateRawJsonValue(FieldValue));
+}
+
+void FLightJsonObject::SetVector2DField(const FString& FieldName, const FVector2D& FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::CreateRawJsonValue(FieldValue));
+}
+
+void FLightJsonObject::SetRotatorField(const FString& FieldName, const FRotator& FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::CreateRawJsonValue(FieldValue));
+}
+
+void FLightJsonObject::SetTransformField(const FString& FieldName, const FTransform& FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::CreateRawJsonValue(FieldValue));
+}
+
+void FLightJsonObject::SetLinearColorField(const FString& FieldName, const FLinearColor& FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::CreateRawJsonValue(FieldValue));
+}
+
+void FLightJsonObject::SetColorField(const FString& FieldName, const FColor& FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::CreateRawJsonValue(FieldValue));
+}
+
+void FLightJsonObject::SetQuatField(const FString& FieldName, const FQuat& FieldValue)
+{
+	SetRawField(FieldName, UJsonValue::CreateRawJsonValue(FieldValue));
+}
+
+bool FLightJsonObject::RemoveField(const FString& FieldName)
+{
+	return Object && Object->Values.Remove(FieldName) > 0;
+}
+
+FLightJsonValue::FLightJsonValue(TSharedPtr<FJsonValue> InValue)
+	: Value(MoveTemp(InValue))
+{}
+
+/* static */ FLightJsonValue FLightJsonValue::MakeString(const FString& Value)
+{
+	return UJsonValue::CreateRawJsonValue(Value);
+}
+
+/* static */ FLightJsonValue FLightJsonValue::MakeFloat(const float Value)
+{
+	return UJsonValue::CreateRawJsonValue(Value);
+}
+
+/* static */ FLightJsonValue FLightJsonValue::MakeInteger64(const int64 Value)
+{
+	return UJsonValue::MakeInteger64Value(Value);
+}
+
+/* static */ FLightJsonValue FLightJsonValue::MakeBoolean(const bool Value)
+{
+	return UJsonValue::CreateRawJsonValue(Value);
+}
+
+/* static */ FLightJsonValue FLightJsonValue::MakeObject(const FLightJsonObject& Value)
+{
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	return FLightJsonValue(MakeShared<FJsonValueObject>(Value.IsValid() ? Value.GetRawObject() : TSharedPtr<FJsonObject>(MakeShared<FJsonObject>())));
+}
+
+/* static */ FLightJsonValue FLightJsonValue::MakeArray(const TArray<FLightJsonValue>& Values)
+{
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	TArray<TSharedPtr<FJsonValue>> Elements;
+	Elements.Reserve(Values.Num());
+	for (const FLightJsonValue& Element : Values)
+	{
+		if (Element.IsValid())
+		{
+			Elements.Emplace(Element.Value);
+		}
+		else
+		{
+			Elements.Emplace(MakeShared<FJsonValueNull>());
+		}
+	}
+
+	return FLightJsonValue(MakeShared<FJsonValueArray>(MoveTemp(Elements)));
+}
+
+/* static */ FLightJsonValue FLightJsonValue::MakeNull()
+{
+	return FLightJsonValue(MakeShared<FJsonValueNull>());
+}
+
+bool FLightJsonValue::IsNull() const
+{
+	return !Value || Value->IsNull();
+}
+
+EJsonType FLightJsonValue::GetType() const
+{
+	if (!Value)
+	{
+		return EJsonType::Null;
+	}
+
+	switch (Value->Type)
+	{
+	case EJson::String:  return EJsonType::String;
+	case EJson::Number:  return EJsonType::Number;
+	case EJson::Boolean: return EJsonType::Boolean;
+	case EJson::Array:   return EJsonType::Array;
+	case EJson::Object:  return EJsonType::Object;
+	default:             return EJsonType::Null;
+	}
+}
+
+FString FLightJsonValue::AsString() const
+{
+	FString String;
+	if (Value && !Value->TryGetString(String))
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get String from JsonValue but the real type is %s."), *UJsonValue::JsonTypeToString(Value->Type));
+	}
+	return String;
+}
+
+float FLightJsonValue::AsFloat() const
+{
+	double Number = 0.;
+	if (Value && !Value->TryGetNumber(Number))
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get Number from JsonValue but the real type is %s."), *UJsonValue::JsonTypeToString(Value->Type));
+	}
+	return static_cast<float>(Number);
+}
+
+int32 FLightJsonValue::AsInt32() const
+{
+	int32 Number = 0;
+	if (Value && !Value->TryGetNumber(Number))
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get Number from JsonValue but the real type is %s."), *UJsonValue::JsonTypeToString(Value->Type));
+	}
+	return Number;
+}
+
+int64 FLightJsonValue::AsInt64() const
+{
+	int64 Number = 0;
+	if (Value && !Value->TryGetNumber(Number))
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get Number from JsonValue but the real type is %s."), *UJsonValue::JsonTypeToString(Value->Type));
+	}
+	return Number;
+}
+
+bool FLightJsonValue::AsBool() const
+{
+	bool bBool = false;
+	if (Value && !Value->TryGetBool(bBool))
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get Boolean from JsonValue but the real type is %s."), *UJsonValue::JsonTypeToString(Value->Type));
+	}
+	return bBool;
+}
+
+FLightJsonObject FLightJsonValue::AsObject() const
+{
+	const TSharedPtr<FJsonObject>* Object = nullptr;
+	if (Value && Value->TryGetObject(Object))
+	{
+		return *Object;
+	}
+
+	if (Value)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get Object from JsonValue but the real type is %s."), *UJsonValue::JsonTypeToString(Value->Type));
+	}
+	return {};
+}
+
+TArray<FLightJsonValue> FLightJsonValue::AsArray() const
+{
+	TArray<FLightJsonValue> Elements;
+
+	const TArray<TSharedPtr<FJsonValue>>* Array = nullptr;
+	if (Value && Value->TryGetArray(Array))
+	{
+		Elements.Reserve(Array->Num());
+		for (const TSharedPtr<FJsonValue>& Element : *Array)
+		{
+			Elements.Emplace(Element);
+		}
+	}
+	else if (Value)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Tried to get Array from JsonValue but the real type is %s."), *UJsonValue::JsonTypeToString(Value->Type));
+	}
+
+	return Elements;
+}
+
+bool FLightJsonValue::ToString(FString& OutJsonString) const
+{
+	if (!Value)
+	{
+		return false;
+	}
+
+	BLUEPRINTJSON_SCOPE(Stringify);
+
+	TSharedRef< TJsonWriter<> > Writer = TJsonWriterFactory<>::Create(&OutJsonString);
+	const bool bSuccess = FBlueprintJsonWriter::Serialize(Value, Writer);
+
+	BLUEPRINTJSON_INC_STAT_BY(BytesWritten, OutJsonString.Len());
+
+	return bSuccess;
+}
+
 FLightJsonObject::FLightJsonObject(TSharedPtr<FJsonObject> InObject)
 	: Object(MoveTemp(InObject))
 {
 }
 
+static int32 GJsonMathEncoding = 0;
+static FAutoConsoleVariableRef CVarJsonMathEncoding(
+	TEXT("BlueprintJson.MathEncoding"),
+	GJsonMathEncoding,
+	TEXT("Default encoding of vectors, rotators, quaternions, colors and transforms written to JSON.\n")
+	TEXT("0: objects with named fields (default).\n")
+	TEXT("1: arrays of numbers, transforms as [tx,ty,tz,qx,qy,qz,qw,sx,sy,sz]."));
+
+namespace
+{
+	TSharedPtr<FJsonValue> MakeNumberArray(std::initializer_list<double> Numbers)
+	{
+		TArray<TSharedPtr<FJsonValue>> Values;
+		Values.Reserve(Numbers.size());
+		for (const double Number : Numbers)
+		{
+			Values.Emplace(MakeShared<FJsonValueNumber>(Number));
+		}
+		return MakeShared<FJsonValueArray>(MoveTemp(Values));
+	}
+
+	/* Math types only have a few fields, they're stored flat like the small objects of a document parsed with FlatObjects. */
+	TSharedPtr<FJsonValue> MakeNumberObject(std::initializer_list<const TCHAR*> Names, std::initializer_list<double> Numbers)
+	{
+		check(Names.size() == Numbers.size());
+
+		const TSharedRef<FJsonValueFlatObject> Object = MakeShared<FJsonValueFlatObject>();
+
+		const TCHAR* const* Name = Names.begin();
+		for (const double Number : Numbers)
+		{
+			Object->AddField(*Name++, MakeShared<FJsonValueNumber>(Number));
+		}
+		return Object;
+	}
+
+	/* Returns a field of an object value, without creating the FJsonObject copy of a flat object. Null if it's not an object. */
+	TSharedPtr<FJsonValue> TryGetObjectField(const FJsonValue& Value, const TCHAR* const Name)
+	{
+		if (const FJsonValueFlatObject* const FlatObject = FJsonValueFlatObject::Cast(&Value))
+		{
+			return FlatObject->TryGetField(Name);
+		}
+
+		const TSharedPtr<FJsonObject>* Object = nullptr;
+		return Value.TryGetObject(Object) ? (*Object)->TryGetField(Name) : nullptr;
+	}
+
+	/**
+	 *  Reads the components of a math type either from an array, in order, or from
+	 *  the named fields of an object. Missing object fields keep their value. Types
+	 *  only written as arrays pass no names.
+	 **/
+	bool ReadComponents(const TSharedPtr<FJsonValue>& Value, std::initializer_list<const TCHAR*> Names, std::initializer_list<double*> Components)
+	{
+		if (!Value)
+		{
+			return false;
+		}
+
+		if (Value->Type == EJson::Array)
+		{
+			const TArray<TSharedPtr<FJsonValue>>& Values = Value->AsArray();
+			if (Values.Num() < static_cast<int32>(Components.size()))
+			{
+				return false;
+			}
+
+			int32 Index = 0;
+			for (double* const Component : Components)
+			{
+				if (!Values[Index++]->TryGetNumber(*Component))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		if (Names.size() != Components.size() || Value->Type != EJson::Object)
+		{
+			return false;
+		}
+
+		const TCHAR* const* Name = Names.begin();
+		for (double* const Component : Components)
+		{
+			if (const TSharedPtr<FJsonValue> Field = TryGetObjectField(*Value, *Name++))
+			{
+				Field->TryGetNumber(*Component);
+			}
+		}
+		return true;
+	}
+}
+
 /* static */ UJsonValue* UJsonValue::CreateFromRaw(TSharedPtr<FJsonValue> RawValue)
 {
+	BLUEPRINTJSON_SCOPE(CreateValue);
+
 	if (RawValue)
 	{
 		UJsonValue* const Value = NewObject < UJsonValue > ();
@@ -158,25 +770,25 @@ FLightJsonObject::FLightJsonObject(TSharedPtr<FJsonObject> InObject)
 	return nullptr;
 }
 
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const int32 Value)
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const int32 Value)
 {
-    return CreateFromRaw(MakeShared<FJsonValueNumber>(Value));
+    return MakeShared<FJsonValueNumber>(Value);
 }
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const int64 Value)
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const int64 Value)
 {
-    return CreateFromRaw(MakeShared<FJsonValueNumber>(Value));
+    return MakeInteger64Value(Value);
 }
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const float Value)
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const float Value)
 {
-    return CreateFromRaw(MakeShared<FJsonValueNumber>(Value));
+    return MakeShared<FJsonValueNumber>(Value);
 }
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const bool Value)
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const bool Value)
 {
-    return CreateFromRaw(MakeShared<FJsonValueBoolean>(Value));
+    return MakeShared<FJsonValueBoolean>(Value);
 }
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const FString& Value)
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const FString& Value)
 {
-    return CreateFromRaw(MakeShared<FJsonValueString>(Value));
+    return MakeShared<FJsonValueString>(Value);
 }
 /* static */ UJsonValue* UJsonValue::CreateJsonValue(UObject* const       Value)
 {
@@ -190,124 +802,211 @@ FLightJsonObject::FLightJsonObject(TSharedPtr<FJsonObject> InObject)
 	}
 	if (UJsonObject* const JsonObject = Cast<UJsonObject>(Value))
 	{
-		return CreateFromRaw(MakeShared<FJsonValueObject>(JsonObject->GetRawObject()));
+		return CreateFromRaw(JsonObject->GetRawValue());
 	}
 
 	UE_LOG(LogBlueprintJson, Warning, TEXT("Object %s is not supported as JsonValue."), *Value->GetName());
 	
 	return nullptr;
 }
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const FVector& Value)
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(UObject* const Value)
 {
-	TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
-
-	Object->SetNumberField(TEXT("X"), Value.X);
-	Object->SetNumberField(TEXT("Y"), Value.Y);
-	Object->SetNumberField(TEXT("Z"), Value.Z);
-
-	return UJsonValue::CreateFromRaw(MakeShared<FJsonValueObject>(Object));
+	if (UJsonValue* const JsonValue = Cast<UJsonValue>(Value))
+	{
+		return JsonValue->GetRawValue();
+	}
+	if (UJsonObject* const JsonObject = Cast<UJsonObject>(Value))
+	{
+		return JsonObject->GetRawValue();
+	}
+	if (Value)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Object %s is not supported as JsonValue."), *Value->GetName());
+	}
+	return nullptr;
 }
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const FVector2D& Value)
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const FVector& Value, const EJsonMathEncoding Encoding)
 {
-	TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
-
-	Object->SetNumberField(TEXT("X"), Value.X);
-	Object->SetNumberField(TEXT("Y"), Value.Y);
+	if (Encoding == EJsonMathEncoding::Array)
+	{
+		return MakeNumberArray({ Value.X, Value.Y, Value.Z });
+	}
 
-	return UJsonValue::CreateFromRaw(MakeShared<FJsonValueObject>(Object));
+	return MakeNumberObject({ TEXT("X"), TEXT("Y"), TEXT("Z") }, { Value.X, Value.Y, Value.Z });
 }
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const FRotator&	Value)
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const FVector2D& Value, const EJsonMathEncoding Encoding)
 {
-	TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+	if (Encoding == EJsonMathEncoding::Array)
+	{
+		return MakeNumberArray({ Value.X, Value.Y });
+	}
 
-	Object->SetNumberField(TEXT("Pitch"),	Value.Pitch);
-	Object->SetNumberField(TEXT("Yaw"),		Value.Yaw);
-	Object->SetNumberField(TEXT("Roll"),	Value.Roll);
+	return MakeNumberObject({ TEXT("X"), TEXT("Y") }, { Value.X, Value.Y });
+}
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const FRotator&	Value, const EJsonMathEncoding Encoding)
+{
+	if (Encoding == EJsonMathEncoding::Array)
+	{
+		return MakeNumberArray({ Value.Pitch, Value.Yaw, Value.Roll });
+	}
 
-	return UJsonValue::CreateFromRaw(MakeShared<FJsonValueObject>(Object));
+	return MakeNumberObject({ TEXT("Pitch"), TEXT("Yaw"), TEXT("Roll") }, { Value.Pitch, Value.Yaw, Value.Roll });
 }
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const FTransform&	Value)
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const FTransform&	Value, const EJsonMathEncoding Encoding)
 {
-	// We don't pass through UJsonObject to reduce the overhead.
-	// Even though it's pretty small.
+	if (Encoding == EJsonMathEncoding::Array)
+	{
+		const FVector Location = Value.GetLocation();
+		const FQuat   Rotation = Value.GetRotation();
+		const FVector Scale    = Value.GetScale3D();
 
-	TSharedPtr<FJsonObject> LocObject = MakeShared<FJsonObject>();
-	TSharedPtr<FJsonObject> RotObject = MakeShared<FJsonObject>();
-	TSharedPtr<FJsonObject> ScaObject = MakeShared<FJsonObject>();
-	TSharedPtr<FJsonObject> TraObject = MakeShared<FJsonObject>();
+		return MakeNumberArray({ Location.X, Location.Y, Location.Z, Rotation.X, Rotation.Y, Rotation.Z, Rotation.W, Scale.X, Scale.Y, Scale.Z });
+	}
 
-	LocObject->SetNumberField(TEXT("X"), Value.GetLocation().X);
-	LocObject->SetNumberField(TEXT("Y"), Value.GetLocation().Y);
-	LocObject->SetNumberField(TEXT("Z"), Value.GetLocation().Z);
+	const TSharedRef<FJsonValueFlatObject> TraObject = MakeShared<FJsonValueFlatObject>();
 
-	ScaObject->SetNumberField(TEXT("X"), Value.GetScale3D().X);
-	ScaObject->SetNumberField(TEXT("Y"), Value.GetScale3D().Y);
-	ScaObject->SetNumberField(TEXT("Z"), Value.GetScale3D().Z);
+	TraObject->AddField(TEXT("Location"), CreateRawJsonValue(Value.GetLocation(), Encoding));
+	TraObject->AddField(TEXT("Scale3D"),  CreateRawJsonValue(Value.GetScale3D(),  Encoding));
+	TraObject->AddField(TEXT("Rotation"), CreateRawJsonValue(Value.Rotator(),     Encoding));
 
-	RotObject->SetNumberField(TEXT("Pitch"), Value.Rotator().Pitch);
-	RotObject->SetNumberField(TEXT("Yaw"),	 Value.Rotator().Yaw);
-	RotObject->SetNumberField(TEXT("Roll"),	 Value.Rotator().Roll);
+	return TraObject;
+}
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const FLinearColor&Value, const EJsonMathEncoding Encoding)
+{
+	if (Encoding == EJsonMathEncoding::Array)
+	{
+		return MakeNumberArray({ Value.R, Value.G, Value.B, Value.A });
+	}
 
-	TraObject->SetObjectField(TEXT("Location"), LocObject);
-	TraObject->SetObjectField(TEXT("Scale3D"),	ScaObject);
-	TraObject->SetObjectField(TEXT("Rotation"), RotObject);
+	return MakeNumberObject({ TEXT("R"), TEXT("G"), TEXT("B"), TEXT("A") }, { Value.R, Value.G, Value.B, Value.A });
+}
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const FColor&		Value, const EJsonMathEncoding Encoding)
+{
+	if (Encoding == EJsonMathEncoding::Array)
+	{
+		return MakeNumberArray({ static_cast<double>(Value.R), static_cast<double>(Value.G), static_cast<double>(Value.B), static_cast<double>(Value.A) });
+	}
 
-	return UJsonValue::CreateFromRaw(MakeShared<FJsonValueObject>(TraObject)); 
+	return MakeNumberObject({ TEXT("R"), TEXT("G"), TEXT("B"), TEXT("A") }, { static_cast<double>(Value.R), static_cast<double>(Value.G), static_cast<double>(Value.B), static_cast<double>(Value.A) });
 }
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const FLinearColor&Value)
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const FQuat&		Value, const EJsonMathEncoding Encoding)
 {
-	TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+	if (Encoding == EJsonMathEncoding::Array)
+	{
+		return MakeNumberArray({ Value.X, Value.Y, Value.Z, Value.W });
+	}
 
-	Object->SetNumberField(TEXT("R"), Value.R);
-	Object->SetNumberField(TEXT("G"), Value.G);
-	Object->SetNumberField(TEXT("B"), Value.B);
-	Object->SetNumberField(TEXT("A"), Value.A);
+	return MakeNumberObject({ TEXT("W"), TEXT("X"), TEXT("Y"), TEXT("Z") }, { Value.W, Value.X, Value.Y, Value.Z });
+}
 
-	return UJsonValue::CreateFromRaw(MakeShared<FJsonValueObject>(Object)); 
+/* static */ bool UJsonValue::ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FVector& OutValue)
+{
+	return ReadComponents(Value, { TEXT("X"), TEXT("Y"), TEXT("Z") }, { &OutValue.X, &OutValue.Y, &OutValue.Z });
+}
+/* static */ bool UJsonValue::ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FVector2D& OutValue)
+{
+	return ReadComponents(Value, { TEXT("X"), TEXT("Y") }, { &OutValue.X, &OutValue.Y });
+}
+/* static */ bool UJsonValue::ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FRotator& OutValue)
+{
+	return ReadComponents(Value, { TEXT("Pitch"), TEXT("Yaw"), TEXT("Roll") }, { &OutValue.Pitch, &OutValue.Yaw, &OutValue.Roll });
+}
+/* static */ bool UJsonValue::ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FQuat& OutValue)
+{
+	return ReadComponents(Value, { TEXT("X"), TEXT("Y"), TEXT("Z"), TEXT("W") }, { &OutValue.X, &OutValue.Y, &OutValue.Z, &OutValue.W });
+}
+/* static */ bool UJsonValue::ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FLinearColor& OutValue)
+{
+	double R = OutValue.R, G = OutValue.G, B = OutValue.B, A = OutValue.A;
+	if (!ReadComponents(Value, { TEXT("R"), TEXT("G"), TEXT("B"), TEXT("A") }, { &R, &G, &B, &A }))
+	{
+		return false;
+	}
+	OutValue = FLinearColor(static_cast<float>(R), static_cast<float>(G), static_cast<float>(B), static_cast<float>(A));
+	return true;
 }
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const FColor&		Value)
+/* static */ bool UJsonValue::ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FColor& OutValue)
 {
+	double R = OutValue.R, G = OutValue.G, B = OutValue.B, A = OutValue.A;
+	if (!ReadComponents(Value, { TEXT("R"), TEXT("G"), TEXT("B"), TEXT("A") }, { &R, &G, &B, &A }))
+	{
+		return false;
+	}
+	const auto ToChannel = [](const double Channel) { return static_cast<uint8>(FMath::Clamp(FMath::RoundToInt32(Channel), 0, 255)); };
+	OutValue = FColor(ToChannel(R), ToChannel(G), ToChannel(B), ToChannel(A));
+	return true;
+}
+/* static */ bool UJsonValue::ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FTransform& OutValue)
+{
+	if (!Value)
+	{
+		return false;
+	}
 
-	TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+	if (Value->Type == EJson::Array)
+	{
+		FVector Location = FVector::ZeroVector;
+		FVector Scale    = FVector::OneVector;
+		FQuat   Rotation = FQuat::Identity;
+		if (!ReadComponents(Value,
+			{},
+			{ &Location.X, &Location.Y, &Location.Z, &Rotation.X, &Rotation.Y, &Rotation.Z, &Rotation.W, &Scale.X, &Scale.Y, &Scale.Z }))
+		{
+			return false;
+		}
+		OutValue = FTransform(Rotation, Location, Scale);
+		return true;
+	}
+
+	if (Value->Type != EJson::Object)
+	{
+		return false;
+	}
+
+	// Each part can itself be written in either encoding.
+	FVector Location = OutValue.GetLocation();
+	FVector Scale    = OutValue.GetScale3D();
+	FRotator Rotation = OutValue.Rotator();
 
-	Object->SetNumberField(TEXT("R"), Value.R);
-	Object->SetNumberField(TEXT("G"), Value.G);
-	Object->SetNumberField(TEXT("B"), Value.B);
-	Object->SetNumberField(TEXT("A"), Value.A);
+	ReadRawJsonValue(TryGetObjectField(*Value, TEXT("Location")), Location);
+	ReadRawJsonValue(TryGetObjectField(*Value, TEXT("Scale3D")),  Scale);
+	ReadRawJsonValue(TryGetObjectField(*Value, TEXT("Rotation")), Rotation);
 
-	return UJsonValue::CreateFromRaw(MakeShared<FJsonValueObject>(Object)); 
+	OutValue = FTransform(Rotation, Location, Scale);
+	return true;
 }
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const FQuat&		Value)
-{
-	TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
 
-	Object->SetNumberField(TEXT("W"), Value.W);
-	Object->SetNumberField(TEXT("X"), Value.X);
-	Object->SetNumberField(TEXT("Y"), Value.Y);
-	Object->SetNumberField(TEXT("Z"), Value.Z);
+/* static */ EJsonMathEncoding UJsonValue::GetMathEncoding()
+{
+	return GJsonMathEncoding == 1 ? EJsonMathEncoding::Array : EJsonMathEncoding::Object;
+}
 
-	return UJsonValue::CreateFromRaw(MakeShared<FJsonValueObject>(Object)); 
+/* static */ void UJsonValue::SetMathEncoding(const EJsonMathEncoding Encoding)
+{
+	GJsonMathEncoding = Encoding == EJsonMathEncoding::Array ? 1 : 0;
 }
 
-/* static */ UJsonValue* UJsonValue::CreateJsonValue(const FHitResult& Value)
+/* static */ TSharedPtr<FJsonValue> UJsonValue::CreateRawJsonValue(const FHitResult& Value, const EJsonMathEncoding Encoding)
 {
-	UJsonObject* const Object = UJsonObject::CreateJsonObject();
+	TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
 
-	Object->SetField(TEXT("BlockingHit"),	CreateJsonValue(Value.bBlockingHit));
-	Object->SetField(TEXT("Time"),			CreateJsonValue(Value.Time));
-	Object->SetField(TEXT("Distance"),		CreateJsonValue(Value.Distance));
-	Object->SetField(TEXT("Location"),		CreateJsonValue(Value.Location));
-	Object->SetField(TEXT("ImpactPoint"),	CreateJsonValue(Value.ImpactPoint));
-	Object->SetField(TEXT("Normal"),		CreateJsonValue(Value.Normal));
-	Object->SetField(TEXT("ImpactNormal"),	CreateJsonValue(Value.ImpactNormal));
-	Object->SetField(TEXT("BoneName"),		CreateJsonValue(Value.BoneName.ToString()));
-	Object->SetField(TEXT("FaceIndex"),		CreateJsonValue(Value.FaceIndex));
-	Object->SetField(TEXT("TraceStart"),	CreateJsonValue(Value.TraceStart));
-	Object->SetField(TEXT("TraceEnd"),		CreateJsonValue(Value.TraceEnd));
+	Object->Values.Reserve(11);
+	Object->SetField(TEXT("BlockingHit"),	CreateRawJsonValue(Value.bBlockingHit));
+	Object->SetField(TEXT("Time"),			CreateRawJsonValue(Value.Time));
+	Object->SetField(TEXT("Distance"),		CreateRawJsonValue(Value.Distance));
+	Object->SetField(TEXT("Location"),		CreateRawJsonValue(Value.Location, Encoding));
+	Object->SetField(TEXT("ImpactPoint"),	CreateRawJsonValue(Value.ImpactPoint, Encoding));
+	Object->SetField(TEXT("Normal"),		CreateRawJsonValue(Value.Normal, Encoding));
+	Object->SetField(TEXT("ImpactNormal"),	CreateRawJsonValue(Value.ImpactNormal, Encoding));
+	Object->SetField(TEXT("BoneName"),		CreateRawJsonValue(Value.BoneName.ToString()));
+	Object->SetField(TEXT("FaceIndex"),		CreateRawJsonValue(Value.FaceIndex));
+	Object->SetField(TEXT("TraceStart"),	CreateRawJsonValue(Value.TraceStart, Encoding));
+	Object->SetField(TEXT("TraceEnd"),		CreateRawJsonValue(Value.TraceEnd, Encoding));
 
-	return UJsonValue::CreateJsonValue(Object);
+	return MakeShared<FJsonValueObject>(Object);
 }
 
+
 FString UJsonValue::GetStringType() const
 {
 	return JsonTypeToString(Value->Type);
@@ -356,11 +1055,71 @@ void UJsonValue::SwitchValueType(EJsonType& Branches)
 }
 
 UJsonObject::UJsonObject() : Super()
-	, Object(MakeShared<FJsonObject>())
-{}
+{
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	Object = MakeShared<FJsonObject>();
+
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		FBlueprintJsonCounters::NumWrappersCreated.fetch_add(1, std::memory_order_relaxed);
+		BLUEPRINTJSON_INC_STAT_BY(LiveObjects, 1);
+	}
+}
+
+void UJsonObject::BeginDestroy()
+{
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		BLUEPRINTJSON_DEC_STAT(LiveObjects);
+	}
+	Super::BeginDestroy();
+}
+
+UJsonValue::UJsonValue() : Super()
+{
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		FBlueprintJsonCounters::NumWrappersCreated.fetch_add(1, std::memory_order_relaxed);
+		BLUEPRINTJSON_INC_STAT_BY(LiveValues, 1);
+	}
+}
+
+void UJsonValue::BeginDestroy()
+{
+	if (!HasAnyFlags(RF_ClassDefaultObject))
+	{
+		BLUEPRINTJSON_DEC_STAT(LiveValues);
+	}
+	Super::BeginDestroy();
+}
+
+/* static */ TSharedPtr<FJsonValue> UJsonValue::MakeInteger64Value(const int64 Value)
+{
+	// Doubles can't represent every integer above 2^53.
+	constexpr int64 MaxExactInteger = 1ll << 53;
+	if (Value > MaxExactInteger || Value < -MaxExactInteger)
+	{
+		return MakeShared<FJsonValueNumberString>(LexToString(Value));
+	}
+	return MakeShared<FJsonValueNumber>(static_cast<double>(Value));
+}
+
+/* static */ TSharedPtr<FJsonValue> UJsonValue::MakeUInteger64Value(const uint64 Value)
+{
+	constexpr uint64 MaxExactInteger = 1ull << 53;
+	if (Value > MaxExactInteger)
+	{
+		return MakeShared<FJsonValueNumberString>(LexToString(Value));
+	}
+	return MakeShared<FJsonValueNumber>(static_cast<double>(Value));
+}
 
 /* static */ TSharedPtr<FJsonObject> UJsonObject::ParseJsonInternal(const FString& Json, bool& bSuccess)
 {
+	BLUEPRINTJSON_SCOPE(ParseJson);
+	BLUEPRINTJSON_INC_STAT_BY(BytesParsed, Json.Len());
+
 	TSharedRef< TJsonReader<> > Reader = TJsonReaderFactory<>::Create(Json);
 
 	TSharedPtr<FJsonObject> JsonObject;
@@ -370,8 +1129,32 @@ UJsonObject::UJsonObject() : Super()
 	return JsonObject;
 }
 
+/* static */ TSharedPtr<FJsonValue> UJsonObject::ParseJsonInternal(FString&& Json, const EJsonParseOptions Options, bool& bSuccess)
+{
+	BLUEPRINTJSON_SCOPE(ParseJson);
+
+	FString Error;
+	TSharedPtr<FJsonValue> Root = FBlueprintJsonParser::ParseValue(MoveTemp(Json), Options, &Error);
+
+	if (Root && Root->Type != EJson::Object)
+	{
+		Error = TEXT("Invalid JSON: the root value is not an object.");
+		Root.Reset();
+	}
+
+	bSuccess = Root.IsValid();
+	if (!bSuccess)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("%s"), *Error);
+	}
+
+	return Root;
+}
+
 /* static */ UJsonObject* UJsonObject::CreateFromRaw(const TSharedPtr<FJsonObject> RawObject)
 {
+	BLUEPRINTJSON_SCOPE(CreateObject);
+
 	if (!RawObject)
 	{
 		return nullptr;
@@ -384,6 +1167,94 @@ UJsonObject::UJsonObject() : Super()
 	return NewJsonObject;
 }
 
+/* static */ UJsonObject* UJsonObject::CreateFromRawFields(TArray<TPair<FString, TSharedPtr<FJsonValue>>>&& Fields)
+{
+	BLUEPRINTJSON_SCOPE(CreateObject);
+
+	UJsonObject* const NewJsonObject = NewObject<UJsonObject>();
+
+	TMap<FString, TSharedPtr<FJsonValue>>& Values = NewJsonObject->Object->Values;
+
+	Values.Reserve(Fields.Num());
+	for (TPair<FString, TSharedPtr<FJsonValue>>& Field : Fields)
+	{
+		Values.Emplace(MoveTemp(Field.Key), MoveTemp(Field.Value));
+	}
+
+	return NewJsonObject;
+}
+
+/* static */ UJsonObject* UJsonObject::CreateFromRawValue(const TSharedPtr<FJsonValue>& RawValue)
+{
+	if (!RawValue || RawValue->Type != EJson::Object)
+	{
+		return nullptr;
+	}
+
+	if (!FJsonValueFlatObject::Cast(RawValue.Get()))
+	{
+		return CreateFromRaw(RawValue->AsObject());
+	}
+
+	BLUEPRINTJSON_SCOPE(CreateObject);
+
+	UJsonObject* const NewJsonObject = NewObject<UJsonObject>();
+
+	NewJsonObject->Object.Reset();
+	NewJsonObject->FlatObject = RawValue;
+
+	return NewJsonObject;
+}
+
+TSharedPtr<FJsonObject> UJsonObject::GetRawObject()
+{
+	if (FlatObject)
+	{
+		BLUEPRINTJSON_SCOPE(UnflattenObject);
+
+		// The flat object keeps the converted object so other readers see our changes.
+		Object = FlatObject->AsObject();
+		FlatObject.Reset();
+	}
+	return Object;
+}
+
+TSharedPtr<FJsonValue> UJsonObject::GetRawValue() const
+{
+	if (FlatObject)
+	{
+		return FlatObject;
+	}
+	return MakeShared<FJsonValueObject>(Object);
+}
+
+bool UJsonObject::NextField(int32& Cursor, FString& OutFieldName, TSharedPtr<FJsonValue>& OutFieldValue) const
+{
+	FStringView FieldName;
+
+	const bool bFound = FlatObject
+		? static_cast<const FJsonValueFlatObject*>(FlatObject.Get())->NextField(Cursor, FieldName, OutFieldValue)
+		: FJsonValueFlatObject::NextField(*Object, Cursor, FieldName, OutFieldValue);
+
+	if (bFound)
+	{
+		// Keeps the buffer of the previous name.
+		OutFieldName.Reset(FieldName.Len());
+		OutFieldName.Append(FieldName);
+	}
+
+	return bFound;
+}
+
+TSharedPtr<FJsonValue> UJsonObject::FindField(const FString& FieldName) const
+{
+	if (FlatObject)
+	{
+		return static_cast<const FJsonValueFlatObject*>(FlatObject.Get())->TryGetField(FieldName);
+	}
+	return Object->TryGetField(FieldName);
+}
+
 /* static */ UJsonObject* UJsonObject::ParseJson(const FString& Json, bool& bSuccess)
 {
 	TSharedPtr<FJsonObject> RawObject = ParseJsonInternal(Json, bSuccess);
@@ -391,6 +1262,21 @@ UJsonObject::UJsonObject() : Super()
 	return CreateFromRaw(RawObject);
 }
 
+/* static */ UJsonObject* UJsonObject::ParseJsonWithOptions(const FString& Json, int32 Options, bool& bSuccess)
+{
+	return ParseJson(CopyTemp(Json), static_cast<EJsonParseOptions>(Options), bSuccess);
+}
+
+/* static */ UJsonObject* UJsonObject::ParseJson(FString&& Json, const EJsonParseOptions Options, bool& bSuccess)
+{
+	if (Options == EJsonParseOptions::None)
+	{
+		return CreateFromRaw(ParseJsonInternal(Json, bSuccess));
+	}
+
+	return CreateFromRawValue(ParseJsonInternal(MoveTemp(Json), Options, bSuccess));
+}
+
 /* static */ UJsonObject* UJsonObject::CreateJsonObject()
 {
 	UJsonObject* const Object = NewObject<UJsonObject>();
@@ -402,11 +1288,25 @@ UJsonObject::UJsonObject() : Super()
 
 UJsonValue* UJsonObject::ToJsonValue()
 {
-	return UJsonValue::CreateFromRaw(MakeShared<FJsonValueObject>(Object));
+	return UJsonValue::CreateFromRaw(GetRawValue());
 }
 
 void UJsonObject::GetAllProperties(TArray<FJsonObjectField>& OutValues) const
 {
+	BLUEPRINTJSON_SCOPE(GetAllProperties);
+
+	if (FlatObject)
+	{
+		const FJsonValueFlatObject* const Flat = static_cast<const FJsonValueFlatObject*>(FlatObject.Get());
+
+		OutValues.Empty(Flat->Num());
+		Flat->ForEachField([&OutValues](const FStringView FieldName, const TSharedPtr<FJsonValue>& FieldValue)
+		{
+			OutValues.Emplace(FJsonObjectField{ FString(FieldName), UJsonValue::CreateFromRaw(FieldValue) });
+		});
+		return;
+	}
+
 	OutValues.Empty(Object->Values.Num());
 	for (const auto& Value : Object->Values)
 	{
@@ -416,7 +1316,7 @@ void UJsonObject::GetAllProperties(TArray<FJsonObjectField>& OutValues) const
 
 FLightJsonObject UJsonObject::GetFieldAsObjectWrapper(const FString& FieldName)
 {
-	TSharedPtr<FJsonValue> Value = Object->TryGetField(FieldName);
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
 	if (!Value || Value->Type != EJson::Object)
 	{
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to get field %s as Object in Json Object."), *FieldName);
@@ -428,7 +1328,7 @@ FLightJsonObject UJsonObject::GetFieldAsObjectWrapper(const FString& FieldName)
 
 FString UJsonObject::GetFieldAsString(const FString& FieldName)
 {
-	TSharedPtr<FJsonValue> Value = Object->TryGetField(FieldName);
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
 	if (!Value)
 	{
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to get field %s in Json Object."), *FieldName);
@@ -445,7 +1345,7 @@ FString UJsonObject::GetFieldAsString(const FString& FieldName)
 
 int32 UJsonObject::GetFieldAsInteger(const FString& FieldName)
 {
-	TSharedPtr<FJsonValue> Value = Object->TryGetField(FieldName);
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
 	if (!Value)
 	{
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to get field %s in Json Object."), *FieldName);
@@ -462,7 +1362,7 @@ int32 UJsonObject::GetFieldAsInteger(const FString& FieldName)
 
 int64 UJsonObject::GetFieldAsInteger64(const FString& FieldName)
 {
-	TSharedPtr<FJsonValue> Value = Object->TryGetField(FieldName);
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
 	if (!Value)
 	{
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to get field %s in Json Object."), *FieldName);
@@ -479,7 +1379,7 @@ int64 UJsonObject::GetFieldAsInteger64(const FString& FieldName)
 
 float UJsonObject::GetFieldAsFloat(const FString& FieldName)
 {
-	TSharedPtr<FJsonValue> Value = Object->TryGetField(FieldName);
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
 	if (!Value)
 	{
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to get field %s in Json Object."), *FieldName);
@@ -501,9 +1401,11 @@ FVector UJsonObject::GetFieldAsVector(const FString& FieldName)
 
 TArray<int32> UJsonObject::GetFieldAsInt32Array(const FString& FieldName)
 {
+	BLUEPRINTJSON_SCOPE(GetTypedArray);
+
 	TArray<int32> FieldValue;
 
-	TSharedPtr<FJsonValue> Value = Object->TryGetField(FieldName);
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
 
 	if (!Value)
 	{
@@ -530,9 +1432,11 @@ TArray<int32> UJsonObject::GetFieldAsInt32Array(const FString& FieldName)
 
 TArray<float> UJsonObject::GetFieldAsFloatArray(const FString& FieldName)
 {
+	BLUEPRINTJSON_SCOPE(GetTypedArray);
+
 	TArray<float> FieldValue;
 
-	TSharedPtr<FJsonValue> Value = Object->TryGetField(FieldName);
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
 
 	if (!Value)
 	{
@@ -564,9 +1468,11 @@ TArray<UJsonValue*> UJsonObject::GetFieldAsArrayExec(const FString& FieldName)
 
 TArray<UJsonValue*> UJsonObject::GetFieldAsArray(const FString& FieldName)
 {
+	BLUEPRINTJSON_SCOPE(GetFieldAsArray);
+
 	TArray<UJsonValue*> FieldValue;
 
-	TSharedPtr<FJsonValue> Value = Object->TryGetField(FieldName);
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
 
 	if (!Value)
 	{
@@ -591,6 +1497,25 @@ TArray<UJsonValue*> UJsonObject::GetFieldAsArray(const FString& FieldName)
 	return FieldValue;	
 }
 
+UJsonArrayView* UJsonObject::GetFieldAsArrayView(const FString& FieldName)
+{
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
+
+	if (!Value)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to get field %s in Json Object."), *FieldName);
+		return nullptr;
+	}
+
+	if (Value->Type != EJson::Array)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Field %s is not an Array but is %s."), *FieldName, *UJsonValue::JsonTypeToString(Value->Type));
+		return nullptr;
+	}
+
+	return UJsonArrayView::CreateFromRaw(Value);
+}
+
 UJsonObject* UJsonObject::GetFieldAsObjectExec(const FString& FieldName)
 {
 	return GetFieldAsObject(FieldName);
@@ -598,7 +1523,9 @@ UJsonObject* UJsonObject::GetFieldAsObjectExec(const FString& FieldName)
 
 UJsonObject* UJsonObject::GetFieldAsObject(const FString& FieldName)
 {
-	TSharedPtr<FJsonValue> Value = Object->TryGetField(FieldName);
+	BLUEPRINTJSON_SCOPE(GetFieldAsObject);
+
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
 	if (!Value)
 	{
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to get field %s in Json Object."), *FieldName);
@@ -611,12 +1538,12 @@ UJsonObject* UJsonObject::GetFieldAsObject(const FString& FieldName)
 		return nullptr;
 	}
 
-	return CreateFromRaw(Value->AsObject());
+	return CreateFromRawValue(Value);
 }
 
 bool UJsonObject::GetFieldAsBoolean(const FString& FieldName)
 {
-	TSharedPtr<FJsonValue> Value = Object->TryGetField(FieldName);
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
 	if (!Value)
 	{
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to get field %s in Json Object."), *FieldName);
@@ -633,17 +1560,18 @@ bool UJsonObject::GetFieldAsBoolean(const FString& FieldName)
 
 UJsonValue* UJsonObject::GetFieldAsValue(const FString& FieldName)
 {
-	if (!Object->HasField(FieldName))
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
+	if (!Value)
 	{
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to get field %s in Json Object."), *FieldName);
 		return nullptr;
 	}
-	return UJsonValue::CreateFromRaw(Object->TryGetField(FieldName));
+	return UJsonValue::CreateFromRaw(MoveTemp(Value));
 }
 
 bool UJsonObject::IsFieldNull(const FString& FieldName)
 {
-	TSharedPtr<FJsonValue> Value = Object->TryGetField(FieldName);
+	TSharedPtr<FJsonValue> Value = FindField(FieldName);
 	if (!Value)
 	{
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to get field %s in Json Object."), *FieldName);
@@ -654,61 +1582,79 @@ bool UJsonObject::IsFieldNull(const FString& FieldName)
 
 bool UJsonObject::HasField(const FString& FieldName)
 {
-	return Object->HasField(FieldName);
+	return FindField(FieldName).IsValid();
 }
 
 void UJsonObject::SetObjectField(const FString& FieldName, UJsonObject* const JsonObject)
 {
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
 	if (!JsonObject)
 	{
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Null object passed to AddObjectField."));
 		return;
 	}
-	Object->SetObjectField(FieldName, JsonObject->Object);
+	SetRawField(FieldName, JsonObject->GetRawValue());
 }
 
 void UJsonObject::SetStringField(const FString& FieldName, const FString& FieldValue)
 {
-	Object->SetStringField(FieldName, FieldValue);
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	GetRawObject()->SetStringField(FieldName, FieldValue);
 }
 
 void UJsonObject::SetIntegerField(const FString& FieldName, const int32 FieldValue)
 {
-	Object->SetNumberField(FieldName, static_cast<double>(FieldValue));
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	GetRawObject()->SetNumberField(FieldName, static_cast<double>(FieldValue));
 }
 
 void UJsonObject::SetInteger64Field(const FString& FieldName, const int64 FieldValue)
 {
-	Object->SetNumberField(FieldName, static_cast<double>(FieldValue));
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	GetRawObject()->SetField(FieldName, UJsonValue::MakeInteger64Value(FieldValue));
 }
 
 void UJsonObject::SetFloatField(const FString& FieldName, const float FieldValue)
 {
-	Object->SetNumberField(FieldName, static_cast<double>(FieldValue));
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	GetRawObject()->SetNumberField(FieldName, static_cast<double>(FieldValue));
 }
 
 void UJsonObject::SetBooleanField(const FString& FieldName, const bool FieldValue)
 {
-	Object->SetBoolField(FieldName, FieldValue);
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	GetRawObject()->SetBoolField(FieldName, FieldValue);
 }
 
 void UJsonObject::SetField(const FString& FieldName, UJsonValue* const FieldValue)
 {
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
 	if (!FieldValue)
 	{
 		UE_LOG(LogBlueprintJson, Warning, TEXT("Null value passed to SetField."));
 		return;
 	}
-	Object->SetField(FieldName, FieldValue->GetRawValue());
+	GetRawObject()->SetField(FieldName, FieldValue->GetRawValue());
 }
 
 void UJsonObject::SetRawField(const FString& FieldName, const TSharedPtr<FJsonValue>& FieldValue)
 {
-	Object->SetField(FieldName, FieldValue);
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	GetRawObject()->SetField(FieldName, FieldValue);
 }
 
 void UJsonObject::SetUObjectField(const FString& FieldName, UObject* const FieldValue)
 {
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
 	if (UJsonObject* const JsonObject = Cast<UJsonObject>(FieldValue))
 	{
 		SetObjectField(FieldName, JsonObject);
@@ -722,6 +1668,8 @@ void UJsonObject::SetUObjectField(const FString& FieldName, UObject* const Field
 
 void UJsonObject::SetArrayField(const FString& FieldName, const TArray<UJsonValue*>& FieldValue)
 {
+	BLUEPRINTJSON_SCOPE(SetArrayField);
+
 	TArray<TSharedPtr<FJsonValue> > Values;
 
 	Values.Reserve(FieldValue.Num());
@@ -733,11 +1681,198 @@ void UJsonObject::SetArrayField(const FString& FieldName, const TArray<UJsonValu
 		}
 	}
 
-	Object->SetArrayField(FieldName, Values);
+	GetRawObject()->SetArrayField(FieldName, Values);
 }
 
 void UJsonObject::SetNullField(const FString& FieldName)
 {
-	Object->SetField(FieldName, MakeShared<FJsonValueNull>());
+	LLM_SCOPE_BYTAG(BlueprintJson);
+
+	GetRawObject()->SetField(FieldName, MakeShared<FJsonValueNull>());
+}
+
+
+/* static */ UJsonArrayView* UJsonArrayView::CreateFromRaw(const TSharedPtr<FJsonValue>& RawArray)
+{
+	if (!RawArray || RawArray->Type != EJson::Array)
+	{
+		return nullptr;
+	}
+
+	BLUEPRINTJSON_SCOPE(CreateArrayView);
+
+	UJsonArrayView* const View = NewObject<UJsonArrayView>();
+
+	View->Array       = RawArray;
+	View->NumElements = RawArray->AsArray().Num();
+
+	return View;
+}
+
+const FJsonValue* UJsonArrayView::FindElement(const int32 Index) const
+{
+	if (!IsValidIndex(Index))
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Index %d is out of the bounds of a Json Array of %d elements."), Index, NumElements);
+		return nullptr;
+	}
+	return Array->AsArray()[First + Index].Get();
+}
+
+UJsonValue* UJsonArrayView::GetAt(const int32 Index) const
+{
+	if (!FindElement(Index))
+	{
+		return nullptr;
+	}
+	return UJsonValue::CreateFromRaw(Array->AsArray()[First + Index]);
+}
+
+EJsonType UJsonArrayView::GetTypeAt(const int32 Index) const
+{
+	if (!FindElement(Index))
+	{
+		return EJsonType::Null;
+	}
+	return FLightJsonValue(Array->AsArray()[First + Index]).GetType();
+}
+
+FString UJsonArrayView::GetStringAt(const int32 Index) const
+{
+	FString Element;
+	if (const FJsonValue* const Value = FindElement(Index); Value && !Value->TryGetString(Element))
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Element %d is not a String but is %s."), Index, *UJsonValue::JsonTypeToString(Value->Type));
+	}
+	return Element;
+}
+
+float UJsonArrayView::GetFloatAt(const int32 Index) const
+{
+	double Element = 0.;
+	if (const FJsonValue* const Value = FindElement(Index); Value && !Value->TryGetNumber(Element))
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Element %d is not a Number but is %s."), Index, *UJsonValue::JsonTypeToString(Value->Type));
+	}
+	return static_cast<float>(Element);
+}
+
+int32 UJsonArrayView::GetIntegerAt(const int32 Index) const
+{
+	int32 Element = 0;
+	if (const FJsonValue* const Value = FindElement(Index); Value && !Value->TryGetNumber(Element))
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Element %d is not a Number but is %s."), Index, *UJsonValue::JsonTypeToString(Value->Type));
+	}
+	return Element;
+}
+
+int64 UJsonArrayView::GetInteger64At(const int32 Index) const
+{
+	int64 Element = 0;
+	if (const FJsonValue* const Value = FindElement(Index); Value && !Value->TryGetNumber(Element))
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Element %d is not a Number but is %s."), Index, *UJsonValue::JsonTypeToString(Value->Type));
+	}
+	return Element;
+}
+
+bool UJsonArrayView::GetBooleanAt(const int32 Index) const
+{
+	bool bElement = false;
+	if (const FJsonValue* const Value = FindElement(Index); Value && !Value->TryGetBool(bElement))
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Element %d is not a Boolean but is %s."), Index, *UJsonValue::JsonTypeToString(Value->Type));
+	}
+	return bElement;
+}
+
+UJsonObject* UJsonArrayView::GetObjectAt(const int32 Index) const
+{
+	const FJsonValue* const Value = FindElement(Index);
+	if (!Value)
+	{
+		return nullptr;
+	}
+
+	if (Value->Type != EJson::Object)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Element %d is not an Object but is %s."), Index, *UJsonValue::JsonTypeToString(Value->Type));
+		return nullptr;
+	}
+
+	return UJsonObject::CreateFromRawValue(Array->AsArray()[First + Index]);
+}
+
+UJsonArrayView* UJsonArrayView::GetArrayAt(const int32 Index) const
+{
+	const FJsonValue* const Value = FindElement(Index);
+	if (!Value)
+	{
+		return nullptr;
+	}
+
+	if (Value->Type != EJson::Array)
+	{
+		UE_LOG(LogBlueprintJson, Warning, TEXT("Element %d is not an Array but is %s."), Index, *UJsonValue::JsonTypeToString(Value->Type));
+		return nullptr;
+	}
+
+	return CreateFromRaw(Array->AsArray()[First + Index]);
+}
+
+bool UJsonArrayView::IsNullAt(const int32 Index) const
+{
+	const FJsonValue* const Value = FindElement(Index);
+	return !Value || Value->IsNull();
+}
+
+UJsonArrayView* UJsonArrayView::Slice(const int32 Start, const int32 Count) const
+{
+	BLUEPRINTJSON_SCOPE(CreateArrayView);
+
+	const int32 SliceStart = FMath::Clamp(Start, 0, NumElements);
+	const int32 Remaining  = NumElements - SliceStart;
+
+	UJsonArrayView* const View = NewObject<UJsonArrayView>();
+
+	View->Array       = Array;
+	View->First       = First + SliceStart;
+	View->NumElements = Count < 0 ? Remaining : FMath::Min(Count, Remaining);
+
+	return View;
+}
+
+TArray<UJsonValue*> UJsonArrayView::ToArray() const
+{
+	BLUEPRINTJSON_SCOPE(GetFieldAsArray);
+
+	const TConstArrayView<TSharedPtr<FJsonValue>> RawValues = GetRawValues();
+
+	TArray<UJsonValue*> Elements;
+	Elements.Reserve(RawValues.Num());
+	for (const TSharedPtr<FJsonValue>& RawValue : RawValues)
+	{
+		Elements.Emplace(UJsonValue::CreateFromRaw(RawValue));
+	}
+
+	return Elements;
+}
+
+TConstArrayView<TSharedPtr<FJsonValue>> UJsonArrayView::GetRawValues() const
+{
+	if (!Array)
+	{
+		return {};
+	}
+	return TConstArrayView<TSharedPtr<FJsonValue>>(Array->AsArray()).Slice(First, NumElements);
 }
 
+TSharedPtr<FJsonValue> UJsonArrayView::GetRawValue() const
+{
+	if (Array && First == 0 && NumElements == Array->AsArray().Num())
+	{
+		return Array;
+	}
+	return MakeShared<FJsonValueArray>(TArray<TSharedPtr<FJsonValue>>(GetRawValues()));
+}
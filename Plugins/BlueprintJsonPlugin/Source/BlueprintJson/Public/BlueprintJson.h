@@ -4,8 +4,20 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "HAL/LowLevelMemTracker.h"
+#include <atomic>
 
-DECLARE_LOG_CATEGORY_EXTERN(LogBlueprintJson, Verbose, All);
+BLUEPRINTJSON_API DECLARE_LOG_CATEGORY_EXTERN(LogBlueprintJson, Verbose, All);
+
+/* LLM tag of the allocations of the plugin, e.g. -llm then "stat LLMFULL" or Insights with -trace=memory. */
+LLM_DECLARE_TAG_API(BlueprintJson, BLUEPRINTJSON_API);
+
+/* Running totals of the module, e.g. for telemetry. Thread safe. */
+struct BLUEPRINTJSON_API FBlueprintJsonCounters
+{
+    /* Number of UJsonObject and UJsonValue created, class defaults excluded. */
+    static std::atomic<int64> NumWrappersCreated;
+};
 
 class FBlueprintJsonModule : public IModuleInterface
 {
@@ -0,0 +1,31 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintJsonWrapper.h"
+
+class FJsonValue;
+
+/**
+ *  Compact binary form of the JSON DOM, meant for caches: loading it is a single
+ *  pass without tokenizing nor number parsing. Field names are stored once in a
+ *  table at the start and referenced by index, integers as variable length
+ *  integers, and strings as UTF-8.
+ *  The format is only stable for a given Version, data of another version fails to load.
+ **/
+class BLUEPRINTJSON_API FBlueprintJsonBinary
+{
+public:
+    /* Incremented each time the format changes. */
+    static constexpr uint8 Version = 1;
+
+    /* Appends the binary form of Value to OutData. */
+    static void Write(const TSharedPtr<FJsonValue>& Value, TArray<uint8>& OutData);
+
+    /**
+     * Reads a value written with Write(). Returns null and fills OutError if the data is
+     * truncated, corrupted or of another version. Only FlatObjects is used from Options.
+     */
+    static TSharedPtr<FJsonValue> Read(TConstArrayView<uint8> Data, const EJsonParseOptions Options = EJsonParseOptions::None, FString* const OutError = nullptr);
+};
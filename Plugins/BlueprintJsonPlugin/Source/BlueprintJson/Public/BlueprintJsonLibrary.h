@@ -42,9 +42,175 @@ public:
     UFUNCTION(BlueprintPure, meta = (BlueprintAutocast), Category = "JSON|Light|Object")
     static UPARAM(DisplayName = "Array") TArray<float> GetFieldAsFloatArray(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName);
 
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object")
+    static UPARAM(DisplayName = "Array") TArray<int32> GetFieldAsInt32Array(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName);
+
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object")
+    static UPARAM(DisplayName = "Array") TArray<FString> GetFieldAsStringArray(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName);
+
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object")
+    static UPARAM(DisplayName = "Array") TArray<FLightJsonValue> GetFieldAsArray(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName);
+
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object")
+    static UPARAM(DisplayName = "Value") bool GetFieldAsBoolean(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName);
+
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object")
+    static UPARAM(DisplayName = "Value") FVector GetFieldAsVector(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName);
+
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object")
+    static UPARAM(DisplayName = "Value") FLightJsonValue GetFieldAsValue(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName);
+
+    /* Returns the value at a path of field names and array indices, e.g. "data.cargo.inventory[0].symbol". Invalid if a part of the path is missing. */
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object")
+    static UPARAM(DisplayName = "Value") FLightJsonValue GetValueAtPath(UPARAM(Ref) FLightJsonObject& Object, const FString& Path);
+
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object")
+    static UPARAM(DisplayName = "Has Field") bool HasField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName);
+
+    /* Returns true if the field is the JSON Null value or is missing. */
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object")
+    static UPARAM(DisplayName = "Is Null") bool IsFieldNull(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName);
+
+    /* Returns the names of the fields, in insertion order. */
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object")
+    static UPARAM(DisplayName = "Field Names") TArray<FString> GetFieldNames(UPARAM(Ref) FLightJsonObject& Object);
+
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object", meta = (DisplayName = "Num Fields"))
+    static UPARAM(DisplayName = "Num") int32 GetNumFields(UPARAM(Ref) FLightJsonObject& Object);
+
+    /* Returns false for a default light object or a failed parse. */
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object", meta = (DisplayName = "Is Valid (Light JsonObject)"))
+    static UPARAM(DisplayName = "Is Valid") bool IsLightObjectValid(UPARAM(Ref) FLightJsonObject& Object);
+
+    /* Creates an empty light JSON object. */
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object", meta = (DisplayName = "Create Light JSON Object"))
+    static UPARAM(DisplayName = "Light JSON Object") FLightJsonObject CreateLightJsonObject();
+
+    /* Parses JSON whose root is an object without creating any UObject. */
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Object", meta = (DisplayName = "Parse Light JSON"))
+    static UPARAM(DisplayName = "Root Object") FLightJsonObject ParseLightJson(const FString& Json, UPARAM(meta = (Bitmask, BitmaskEnum = "/Script/BlueprintJson.EJsonParseOptions")) int32 Options, UPARAM(DisplayName = "Is Valid JSON") bool& bSuccess);
+
+    /* Stringify the provided light JSON object. */
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object", meta = (DisplayName = "Light JSON object to string"))
+    static UPARAM(DisplayName = "Success") bool StringifyLightJsonObject(UPARAM(Ref) FLightJsonObject& Object, FString& OutJsonString);
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetStringField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const FString& FieldValue) { Object.SetStringField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetIntegerField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const int32 FieldValue) { Object.SetIntegerField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetInteger64Field(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const int64 FieldValue) { Object.SetInteger64Field(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetFloatField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const float FieldValue) { Object.SetFloatField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetBooleanField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const bool FieldValue) { Object.SetBooleanField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetObjectField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const FLightJsonObject& FieldValue) { Object.SetObjectField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetArrayField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const TArray<FLightJsonValue>& FieldValue) { Object.SetArrayField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const FLightJsonValue& FieldValue) { Object.SetField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetNullField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName) { Object.SetNullField(FieldName); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetVectorField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const FVector& FieldValue) { Object.SetVectorField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetVector2DField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const FVector2D& FieldValue) { Object.SetVector2DField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetRotatorField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const FRotator& FieldValue) { Object.SetRotatorField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetTransformField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const FTransform& FieldValue) { Object.SetTransformField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetLinearColorField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const FLinearColor& FieldValue) { Object.SetLinearColorField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetColorField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const FColor& FieldValue) { Object.SetColorField(FieldName, FieldValue); }
+
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static void SetQuatField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName, const FQuat& FieldValue) { Object.SetQuatField(FieldName, FieldValue); }
+
+    /* Removes a field. Returns false if there was none. */
+    UFUNCTION(BlueprintCallable, Category = "JSON|Light|Object")
+    static UPARAM(DisplayName = "Removed") bool RemoveField(UPARAM(Ref) FLightJsonObject& Object, const FString& FieldName) { return Object.RemoveField(FieldName); }
+
     UFUNCTION(BlueprintPure, meta = (BlueprintAutocast, CompactNodeTitle = "->"), Category = "JSON|Light|Object")
     static UJsonObject* ConvertLightObject(UPARAM(Ref) FLightJsonObject& Object);
 
+    // FLightJsonValue API
+
+    UFUNCTION(BlueprintPure, Category = "JSON|Light|Value")
+    static UPARAM(DisplayName = "Type") EJsonType GetValueType(const FLightJsonValue& Value);
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToString (Light JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static FString LightValue_ToString(const FLightJsonValue& Value);
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToFloat (Light JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static float LightValue_ToFloat(const FLightJsonValue& Value);
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToInteger64 (Light JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static int64 LightValue_ToInteger64(const FLightJsonValue& Value);
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToBoolean (Light JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static bool LightValue_ToBool(const FLightJsonValue& Value);
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToLightObject (Light JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static FLightJsonObject LightValue_ToObject(const FLightJsonValue& Value);
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToInteger (Light JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static int32 LightValue_ToInteger(const FLightJsonValue& Value);
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToArray (Light JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static TArray<FLightJsonValue> LightValue_ToArray(const FLightJsonValue& Value);
+
+    /* Creates a UJsonValue wrapper for this value. */
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToJsonValue (Light JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static UJsonValue* LightValue_ToJsonValue(const FLightJsonValue& Value);
+
+    /* Returns true if the value is the JSON Null value or is invalid. */
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "Is Null (Light JsonValue)"), Category = "JSON|Light|Value")
+    static UPARAM(DisplayName = "Is Null") bool LightValue_IsNull(const FLightJsonValue& Value);
+
+    /* Stringify the provided light JSON value. */
+    UFUNCTION(BlueprintCallable, meta = (DisplayName = "Light JSON value to string"), Category = "JSON|Light|Value")
+    static UPARAM(DisplayName = "Success") bool StringifyLightJsonValue(const FLightJsonValue& Value, FString& OutJsonString);
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToLightJsonValue (FString)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static FLightJsonValue LightValue_String(const FString& Value) { return FLightJsonValue::MakeString(Value); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToLightJsonValue (float)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static FLightJsonValue LightValue_Float(const float Value) { return FLightJsonValue::MakeFloat(Value); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToLightJsonValue (int32)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static FLightJsonValue LightValue_Integer(const int32 Value) { return FLightJsonValue::MakeInteger64(Value); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToLightJsonValue (int64)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static FLightJsonValue LightValue_Integer64(const int64 Value) { return FLightJsonValue::MakeInteger64(Value); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToLightJsonValue (bool)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static FLightJsonValue LightValue_Boolean(const bool Value) { return FLightJsonValue::MakeBoolean(Value); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToLightJsonValue (Light JsonObject)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static FLightJsonValue LightValue_Object(const FLightJsonObject& Value) { return FLightJsonValue::MakeObject(Value); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToLightJsonValue (Array)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Light|Value")
+    static FLightJsonValue LightValue_Array(const TArray<FLightJsonValue>& Value) { return FLightJsonValue::MakeArray(Value); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "Make Null Light JSON Value"), Category = "JSON|Light|Value")
+    static FLightJsonValue LightValue_Null() { return FLightJsonValue::MakeNull(); }
+
 public:
 
     /* Tries to get this Json value as a string */
@@ -79,10 +245,22 @@ public:
     UFUNCTION(BlueprintPure, meta = (DisplayName = "ToTransform (JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Value")
     static FTransform JsonValue_ToTransform(UJsonValue* Object);
     
+    /* Sets how vectors, rotators, quaternions, colors and transforms are written when no encoding is specified. */
+    UFUNCTION(BlueprintCallable, Category = "JSON|Value")
+    static void SetJsonMathEncoding(const EJsonMathEncoding Encoding);
+
+    /* Returns how vectors, rotators, quaternions, colors and transforms are written when no encoding is specified. */
+    UFUNCTION(BlueprintPure, Category = "JSON|Value")
+    static UPARAM(DisplayName = "Encoding") EJsonMathEncoding GetJsonMathEncoding();
+
     /* Tries to get this Json value as an Array */
     UFUNCTION(BlueprintPure, meta = (DisplayName = "ToArray (JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Value")
     static TArray<UJsonValue*> JsonValue_ToArray(UJsonValue* Object);
 
+    /* Tries to get this Json value as an Array View, which only wraps the elements accessed */
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToArrayView (JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Value")
+    static UJsonArrayView* JsonValue_ToArrayView(UJsonValue* Object);
+
     /* Tries to get this Json value as an Object */
     UFUNCTION(BlueprintPure, meta = (DisplayName = "ToObject (JsonValue)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Value")
     static UJsonObject* JsonValue_ToObject(UJsonValue* Object);
@@ -145,38 +323,61 @@ public:
     UFUNCTION(BlueprintPure, meta = (DisplayName = "ToJsonValue (HitResult)", CompactNodeTitle = "->", BlueprintAutocast), Category = "JSON|Value") 
     static UJsonValue* JsonValue_HitResult(const FHitResult& Value) { return UJsonValue::CreateJsonValue(Value); }
 
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToJsonValue (Vector, Encoding)"), Category = "JSON|Value")
+    static UJsonValue* JsonValue_VectorWithEncoding(const FVector& Value, const EJsonMathEncoding Encoding) { return UJsonValue::CreateFromRaw(UJsonValue::CreateRawJsonValue(Value, Encoding)); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToJsonValue (Rotator, Encoding)"), Category = "JSON|Value")
+    static UJsonValue* JsonValue_RotatorWithEncoding(const FRotator& Value, const EJsonMathEncoding Encoding) { return UJsonValue::CreateFromRaw(UJsonValue::CreateRawJsonValue(Value, Encoding)); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToJsonValue (Quat, Encoding)"), Category = "JSON|Value")
+    static UJsonValue* JsonValue_QuatWithEncoding(const FQuat& Value, const EJsonMathEncoding Encoding) { return UJsonValue::CreateFromRaw(UJsonValue::CreateRawJsonValue(Value, Encoding)); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToJsonValue (Transform, Encoding)"), Category = "JSON|Value")
+    static UJsonValue* JsonValue_TransformWithEncoding(const FTransform& Value, const EJsonMathEncoding Encoding) { return UJsonValue::CreateFromRaw(UJsonValue::CreateRawJsonValue(Value, Encoding)); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToJsonValue (LinearColor, Encoding)"), Category = "JSON|Value")
+    static UJsonValue* JsonValue_LinearColorWithEncoding(const FLinearColor& Value, const EJsonMathEncoding Encoding) { return UJsonValue::CreateFromRaw(UJsonValue::CreateRawJsonValue(Value, Encoding)); }
+
+    UFUNCTION(BlueprintPure, meta = (DisplayName = "ToJsonValue (Color, Encoding)"), Category = "JSON|Value")
+    static UJsonValue* JsonValue_ColorWithEncoding(const FColor& Value, const EJsonMathEncoding Encoding) { return UJsonValue::CreateFromRaw(UJsonValue::CreateRawJsonValue(Value, Encoding)); }
+
 };
 
 
-/* Macro to easily add internal array functions a body. Warp the custom array into a (UJsonValue*) array. */
+/* Macro to easily add internal array functions a body. Converts the custom array straight into a raw JSON array. */
 #define JSON_K2NODE_SET_FIELD_ARR {                                                                             \
         if (!JsonObject)                                                                                        \
         {                                                                                                       \
             UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to add field to JSON Object: Null object passed.")); \
             return;                                                                                             \
         }                                                                                                       \
-        TArray<UJsonValue*> Values;                                                                             \
+        TArray<TSharedPtr<FJsonValue>> Values;                                                                  \
+        Values.Reserve(FieldValue.Num());                                                                       \
         for (const auto& Value : FieldValue)                                                                    \
         {                                                                                                       \
-            UJsonValue* const JsonValue = UJsonValue::CreateJsonValueTemplate(Value);                           \
-            if (JsonValue)                                                                                      \
+            TSharedPtr<FJsonValue> RawValue = UJsonValue::CreateRawJsonValue(Value);                            \
+            if (RawValue)                                                                                       \
             {                                                                                                   \
-                Values.Emplace(JsonValue);                                                                      \
+                Values.Emplace(MoveTemp(RawValue));                                                             \
             }                                                                                                   \
         }                                                                                                       \
-        JsonObject->SetArrayField(FieldName, Values);                                                           \
+        JsonObject->SetRawField(FieldName, MakeShared<FJsonValueArray>(MoveTemp(Values)));                      \
     }
 
-// Macro to easily add internal functions a body. Transform the passed variable to a (UJsonValue*).
+// Macro to easily add internal functions a body. Transform the passed variable to a raw JSON value.
 #define JSON_K2NODE_SET_FIELD {                                                                                 \
-        if (JsonObject)                                                                                         \
+        if (!JsonObject)                                                                                        \
         {                                                                                                       \
-            JsonObject->SetField(FieldName, UJsonValue::CreateJsonValue(FieldValue));                           \
+            UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to add field to JSON Object: Null object passed.")); \
+            return;                                                                                             \
         }                                                                                                       \
-        else                                                                                                    \
+        TSharedPtr<FJsonValue> RawValue = UJsonValue::CreateRawJsonValue(FieldValue);                           \
+        if (!RawValue)                                                                                          \
         {                                                                                                       \
-            UE_LOG(LogBlueprintJson, Warning, TEXT("Failed to add field to JSON Object: Null object passed.")); \
+            UE_LOG(LogBlueprintJson, Warning, TEXT("Null value passed to SetField."));                          \
+            return;                                                                                             \
         }                                                                                                       \
+        JsonObject->SetRawField(FieldName, RawValue);                                                           \
     }
 
 
@@ -198,6 +399,26 @@ public:
     /*********                                                                                                           *********/
     /*****************************************************************************************************************************/
 
+    /* Iterator behind For Each Field in JSON Object. Returns false once every field has been visited. */
+    UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true"))
+    static bool JO_NextField(UJsonObject* const JsonObject, UPARAM(ref) int32& Cursor, FString& FieldName, FLightJsonValue& FieldValue);
+
+    /**
+     * Native call behind Break JSON Object. It's variadic: each field name is followed by the
+     * output the field is written to. Returns false if a field is missing or of the wrong type.
+     */
+    UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true", Variadic))
+    static bool JO_BreakFields(UJsonObject* const JsonObject, const TArray<FString>& FieldNames);
+    DECLARE_FUNCTION(execJO_BreakFields);
+
+    /**
+     * Native call behind Make JSON Object. It's variadic: each field name is followed by
+     * the input holding the field's value.
+     */
+    UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true", Variadic))
+    static UJsonObject* JO_MakeObject(const TArray<FString>& FieldNames);
+    DECLARE_FUNCTION(execJO_MakeObject);
+
     /* Add Field to JSON Object functions. */
     UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true")) static void JO_AddField_Int        (UJsonObject* const JsonObject, const FString& FieldName, const int32           FieldValue) { JSON_K2NODE_SET_FIELD }
     UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true")) static void JO_AddField_Int64      (UJsonObject* const JsonObject, const FString& FieldName, const int64           FieldValue) { JSON_K2NODE_SET_FIELD }
@@ -215,6 +436,16 @@ public:
     UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true")) static void JO_AddField_Quat       (UJsonObject* const JsonObject, const FString& FieldName, const FQuat&          FieldValue) { JSON_K2NODE_SET_FIELD }
     UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true")) static void JO_AddField_HitResult  (UJsonObject* const JsonObject, const FString& FieldName, const FHitResult&     FieldValue) { JSON_K2NODE_SET_FIELD }
                                           
+    /* Add a Set field as a JSON array. Any element type, the pin type is set by the custom node. */
+    UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true", SetParam = "FieldValue"))
+    static void JO_AddField_Set(UJsonObject* const JsonObject, const FString& FieldName, const TSet<int32>& FieldValue);
+    DECLARE_FUNCTION(execJO_AddField_Set);
+
+    /* Add a Map field as a JSON object. Keys must be String or Name, the pin type is set by the custom node. */
+    UFUNCTION(BlueprintCallable, CustomThunk, meta = (BlueprintInternalUseOnly = "true", MapParam = "FieldValue"))
+    static void JO_AddField_Map(UJsonObject* const JsonObject, const FString& FieldName, const TMap<FString, int32>& FieldValue);
+    DECLARE_FUNCTION(execJO_AddField_Map);
+
     /* Add Array Field to JSON Object functions. */
     UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true")) static void JO_AddField_Arr_Int        (UJsonObject* const JsonObject, const FString& FieldName, const TArray<int32>           & FieldValue) { JSON_K2NODE_SET_FIELD_ARR }
     UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true")) static void JO_AddField_Arr_Int64      (UJsonObject* const JsonObject, const FString& FieldName, const TArray<int64>           & FieldValue) { JSON_K2NODE_SET_FIELD_ARR }
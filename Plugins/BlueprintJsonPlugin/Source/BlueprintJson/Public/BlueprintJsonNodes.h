@@ -17,7 +17,7 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE(FJsonSaveEvent);
  *  Base class for asynchronous json loading.
  **/
 UCLASS(Abstract)
-class UJsonLoadAsyncProxyBase : public UBlueprintAsyncActionBase
+class BLUEPRINTJSON_API UJsonLoadAsyncProxyBase : public UBlueprintAsyncActionBase
 {
 	GENERATED_BODY()
 public:
@@ -68,7 +68,7 @@ protected:
  *  Asynchronous node to load Json directly from a file.
  **/
 UCLASS()
-class UJsonLoadAsyncFromFileProxy final : public UJsonLoadAsyncProxyBase
+class BLUEPRINTJSON_API UJsonLoadAsyncFromFileProxy final : public UJsonLoadAsyncProxyBase
 {
     GENERATED_BODY()
 public:
@@ -85,7 +85,7 @@ private:
  *  Asynchronous node to parse Json.
  **/
 UCLASS()
-class UJsonParseAsyncProxy final : public UJsonLoadAsyncProxyBase
+class BLUEPRINTJSON_API UJsonParseAsyncProxy final : public UJsonLoadAsyncProxyBase
 {
     GENERATED_BODY()
 public:
@@ -98,7 +98,7 @@ public:
  *  Base class for asynchronous json loading.
  **/
 UCLASS()
-class UJsonSaveAsyncProxy final : public UBlueprintAsyncActionBase
+class BLUEPRINTJSON_API UJsonSaveAsyncProxy final : public UBlueprintAsyncActionBase
 {
     GENERATED_BODY()
 public:
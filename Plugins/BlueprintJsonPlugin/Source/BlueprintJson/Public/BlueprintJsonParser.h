@@ -0,0 +1,37 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintJsonWrapper.h"
+
+class FJsonValue;
+class FJsonObject;
+
+/**
+ *  JSON parser building the engine DOM (FJsonObject / FJsonValue) with the
+ *  representations selected by EJsonParseOptions. Parsing without options
+ *  produces the same DOM as FJsonSerializer.
+ *  Lazy values keep the source text alive, it's moved in rather than copied.
+ **/
+class BLUEPRINTJSON_API FBlueprintJsonParser
+{
+public:
+    /**
+     * Parses a document whose root is an object. Returns null and fills OutError on failure.
+     * A flat root object is converted to FJsonObject, use ParseValue to keep it flat.
+     */
+    static TSharedPtr<FJsonObject> ParseObject(FString&& Json, const EJsonParseOptions Options, FString* const OutError = nullptr);
+
+    /* Parses a UTF-8 document whose root is an object, e.g. an HTTP response body. */
+    static TSharedPtr<FJsonObject> ParseObject(TArray<uint8>&& Utf8Json, const EJsonParseOptions Options, FString* const OutError = nullptr);
+
+    /* Parses a document whose root can be any JSON value. Returns null and fills OutError on failure. */
+    static TSharedPtr<FJsonValue> ParseValue(FString&& Json, const EJsonParseOptions Options, FString* const OutError = nullptr);
+
+    /* Parses a UTF-8 document whose root can be any JSON value. */
+    static TSharedPtr<FJsonValue> ParseValue(TArray<uint8>&& Utf8Json, const EJsonParseOptions Options, FString* const OutError = nullptr);
+
+    /* Maximum nesting depth of objects and arrays. */
+    static constexpr int32 MaxDepth = 512;
+};
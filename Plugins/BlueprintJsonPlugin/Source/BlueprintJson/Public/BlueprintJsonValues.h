@@ -0,0 +1,306 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "Async/Mutex.h"
+
+#include <atomic>
+
+/**
+ *  Source text of a parsed document, either as TCHAR or as UTF-8. Lazy values
+ *  point into it instead of owning a decoded copy, so it's kept alive as long
+ *  as one of them is.
+ **/
+class BLUEPRINTJSON_API FJsonSourceBuffer
+{
+public:
+    explicit FJsonSourceBuffer(FString&& InText)
+        : Text(MoveTemp(InText))
+        , bUtf8(false)
+    {}
+
+    explicit FJsonSourceBuffer(TArray<uint8>&& InUtf8Text)
+        : Utf8Text(MoveTemp(InUtf8Text))
+        , bUtf8(true)
+    {}
+
+    /* Returns true if the source text is stored as UTF-8. */
+    bool IsUtf8() const { return bUtf8; }
+
+    /* Returns the characters in [Offset, Offset + Length). The source must not be UTF-8. */
+    FStringView Slice(const int32 Offset, const int32 Length) const
+    {
+        check(!bUtf8);
+        return FStringView(*Text + Offset, Length);
+    }
+
+    /* Returns the code units in [Offset, Offset + Length). The source must be UTF-8. */
+    FUtf8StringView SliceUtf8(const int32 Offset, const int32 Length) const
+    {
+        check(bUtf8);
+        return FUtf8StringView(reinterpret_cast<const UTF8CHAR*>(Utf8Text.GetData()) + Offset, Length);
+    }
+
+    /* Calls Functor with the slice [Offset, Offset + Length) as either FStringView or FUtf8StringView. */
+    template<typename FunctorType>
+    decltype(auto) VisitSlice(const int32 Offset, const int32 Length, FunctorType&& Functor) const
+    {
+        return bUtf8 ? Functor(SliceUtf8(Offset, Length)) : Functor(Slice(Offset, Length));
+    }
+
+    /* Returns the number of code units in the retained text. */
+    int32 Num() const { return bUtf8 ? Utf8Text.Num() : Text.Len(); }
+
+    /* Returns the size of the retained text, in bytes. */
+    SIZE_T GetAllocatedSize() const { return Text.GetAllocatedSize() + Utf8Text.GetAllocatedSize(); }
+
+private:
+    FString       Text;
+    TArray<uint8> Utf8Text;
+    bool          bUtf8;
+};
+
+using FJsonSourceBufferRef = TSharedRef<const FJsonSourceBuffer, ESPMode::ThreadSafe>;
+
+/**
+ *  Base of the values below. The engine is built without RTTI and FJsonValue only
+ *  exposes EJson, so each of them stores the address of a sentinel of its own,
+ *  set by its constructor, and Cast() compares it after checking Type. Every
+ *  engine value of the same EJson type also has data at that offset.
+ **/
+class BLUEPRINTJSON_API FJsonValueTagged : public FJsonValue
+{
+protected:
+    explicit FJsonValueTagged(const void* const InKind)
+        : Kind(InKind)
+    {}
+
+    /* Returns true if Value was created with Kind. Value must be a Number, String or Object. */
+    static bool IsKind(const FJsonValue* const Value, const void* const Kind)
+    {
+        return static_cast<const FJsonValueTagged*>(Value)->Kind == Kind;
+    }
+
+private:
+    const void* const Kind;
+};
+
+/**
+ *  A JSON Number that keeps the lexeme it was parsed from and only decodes it
+ *  the first time it's read. Integer lexemes are decoded to int64 directly
+ *  instead of going through a double, so values above 2^53 stay exact.
+ **/
+class BLUEPRINTJSON_API FJsonValueLazyNumber final : public FJsonValueTagged
+{
+public:
+    FJsonValueLazyNumber(FJsonSourceBufferRef InSource, const int32 InOffset, const int32 InLength, const bool bInIsInteger);
+
+    virtual bool TryGetNumber(double& OutNumber) const override;
+    virtual bool TryGetNumber(int64&  OutNumber) const override;
+    virtual bool TryGetNumber(uint64& OutNumber) const override;
+
+    /* Numbers convert to string the way they were written in the document. */
+    virtual bool TryGetString(FString& OutString) const override;
+    virtual bool TryGetBool(bool& OutBool) const override;
+
+    /* Integers are written back from their lexeme by FJsonSerializer, instead of through a double that rounds them above 2^53. */
+    virtual bool PreferStringRepresentation() const override { return bIsInteger; }
+
+    /* Returns the number as written in the source document. */
+    FString GetLexeme() const;
+
+    /* Returns true if the lexeme has no fraction nor exponent. */
+    bool IsInteger() const { return bIsInteger; }
+
+    /* Returns the document the lexeme is in. */
+    const FJsonSourceBuffer& GetSource() const { return *Source; }
+
+    /* Returns Value as a lazy number if it is one, null otherwise. */
+    static const FJsonValueLazyNumber* Cast(const FJsonValue* const Value);
+
+    /* Decodes an integer lexeme (-?[0-9]+) exactly. Returns false on overflow or if it isn't an integer. */
+    static bool TryParseInteger(FStringView     Lexeme, int64& OutValue);
+    static bool TryParseInteger(FUtf8StringView Lexeme, int64& OutValue);
+
+    /* Decodes an unsigned integer lexeme ([0-9]+) exactly. Returns false on overflow or if it isn't an integer. */
+    static bool TryParseUnsignedInteger(FStringView     Lexeme, uint64& OutValue);
+    static bool TryParseUnsignedInteger(FUtf8StringView Lexeme, uint64& OutValue);
+
+    /* Decodes any JSON number lexeme to a double. */
+    static double ParseDouble(FStringView     Lexeme);
+    static double ParseDouble(FUtf8StringView Lexeme);
+
+protected:
+    virtual FString GetType() const override { return TEXT("Number"); }
+
+private:
+    double DecodeDouble() const;
+
+    FJsonSourceBufferRef Source;
+    int32 Offset;
+    int32 Length;
+    bool  bIsInteger;
+
+    /* Decoded value, only valid once bDecoded is set. */
+    mutable std::atomic<double> Decoded;
+    mutable std::atomic<bool>   bDecoded;
+};
+
+/**
+ *  A JSON String stored as a range of the source document. It's only copied,
+ *  and unescaped if needed, when converted to FString.
+ *
+ *  C++ code reading a document parsed with EJsonParseOptions::LazyStrings can
+ *  use Cast() on its String values to access the views below.
+ **/
+class BLUEPRINTJSON_API FJsonValueLazyString final : public FJsonValueTagged
+{
+public:
+    FJsonValueLazyString(FJsonSourceBufferRef InSource, const int32 InOffset, const int32 InLength, const bool bInHasEscapes);
+
+    virtual bool TryGetString(FString& OutString) const override;
+    virtual bool TryGetNumber(double& OutNumber) const override;
+    virtual bool TryGetBool(bool& OutBool) const override;
+
+    /* Returns true if the string contains escape sequences, in which case it can't be viewed in place. */
+    bool HasEscapes() const { return bHasEscapes; }
+
+    /* Returns the document the string is in. */
+    const FJsonSourceBuffer& GetSource() const { return *Source; }
+
+    /**
+     * Returns a view of the string in the source buffer, without allocating.
+     * Fails if the string has escape sequences or the source is UTF-8.
+     */
+    bool TryGetStringView(FStringView& OutView) const;
+
+    /**
+     * Returns a view of the string in the source buffer, without allocating.
+     * Fails if the string has escape sequences or the source isn't UTF-8.
+     */
+    bool TryGetUtf8StringView(FUtf8StringView& OutView) const;
+
+    /* Returns Value as a lazy string if it is one, null otherwise. */
+    static const FJsonValueLazyString* Cast(const FJsonValue* const Value);
+
+    /* Appends the unescaped body of a JSON string. The input must have been validated by the parser. */
+    static void AppendUnescaped(FStringView     Escaped, FString& OutString);
+    static void AppendUnescaped(FUtf8StringView Escaped, FString& OutString);
+
+protected:
+    virtual FString GetType() const override { return TEXT("String"); }
+
+private:
+    FJsonSourceBufferRef Source;
+    int32 Offset;
+    int32 Length;
+    bool  bHasEscapes;
+};
+
+/**
+ *  A JSON Object with few fields, stored flat instead of in a TMap: field values
+ *  in one insertion-ordered array and every field name back to back in another.
+ *  Lookups compare a tag made of the name's length and first characters against
+ *  all fields at once with SIMD, then check the full name of the candidates.
+ *  Names are case insensitive like FJsonObject's.
+ *
+ *  Engine code accessing it as an FJsonObject (AsObject, TryGetObject, FJsonSerializer)
+ *  gets a copy built on first access. That copy is then the object's content, so
+ *  modifications made through it are seen by every reader. It costs a TMap and a
+ *  FString per field on top of the flat storage, which is kept for the readers that
+ *  may still be walking it, so the plugin only goes through the API above and
+ *  writes text with FBlueprintJsonWriter rather than FJsonSerializer.
+ **/
+class BLUEPRINTJSON_API FJsonValueFlatObject final : public FJsonValueTagged
+{
+public:
+    /* Maximum number of fields of a flat object. Larger objects are hashed in a FJsonObject. */
+    static constexpr int32 MaxFlatFields = 16;
+
+    FJsonValueFlatObject();
+
+    /* Adds a field, or replaces the field with the same name. Returns false if the object is full. */
+    bool AddField(FStringView FieldName, const TSharedPtr<FJsonValue>& FieldValue);
+
+    /* Returns the value of the specified field, or null. */
+    TSharedPtr<FJsonValue> TryGetField(FStringView FieldName) const;
+
+    /* Returns the number of fields. */
+    int32 Num() const;
+
+    /* Calls Functor(FStringView Name, const TSharedPtr<FJsonValue>& Value) for each field, in insertion order. */
+    template<typename FunctorType>
+    void ForEachField(FunctorType&& Functor) const
+    {
+        if (const FJsonObject* const Object = GetMaterializedObject())
+        {
+            for (const auto& Field : Object->Values)
+            {
+                Functor(FStringView(Field.Key), Field.Value);
+            }
+            return;
+        }
+
+        for (const FField& Field : Fields)
+        {
+            Functor(GetFieldName(Field), Field.Value);
+        }
+    }
+
+    /**
+     * Returns the field at Cursor and advances it, without allocating. Cursor starts at 0
+     * and is only meant to be passed back. Returns false once every field has been visited.
+     */
+    bool NextField(int32& Cursor, FStringView& OutFieldName, TSharedPtr<FJsonValue>& OutFieldValue) const;
+
+    /* Same as above, for the fields of an FJsonObject. */
+    static bool NextField(const FJsonObject& Object, int32& Cursor, FStringView& OutFieldName, TSharedPtr<FJsonValue>& OutFieldValue);
+
+    /* Creates an FJsonObject holding the same fields. */
+    TSharedPtr<FJsonObject> ToJsonObject() const;
+
+    /* Returns the size of the fields and their names, and of the FJsonObject copy if it was created, values excluded. */
+    SIZE_T GetAllocatedSize() const;
+
+    /* Returns Value as a flat object if it is one, null otherwise. */
+    static const FJsonValueFlatObject* Cast(const FJsonValue* const Value);
+
+    virtual bool TryGetObject(const TSharedPtr<FJsonObject>*& OutObject) const override;
+
+protected:
+    virtual FString GetType() const override { return TEXT("Object"); }
+
+private:
+    struct FField
+    {
+        TSharedPtr<FJsonValue> Value;
+        int32 NameOffset;
+        int32 NameLength;
+    };
+
+    FStringView GetFieldName(const FField& Field) const
+    {
+        return FStringView(NameChars.GetData() + Field.NameOffset, Field.NameLength);
+    }
+
+    /* Returns the index of the field with the specified name, or INDEX_NONE. */
+    int32 FindFieldIndex(FStringView FieldName) const;
+
+    /* Returns the FJsonObject copy if it has been created. */
+    const FJsonObject* GetMaterializedObject() const;
+
+    static uint32 MakeTag(FStringView FieldName);
+
+    TArray<FField> Fields;
+    TArray<TCHAR>  NameChars;
+
+    /* Tag of each field, compared four at a time. */
+    alignas(16) uint32 Tags[MaxFlatFields];
+
+    mutable TSharedPtr<FJsonObject> Materialized;
+    mutable std::atomic<bool>       bMaterialized;
+    mutable UE::FMutex              MaterializeMutex;
+};
@@ -8,7 +8,9 @@
 #include "BlueprintJsonWrapper.generated.h"
 
 class UJsonObject;
+class UJsonArrayView;
 class FJsonValue;
+struct FLightJsonValue;
 class FJsonObject;
 
 UENUM(BlueprintType)
@@ -22,6 +24,30 @@ enum class EJsonType : uint8
     Object
 };
 
+/* Options changing how a JSON document is stored once parsed. */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EJsonParseOptions : uint8
+{
+    None        = 0 UMETA(Hidden),
+    /* Keep numbers as their source text and only decode them when read. Integers are decoded exactly. */
+    LazyNumbers = 1 << 0,
+    /* Keep strings as ranges of the source text and only copy and unescape them when read. */
+    LazyStrings = 1 << 1,
+    /* Store objects with few fields in flat arrays instead of hash maps. */
+    FlatObjects = 1 << 2
+};
+ENUM_CLASS_FLAGS(EJsonParseOptions);
+
+/* How vectors, rotators, quaternions, colors and transforms are written to JSON. */
+UENUM(BlueprintType)
+enum class EJsonMathEncoding : uint8
+{
+    /* Objects with named fields, e.g. {"X":1,"Y":2,"Z":3}. */
+    Object,
+    /* Fixed-length arrays of numbers, e.g. [1,2,3]. Transforms are [tx,ty,tz,qx,qy,qz,qw,sx,sy,sz]. */
+    Array
+};
+
 /* Associate a field name to its value. */
 USTRUCT(BlueprintType)
 struct BLUEPRINTJSON_API FJsonObjectField
@@ -52,6 +78,10 @@ class BLUEPRINTJSON_API UJsonValue : public UObject
 {
     GENERATED_BODY()
 public:
+    UJsonValue();
+
+    virtual void BeginDestroy() override;
+
     /* Returns if this value represents the Json Null value. */
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Value")
     UPARAM(DisplayName = "Is Null") bool IsNull();
@@ -76,49 +106,88 @@ public:
     TSharedPtr<FJsonValue> GetRawValue() const { return Value; }
 
     /* Creates a JSON value holding a Number */
-    static UJsonValue* CreateJsonValue(const int32          Value);
+    static UJsonValue* CreateJsonValue(const int32          Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
 
     /* Creates a JSON value holding a Number */
-    static UJsonValue* CreateJsonValue(const int64          Value);
+    static UJsonValue* CreateJsonValue(const int64          Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
 
     /* Creates a JSON value holding a Number */
-    static UJsonValue* CreateJsonValue(const float          Value);
+    static UJsonValue* CreateJsonValue(const float          Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
+
+    /* Creates a raw Number holding an int64 without losing precision above 2^53. */
+    static TSharedPtr<FJsonValue> MakeInteger64Value(const int64 Value);
+
+    /* Same as above, for uint64. */
+    static TSharedPtr<FJsonValue> MakeUInteger64Value(const uint64 Value);
 
     /* Creates a JSON value holding a Boolean */
-    static UJsonValue* CreateJsonValue(const bool           Value);
+    static UJsonValue* CreateJsonValue(const bool           Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
 
     /* Creates a JSON value holding a String */
-    static UJsonValue* CreateJsonValue(const FString&       Value);
+    static UJsonValue* CreateJsonValue(const FString&       Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
     static UJsonValue* CreateJsonValue(const FText&         Value) { return CreateJsonValue(Value.ToString()); }
     static UJsonValue* CreateJsonValue(const FName&         Value) { return CreateJsonValue(Value.ToString()); }
 
     /* Creates a JSON value holding a Vector */
-    static UJsonValue* CreateJsonValue(const FVector&       Value);
+    static UJsonValue* CreateJsonValue(const FVector&       Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
 
     /* Creates a JSON value holding a Vector2D */
-    static UJsonValue* CreateJsonValue(const FVector2D&     Value);
+    static UJsonValue* CreateJsonValue(const FVector2D&     Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
 
     /* Creates a JSON value holding a Rotator */
-    static UJsonValue* CreateJsonValue(const FRotator&      Value);
+    static UJsonValue* CreateJsonValue(const FRotator&      Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
 
     /* Creates a JSON value holding a Transform */
-    static UJsonValue* CreateJsonValue(const FTransform&    Value);
+    static UJsonValue* CreateJsonValue(const FTransform&    Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
 
     /* Creates a JSON value holding a LinearColor */
-    static UJsonValue* CreateJsonValue(const FLinearColor&  Value);
+    static UJsonValue* CreateJsonValue(const FLinearColor&  Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
 
     /* Creates a JSON value holding a Color */
-    static UJsonValue* CreateJsonValue(const FColor&        Value);
+    static UJsonValue* CreateJsonValue(const FColor&        Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
 
     /* Creates a JSON value holding a Quaternion */
-    static UJsonValue* CreateJsonValue(const FQuat&         Value);
+    static UJsonValue* CreateJsonValue(const FQuat&         Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
 
     /* Creates a JSON value holding a Hit Result*/
-    static UJsonValue* CreateJsonValue(const FHitResult&    Value);
+    static UJsonValue* CreateJsonValue(const FHitResult&    Value) { return CreateFromRaw(CreateRawJsonValue(Value)); }
 
     /* Creates a JSON value holding a UObject. Only UJsonValue and UJsonObject are supported. */
     static UJsonValue* CreateJsonValue(UObject* const       Value);
 
+    /* Raw versions of CreateJsonValue, they don't create a UJsonValue wrapper. */
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const int32          Value);
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const int64          Value);
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const float          Value);
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const bool           Value);
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const FString&       Value);
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const FText&         Value) { return CreateRawJsonValue(Value.ToString()); }
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const FName&         Value) { return CreateRawJsonValue(Value.ToString()); }
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const FVector&       Value, const EJsonMathEncoding Encoding = GetMathEncoding());
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const FVector2D&     Value, const EJsonMathEncoding Encoding = GetMathEncoding());
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const FRotator&      Value, const EJsonMathEncoding Encoding = GetMathEncoding());
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const FTransform&    Value, const EJsonMathEncoding Encoding = GetMathEncoding());
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const FLinearColor&  Value, const EJsonMathEncoding Encoding = GetMathEncoding());
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const FColor&        Value, const EJsonMathEncoding Encoding = GetMathEncoding());
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const FQuat&         Value, const EJsonMathEncoding Encoding = GetMathEncoding());
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(const FHitResult&    Value, const EJsonMathEncoding Encoding = GetMathEncoding());
+    static TSharedPtr<FJsonValue> CreateRawJsonValue(UObject* const       Value);
+
+    /* Reads a math type written with either encoding. Missing object fields keep OutValue's. */
+    static bool ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FVector&      OutValue);
+    static bool ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FVector2D&    OutValue);
+    static bool ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FRotator&     OutValue);
+    static bool ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FQuat&        OutValue);
+    static bool ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FLinearColor& OutValue);
+    static bool ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FColor&       OutValue);
+    static bool ReadRawJsonValue(const TSharedPtr<FJsonValue>& Value, FTransform&   OutValue);
+
+    /* Returns the encoding used when none is specified. Also set with the BlueprintJson.MathEncoding console variable. */
+    static EJsonMathEncoding GetMathEncoding();
+
+    /* Changes the encoding used when none is specified. */
+    static void SetMathEncoding(const EJsonMathEncoding Encoding);
+
     /* Used for custom nodes. Using CreateJsonValue is the same. */
     template<class T>
     FORCEINLINE static UJsonValue* CreateJsonValueTemplate(const T& Value)
@@ -134,6 +203,9 @@ private:
 /**
  *  Alternative API to access data with a smaller overhead, as it doesn't create
  *  UObject wrappers on the fly.
+ *
+ *  Copies share the same FJsonObject, so fields set through one are seen by all.
+ *  Setters called on an invalid object create an empty one first.
  **/
 USTRUCT(BlueprintType)
 struct BLUEPRINTJSON_API FLightJsonObject
@@ -150,6 +222,18 @@ public:
     FLightJsonObject& operator=(FLightJsonObject&&);
 
 public:
+    /* Creates an empty object. */
+    static FLightJsonObject Create();
+
+    /* Parses a document whose root is an object. Returns an invalid object and fills OutError on failure. */
+    static FLightJsonObject Parse(FString&& Json, const EJsonParseOptions Options = EJsonParseOptions::None, FString* const OutError = nullptr);
+
+    /* Returns false for a default constructed object or a failed parse. */
+    bool IsValid() const { return Object.IsValid(); }
+
+    /* Writes this object as JSON. Returns false if it is invalid. */
+    bool ToString(FString& OutJsonString) const;
+
     FString GetFieldAsString(const FString& FieldName) const;
     
     float GetFieldAsFloat(const FString& FieldName) const;
@@ -158,17 +242,143 @@ public:
     
     int64 GetFieldAsInt64(const FString& FieldName) const;
 
+    bool GetFieldAsBoolean(const FString& FieldName) const;
+
+    /* Reads a vector written with either math encoding. */
+    FVector GetFieldAsVector(const FString& FieldName) const;
+
     FLightJsonObject GetFieldAsObject(const FString& FieldName) const;
 
+    /* Returns the value of a field, invalid if there is none. */
+    FLightJsonValue GetFieldAsValue(const FString& FieldName) const;
+
     TArray<FLightJsonObject> GetFieldAsObjectArray(const FString& FieldName) const;
 
+    TArray<FLightJsonValue> GetFieldAsArray(const FString& FieldName) const;
+
     TArray<float> GetFieldAsFloatArray(const FString& FieldName) const;
 
+    TArray<int32> GetFieldAsInt32Array(const FString& FieldName) const;
+
+    TArray<FString> GetFieldAsStringArray(const FString& FieldName) const;
+
+    /**
+     * Returns the value at a path of field names and array indices separated by dots,
+     * e.g. "data.cargo.inventory[0].symbol". Invalid if a part of the path is missing.
+     */
+    FLightJsonValue GetValueAtPath(const FString& Path) const;
+
+    bool HasField(const FString& FieldName) const;
+
+    /* Returns true if the field is the JSON Null value or is missing. */
+    bool IsFieldNull(const FString& FieldName) const;
+
+    /* Returns the number of fields. */
+    int32 Num() const;
+
+    /* Returns the names of the fields, in insertion order. */
+    TArray<FString> GetFieldNames() const;
+
+    /**
+     * Returns the field at Cursor and advances it. Cursor starts at 0 and is only meant
+     * to be passed back. Returns false once every field has been visited.
+     */
+    bool NextField(int32& Cursor, FString& OutFieldName, FLightJsonValue& OutFieldValue) const;
+
+    void SetStringField(const FString& FieldName, const FString& FieldValue);
+
+    void SetIntegerField(const FString& FieldName, const int32 FieldValue);
+
+    /* Keeps integers above 2^53 exact. */
+    void SetInteger64Field(const FString& FieldName, const int64 FieldValue);
+
+    void SetFloatField(const FString& FieldName, const float FieldValue);
+
+    void SetBooleanField(const FString& FieldName, const bool FieldValue);
+
+    void SetObjectField(const FString& FieldName, const FLightJsonObject& FieldValue);
+
+    void SetArrayField(const FString& FieldName, const TArray<FLightJsonValue>& FieldValue);
+
+    void SetField(const FString& FieldName, const FLightJsonValue& FieldValue);
+
+    void SetNullField(const FString& FieldName);
+
+    /* Math types are written with the default encoding, see UJsonValue::GetMathEncoding(). */
+    void SetVectorField     (const FString& FieldName, const FVector&      FieldValue);
+    void SetVector2DField   (const FString& FieldName, const FVector2D&    FieldValue);
+    void SetRotatorField    (const FString& FieldName, const FRotator&     FieldValue);
+    void SetTransformField  (const FString& FieldName, const FTransform&   FieldValue);
+    void SetLinearColorField(const FString& FieldName, const FLinearColor& FieldValue);
+    void SetColorField      (const FString& FieldName, const FColor&       FieldValue);
+    void SetQuatField       (const FString& FieldName, const FQuat&        FieldValue);
+
+    /* Sets a raw field. */
+    void SetRawField(const FString& FieldName, const TSharedPtr<FJsonValue>& FieldValue);
+
+    /* Removes a field. Returns false if there was none. */
+    bool RemoveField(const FString& FieldName);
+
+    /* Returns the wrapped JSON object pointer */
+    const TSharedPtr<FJsonObject>& GetRawObject() const { return Object; }
+
 private:
     friend class UJsonObject;
     TSharedPtr<FJsonObject> Object;
 };
 
+/**
+ *  A JSON value without UObject wrapper, as yielded by For Each Field.
+ **/
+USTRUCT(BlueprintType)
+struct BLUEPRINTJSON_API FLightJsonValue
+{
+    GENERATED_BODY()
+public:
+    FLightJsonValue() = default;
+    FLightJsonValue(TSharedPtr<FJsonValue> InValue);
+
+public:
+    static FLightJsonValue MakeString(const FString& Value);
+    static FLightJsonValue MakeFloat(const float Value);
+    static FLightJsonValue MakeInteger64(const int64 Value);
+    static FLightJsonValue MakeBoolean(const bool Value);
+    static FLightJsonValue MakeObject(const FLightJsonObject& Value);
+    static FLightJsonValue MakeArray(const TArray<FLightJsonValue>& Values);
+    static FLightJsonValue MakeNull();
+
+    /* Returns false for a default constructed value or a missing field. */
+    bool IsValid() const { return Value.IsValid(); }
+
+    /* Returns true if the value is the JSON Null value or is invalid. */
+    bool IsNull() const;
+
+    EJsonType GetType() const;
+
+    FString AsString() const;
+
+    float AsFloat() const;
+
+    int32 AsInt32() const;
+
+    int64 AsInt64() const;
+
+    bool AsBool() const;
+
+    FLightJsonObject AsObject() const;
+
+    TArray<FLightJsonValue> AsArray() const;
+
+    /* Writes this value as JSON. Returns false if it is invalid. */
+    bool ToString(FString& OutJsonString) const;
+
+    /* Returns the wrapped JSON value pointer */
+    const TSharedPtr<FJsonValue>& GetRawValue() const { return Value; }
+
+private:
+    TSharedPtr<FJsonValue> Value;
+};
+
 /**
  *  A Json Object. Contains a list of fields.
  **/
@@ -179,10 +389,18 @@ class BLUEPRINTJSON_API UJsonObject : public UObject
 public:
     UJsonObject();
 
+    virtual void BeginDestroy() override;
+
     /* Parse JSON and construct a JSON object from it. */
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Object")
     static UPARAM(DisplayName = "Root JSON Object") UJsonObject* ParseJson(const FString& Json, UPARAM(DisplayName = "Is Valid JSON") bool& bSuccess);
 
+    /* Parse JSON with the specified options and construct a JSON object from it. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Object")
+    static UPARAM(DisplayName = "Root JSON Object") UJsonObject* ParseJsonWithOptions(const FString& Json, UPARAM(meta = (Bitmask, BitmaskEnum = "/Script/BlueprintJson.EJsonParseOptions")) int32 Options, UPARAM(DisplayName = "Is Valid JSON") bool& bSuccess);
+
+    static UJsonObject* ParseJson(FString&& Json, const EJsonParseOptions Options, bool& bSuccess);
+
     static UJsonObject* FromLightObject(const FLightJsonObject& InObject);
 
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Object")
@@ -200,9 +418,14 @@ public:
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Object")
     UPARAM(DisplayName = "Field Value") FVector GetFieldAsVector(const FString& FieldName);
 
+    /* Wraps every element of the array in a UJsonValue. GetFieldAsArrayView only wraps the elements read. */
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Object")
     UPARAM(DisplayName = "Field Value") TArray<UJsonValue*> GetFieldAsArray(const FString& FieldName);
 
+    /* Returns a view of the array, its elements are only wrapped when accessed. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Object")
+    UPARAM(DisplayName = "Field Value") UJsonArrayView* GetFieldAsArrayView(const FString& FieldName);
+
     UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Object")
     UPARAM(DisplayName = "Field Value") TArray<float> GetFieldAsFloatArray(const FString& FieldName);
 
@@ -310,20 +533,118 @@ public:
     /* Create a new UJsonObject from a raw FJsonObject. */
     static UJsonObject* CreateFromRaw(TSharedPtr<FJsonObject> RawObject);
 
-    /* Returns thie Object's raw pointer. */
-    TSharedPtr<FJsonObject> GetRawObject() { return Object; };
+    /* Create a new UJsonObject from a raw Object value, keeping flat objects flat. */
+    static UJsonObject* CreateFromRawValue(const TSharedPtr<FJsonValue>& RawValue);
+
+    /* Returns thie Object's raw pointer. A flat object is converted to FJsonObject first. */
+    TSharedPtr<FJsonObject> GetRawObject();
+
+    /* Returns this Object as a raw JSON value, without converting flat objects. */
+    TSharedPtr<FJsonValue> GetRawValue() const;
 
     /* Returns all the properties of this object. */
     UFUNCTION(BlueprintPure, Category = "JSON|Object")
     void GetAllProperties(UPARAM(DisplayName="Properties") TArray<FJsonObjectField>& OutValues) const;
 
+    /* Creates a JSON object from raw fields, its storage is sized for them up front. */
+    static UJsonObject* CreateFromRawFields(TArray<TPair<FString, TSharedPtr<FJsonValue>>>&& Fields);
+
+    /* Returns the raw value of the specified field, or null. Doesn't log when the field is missing. */
+    TSharedPtr<FJsonValue> FindField(const FString& FieldName) const;
+
     /* Sets a raw field without using a wrapper. */
     void SetRawField(const FString& FieldName, const TSharedPtr<FJsonValue> & FieldValue);
+
+    /**
+     * Returns the field at Cursor and advances it. Cursor starts at 0 and is only meant
+     * to be passed back. Returns false once every field has been visited.
+     */
+    bool NextField(int32& Cursor, FString& OutFieldName, TSharedPtr<FJsonValue>& OutFieldValue) const;
 private:
    
     static TSharedPtr<FJsonObject> ParseJsonInternal(const FString& Json, bool& bSuccess);
+    static TSharedPtr<FJsonValue>  ParseJsonInternal(FString&& Json, const EJsonParseOptions Options, bool& bSuccess);
 
     TSharedPtr<FJsonObject> Object;
+
+    /* Set instead of Object while this object is an unmodified FJsonValueFlatObject. */
+    TSharedPtr<FJsonValue> FlatObject;
+};
+
+/**
+ *  A read-only view of a JSON array or of a range of it. Elements are only wrapped
+ *  when accessed, so reading a few elements of a large array creates a few UObjects
+ *  instead of one per element. Slices share the array of their view.
+ **/
+UCLASS(BlueprintType)
+class BLUEPRINTJSON_API UJsonArrayView : public UObject
+{
+    GENERATED_BODY()
+public:
+    /* Creates a view of a raw Array value. Returns null if it isn't an Array. */
+    static UJsonArrayView* CreateFromRaw(const TSharedPtr<FJsonValue>& RawArray);
+
+    /* Returns the number of elements in the view. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Num") int32 Num() const { return NumElements; }
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Is Valid") bool IsValidIndex(const int32 Index) const { return Index >= 0 && Index < NumElements; }
+
+    /* Wraps the element at Index in a UJsonValue. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Element") UJsonValue* GetAt(const int32 Index) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Type") EJsonType GetTypeAt(const int32 Index) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Element") FString GetStringAt(const int32 Index) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Element") float GetFloatAt(const int32 Index) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Element") int32 GetIntegerAt(const int32 Index) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Element") int64 GetInteger64At(const int32 Index) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Element") bool GetBooleanAt(const int32 Index) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Element") UJsonObject* GetObjectAt(const int32 Index) const;
+
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Element") UJsonArrayView* GetArrayAt(const int32 Index) const;
+
+    /* Returns true if the element is the JSON Null value or is out of bounds. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Is Null") bool IsNullAt(const int32 Index) const;
+
+    /* Returns a view of Count elements from Start, clamped to this view. A negative Count goes to the end. */
+    UFUNCTION(BlueprintCallable, BlueprintPure, Category = "JSON|Array")
+    UPARAM(DisplayName = "Slice") UJsonArrayView* Slice(const int32 Start, const int32 Count = -1) const;
+
+    /* Wraps every element of the view in a UJsonValue, as GetFieldAsArray does. */
+    UFUNCTION(BlueprintCallable, Category = "JSON|Array")
+    UPARAM(DisplayName = "Elements") TArray<UJsonValue*> ToArray() const;
+
+    /* Returns the raw elements of the view. */
+    TConstArrayView<TSharedPtr<FJsonValue>> GetRawValues() const;
+
+    /* Returns the view as a raw Array value. The elements of a slice are copied to a new array. */
+    TSharedPtr<FJsonValue> GetRawValue() const;
+
+private:
+    /* Returns the element at Index, or null and logs if it is out of bounds. */
+    const FJsonValue* FindElement(const int32 Index) const;
+
+    TSharedPtr<FJsonValue> Array;
+
+    int32 First       = 0;
+    int32 NumElements = 0;
 };
 
 
@@ -0,0 +1,116 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintJsonValues.h"
+#include "Serialization/JsonWriter.h"
+
+/**
+ *  Writes the engine DOM as JSON text, with the same output as FJsonSerializer, but
+ *  walks the values of the plugin directly: flat objects are written from their
+ *  fields instead of through the FJsonObject copy FJsonSerializer would create and
+ *  keep in each of them, and lazy integers from their lexeme.
+ **/
+class FBlueprintJsonWriter
+{
+public:
+    /* Writes Object as the root of the document and closes Writer. */
+    template<typename PrintPolicyType>
+    static bool Serialize(const TSharedRef<FJsonObject>& Object, const TSharedRef<TJsonWriter<TCHAR, PrintPolicyType>>& Writer)
+    {
+        WriteObject(*Writer, *Object);
+        return Writer->Close();
+    }
+
+    /* Writes Value as the root of the document and closes Writer. */
+    template<typename PrintPolicyType>
+    static bool Serialize(const TSharedPtr<FJsonValue>& Value, const TSharedRef<TJsonWriter<TCHAR, PrintPolicyType>>& Writer)
+    {
+        WriteValue(*Writer, Value);
+        return Writer->Close();
+    }
+
+private:
+    template<typename WriterType>
+    static void WriteValue(WriterType& Writer, const TSharedPtr<FJsonValue>& Value)
+    {
+        if (!Value)
+        {
+            Writer.WriteNull();
+            return;
+        }
+
+        switch (Value->Type)
+        {
+        case EJson::Boolean:
+            Writer.WriteValue(Value->AsBool());
+            break;
+
+        case EJson::Number:
+        {
+            // Integers above 2^53 would be rounded by a double.
+            FString Lexeme;
+            if (Value->PreferStringRepresentation() && Value->TryGetString(Lexeme))
+            {
+                Writer.WriteRawJSONValue(Lexeme);
+            }
+            else
+            {
+                Writer.WriteValue(Value->AsNumber());
+            }
+            break;
+        }
+
+        case EJson::String:
+            Writer.WriteValue(Value->AsString());
+            break;
+
+        case EJson::Array:
+            Writer.WriteArrayStart();
+            for (const TSharedPtr<FJsonValue>& Element : Value->AsArray())
+            {
+                WriteValue(Writer, Element);
+            }
+            Writer.WriteArrayEnd();
+            break;
+
+        case EJson::Object:
+            if (const FJsonValueFlatObject* const FlatObject = FJsonValueFlatObject::Cast(Value.Get()))
+            {
+                Writer.WriteObjectStart();
+                FlatObject->ForEachField([&Writer](const FStringView FieldName, const TSharedPtr<FJsonValue>& FieldValue)
+                {
+                    Writer.WriteIdentifierPrefix(FString(FieldName));
+                    WriteValue(Writer, FieldValue);
+                });
+                Writer.WriteObjectEnd();
+            }
+            else if (const TSharedPtr<FJsonObject> Object = Value->AsObject())
+            {
+                WriteObject(Writer, *Object);
+            }
+            else
+            {
+                Writer.WriteNull();
+            }
+            break;
+
+        default:
+            Writer.WriteNull();
+            break;
+        }
+    }
+
+    template<typename WriterType>
+    static void WriteObject(WriterType& Writer, const FJsonObject& Object)
+    {
+        Writer.WriteObjectStart();
+        for (const auto& Field : Object.Values)
+        {
+            Writer.WriteIdentifierPrefix(Field.Key);
+            WriteValue(Writer, Field.Value);
+        }
+        Writer.WriteObjectEnd();
+    }
+};
@@ -0,0 +1,784 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#include "BlueprintJsonBenchmarkCommandlet.h"
+#include "BlueprintJson.h"
+#include "BlueprintJsonWrapper.h"
+#include "BlueprintJsonLibrary.h"
+#include "BlueprintJsonNodes.h"
+#include "BlueprintJsonParser.h"
+#include "HAL/MemoryBase.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+namespace
+{
+	/**
+	 * Forwards to the allocator and counts the allocations of every thread. The benchmark
+	 * installs it as GMalloc while it measures; blocks belong to the inner allocator, so
+	 * they can still be freed once it's removed.
+	 */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* const InInner)
+			: Inner(InInner)
+		{}
+
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+		{
+			CountAllocation(Size);
+			return Inner->Malloc(Size, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Size, uint32 Alignment) override
+		{
+			CountAllocation(Size);
+			return Inner->TryMalloc(Size, Alignment);
+		}
+
+		virtual void* MallocZeroed(SIZE_T Size, uint32 Alignment) override
+		{
+			CountAllocation(Size);
+			return Inner->MallocZeroed(Size, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+		{
+			CountAllocation(Size);
+			return Inner->Realloc(Original, Size, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Size, uint32 Alignment) override
+		{
+			CountAllocation(Size);
+			return Inner->TryRealloc(Original, Size, Alignment);
+		}
+
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+
+		virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override { return Inner->QuantizeSize(Size, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& OutSize) override { return Inner->GetAllocationSize(Original, OutSize); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+		FMalloc* GetInner() const { return Inner; }
+
+		std::atomic<int64> NumAllocations{ 0 };
+		std::atomic<int64> NumBytes{ 0 };
+
+	private:
+		void CountAllocation(const SIZE_T Size)
+		{
+			// Reallocating to 0 frees.
+			if (Size > 0)
+			{
+				NumAllocations.fetch_add(1, std::memory_order_relaxed);
+				NumBytes.fetch_add(static_cast<int64>(Size), std::memory_order_relaxed);
+			}
+		}
+
+		FMalloc* const Inner;
+	};
+
+	/* Installed while the benchmark runs, if bCountAllocations. */
+	FCountingMalloc* CountingMalloc = nullptr;
+
+	constexpr EJsonParseOptions AllParseOptions = EJsonParseOptions::LazyNumbers | EJsonParseOptions::LazyStrings | EJsonParseOptions::FlatObjects;
+
+	/* Wrappers are collected between the iterations of payloads above this size, or once that many were created. */
+	constexpr int32 CollectAfterBytes    = 1 << 20;
+	constexpr int64 CollectAfterWrappers = 100000;
+
+	struct FSample
+	{
+		double Seconds        = 0.;
+		int64  Allocations    = 0;
+		int64  AllocatedBytes = 0;
+		int64  Wrappers       = 0;
+	};
+
+	/* Times Func, with the allocations and the wrappers it made. */
+	template<typename FuncType>
+	FSample Measure(FuncType&& Func)
+	{
+		const int64 Allocations    = CountingMalloc ? CountingMalloc->NumAllocations.load(std::memory_order_relaxed) : 0;
+		const int64 AllocatedBytes = CountingMalloc ? CountingMalloc->NumBytes.load(std::memory_order_relaxed) : 0;
+		const int64 Wrappers       = FBlueprintJsonCounters::NumWrappersCreated.load(std::memory_order_relaxed);
+		const double StartTime     = FPlatformTime::Seconds();
+
+		Func();
+
+		FSample Sample;
+		Sample.Seconds  = FPlatformTime::Seconds() - StartTime;
+		Sample.Wrappers = FBlueprintJsonCounters::NumWrappersCreated.load(std::memory_order_relaxed) - Wrappers;
+		if (CountingMalloc)
+		{
+			Sample.Allocations    = CountingMalloc->NumAllocations.load(std::memory_order_relaxed) - Allocations;
+			Sample.AllocatedBytes = CountingMalloc->NumBytes.load(std::memory_order_relaxed) - AllocatedBytes;
+		}
+		return Sample;
+	}
+
+	struct FPayload
+	{
+		FString Name;
+		FString Json;
+		TArray<uint8> Utf8Json;
+		int32 Iterations = 1;
+
+		/* Parsed once for the cases reading or writing it. */
+		TStrongObjectPtr<UJsonObject> Object;
+		TSharedPtr<FJsonObject> RawObject;
+
+		/* If data is an array of systems, read by the access and array cases, and the sum of their symbol lengths and coordinates. */
+		bool  bSystems = false;
+		int64 Checksum = 0;
+
+		/* The x coordinates of the systems and waypoints, for the typed array cases. */
+		TStrongObjectPtr<UJsonObject> Coordinates;
+
+		/* The payload as a file for the async load, and where the async save writes. */
+		FString LoadPath;
+		FString SavePath;
+	};
+
+	double GetPercentile(const TArray<double>& SortedTimes, const double Percentile)
+	{
+		const int32 Index = FMath::CeilToInt32(Percentile / 100. * SortedTimes.Num()) - 1;
+		return SortedTimes[FMath::Clamp(Index, 0, SortedTimes.Num() - 1)];
+	}
+
+	FBlueprintJsonBenchmarkResult Summarize(const FString& Case, const FPayload& Payload, const TArray<FSample>& Samples)
+	{
+		FBlueprintJsonBenchmarkResult Result;
+		Result.Case       = Case;
+		Result.Payload    = Payload.Name;
+		Result.Bytes      = Payload.Utf8Json.Num();
+		Result.Iterations = Samples.Num();
+
+		if (Samples.Num() == 0)
+		{
+			return Result;
+		}
+
+		TArray<double> Times;
+		Times.Reserve(Samples.Num());
+
+		double TotalTime = 0.;
+		for (const FSample& Sample : Samples)
+		{
+			Times.Add(Sample.Seconds * 1000.);
+			TotalTime             += Sample.Seconds;
+			Result.Allocations    += Sample.Allocations;
+			Result.AllocatedBytes += Sample.AllocatedBytes;
+			Result.Wrappers       += Sample.Wrappers;
+		}
+		Times.Sort();
+
+		Result.MeanMs          = TotalTime * 1000. / Samples.Num();
+		Result.MedianMs        = GetPercentile(Times, 50.);
+		Result.P99Ms           = GetPercentile(Times, 99.);
+		Result.MinMs           = Times[0];
+		Result.Throughput      = TotalTime > 0. ? Result.Bytes * Samples.Num() / TotalTime / (1024. * 1024.) : 0.;
+		Result.Allocations    /= Samples.Num();
+		Result.AllocatedBytes /= Samples.Num();
+		Result.Wrappers       /= Samples.Num();
+
+		return Result;
+	}
+
+	/* Runs a few warm-up iterations then Iterations measured ones. Returns false if one of them failed. */
+	bool RunIterations(const FPayload& Payload, const int32 Iterations, TFunctionRef<bool(FSample&)> Iteration, TArray<FSample>& OutSamples)
+	{
+		const int32 NumWarmUp = FMath::Min(Iterations / 10, 10);
+		OutSamples.Reset(Iterations);
+
+		int64 WrappersSinceCollect = 0;
+		for (int32 Index = 0; Index < NumWarmUp + Iterations; ++Index)
+		{
+			FSample Sample;
+			if (!Iteration(Sample))
+			{
+				return false;
+			}
+
+			if (Index >= NumWarmUp)
+			{
+				OutSamples.Add(Sample);
+			}
+
+			// Collecting is kept out of the samples, the wrappers would otherwise pile up over the iterations.
+			WrappersSinceCollect += Sample.Wrappers;
+			if (WrappersSinceCollect >= CollectAfterWrappers || (WrappersSinceCollect > 0 && Payload.Utf8Json.Num() >= CollectAfterBytes))
+			{
+				CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+				WrappersSinceCollect = 0;
+			}
+		}
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		return true;
+	}
+
+	/* Repeats the systems of the medium payload until the document is at least Size bytes. */
+	FString MakeLargePayload(const FString& Medium, const int64 Size)
+	{
+		TSharedPtr<FJsonObject> Root;
+		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Medium);
+
+		const TArray<TSharedPtr<FJsonValue>>* Systems = nullptr;
+		if (!FJsonSerializer::Deserialize(Reader, Root) || !Root->TryGetArrayField(TEXT("data"), Systems) || Systems->Num() == 0)
+		{
+			return FString();
+		}
+
+		FString Chunk;
+		for (const TSharedPtr<FJsonValue>& System : *Systems)
+		{
+			FString SystemJson;
+			const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&SystemJson);
+			FJsonSerializer::Serialize(System->AsObject().ToSharedRef(), Writer);
+
+			if (!Chunk.IsEmpty())
+			{
+				Chunk += TEXT(',');
+			}
+			Chunk += SystemJson;
+		}
+
+		FString Large;
+		Large.Reserve(static_cast<int32>(Size) + Chunk.Len() + 64);
+		Large += TEXT("{\"data\":[");
+
+		int32 NumSystems = 0;
+		while (Large.Len() < Size)
+		{
+			if (NumSystems > 0)
+			{
+				Large += TEXT(',');
+			}
+			Large += Chunk;
+			NumSystems += Systems->Num();
+		}
+
+		Large += FString::Printf(TEXT("],\"meta\":{\"total\":%d,\"page\":1,\"limit\":%d}}"), NumSystems, NumSystems);
+		return Large;
+	}
+
+	int64 GetSystemsChecksum(const FJsonObject& Root)
+	{
+		int64 Sum = 0;
+		for (const TSharedPtr<FJsonValue>& SystemValue : Root.GetArrayField(TEXT("data")))
+		{
+			const TSharedPtr<FJsonObject>& System = SystemValue->AsObject();
+			Sum += System->GetStringField(TEXT("symbol")).Len() + System->GetIntegerField(TEXT("x")) + System->GetIntegerField(TEXT("y"));
+
+			for (const TSharedPtr<FJsonValue>& WaypointValue : System->GetArrayField(TEXT("waypoints")))
+			{
+				const TSharedPtr<FJsonObject>& Waypoint = WaypointValue->AsObject();
+				Sum += Waypoint->GetStringField(TEXT("symbol")).Len() + Waypoint->GetIntegerField(TEXT("x")) + Waypoint->GetIntegerField(TEXT("y"));
+			}
+		}
+		return Sum;
+	}
+
+	/* Parses the payload once and writes the file of the async load. */
+	bool PreparePayload(FPayload& Payload, const FString& WorkingDir)
+	{
+		const FTCHARToUTF8 Utf8(*Payload.Json);
+		Payload.Utf8Json = TArray<uint8>(reinterpret_cast<const uint8*>(Utf8.Get()), Utf8.Length());
+
+		bool bParsed = false;
+		Payload.Object.Reset(UJsonObject::ParseJson(Payload.Json, bParsed));
+		if (!bParsed || !Payload.Object)
+		{
+			UE_LOG(LogBlueprintJson, Error, TEXT("Failed to parse the %s payload."), *Payload.Name);
+			return false;
+		}
+		Payload.RawObject = Payload.Object->GetRawObject();
+
+		const TArray<TSharedPtr<FJsonValue>>* Systems = nullptr;
+		Payload.bSystems = Payload.RawObject->TryGetArrayField(TEXT("data"), Systems);
+		if (Payload.bSystems)
+		{
+			Payload.Checksum = GetSystemsChecksum(*Payload.RawObject);
+
+			TArray<TSharedPtr<FJsonValue>> X;
+			for (const TSharedPtr<FJsonValue>& System : *Systems)
+			{
+				X.Add(System->AsObject()->TryGetField(TEXT("x")));
+				for (const TSharedPtr<FJsonValue>& Waypoint : System->AsObject()->GetArrayField(TEXT("waypoints")))
+				{
+					X.Add(Waypoint->AsObject()->TryGetField(TEXT("x")));
+				}
+			}
+
+			Payload.Coordinates.Reset(UJsonObject::CreateJsonObject());
+			Payload.Coordinates->GetRawObject()->SetArrayField(TEXT("x"), MoveTemp(X));
+		}
+
+		Payload.LoadPath = FPaths::Combine(WorkingDir, Payload.Name + TEXT(".json"));
+		Payload.SavePath = FPaths::Combine(WorkingDir, Payload.Name + TEXT("-saved.json"));
+		if (!FFileHelper::SaveStringToFile(Payload.Json, *Payload.LoadPath))
+		{
+			UE_LOG(LogBlueprintJson, Error, TEXT("Failed to write %s."), *Payload.LoadPath);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool LoadCorpusFile(const FString& CorpusDir, const TCHAR* const FileName, FString& OutJson)
+	{
+		const FString FilePath = FPaths::Combine(CorpusDir, FileName);
+		if (!FFileHelper::LoadFileToString(OutJson, *FilePath))
+		{
+			UE_LOG(LogBlueprintJson, Error, TEXT("Failed to load %s, pass the directory of the corpus with -Corpus=."), *FilePath);
+			return false;
+		}
+		return true;
+	}
+
+	/* Loads small.json and medium.json from the corpus and builds the large payload from the latter. Payloads not in Filters are skipped, if any. */
+	bool LoadPayloads(const FString& CorpusDir, const int64 LargeSize, const TArray<FString>& Filters, TArray<FPayload>& OutPayloads)
+	{
+		const auto IsWanted = [&Filters](const TCHAR* const Name)
+		{
+			return Filters.Num() == 0 || Filters.Contains(Name);
+		};
+
+		FString Small;
+		FString Medium;
+		FString Large;
+
+		if (IsWanted(TEXT("small")) && !LoadCorpusFile(CorpusDir, TEXT("small.json"), Small))
+		{
+			return false;
+		}
+
+		if ((IsWanted(TEXT("medium")) || IsWanted(TEXT("large"))) && !LoadCorpusFile(CorpusDir, TEXT("medium.json"), Medium))
+		{
+			return false;
+		}
+
+		if (IsWanted(TEXT("large")))
+		{
+			Large = MakeLargePayload(Medium, LargeSize);
+			if (Large.IsEmpty())
+			{
+				UE_LOG(LogBlueprintJson, Error, TEXT("medium.json has no systems to build the large payload from."));
+				return false;
+			}
+		}
+
+		const auto AddPayload = [&OutPayloads, &IsWanted](const TCHAR* const Name, FString&& Json, const int32 Iterations)
+		{
+			if (IsWanted(Name))
+			{
+				FPayload& Payload = OutPayloads.AddDefaulted_GetRef();
+				Payload.Name       = Name;
+				Payload.Json       = MoveTemp(Json);
+				Payload.Iterations = Iterations;
+			}
+		};
+
+		AddPayload(TEXT("small"),  MoveTemp(Small),  2000);
+		AddPayload(TEXT("medium"), MoveTemp(Medium), 100);
+		AddPayload(TEXT("large"),  MoveTemp(Large),  3);
+
+		return true;
+	}
+}
+
+/* static */ FString FBlueprintJsonBenchmark::GetDefaultCorpusDir()
+{
+	return FPaths::Combine(FPaths::ProjectDir(), TEXT("Tools"), TEXT("BlueprintJsonBenchmark"), TEXT("Corpus"));
+}
+
+/* static */ bool FBlueprintJsonBenchmark::Run(const FBlueprintJsonBenchmarkSettings& Settings, TArray<FBlueprintJsonBenchmarkResult>& OutResults)
+{
+	const FString CorpusDir = Settings.CorpusDir.IsEmpty() ? GetDefaultCorpusDir() : Settings.CorpusDir;
+
+	TArray<FPayload> Payloads;
+	if (!LoadPayloads(CorpusDir, Settings.LargeSize, Settings.Payloads, Payloads))
+	{
+		return false;
+	}
+
+	const FString WorkingDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("BlueprintJson"), TEXT("Benchmark"));
+	for (FPayload& Payload : Payloads)
+	{
+		if (!PreparePayload(Payload, WorkingDir))
+		{
+			return false;
+		}
+	}
+
+	const TStrongObjectPtr<UBlueprintJsonBenchmarkAsyncListener> Listener(NewObject<UBlueprintJsonBenchmarkAsyncListener>());
+
+	if (Settings.bCountAllocations)
+	{
+		// Never deleted, other threads may still be inside it after it's removed.
+		CountingMalloc = new FCountingMalloc(GMalloc);
+		GMalloc = CountingMalloc;
+	}
+
+	bool bSuccess = true;
+
+	const auto RunCase = [&](const TCHAR* const Case, const FPayload& Payload, TFunctionRef<bool(FSample&)> Iteration)
+	{
+		if (Settings.Cases.Num() > 0 && !Settings.Cases.ContainsByPredicate([Case](const FString& Filter) { return FCString::Strnicmp(Case, *Filter, Filter.Len()) == 0; }))
+		{
+			return;
+		}
+
+		TArray<FSample> Samples;
+		if (!RunIterations(Payload, Settings.Iterations > 0 ? Settings.Iterations : Payload.Iterations, Iteration, Samples))
+		{
+			UE_LOG(LogBlueprintJson, Error, TEXT("%s failed on the %s payload."), Case, *Payload.Name);
+			bSuccess = false;
+			return;
+		}
+
+		const FBlueprintJsonBenchmarkResult& Result = OutResults.Add_GetRef(Summarize(Case, Payload, Samples));
+		UE_LOG(LogBlueprintJson, Display, TEXT("%-16s %-6s %5d x  mean %9.3fms  median %9.3fms  p99 %9.3fms  %8.1f MB/s  %10.0f allocations  %8.0f wrappers"),
+			Case, *Payload.Name, Result.Iterations, Result.MeanMs, Result.MedianMs, Result.P99Ms, Result.Throughput, Result.Allocations, Result.Wrappers);
+	};
+
+	for (FPayload& Payload : Payloads)
+	{
+		RunCase(TEXT("parse/serializer"), Payload, [&Payload](FSample& Sample)
+		{
+			bool bParsed = false;
+			Sample = Measure([&] { UJsonObject::ParseJson(Payload.Json, bParsed); });
+			return bParsed;
+		});
+
+		RunCase(TEXT("parse/options"), Payload, [&Payload](FSample& Sample)
+		{
+			FString Json = Payload.Json;
+			bool bParsed = false;
+			Sample = Measure([&] { UJsonObject::ParseJson(MoveTemp(Json), AllParseOptions, bParsed); });
+			return bParsed;
+		});
+
+		RunCase(TEXT("parse/utf8"), Payload, [&Payload](FSample& Sample)
+		{
+			TArray<uint8> Utf8Json = Payload.Utf8Json;
+			TSharedPtr<FJsonObject> Root;
+			Sample = Measure([&] { Root = FBlueprintJsonParser::ParseObject(MoveTemp(Utf8Json), AllParseOptions); });
+			return Root.IsValid();
+		});
+
+		RunCase(TEXT("stringify"), Payload, [&Payload](FSample& Sample)
+		{
+			FString Json;
+			bool bWritten = false;
+			Sample = Measure([&] { bWritten = UJsonLibrary::StringifyJsonObject(Payload.Object.Get(), Json); });
+			return bWritten;
+		});
+
+		RunCase(TEXT("async/load"), Payload, [&Listener, &Payload](FSample& Sample)
+		{
+			bool bLoaded = false;
+			Sample = Measure([&]
+			{
+				UJsonLoadAsyncFromFileProxy* const Proxy = UJsonLoadAsyncFromFileProxy::LoadJsonFileAsync(Payload.LoadPath);
+				Proxy->Success.AddDynamic(Listener.Get(), &UBlueprintJsonBenchmarkAsyncListener::OnAsyncLoaded);
+				Proxy->Failed.AddDynamic(Listener.Get(), &UBlueprintJsonBenchmarkAsyncListener::OnAsyncLoaded);
+				Proxy->Activate();
+				bLoaded = Listener->WaitForAsync();
+			});
+			return bLoaded;
+		});
+
+		RunCase(TEXT("async/save"), Payload, [&Listener, &Payload](FSample& Sample)
+		{
+			bool bSaved = false;
+			Sample = Measure([&]
+			{
+				UJsonSaveAsyncProxy* const Proxy = UJsonSaveAsyncProxy::SaveJsonToFileAsync(Payload.SavePath, Payload.Object.Get());
+				Proxy->Success.AddDynamic(Listener.Get(), &UBlueprintJsonBenchmarkAsyncListener::OnAsyncSaved);
+				Proxy->Failed.AddDynamic(Listener.Get(), &UBlueprintJsonBenchmarkAsyncListener::OnAsyncSaveFailed);
+				Proxy->Activate();
+				bSaved = Listener->WaitForAsync();
+			});
+			return bSaved;
+		});
+
+		if (!Payload.bSystems)
+		{
+			continue;
+		}
+
+		// Each access path reads the symbol and coordinates of every system and waypoint, their sum must match the checksum.
+		RunCase(TEXT("access/object"), Payload, [&Payload](FSample& Sample)
+		{
+			int64 Sum = 0;
+			Sample = Measure([&]
+			{
+				for (UJsonValue* const SystemValue : Payload.Object->GetFieldAsArrayExec(TEXT("data")))
+				{
+					UJsonObject* const System = UJsonLibrary::JsonValue_ToObject(SystemValue);
+					Sum += System->GetFieldAsString(TEXT("symbol")).Len() + System->GetFieldAsInteger(TEXT("x")) + System->GetFieldAsInteger(TEXT("y"));
+
+					for (UJsonValue* const WaypointValue : System->GetFieldAsArrayExec(TEXT("waypoints")))
+					{
+						UJsonObject* const Waypoint = UJsonLibrary::JsonValue_ToObject(WaypointValue);
+						Sum += Waypoint->GetFieldAsString(TEXT("symbol")).Len() + Waypoint->GetFieldAsInteger(TEXT("x")) + Waypoint->GetFieldAsInteger(TEXT("y"));
+					}
+				}
+			});
+			return Sum == Payload.Checksum;
+		});
+
+		RunCase(TEXT("access/light"), Payload, [&Payload](FSample& Sample)
+		{
+			const FLightJsonObject Root(Payload.RawObject);
+			int64 Sum = 0;
+			Sample = Measure([&]
+			{
+				for (const FLightJsonObject& System : Root.GetFieldAsObjectArray(TEXT("data")))
+				{
+					Sum += System.GetFieldAsString(TEXT("symbol")).Len() + System.GetFieldAsInt32(TEXT("x")) + System.GetFieldAsInt32(TEXT("y"));
+
+					for (const FLightJsonObject& Waypoint : System.GetFieldAsObjectArray(TEXT("waypoints")))
+					{
+						Sum += Waypoint.GetFieldAsString(TEXT("symbol")).Len() + Waypoint.GetFieldAsInt32(TEXT("x")) + Waypoint.GetFieldAsInt32(TEXT("y"));
+					}
+				}
+			});
+			return Sum == Payload.Checksum;
+		});
+
+		RunCase(TEXT("access/library"), Payload, [&Payload](FSample& Sample)
+		{
+			int64 Sum = 0;
+			Sample = Measure([&]
+			{
+				for (UJsonValue* const SystemValue : UJsonLibrary::JsonValue_ToArray(Payload.Object->GetFieldAsValue(TEXT("data"))))
+				{
+					UJsonObject* const System = UJsonLibrary::JsonValue_ToObject(SystemValue);
+					Sum += UJsonLibrary::JsonValue_ToString(System->GetFieldAsValue(TEXT("symbol"))).Len()
+						+ UJsonLibrary::JsonValue_ToInteger(System->GetFieldAsValue(TEXT("x")))
+						+ UJsonLibrary::JsonValue_ToInteger(System->GetFieldAsValue(TEXT("y")));
+
+					for (UJsonValue* const WaypointValue : UJsonLibrary::JsonValue_ToArray(System->GetFieldAsValue(TEXT("waypoints"))))
+					{
+						UJsonObject* const Waypoint = UJsonLibrary::JsonValue_ToObject(WaypointValue);
+						Sum += UJsonLibrary::JsonValue_ToString(Waypoint->GetFieldAsValue(TEXT("symbol"))).Len()
+							+ UJsonLibrary::JsonValue_ToInteger(Waypoint->GetFieldAsValue(TEXT("x")))
+							+ UJsonLibrary::JsonValue_ToInteger(Waypoint->GetFieldAsValue(TEXT("y")));
+					}
+				}
+			});
+			return Sum == Payload.Checksum;
+		});
+
+		RunCase(TEXT("array/values"), Payload, [&Payload](FSample& Sample)
+		{
+			int32 Num = 0;
+			Sample = Measure([&] { Num = Payload.Object->GetFieldAsArray(TEXT("data")).Num(); });
+			return Num > 0;
+		});
+
+		RunCase(TEXT("array/view"), Payload, [&Payload](FSample& Sample)
+		{
+			int32 Len = 0;
+			Sample = Measure([&]
+			{
+				const UJsonArrayView* const Systems = Payload.Object->GetFieldAsArrayView(TEXT("data"));
+				Len = Systems->GetObjectAt(Systems->Num() / 2)->GetFieldAsString(TEXT("symbol")).Len();
+			});
+			return Len > 0;
+		});
+
+		RunCase(TEXT("array/int32"), Payload, [&Payload](FSample& Sample)
+		{
+			int32 Num = 0;
+			Sample = Measure([&] { Num = Payload.Coordinates->GetFieldAsInt32Array(TEXT("x")).Num(); });
+			return Num > 0;
+		});
+
+		RunCase(TEXT("array/float"), Payload, [&Payload](FSample& Sample)
+		{
+			int32 Num = 0;
+			Sample = Measure([&] { Num = Payload.Coordinates->GetFieldAsFloatArray(TEXT("x")).Num(); });
+			return Num > 0;
+		});
+	}
+
+	if (CountingMalloc)
+	{
+		GMalloc = CountingMalloc->GetInner();
+		CountingMalloc = nullptr;
+	}
+
+	return bSuccess;
+}
+
+/* static */ bool FBlueprintJsonBenchmark::WriteResults(const FString& OutputPath, const FString& Label, const bool bAllocationsCounted, const TArray<FBlueprintJsonBenchmarkResult>& Results)
+{
+	const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("label"),         Label);
+	Root->SetStringField(TEXT("date"),          FDateTime::UtcNow().ToIso8601());
+	Root->SetStringField(TEXT("engine"),        FEngineVersion::Current().ToString());
+	Root->SetStringField(TEXT("configuration"), LexToString(FApp::GetBuildConfiguration()));
+	Root->SetStringField(TEXT("platform"),      ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+	Root->SetStringField(TEXT("cpu"),           FPlatformMisc::GetCPUBrand().TrimStartAndEnd());
+	Root->SetNumberField(TEXT("cores"),         FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+	Root->SetBoolField(TEXT("allocationsCounted"), bAllocationsCounted);
+
+	FString Csv = TEXT("case,payload,bytes,iterations,meanMs,medianMs,p99Ms,minMs,throughputMBps,allocations,allocatedBytes,wrappers\n");
+
+	TArray<TSharedPtr<FJsonValue>> Cases;
+	for (const FBlueprintJsonBenchmarkResult& Result : Results)
+	{
+		const TSharedRef<FJsonObject> Case = MakeShared<FJsonObject>();
+		Case->SetStringField(TEXT("case"),           Result.Case);
+		Case->SetStringField(TEXT("payload"),        Result.Payload);
+		Case->SetNumberField(TEXT("bytes"),          Result.Bytes);
+		Case->SetNumberField(TEXT("iterations"),     Result.Iterations);
+		Case->SetNumberField(TEXT("meanMs"),         Result.MeanMs);
+		Case->SetNumberField(TEXT("medianMs"),       Result.MedianMs);
+		Case->SetNumberField(TEXT("p99Ms"),          Result.P99Ms);
+		Case->SetNumberField(TEXT("minMs"),          Result.MinMs);
+		Case->SetNumberField(TEXT("throughputMBps"), Result.Throughput);
+		Case->SetNumberField(TEXT("allocations"),    Result.Allocations);
+		Case->SetNumberField(TEXT("allocatedBytes"), Result.AllocatedBytes);
+		Case->SetNumberField(TEXT("wrappers"),       Result.Wrappers);
+		Cases.Add(MakeShared<FJsonValueObject>(Case));
+
+		Csv += FString::Printf(TEXT("%s,%s,%lld,%d,%.4f,%.4f,%.4f,%.4f,%.2f,%.1f,%.1f,%.1f\n"),
+			*Result.Case, *Result.Payload, Result.Bytes, Result.Iterations, Result.MeanMs, Result.MedianMs, Result.P99Ms, Result.MinMs,
+			Result.Throughput, Result.Allocations, Result.AllocatedBytes, Result.Wrappers);
+	}
+	Root->SetArrayField(TEXT("results"), MoveTemp(Cases));
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, Writer);
+
+	return FFileHelper::SaveStringToFile(Json, *(OutputPath + TEXT(".json")))
+		&& FFileHelper::SaveStringToFile(Csv, *(OutputPath + TEXT(".csv")));
+}
+
+UBlueprintJsonBenchmarkCommandlet::UBlueprintJsonBenchmarkCommandlet()
+{
+	IsClient     = false;
+	IsServer     = false;
+	IsEditor     = false;
+	LogToConsole = true;
+}
+
+int32 UBlueprintJsonBenchmarkCommandlet::Main(const FString& Params)
+{
+	FString Label = FDateTime::Now().ToString();
+	FParse::Value(*Params, TEXT("Label="), Label);
+
+	FString OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("BlueprintJson"), TEXT("Benchmark-") + Label);
+	if (FParse::Value(*Params, TEXT("Output="), OutputPath))
+	{
+		OutputPath = FPaths::GetBaseFilename(OutputPath, false);
+	}
+
+	FBlueprintJsonBenchmarkSettings Settings;
+	FParse::Value(*Params, TEXT("Corpus="), Settings.CorpusDir);
+
+	FString CasesParam;
+	if (FParse::Value(*Params, TEXT("Cases="), CasesParam, false))
+	{
+		CasesParam.ParseIntoArray(Settings.Cases, TEXT(","));
+	}
+
+	FString PayloadsParam;
+	if (FParse::Value(*Params, TEXT("Payloads="), PayloadsParam, false))
+	{
+		PayloadsParam.ParseIntoArray(Settings.Payloads, TEXT(","));
+	}
+
+	FParse::Value(*Params, TEXT("Iterations="), Settings.Iterations);
+
+	int32 LargeSize = 100;
+	FParse::Value(*Params, TEXT("LargeSize="), LargeSize);
+	Settings.LargeSize = static_cast<int64>(FMath::Clamp(LargeSize, 1, 1024)) << 20;
+
+	Settings.bCountAllocations = !FParse::Param(*Params, TEXT("NoAllocationCount"));
+
+	TArray<FBlueprintJsonBenchmarkResult> Results;
+	const bool bSuccess = FBlueprintJsonBenchmark::Run(Settings, Results);
+	if (Results.Num() == 0)
+	{
+		return 1;
+	}
+
+	if (!FBlueprintJsonBenchmark::WriteResults(OutputPath, Label, Settings.bCountAllocations, Results))
+	{
+		UE_LOG(LogBlueprintJson, Error, TEXT("Failed to write %s.json and .csv."), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogBlueprintJson, Display, TEXT("Wrote %d results to %s.json and .csv."), Results.Num(), *OutputPath);
+	return bSuccess ? 0 : 1;
+}
+
+void UBlueprintJsonBenchmarkAsyncListener::OnAsyncLoaded(UJsonObject* JsonObject)
+{
+	if (JsonObject)
+	{
+		++NumAsyncCompleted;
+	}
+	else
+	{
+		++NumAsyncFailed;
+	}
+}
+
+void UBlueprintJsonBenchmarkAsyncListener::OnAsyncSaved()
+{
+	++NumAsyncCompleted;
+}
+
+void UBlueprintJsonBenchmarkAsyncListener::OnAsyncSaveFailed()
+{
+	++NumAsyncFailed;
+}
+
+bool UBlueprintJsonBenchmarkAsyncListener::WaitForAsync()
+{
+	constexpr double Timeout = 120.;
+
+	// The nodes complete on the game thread, which is this one.
+	NumAsyncCompleted = 0;
+	NumAsyncFailed    = 0;
+
+	const double StartTime = FPlatformTime::Seconds();
+	while (NumAsyncCompleted == 0 && NumAsyncFailed == 0)
+	{
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+		if (FPlatformTime::Seconds() - StartTime > Timeout)
+		{
+			UE_LOG(LogBlueprintJson, Error, TEXT("The async node didn't complete in %.0f seconds."), Timeout);
+			return false;
+		}
+		FPlatformProcess::YieldThread();
+	}
+
+	return NumAsyncFailed == 0;
+}
@@ -0,0 +1,109 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BlueprintJsonBenchmarkCommandlet.generated.h"
+
+class UJsonObject;
+
+/* What a run of the benchmark measures. */
+struct FBlueprintJsonBenchmarkSettings
+{
+    /* Directory of small.json and medium.json, Tools/BlueprintJsonBenchmark/Corpus by default. */
+    FString CorpusDir;
+
+    /* Prefixes of the cases to run, e.g. "parse" or "access/light". Every case if empty. */
+    TArray<FString> Cases;
+
+    /* Payloads to run among small, medium and large. Every payload if empty. */
+    TArray<FString> Payloads;
+
+    /* Measured iterations of each case, 0 to use the default of each payload. */
+    int32 Iterations = 0;
+
+    /* Size of the large payload, in bytes. */
+    int64 LargeSize = 100ll << 20;
+
+    /* Replaces GMalloc while measuring to count the allocations of each iteration. */
+    bool bCountAllocations = true;
+};
+
+/* Summary of the iterations of a case. Times are in milliseconds, counts are per iteration. */
+struct FBlueprintJsonBenchmarkResult
+{
+    FString Case;
+    FString Payload;
+    int64  Bytes          = 0;
+    int32  Iterations     = 0;
+    double MeanMs         = 0.;
+    double MedianMs       = 0.;
+    double P99Ms          = 0.;
+    double MinMs          = 0.;
+    double Throughput     = 0.;
+    double Allocations    = 0.;
+    double AllocatedBytes = 0.;
+    double Wrappers       = 0.;
+};
+
+/* The cases of the benchmark, run by the commandlet and the BlueprintJson.Perf automation tests. Game thread only. */
+class FBlueprintJsonBenchmark
+{
+public:
+    /* Runs the cases on the payloads. Returns false if a payload can't be loaded or a case failed, the results of the others are still added. */
+    static bool Run(const FBlueprintJsonBenchmarkSettings& Settings, TArray<FBlueprintJsonBenchmarkResult>& OutResults);
+
+    /* Writes Results to OutputPath.json and OutputPath.csv. */
+    static bool WriteResults(const FString& OutputPath, const FString& Label, const bool bAllocationsCounted, const TArray<FBlueprintJsonBenchmarkResult>& Results);
+
+    static FString GetDefaultCorpusDir();
+};
+
+/**
+ *  Measures the JSON layer over the corpus of Tools/BlueprintJsonBenchmark: parsing, field access
+ *  through UJsonObject, FLightJsonObject and the library, array extraction, stringify and the
+ *  async load and save nodes, on a small, a medium and a 100 MB payload.
+ *
+ *  UnrealEditor-Cmd SpaceTraders.uproject -run=BlueprintJsonBenchmark -unattended -nullrhi
+ *      [-Label=Name] [-Output=Path] [-Corpus=Dir] [-Cases=parse,access,...] [-Payloads=small,medium,large]
+ *      [-Iterations=N] [-LargeSize=MB] [-NoAllocationCount]
+ *
+ *  Writes Output.json and Output.csv, Saved/BlueprintJson/Benchmark-{Label} by default, with the mean,
+ *  median and p99 time, the throughput and the allocations per iteration of each case, so the files
+ *  of two branches can be compared.
+ *
+ *  Lives in the editor module so it never ships: counting allocations replaces GMalloc.
+ **/
+UCLASS()
+class UBlueprintJsonBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+public:
+    UBlueprintJsonBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
+
+/* Receives the completion of the async nodes the async cases measure. */
+UCLASS(Transient)
+class UBlueprintJsonBenchmarkAsyncListener final : public UObject
+{
+    GENERATED_BODY()
+public:
+    UFUNCTION()
+    void OnAsyncLoaded(UJsonObject* JsonObject);
+
+    UFUNCTION()
+    void OnAsyncSaved();
+
+    UFUNCTION()
+    void OnAsyncSaveFailed();
+
+    /* Runs the tasks of the game thread until the pending async node completes. Returns false if it failed. */
+    bool WaitForAsync();
+
+private:
+    int32 NumAsyncCompleted = 0;
+    int32 NumAsyncFailed = 0;
+};
@@ -6,6 +6,12 @@
 #include "BlueprintActionDatabaseRegistrar.h"
 #include "BlueprintNodeSpawner.h"
 #include "K2Node_CallFunction.h"
+#include "K2Node_TemporaryVariable.h"
+#include "K2Node_AssignmentStatement.h"
+#include "K2Node_IfThenElse.h"
+#include "K2Node_ExecutionSequence.h"
+#include "K2Node_MakeArray.h"
+#include "Kismet2/BlueprintEditorUtils.h"
 
 #include "BlueprintJsonWrapper.h"
 #include "BlueprintJsonLibrary.h"
@@ -19,8 +25,10 @@ struct FPinName
     AddEntry(FieldValue, "FieldValue");
     AddEntry(FieldName,  "FieldName");
     AddEntry(JsonObject, "JsonObject");
-    AddEntry(ForBody,    "Loopr Body");
+    AddEntry(LoopBody,   "Loop Body");
     AddEntry(Completed,  "Completed");
+    AddEntry(FieldNames, "FieldNames");
+    AddEntry(Found,      "Found");
 
 #undef AddEntry
 };
@@ -176,6 +184,18 @@ bool UK2Node_AddFieldToJsonObject::IsValidValueType(const UEdGraphPin* const Pin
 {
     const FName & PinType = Pin->PinType.PinCategory;
 
+    // Maps are added as objects, their values are converted whatever their type.
+    if (Pin->PinType.IsMap())
+    {
+        if (PinType != UEdGraphSchema_K2::PC_String && PinType != UEdGraphSchema_K2::PC_Name)
+        {
+            OutReason = TEXT("Map keys must be String or Name.");
+            return false;
+        }
+        OutReason = TEXT("Add Map field as an Object.");
+        return true;
+    }
+
     if (PinType == UEdGraphSchema_K2::PC_Object && Pin->PinType.PinSubCategoryObject.IsValid())
     {
         const FString & ObjectName = Pin->PinType.PinSubCategoryObject->GetName();
@@ -256,9 +276,17 @@ void UK2Node_AddFieldToJsonObject::ExpandNode(FKismetCompilerContext& CompilerCo
     
     CompilerContext.MessageLog.NotifyIntermediateObjectCreation(CallFunction, this);
 
+    UEdGraphPin* const InternalValuePin = CallFunction->FindPinChecked(FPinName::FieldValue());
+
+    // The generic Set and Map pins take the type of the value.
+    if (FieldValuePin->PinType.IsSet() || FieldValuePin->PinType.IsMap())
+    {
+        InternalValuePin->PinType = FieldValuePin->PinType;
+    }
+
     CompilerContext.MovePinLinksToIntermediate(*GetJsonObjectPin(), *CallFunction->FindPinChecked(FPinName::JsonObject()));
     CompilerContext.MovePinLinksToIntermediate(*GetFieldNamePin (), *CallFunction->FindPinChecked(FPinName::FieldName()));
-    CompilerContext.MovePinLinksToIntermediate(*GetFieldValuePin(), *CallFunction->FindPinChecked(FPinName::FieldValue()));
+    CompilerContext.MovePinLinksToIntermediate(*FieldValuePin,      *InternalValuePin);
 
     UEdGraphPin* const NodeExec = GetExecPin();
     UEdGraphPin* const NodeThen = FindPin(UEdGraphSchema_K2::PN_Then);
@@ -287,10 +315,20 @@ UFunction* UK2Node_AddFieldToJsonObject::GetMatchingFunction(FKismetCompilerCont
         FunctionName += TEXT("Arr_");
     }
 
-    else if (PinType.IsSet() || PinType.IsMap())
+    // Sets and Maps use generic functions converting each element from its property.
+    else if (PinType.IsSet())
     {
-        CompilerContext.MessageLog.Error(TEXT("Add Field to JSON Object: Set and Map aren't supported at the moment."));
-        return nullptr;
+        return UInternalJsonLibrary::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UInternalJsonLibrary, JO_AddField_Set));
+    }
+
+    else if (PinType.IsMap())
+    {
+        if (PinType.PinCategory != UEdGraphSchema_K2::PC_String && PinType.PinCategory != UEdGraphSchema_K2::PC_Name)
+        {
+            CompilerContext.MessageLog.Error(TEXT("Add Field to JSON Object: Map keys must be String or Name."));
+            return nullptr;
+        }
+        return UInternalJsonLibrary::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UInternalJsonLibrary, JO_AddField_Map));
     }
 
     if (PinType.PinCategory == UEdGraphSchema_K2::PC_Wildcard)
@@ -334,60 +372,7 @@ UFunction* UK2Node_AddFieldToJsonObject::GetMatchingFunction(FKismetCompilerCont
 
 #undef LOCTEXT_NAMESPACE
 
-/*#define LOCTEXT_NAMESPACE "UK2_BlueprintJson_AddFieldToJsonObject"
-
-class FKCHandler_JsonObjectLoop : public FNodeHandlingFunctor
-{
-public:
-    FKCHandler_JsonObjectLoop(FKismetCompilerContext& InCompilerContext)
-        : FNodeHandlingFunctor(InCompilerContext)
-    {}
-
-    virtual void Compile(FKismetFunctionContext& Context, UEdGraphNode* Node) override
-    {
-        // Find the valid, connected output pins, and add them to the processing list
-        UEdGraphPin* BodyPin      = nullptr;
-        UEdGraphPin* CompletedPin = nullptr;
-
-        for (const auto& Pin : Node->Pins)
-        {
-            if (Pin->GetName() == FPinName::ForBody().ToString())
-            {
-                BodyPin = Pin;
-            }
-            else if (Pin->GetName() == FPinName::Completed().ToString())
-            {
-                CompletedPin = BodyPin;
-            }
-        }
-
-        if (!BodyPin || !CompletedPin)
-        {
-            CompilerContext.MessageLog.Error(TEXT("Failed to get pins."));
-            return;
-        }
-        
-        if (BodyPin->LinkedTo.Num() < 1)
-        {
-            // Immediately jump to the end
-            FBlueprintCompiledStatement& NextExecutionState = Context.AppendStatementForNode(Node);
-            NextExecutionState.Type = KCST_UnconditionalGoto;
-            Context.GotoFixupRequestMap.Add(&NextExecutionState, CompletedPin);
-        }
-        else
-        {            
-            FBlueprintCompiledStatement& PushExecutionState = Context.AppendStatementForNode(Node);
-            PushExecutionState.Type = KCST_PushState;
-            Context.GotoFixupRequestMap.Add(&PushExecutionState, CompletedPin);
-
-            // Immediately jump to the first pin
-            UEdGraphNode* const NextNode = BodyPin->LinkedTo[0]->GetOwningNode();
-            FBlueprintCompiledStatement& NextExecutionState = Context.AppendStatementForNode(Node);
-            NextExecutionState.Type = KCST_UnconditionalGoto;
-            Context.GotoFixupRequestMap.Add(&NextExecutionState, BodyPin);
-        }
-    }
-};
+#define LOCTEXT_NAMESPACE "UK2_BlueprintJson_ForEachFieldJsonObject"
 
 UEdGraphPin* UK2Node_ForEachFieldJsonObject::GetJsonObjectPin()
 {
@@ -406,7 +391,7 @@ UEdGraphPin* UK2Node_ForEachFieldJsonObject::GetFieldValuePin()
 
 UEdGraphPin* UK2Node_ForEachFieldJsonObject::GetLoopBodyPin()
 {
-    return FindPinChecked(FPinName::ForBody());
+    return FindPinChecked(FPinName::LoopBody());
 }
 
 UEdGraphPin* UK2Node_ForEachFieldJsonObject::GetCompletedPin()
@@ -419,7 +404,7 @@ FLinearColor UK2Node_ForEachFieldJsonObject::GetNodeTitleColor() const
     return FLinearColor::White;
 }
 
-void  UK2Node_ForEachFieldJsonObject::GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const
+void UK2Node_ForEachFieldJsonObject::GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const
 {
     Super::GetMenuActions(ActionRegistrar);
 
@@ -432,16 +417,16 @@ void  UK2Node_ForEachFieldJsonObject::GetMenuActions(FBlueprintActionDatabaseReg
     }
 }
 
-void  UK2Node_ForEachFieldJsonObject::AllocateDefaultPins()
+void UK2Node_ForEachFieldJsonObject::AllocateDefaultPins()
 {
     // Inputs
     CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Execute);
     CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Object, UJsonObject::StaticClass(), FPinName::JsonObject());
 
     // Outputs
-    CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec,   FPinName::ForBody());
+    CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec,   FPinName::LoopBody());
     CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_String, FPinName::FieldName());
-    CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Object, UJsonValue::StaticClass(), FPinName::FieldValue());
+    CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Struct, FLightJsonValue::StaticStruct(), FPinName::FieldValue());
     CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec,   FPinName::Completed());
 
     Super::AllocateDefaultPins();
@@ -454,34 +439,405 @@ FText UK2Node_ForEachFieldJsonObject::GetMenuCategory() const
 
 FText UK2Node_ForEachFieldJsonObject::GetNodeTitle(ENodeTitleType::Type TitleType) const
 {
-    return LOCTEXT("UK2_BlueprintJson_ForEachFieldJsonObject_NodeTitle", "For each JSON Object field");
+    return LOCTEXT("UK2_BlueprintJson_ForEachFieldJsonObject_NodeTitle", "For Each Field in JSON Object");
 }
 
 FText UK2Node_ForEachFieldJsonObject::GetTooltipText() const
 {
-    return LOCTEXT("UK2_BlueprintJson_ForEachFieldJsonObject_Tooltip", "Iterate over all this object's properties.");
+    return LOCTEXT("UK2_BlueprintJson_ForEachFieldJsonObject_Tooltip", "Iterate over all this object's fields, one at a time.");
 }
 
-void  UK2Node_ForEachFieldJsonObject::PinDefaultValueChanged(UEdGraphPin* const Pin)
+void UK2Node_ForEachFieldJsonObject::ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
 {
-    Super::PinDefaultValueChanged(Pin);
+    Super::ExpandNode(CompilerContext, SourceGraph);
+
+    const UEdGraphSchema_K2* const Schema = CompilerContext.GetSchema();
+
+    UFunction* const NextFieldFunction = UInternalJsonLibrary::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UInternalJsonLibrary, JO_NextField));
+    if (!NextFieldFunction)
+    {
+        CompilerContext.MessageLog.Error(TEXT("For Each Field in JSON Object: Function not found."));
+        return;
+    }
+
+    // Cursor = 0
+    UK2Node_TemporaryVariable* const CursorNode = CompilerContext.SpawnIntermediateNode<UK2Node_TemporaryVariable>(this, SourceGraph);
+    CursorNode->VariableType.PinCategory = UEdGraphSchema_K2::PC_Int;
+    CursorNode->AllocateDefaultPins();
+    UEdGraphPin* const CursorPin = CursorNode->GetVariablePin();
+
+    UK2Node_AssignmentStatement* const InitCursorNode = CompilerContext.SpawnIntermediateNode<UK2Node_AssignmentStatement>(this, SourceGraph);
+    InitCursorNode->AllocateDefaultPins();
+    InitCursorNode->GetValuePin()->DefaultValue = TEXT("0");
+
+    bool bResult = Schema->TryCreateConnection(CursorPin, InitCursorNode->GetVariablePin());
+    CompilerContext.MovePinLinksToIntermediate(*GetExecPin(), *InitCursorNode->GetExecPin());
+
+    // while (JO_NextField(JsonObject, Cursor, FieldName, FieldValue))
+    UK2Node_CallFunction* const NextFieldNode = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+    NextFieldNode->SetFromFunction(NextFieldFunction);
+    NextFieldNode->AllocateDefaultPins();
+    CompilerContext.MessageLog.NotifyIntermediateObjectCreation(NextFieldNode, this);
+
+    bResult &= Schema->TryCreateConnection(InitCursorNode->GetThenPin(), NextFieldNode->GetExecPin());
+    bResult &= Schema->TryCreateConnection(CursorPin, NextFieldNode->FindPinChecked(TEXT("Cursor")));
+
+    CompilerContext.MovePinLinksToIntermediate(*GetJsonObjectPin(), *NextFieldNode->FindPinChecked(FPinName::JsonObject()));
+    CompilerContext.MovePinLinksToIntermediate(*GetFieldNamePin(),  *NextFieldNode->FindPinChecked(FPinName::FieldName()));
+    CompilerContext.MovePinLinksToIntermediate(*GetFieldValuePin(), *NextFieldNode->FindPinChecked(FPinName::FieldValue()));
+
+    UK2Node_IfThenElse* const BranchNode = CompilerContext.SpawnIntermediateNode<UK2Node_IfThenElse>(this, SourceGraph);
+    BranchNode->AllocateDefaultPins();
+
+    bResult &= Schema->TryCreateConnection(NextFieldNode->GetThenPin(), BranchNode->GetExecPin());
+    bResult &= Schema->TryCreateConnection(NextFieldNode->GetReturnValuePin(), BranchNode->GetConditionPin());
+
+    // Run the body, then fetch the next field.
+    UK2Node_ExecutionSequence* const SequenceNode = CompilerContext.SpawnIntermediateNode<UK2Node_ExecutionSequence>(this, SourceGraph);
+    SequenceNode->AllocateDefaultPins();
+
+    bResult &= Schema->TryCreateConnection(BranchNode->GetThenPin(), SequenceNode->GetExecPin());
+    bResult &= Schema->TryCreateConnection(SequenceNode->GetThenPinGivenIndex(1), NextFieldNode->GetExecPin());
+
+    CompilerContext.MovePinLinksToIntermediate(*GetLoopBodyPin(),  *SequenceNode->GetThenPinGivenIndex(0));
+    CompilerContext.MovePinLinksToIntermediate(*GetCompletedPin(), *BranchNode->GetElsePin());
+
+    if (!bResult)
+    {
+        CompilerContext.MessageLog.Error(TEXT("For Each Field in JSON Object: Failed to expand @@."), this);
+    }
+
+    BreakAllNodeLinks();
 }
 
-void  UK2Node_ForEachFieldJsonObject::NotifyPinConnectionListChanged(UEdGraphPin* Pin)
+#undef LOCTEXT_NAMESPACE
+
+FEdGraphPinType FJsonFieldPin::GetPinType() const
 {
-    Super::NotifyPinConnectionListChanged(Pin);
+    FEdGraphPinType PinType;
+
+    switch (Type)
+    {
+    case EJsonFieldPinType::Boolean:   PinType.PinCategory = UEdGraphSchema_K2::PC_Boolean; break;
+    case EJsonFieldPinType::Integer:   PinType.PinCategory = UEdGraphSchema_K2::PC_Int;     break;
+    case EJsonFieldPinType::Integer64: PinType.PinCategory = UEdGraphSchema_K2::PC_Int64;   break;
+    case EJsonFieldPinType::Float:
+        PinType.PinCategory    = UEdGraphSchema_K2::PC_Real;
+        PinType.PinSubCategory = UEdGraphSchema_K2::PC_Double;
+        break;
+    case EJsonFieldPinType::String:    PinType.PinCategory = UEdGraphSchema_K2::PC_String;  break;
+    case EJsonFieldPinType::Name:      PinType.PinCategory = UEdGraphSchema_K2::PC_Name;    break;
+    case EJsonFieldPinType::Text:      PinType.PinCategory = UEdGraphSchema_K2::PC_Text;    break;
+    case EJsonFieldPinType::Vector:
+        PinType.PinCategory          = UEdGraphSchema_K2::PC_Struct;
+        PinType.PinSubCategoryObject = TBaseStructure<FVector>::Get();
+        break;
+    case EJsonFieldPinType::Rotator:
+        PinType.PinCategory          = UEdGraphSchema_K2::PC_Struct;
+        PinType.PinSubCategoryObject = TBaseStructure<FRotator>::Get();
+        break;
+    case EJsonFieldPinType::LinearColor:
+        PinType.PinCategory          = UEdGraphSchema_K2::PC_Struct;
+        PinType.PinSubCategoryObject = TBaseStructure<FLinearColor>::Get();
+        break;
+    case EJsonFieldPinType::JsonObject:
+        PinType.PinCategory          = UEdGraphSchema_K2::PC_Object;
+        PinType.PinSubCategoryObject = UJsonObject::StaticClass();
+        break;
+    case EJsonFieldPinType::JsonValue:
+        PinType.PinCategory          = UEdGraphSchema_K2::PC_Object;
+        PinType.PinSubCategoryObject = UJsonValue::StaticClass();
+        break;
+    case EJsonFieldPinType::LightJsonObject:
+        PinType.PinCategory          = UEdGraphSchema_K2::PC_Struct;
+        PinType.PinSubCategoryObject = FLightJsonObject::StaticStruct();
+        break;
+    case EJsonFieldPinType::LightJsonValue:
+        PinType.PinCategory          = UEdGraphSchema_K2::PC_Struct;
+        PinType.PinSubCategoryObject = FLightJsonValue::StaticStruct();
+        break;
+    }
+
+    return PinType;
 }
 
-void  UK2Node_ForEachFieldJsonObject::ReallocatePinsDuringReconstruction(TArray<UEdGraphPin*>& OldPins)
+/* static */ void FJsonFieldPin::ValidateFields(const TArray<FJsonFieldPin>& Fields, const TArray<FName>& ReservedNames, const UK2Node* const Node, FCompilerResultsLog& MessageLog)
 {
-    Super::ReallocatePinsDuringReconstruction(OldPins);
+    TSet<FString> Names;
+    for (const FJsonFieldPin& Field : Fields)
+    {
+        if (Field.FieldName.IsEmpty())
+        {
+            MessageLog.Warning(TEXT("@@ has a field without name, it's ignored."), Node);
+            continue;
+        }
+
+        bool bAlreadyInSet = false;
+        Names.Add(Field.FieldName, &bAlreadyInSet);
+
+        if (bAlreadyInSet || ReservedNames.Contains(FName(*Field.FieldName)))
+        {
+            MessageLog.Error(*FString::Printf(TEXT("@@: field name %s is duplicated or reserved."), *Field.FieldName), Node);
+        }
+    }
+}
+
+/* static */ void FJsonFieldPin::SpawnFieldNamesArray(const TArray<FJsonFieldPin>& Fields, UEdGraphPin* const ArrayPin, UK2Node* const Node, FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
+{
+    TArray<const FString*> Names;
+    for (const FJsonFieldPin& Field : Fields)
+    {
+        if (!Field.FieldName.IsEmpty())
+        {
+            Names.Add(&Field.FieldName);
+        }
+    }
+
+    UK2Node_MakeArray* const MakeArray = CompilerContext.SpawnIntermediateNode<UK2Node_MakeArray>(Node, SourceGraph);
+    MakeArray->NumInputs = Names.Num();
+    MakeArray->AllocateDefaultPins();
+    CompilerContext.MessageLog.NotifyIntermediateObjectCreation(MakeArray, Node);
+
+    UEdGraphPin* const ArrayOut = MakeArray->GetOutputPin();
+    ArrayOut->MakeLinkTo(ArrayPin);
+    MakeArray->PinConnectionListChanged(ArrayOut);
+
+    for (int32 Index = 0; Index < Names.Num(); ++Index)
+    {
+        MakeArray->FindPinChecked(FString::Printf(TEXT("[%d]"), Index))->DefaultValue = *Names[Index];
+    }
+}
+
+#define LOCTEXT_NAMESPACE "UK2_BlueprintJson_BreakJsonObject"
+
+UEdGraphPin* UK2Node_BreakJsonObject::GetJsonObjectPin()
+{
+    return FindPinChecked(FPinName::JsonObject());
+}
+
+UEdGraphPin* UK2Node_BreakJsonObject::GetFoundPin()
+{
+    return FindPinChecked(FPinName::Found());
 }
 
-FNodeHandlingFunctor* UK2Node_ForEachFieldJsonObject::CreateNodeHandler(FKismetCompilerContext& CompilerContext) const
+FLinearColor UK2Node_BreakJsonObject::GetNodeTitleColor() const
 {
-    return new FKCHandler_JsonObjectLoop(CompilerContext);
+    return FLinearColor(1.f, 0.7f, 0.f);
 }
 
+FText UK2Node_BreakJsonObject::GetMenuCategory() const
+{
+    return LOCTEXT("UK2_BlueprintJson_BreakJsonObject_MenuCategory", "JSON");
+}
+
+FText UK2Node_BreakJsonObject::GetNodeTitle(ENodeTitleType::Type TitleType) const
+{
+    return LOCTEXT("UK2_BlueprintJson_BreakJsonObject_Title", "Break JSON Object");
+}
+
+FText UK2Node_BreakJsonObject::GetTooltipText() const
+{
+    return LOCTEXT("UK2_BlueprintJson_BreakJsonObject_Tooltip", "Read several fields of a JSON object at once. Add the fields in the details panel.\nFound is false if a field is missing or of the wrong type.");
+}
+
+void UK2Node_BreakJsonObject::GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const
+{
+    Super::GetMenuActions(ActionRegistrar);
+
+    UClass* const Action = GetClass();
+    if (ActionRegistrar.IsOpenForRegistration(Action))
+    {
+        UBlueprintNodeSpawner* const Spawner = UBlueprintNodeSpawner::Create(GetClass());
+        check(Spawner != nullptr);
+        ActionRegistrar.AddBlueprintAction(Action, Spawner);
+    }
+}
+
+void UK2Node_BreakJsonObject::AllocateDefaultPins()
+{
+    CreatePin(EGPD_Input,  UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Execute);
+    CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Then);
 
-#undef LOCTEXT_NAMEPSACE
-*/
+    CreatePin(EGPD_Input,  UEdGraphSchema_K2::PC_Object,  UJsonObject::StaticClass(), FPinName::JsonObject());
+    CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Boolean, FPinName::Found());
+
+    for (const FJsonFieldPin& Field : Fields)
+    {
+        if (!Field.FieldName.IsEmpty())
+        {
+            CreatePin(EGPD_Output, Field.GetPinType(), *Field.FieldName);
+        }
+    }
+
+    Super::AllocateDefaultPins();
+}
+
+void UK2Node_BreakJsonObject::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    ReconstructNode();
+    FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(GetBlueprint());
+}
+
+void UK2Node_BreakJsonObject::ValidateNodeDuringCompilation(FCompilerResultsLog& MessageLog) const
+{
+    Super::ValidateNodeDuringCompilation(MessageLog);
+
+    FJsonFieldPin::ValidateFields(Fields, { FPinName::JsonObject(), FPinName::Found(), UEdGraphSchema_K2::PN_Execute, UEdGraphSchema_K2::PN_Then }, this, MessageLog);
+}
+
+void UK2Node_BreakJsonObject::ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
+{
+    Super::ExpandNode(CompilerContext, SourceGraph);
+
+    UFunction* const Function = UInternalJsonLibrary::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UInternalJsonLibrary, JO_BreakFields));
+    if (!Function)
+    {
+        CompilerContext.MessageLog.Error(TEXT("Break JSON Object: Function not found."));
+        return;
+    }
+
+    UK2Node_CallFunction* const CallFunction = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+    CallFunction->SetFromFunction(Function);
+    CallFunction->AllocateDefaultPins();
+    CompilerContext.MessageLog.NotifyIntermediateObjectCreation(CallFunction, this);
+
+    // Names are passed as an array, followed by one variadic output per name.
+    FJsonFieldPin::SpawnFieldNamesArray(Fields, CallFunction->FindPinChecked(FPinName::FieldNames()), this, CompilerContext, SourceGraph);
+
+    for (const FJsonFieldPin& Field : Fields)
+    {
+        if (!Field.FieldName.IsEmpty())
+        {
+            UEdGraphPin* const FieldPin    = FindPinChecked(*Field.FieldName, EGPD_Output);
+            UEdGraphPin* const VariadicPin = CallFunction->CreatePin(EGPD_Output, FieldPin->PinType, FieldPin->PinName);
+
+            CompilerContext.MovePinLinksToIntermediate(*FieldPin, *VariadicPin);
+        }
+    }
+
+    CompilerContext.MovePinLinksToIntermediate(*GetJsonObjectPin(), *CallFunction->FindPinChecked(FPinName::JsonObject()));
+    CompilerContext.MovePinLinksToIntermediate(*GetFoundPin(),      *CallFunction->GetReturnValuePin());
+    CompilerContext.MovePinLinksToIntermediate(*GetExecPin(),       *CallFunction->GetExecPin());
+    CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(UEdGraphSchema_K2::PN_Then), *CallFunction->GetThenPin());
+
+    BreakAllNodeLinks();
+}
+
+#undef LOCTEXT_NAMESPACE
+
+#define LOCTEXT_NAMESPACE "UK2_BlueprintJson_MakeJsonObject"
+
+UEdGraphPin* UK2Node_MakeJsonObject::GetJsonObjectPin()
+{
+    return FindPinChecked(FPinName::JsonObject());
+}
+
+FLinearColor UK2Node_MakeJsonObject::GetNodeTitleColor() const
+{
+    return FLinearColor(1.f, 0.7f, 0.f);
+}
+
+FText UK2Node_MakeJsonObject::GetMenuCategory() const
+{
+    return LOCTEXT("UK2_BlueprintJson_MakeJsonObject_MenuCategory", "JSON");
+}
+
+FText UK2Node_MakeJsonObject::GetNodeTitle(ENodeTitleType::Type TitleType) const
+{
+    return LOCTEXT("UK2_BlueprintJson_MakeJsonObject_Title", "Make JSON Object");
+}
+
+FText UK2Node_MakeJsonObject::GetTooltipText() const
+{
+    return LOCTEXT("UK2_BlueprintJson_MakeJsonObject_Tooltip", "Create a JSON object with several fields at once. Add the fields in the details panel.");
+}
+
+void UK2Node_MakeJsonObject::GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const
+{
+    Super::GetMenuActions(ActionRegistrar);
+
+    UClass* const Action = GetClass();
+    if (ActionRegistrar.IsOpenForRegistration(Action))
+    {
+        UBlueprintNodeSpawner* const Spawner = UBlueprintNodeSpawner::Create(GetClass());
+        check(Spawner != nullptr);
+        ActionRegistrar.AddBlueprintAction(Action, Spawner);
+    }
+}
+
+void UK2Node_MakeJsonObject::AllocateDefaultPins()
+{
+    const UEdGraphSchema_K2* const K2Schema = GetDefault<UEdGraphSchema_K2>();
+
+    CreatePin(EGPD_Input,  UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Execute);
+    CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec, UEdGraphSchema_K2::PN_Then);
+
+    for (const FJsonFieldPin& Field : Fields)
+    {
+        if (!Field.FieldName.IsEmpty())
+        {
+            UEdGraphPin* const FieldPin = CreatePin(EGPD_Input, Field.GetPinType(), *Field.FieldName);
+            K2Schema->SetPinAutogeneratedDefaultValueBasedOnType(FieldPin);
+        }
+    }
+
+    CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Object, UJsonObject::StaticClass(), FPinName::JsonObject());
+
+    Super::AllocateDefaultPins();
+}
+
+void UK2Node_MakeJsonObject::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    ReconstructNode();
+    FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(GetBlueprint());
+}
+
+void UK2Node_MakeJsonObject::ValidateNodeDuringCompilation(FCompilerResultsLog& MessageLog) const
+{
+    Super::ValidateNodeDuringCompilation(MessageLog);
+
+    FJsonFieldPin::ValidateFields(Fields, { FPinName::JsonObject(), UEdGraphSchema_K2::PN_Execute, UEdGraphSchema_K2::PN_Then }, this, MessageLog);
+}
+
+void UK2Node_MakeJsonObject::ExpandNode(FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
+{
+    Super::ExpandNode(CompilerContext, SourceGraph);
+
+    UFunction* const Function = UInternalJsonLibrary::StaticClass()->FindFunctionByName(GET_FUNCTION_NAME_CHECKED(UInternalJsonLibrary, JO_MakeObject));
+    if (!Function)
+    {
+        CompilerContext.MessageLog.Error(TEXT("Make JSON Object: Function not found."));
+        return;
+    }
+
+    UK2Node_CallFunction* const CallFunction = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(this, SourceGraph);
+    CallFunction->SetFromFunction(Function);
+    CallFunction->AllocateDefaultPins();
+    CompilerContext.MessageLog.NotifyIntermediateObjectCreation(CallFunction, this);
+
+    // Names are passed as an array, followed by one variadic input per name.
+    FJsonFieldPin::SpawnFieldNamesArray(Fields, CallFunction->FindPinChecked(FPinName::FieldNames()), this, CompilerContext, SourceGraph);
+
+    for (const FJsonFieldPin& Field : Fields)
+    {
+        if (!Field.FieldName.IsEmpty())
+        {
+            UEdGraphPin* const FieldPin    = FindPinChecked(*Field.FieldName, EGPD_Input);
+            UEdGraphPin* const VariadicPin = CallFunction->CreatePin(EGPD_Input, FieldPin->PinType, FieldPin->PinName);
+
+            CompilerContext.MovePinLinksToIntermediate(*FieldPin, *VariadicPin);
+        }
+    }
+
+    CompilerContext.MovePinLinksToIntermediate(*GetJsonObjectPin(), *CallFunction->GetReturnValuePin());
+    CompilerContext.MovePinLinksToIntermediate(*GetExecPin(),       *CallFunction->GetExecPin());
+    CompilerContext.MovePinLinksToIntermediate(*FindPinChecked(UEdGraphSchema_K2::PN_Then), *CallFunction->GetThenPin());
+
+    BreakAllNodeLinks();
+}
+
+#undef LOCTEXT_NAMESPACE
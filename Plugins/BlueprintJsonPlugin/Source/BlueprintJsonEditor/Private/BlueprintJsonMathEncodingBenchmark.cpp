@@ -0,0 +1,83 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#include "BlueprintJson.h"
+#include "BlueprintJsonWrapper.h"
+#include "BlueprintJsonParser.h"
+#include "BlueprintJsonWriter.h"
+#include "HAL/IConsoleManager.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+/* Lives in the editor module with the benchmark commandlet so it never ships in game builds. */
+
+namespace
+{
+	/* Writes Count transforms in the specified encoding, then reads them back, and logs the size and timings. */
+	void BenchmarkMathEncoding(const int32 Count, const EJsonMathEncoding Encoding)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		TArray<TSharedPtr<FJsonValue>> Transforms;
+		Transforms.Reserve(Count);
+
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const FTransform Transform(FRotator(i * 0.5, i * 0.25, i * 0.125), FVector(i, i * 2.0, i * 3.0), FVector(1.0 + i % 3));
+			Transforms.Emplace(UJsonValue::CreateRawJsonValue(Transform, Encoding));
+		}
+
+		const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetArrayField(TEXT("transforms"), MoveTemp(Transforms));
+
+		const double BuildTime = FPlatformTime::Seconds();
+
+		FString Json;
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+		FBlueprintJsonWriter::Serialize(Root, Writer);
+
+		const double WriteTime = FPlatformTime::Seconds();
+		const int32  JsonLength = Json.Len();
+
+		const TSharedPtr<FJsonObject> Parsed = FBlueprintJsonParser::ParseObject(MoveTemp(Json), EJsonParseOptions::None);
+
+		const double ParseTime = FPlatformTime::Seconds();
+
+		int32 ReadCount = 0;
+		const TArray<TSharedPtr<FJsonValue>>* ParsedTransforms = nullptr;
+		if (Parsed && Parsed->TryGetArrayField(TEXT("transforms"), ParsedTransforms))
+		{
+			for (const TSharedPtr<FJsonValue>& Value : *ParsedTransforms)
+			{
+				FTransform Transform;
+				ReadCount += UJsonValue::ReadRawJsonValue(Value, Transform) ? 1 : 0;
+			}
+		}
+
+		const double ReadTime = FPlatformTime::Seconds();
+
+		UE_LOG(LogBlueprintJson, Display, TEXT("%s encoding: %d transforms, %d characters (%.1f per transform). Build %.2fms, write %.2fms, parse %.2fms, read %.2fms (%d read)."),
+			Encoding == EJsonMathEncoding::Array ? TEXT("Array") : TEXT("Object"),
+			Count, JsonLength, Count > 0 ? static_cast<double>(JsonLength) / Count : 0.0,
+			(BuildTime - StartTime) * 1000.0, (WriteTime - BuildTime) * 1000.0,
+			(ParseTime - WriteTime) * 1000.0, (ReadTime - ParseTime) * 1000.0, ReadCount);
+	}
+}
+
+static FAutoConsoleCommand CmdBenchmarkMathEncoding(
+	TEXT("BlueprintJson.BenchmarkMathEncoding"),
+	TEXT("Compares the size and speed of the Object and Array math encodings on transforms.\n")
+	TEXT("Usage: BlueprintJson.BenchmarkMathEncoding [Count=10000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		int32 Count = 10000;
+		if (Args.Num() > 0)
+		{
+			LexFromString(Count, *Args[0]);
+		}
+		Count = FMath::Max(Count, 1);
+
+		BenchmarkMathEncoding(Count, EJsonMathEncoding::Object);
+		BenchmarkMathEncoding(Count, EJsonMathEncoding::Array);
+	}));
@@ -0,0 +1,55 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#include "BlueprintJsonBenchmarkCommandlet.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+/**
+ *  The cases of the BlueprintJsonBenchmark commandlet on the small and medium payloads, with fewer
+ *  iterations, so they can run on every change, e.g. headless on Linux:
+ *
+ *  UnrealEditor-Cmd SpaceTraders.uproject -ExecCmds="Automation RunTests BlueprintJson.Perf; Quit" -unattended -nullrhi
+ *
+ *  A test fails if its payload can't be loaded or a case reads the wrong values. The timings are
+ *  reported as telemetry of the test.
+ **/
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FBlueprintJsonPerfTest, "BlueprintJson.Perf", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+void FBlueprintJsonPerfTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	OutBeautifiedNames.Add(TEXT("Small"));
+	OutTestCommands.Add(TEXT("small"));
+
+	OutBeautifiedNames.Add(TEXT("Medium"));
+	OutTestCommands.Add(TEXT("medium"));
+}
+
+bool FBlueprintJsonPerfTest::RunTest(const FString& Parameters)
+{
+	FBlueprintJsonBenchmarkSettings Settings;
+	Settings.Payloads.Add(Parameters);
+	Settings.Iterations = Parameters == TEXT("small") ? 200 : 10;
+
+	// GMalloc isn't replaced in an editor that keeps running after the tests.
+	Settings.bCountAllocations = false;
+
+	TArray<FBlueprintJsonBenchmarkResult> Results;
+	const bool bSuccess = FBlueprintJsonBenchmark::Run(Settings, Results);
+
+	for (const FBlueprintJsonBenchmarkResult& Result : Results)
+	{
+		AddInfo(FString::Printf(TEXT("%s: mean %.3fms, median %.3fms, p99 %.3fms, %.1f MB/s, %.0f wrappers."),
+			*Result.Case, Result.MeanMs, Result.MedianMs, Result.P99Ms, Result.Throughput, Result.Wrappers));
+
+		AddTelemetryData(Result.Case + TEXT(" Median Ms"), Result.MedianMs, Result.Payload);
+		AddTelemetryData(Result.Case + TEXT(" P99 Ms"),    Result.P99Ms,    Result.Payload);
+	}
+
+	TestTrue(TEXT("Every case completed with the expected values"), bSuccess);
+	TestTrue(TEXT("Cases were run"), Results.Num() > 0);
+
+	return bSuccess;
+}
+
+#endif
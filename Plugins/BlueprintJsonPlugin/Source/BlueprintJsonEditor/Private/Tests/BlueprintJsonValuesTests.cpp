@@ -0,0 +1,148 @@
+// Copyright Pandores Marketplace 2021. All Rights Reserved.
+
+#include "BlueprintJsonValues.h"
+#include "BlueprintJsonParser.h"
+#include "BlueprintJsonWrapper.h"
+#include "BlueprintJsonWriter.h"
+#include "Misc/AutomationTest.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	FString StringifyCondensed(const TSharedRef<FJsonObject>& Object)
+	{
+		FString Json;
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+		FJsonSerializer::Serialize(Object, Writer);
+		return Json;
+	}
+
+	FString StringifyCondensed(const TSharedPtr<FJsonValue>& Value)
+	{
+		FString Json;
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+		FBlueprintJsonWriter::Serialize(Value, Writer);
+		return Json;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintJsonLazyNumberRoundTripTest, "BlueprintJson.Values.LazyNumberRoundTrip", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FBlueprintJsonLazyNumberRoundTripTest::RunTest(const FString& Parameters)
+{
+	// 2^53 + 1, the first integer a double can't hold.
+	const TSharedPtr<FJsonObject> Root = FBlueprintJsonParser::ParseObject(TEXT("{\"id\":9007199254740993,\"ratio\":0.5}"), EJsonParseOptions::LazyNumbers);
+	if (!TestTrue(TEXT("Document parsed"), Root.IsValid()))
+	{
+		return false;
+	}
+
+	const TSharedPtr<FJsonValue> Id = Root->TryGetField(TEXT("id"));
+	TestNotNull(TEXT("Integer parsed as a lazy number"), FJsonValueLazyNumber::Cast(Id.Get()));
+
+	int64 IdValue = 0;
+	TestTrue(TEXT("Integer decoded"), Id.IsValid() && Id->TryGetNumber(IdValue));
+	TestEqual(TEXT("Integer decoded exactly"), IdValue, 9007199254740993ll);
+
+	TestEqual(TEXT("Round trip through FJsonSerializer"), StringifyCondensed(Root.ToSharedRef()), FString(TEXT("{\"id\":9007199254740993,\"ratio\":0.5}")));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintJsonUInteger64Test, "BlueprintJson.Values.UInteger64", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FBlueprintJsonUInteger64Test::RunTest(const FString& Parameters)
+{
+	TestEqual(TEXT("2^53 written as a number"), StringifyCondensed(UJsonValue::MakeUInteger64Value(1ull << 53)), FString(TEXT("9007199254740992")));
+	TestEqual(TEXT("MAX_uint64 written exactly"), StringifyCondensed(UJsonValue::MakeUInteger64Value(MAX_uint64)), FString(TEXT("18446744073709551615")));
+
+	uint64 Number = 0;
+	TestTrue(TEXT("MAX_uint64 read"), UJsonValue::MakeUInteger64Value(MAX_uint64)->TryGetNumber(Number));
+	TestEqual(TEXT("MAX_uint64 read exactly"), Number, MAX_uint64);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintJsonValueCastTest, "BlueprintJson.Values.Cast", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FBlueprintJsonValueCastTest::RunTest(const FString& Parameters)
+{
+	const TSharedPtr<FJsonValue> Root = FBlueprintJsonParser::ParseValue(TEXT("{\"n\":1,\"s\":\"a\"}"),
+		EJsonParseOptions::LazyNumbers | EJsonParseOptions::LazyStrings | EJsonParseOptions::FlatObjects);
+	if (!TestTrue(TEXT("Document parsed"), Root.IsValid()))
+	{
+		return false;
+	}
+
+	const FJsonValueFlatObject* const Flat = FJsonValueFlatObject::Cast(Root.Get());
+	if (!TestNotNull(TEXT("Root is flat"), Flat))
+	{
+		return false;
+	}
+
+	TestNotNull(TEXT("Lazy number"), FJsonValueLazyNumber::Cast(Flat->TryGetField(TEXT("n")).Get()));
+	TestNotNull(TEXT("Lazy string"), FJsonValueLazyString::Cast(Flat->TryGetField(TEXT("s")).Get()));
+
+	// Engine values of the same type are never taken for the plugin's.
+	const TSharedRef<FJsonValue> Number       = MakeShared<FJsonValueNumber>(1.);
+	const TSharedRef<FJsonValue> NumberString = MakeShared<FJsonValueNumberString>(TEXT("1"));
+	const TSharedRef<FJsonValue> String       = MakeShared<FJsonValueString>(TEXT("a"));
+	const TSharedRef<FJsonValue> Object       = MakeShared<FJsonValueObject>(MakeShared<FJsonObject>());
+
+	TestNull(TEXT("FJsonValueNumber"),       FJsonValueLazyNumber::Cast(&Number.Get()));
+	TestNull(TEXT("FJsonValueNumberString"), FJsonValueLazyNumber::Cast(&NumberString.Get()));
+	TestNull(TEXT("FJsonValueString"),       FJsonValueLazyString::Cast(&String.Get()));
+	TestNull(TEXT("FJsonValueObject"),       FJsonValueFlatObject::Cast(&Object.Get()));
+	TestNull(TEXT("Null value"),             FJsonValueFlatObject::Cast(nullptr));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlueprintJsonFlatMathObjectTest, "BlueprintJson.Values.FlatMathObject", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FBlueprintJsonFlatMathObjectTest::RunTest(const FString& Parameters)
+{
+	const TSharedPtr<FJsonValue> Vector = UJsonValue::CreateRawJsonValue(FVector(1., 2., 3.), EJsonMathEncoding::Object);
+	const FJsonValueFlatObject* const FlatVector = FJsonValueFlatObject::Cast(Vector.Get());
+	if (!TestNotNull(TEXT("Vector is flat"), FlatVector))
+	{
+		return false;
+	}
+
+	const SIZE_T AllocatedSize = FlatVector->GetAllocatedSize();
+	TestEqual(TEXT("Vector written"), StringifyCondensed(Vector), FString(TEXT("{\"X\":1,\"Y\":2,\"Z\":3}")));
+	TestEqual(TEXT("Writing doesn't create the FJsonObject copy"), FlatVector->GetAllocatedSize(), AllocatedSize);
+
+	FVector VectorValue = FVector::ZeroVector;
+	TestTrue(TEXT("Vector read"), UJsonValue::ReadRawJsonValue(Vector, VectorValue));
+	TestEqual(TEXT("Vector read back"), VectorValue, FVector(1., 2., 3.));
+
+	const TSharedPtr<FJsonValue> Rotator = UJsonValue::CreateRawJsonValue(FRotator(10., 20., 30.), EJsonMathEncoding::Object);
+	TestNotNull(TEXT("Rotator is flat"), FJsonValueFlatObject::Cast(Rotator.Get()));
+
+	const FTransform Transform(FRotator(10., 20., 30.), FVector(1., 2., 3.), FVector(2., 2., 2.));
+	const TSharedPtr<FJsonValue> TransformValue = UJsonValue::CreateRawJsonValue(Transform, EJsonMathEncoding::Object);
+	const FJsonValueFlatObject* const FlatTransform = FJsonValueFlatObject::Cast(TransformValue.Get());
+	if (!TestNotNull(TEXT("Transform is flat"), FlatTransform))
+	{
+		return false;
+	}
+
+	TestNotNull(TEXT("Location is flat"), FJsonValueFlatObject::Cast(FlatTransform->TryGetField(TEXT("Location")).Get()));
+	TestNotNull(TEXT("Scale3D is flat"),  FJsonValueFlatObject::Cast(FlatTransform->TryGetField(TEXT("Scale3D")).Get()));
+	TestNotNull(TEXT("Rotation is flat"), FJsonValueFlatObject::Cast(FlatTransform->TryGetField(TEXT("Rotation")).Get()));
+
+	FTransform TransformRead;
+	TestTrue(TEXT("Transform read"), UJsonValue::ReadRawJsonValue(TransformValue, TransformRead));
+	TestTrue(TEXT("Transform read back"), TransformRead.Equals(Transform, 1.e-4));
+
+	return true;
+}
+
+#endif
@@ -5,6 +5,50 @@
 #include "K2Node.h"
 #include "BlueprintJsonEditorNodes.generated.h"
 
+/* Type of a field pin of the Break and Make JSON Object nodes. */
+UENUM()
+enum class EJsonFieldPinType : uint8
+{
+	Boolean,
+	Integer,
+	Integer64,
+	Float,
+	String,
+	Name,
+	Text,
+	Vector,
+	Rotator,
+	LinearColor,
+	JsonObject      UMETA(DisplayName = "JSON Object"),
+	JsonValue       UMETA(DisplayName = "JSON Value"),
+	LightJsonObject UMETA(DisplayName = "Light JSON Object"),
+	LightJsonValue  UMETA(DisplayName = "Light JSON Value")
+};
+
+/* A field of a JSON object, exposed as a pin of its type. */
+USTRUCT()
+struct FJsonFieldPin
+{
+	GENERATED_BODY()
+public:
+	/* Name of the field, also used as pin name. */
+	UPROPERTY(EditAnywhere, Category = "Field")
+	FString FieldName;
+
+	/* Type the field is converted to. */
+	UPROPERTY(EditAnywhere, Category = "Field")
+	EJsonFieldPinType Type = EJsonFieldPinType::String;
+
+	/* Returns the pin type matching Type. */
+	FEdGraphPinType GetPinType() const;
+
+	/* Reports empty, duplicated and reserved names of Fields. */
+	static void ValidateFields(const TArray<FJsonFieldPin>& Fields, const TArray<FName>& ReservedNames, const class UK2Node* const Node, class FCompilerResultsLog& MessageLog);
+
+	/* Spawns a Make Array node holding the non-empty names of Fields and links it to ArrayPin. */
+	static void SpawnFieldNamesArray(const TArray<FJsonFieldPin>& Fields, UEdGraphPin* const ArrayPin, class UK2Node* const Node, class FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph);
+};
+
 /**
  *	K2 Node accepting a wild card to easily add a field to a JSON object.
  **/
@@ -42,8 +86,10 @@ private:
 
 
 /**
- *	K2 Node iterating over the fields of a JSON object.
- **-/
+ *	K2 Node iterating over the fields of a JSON object. It expands to a native
+ *	iterator yielding one field at a time, so no array of fields nor UJsonValue
+ *	wrapper is created.
+ **/
 UCLASS(BlueprintType, Blueprintable)
 class BLUEPRINTJSONEDITOR_API UK2Node_ForEachFieldJsonObject : public UK2Node
 {
@@ -54,14 +100,10 @@ public:
 	virtual void GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const override;
 	virtual void AllocateDefaultPins() override;
 	virtual FLinearColor GetNodeTitleColor() const override;
+	virtual void ExpandNode(class FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph) override;
 	virtual FText GetMenuCategory() const override;
 	virtual FText GetNodeTitle(ENodeTitleType::Type TitleType) const override;
 	virtual FText GetTooltipText() const override;
-	virtual void PinDefaultValueChanged(UEdGraphPin* const Pin) override;
-	virtual void NotifyPinConnectionListChanged(UEdGraphPin* Pin) override;
-	virtual void ReallocatePinsDuringReconstruction(TArray<UEdGraphPin*>& OldPins);
-
-	virtual class FNodeHandlingFunctor* CreateNodeHandler(class FKismetCompilerContext& CompilerContext) const override;
 
 private:
 	UEdGraphPin* GetJsonObjectPin();
@@ -70,4 +112,66 @@ private:
 	UEdGraphPin* GetLoopBodyPin();
 	UEdGraphPin* GetCompletedPin();
 };
-*/
+
+
+/**
+ *	K2 Node reading several fields of a JSON object at once. It compiles to a
+ *	single native call instead of one pure GetFieldAs* node per field.
+ **/
+UCLASS(BlueprintType, Blueprintable)
+class BLUEPRINTJSONEDITOR_API UK2Node_BreakJsonObject : public UK2Node
+{
+	GENERATED_BODY()
+public:
+	UK2Node_BreakJsonObject(const FObjectInitializer& OI) : Super(OI) {};
+
+	virtual void GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const override;
+	virtual void AllocateDefaultPins() override;
+	virtual FLinearColor GetNodeTitleColor() const override;
+	virtual void ExpandNode(class FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph) override;
+	virtual void ValidateNodeDuringCompilation(class FCompilerResultsLog& MessageLog) const override;
+	virtual FText GetMenuCategory() const override;
+	virtual FText GetNodeTitle(ENodeTitleType::Type TitleType) const override;
+	virtual FText GetTooltipText() const override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+
+	/* Fields to read, each one gets an output pin. */
+	UPROPERTY(EditAnywhere, Category = "JSON")
+	TArray<FJsonFieldPin> Fields;
+
+private:
+	UEdGraphPin* GetJsonObjectPin();
+	UEdGraphPin* GetFoundPin();
+};
+
+
+/**
+ *	K2 Node creating a JSON object from several typed fields. It compiles to a
+ *	single native call writing raw values, instead of a chain of Add Field nodes
+ *	each creating a UJsonValue. It has exec pins: a pure node would create a new
+ *	object each time one of its outputs is read.
+ **/
+UCLASS(BlueprintType, Blueprintable)
+class BLUEPRINTJSONEDITOR_API UK2Node_MakeJsonObject : public UK2Node
+{
+	GENERATED_BODY()
+public:
+	UK2Node_MakeJsonObject(const FObjectInitializer& OI) : Super(OI) {};
+
+	virtual void GetMenuActions(FBlueprintActionDatabaseRegistrar& ActionRegistrar) const override;
+	virtual void AllocateDefaultPins() override;
+	virtual FLinearColor GetNodeTitleColor() const override;
+	virtual void ExpandNode(class FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph) override;
+	virtual void ValidateNodeDuringCompilation(class FCompilerResultsLog& MessageLog) const override;
+	virtual FText GetMenuCategory() const override;
+	virtual FText GetNodeTitle(ENodeTitleType::Type TitleType) const override;
+	virtual FText GetTooltipText() const override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+
+	/* Fields to write, each one gets an input pin. */
+	UPROPERTY(EditAnywhere, Category = "JSON")
+	TArray<FJsonFieldPin> Fields;
+
+private:
+	UEdGraphPin* GetJsonObjectPin();
+};
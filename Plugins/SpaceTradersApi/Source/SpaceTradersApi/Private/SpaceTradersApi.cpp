@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersApi.h"
+
+DEFINE_LOG_CATEGORY(LogSpaceTradersApi);
+
+LLM_DEFINE_TAG(BlueprintJson_SpaceTraders, TEXT("SpaceTraders"), TEXT("BlueprintJson"));
+
+#define LOCTEXT_NAMESPACE "FSpaceTradersApiModule"
+
+void FSpaceTradersApiModule::StartupModule()
+{}
+
+void FSpaceTradersApiModule::ShutdownModule()
+{}
+
+#undef LOCTEXT_NAMESPACE
+	
+IMPLEMENT_MODULE(FSpaceTradersApiModule, SpaceTradersApi)
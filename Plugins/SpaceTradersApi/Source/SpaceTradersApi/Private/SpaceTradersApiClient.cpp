@@ -0,0 +1,603 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersApiClient.h"
+#include "SpaceTradersApi.h"
+#include "SpaceTradersApiSettings.h"
+#include "SpaceTradersCrawler.h"
+#include "BlueprintJson.h"
+#include "BlueprintJsonParser.h"
+#include "BlueprintJsonWriter.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "Interfaces/IHttpResponse.h"
+#include "HttpModule.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+
+FString FSpaceTradersRequest::BuildUrl(const FString& BaseUrl) const
+{
+	TStringBuilder<256> Url;
+	Url << BaseUrl << Path;
+
+	TCHAR Separator = TEXT('?');
+	for (const TPair<FString, FString>& Parameter : Query)
+	{
+		Url << Separator << FGenericPlatformHttp::UrlEncode(Parameter.Key) << TEXT('=') << FGenericPlatformHttp::UrlEncode(Parameter.Value);
+		Separator = TEXT('&');
+	}
+
+	return FString(Url.ToView());
+}
+
+/* static */ USpaceTradersApiClient* USpaceTradersApiClient::Get(const UObject* const WorldContextObject)
+{
+	const UWorld* const World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	const UGameInstance* const GameInstance = World ? World->GetGameInstance() : nullptr;
+
+	return GameInstance ? GameInstance->GetSubsystem<USpaceTradersApiClient>() : nullptr;
+}
+
+void FSpaceTradersRateLimitHeaders::Read(const IHttpResponse& Response)
+{
+	const FString PerSecond = Response.GetHeader(TEXT("x-ratelimit-limit-per-second"));
+	if (!PerSecond.IsEmpty())
+	{
+		LexFromString(RequestsPerSecond, *PerSecond);
+	}
+
+	const FString Burst = Response.GetHeader(TEXT("x-ratelimit-limit-burst"));
+	if (!Burst.IsEmpty())
+	{
+		LexFromString(BurstRequests, *Burst);
+	}
+
+	const FString RemainingHeader = Response.GetHeader(TEXT("x-ratelimit-remaining"));
+	if (!RemainingHeader.IsEmpty())
+	{
+		LexFromString(Remaining, *RemainingHeader);
+	}
+
+	// The reset date comes from the server's clock, it's compared to the response date to be immune to clock skew.
+	FDateTime ResetDate;
+	if (FDateTime::ParseIso8601(*Response.GetHeader(TEXT("x-ratelimit-reset")), ResetDate))
+	{
+		FDateTime ServerDate;
+		if (!FDateTime::ParseHttpDate(Response.GetHeader(TEXT("date")), ServerDate))
+		{
+			ServerDate = FDateTime::UtcNow();
+		}
+		ResetIn = FMath::Max((ResetDate - ServerDate).GetTotalSeconds(), 0.);
+	}
+
+	const FString RetryAfterHeader = Response.GetHeader(TEXT("retry-after"));
+	if (!RetryAfterHeader.IsEmpty())
+	{
+		LexFromString(RetryAfter, *RetryAfterHeader);
+	}
+}
+
+void USpaceTradersApiClient::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const USpaceTradersApiSettings* const Settings = GetDefault<USpaceTradersApiSettings>();
+
+	BaseUrl               = Settings->GetBaseUrl();
+	RequestTimeout        = Settings->RequestTimeout;
+	MaxConcurrentRequests = FMath::Max(Settings->MaxConcurrentRequests, 1);
+	MaxRetries            = FMath::Max(Settings->MaxRetries, 0);
+	RateLimiter           = MakeUnique<FSpaceTradersRateLimiter>(Settings->RequestsPerSecond, Settings->BurstRequests, Settings->BurstWindow);
+
+	if (Settings->bEnableCache)
+	{
+		ResponseCache = MakeShared<FSpaceTradersResponseCache, ESPMode::ThreadSafe>(
+			FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SpaceTraders"), TEXT("Cache")), Settings->MaxCacheSizeMB * 1024ll * 1024ll);
+	}
+
+	PumpHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ThisClass::Pump));
+
+	UE_LOG(LogSpaceTradersApi, Log, TEXT("SpaceTraders API client using %s."), *BaseUrl);
+}
+
+void USpaceTradersApiClient::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(PumpHandle);
+
+	// Nothing else references them, the game instance must not outlive this.
+	for (USpaceTradersCrawler* const Crawler : RetainedCrawlers)
+	{
+		if (Crawler)
+		{
+			Crawler->Stop();
+		}
+	}
+	RetainedCrawlers.Empty();
+
+	for (TDeque<FQueuedRequestRef>& Queue : Queues)
+	{
+		Queue.Empty();
+	}
+
+	// Completion delegates check the client is still alive, cancelled requests are simply dropped.
+	for (const FHttpRequestPtr& Request : PendingRequests)
+	{
+		Request->CancelRequest();
+	}
+	PendingRequests.Empty();
+
+	// Saves the index once the worker threads still using the cache are done with it.
+	ResponseCache.Reset();
+
+	Super::Deinitialize();
+}
+
+void USpaceTradersApiClient::SetAgentToken(const FString& Token)
+{
+	AgentToken = Token;
+}
+
+void USpaceTradersApiClient::RetainCrawler(USpaceTradersCrawler* const Crawler)
+{
+	RetainedCrawlers.AddUnique(Crawler);
+}
+
+void USpaceTradersApiClient::ReleaseCrawler(USpaceTradersCrawler* const Crawler)
+{
+	RetainedCrawlers.Remove(Crawler);
+}
+
+void USpaceTradersApiClient::ClearCache()
+{
+	if (ResponseCache)
+	{
+		ResponseCache->Clear();
+	}
+}
+
+void USpaceTradersApiClient::Send(FSpaceTradersRequest&& Request, FOnSpaceTradersResponse&& OnResponse)
+{
+	LLM_SCOPE_BYTAG(BlueprintJson_SpaceTraders);
+
+	FQueuedRequestRef Queued = MakeShared<FQueuedRequest, ESPMode::ThreadSafe>();
+	Queued->Request    = MoveTemp(Request);
+	Queued->OnResponse = MoveTemp(OnResponse);
+
+	const double TimeToLive = ResponseCache && Queued->Request.Verb == TEXT("GET")
+		? GetDefault<USpaceTradersApiSettings>()->GetTimeToLive(Queued->Request.Path) : 0.;
+
+	if (TimeToLive > 0.)
+	{
+		Queued->Cache    = ResponseCache;
+		Queued->CacheKey = FSpaceTradersResponseCache::MakeKey(Queued->Request.Verb, Queued->Request.BuildUrl(BaseUrl), Queued->Request.bAuthenticated ? AgentToken : FString());
+
+		if (const FSpaceTradersCacheEntry* const Entry = ResponseCache->Find(Queued->CacheKey))
+		{
+			if (!Queued->Request.bBypassCache && (FDateTime::UtcNow() - Entry->StoredAt).GetTotalSeconds() < TimeToLive)
+			{
+				LoadFromCache(Queued);
+				return;
+			}
+
+			// Expired, the server only sends it again if it changed.
+			Queued->CachedETag = Entry->ETag;
+		}
+	}
+
+	Enqueue(Queued);
+}
+
+void USpaceTradersApiClient::Enqueue(const FQueuedRequestRef& Queued, const bool bFirst)
+{
+	const int32 Priority = FMath::Clamp(static_cast<int32>(Queued->Request.Priority), 0, static_cast<int32>(ESpaceTradersPriority::MAX) - 1);
+
+	if (bFirst)
+	{
+		Queues[Priority].EmplaceFirst(Queued);
+	}
+	else
+	{
+		Queues[Priority].EmplaceLast(Queued);
+	}
+
+	// Sends it right away if a token is available instead of waiting for the next tick.
+	Pump(0.f);
+}
+
+void USpaceTradersApiClient::LoadFromCache(const FQueuedRequestRef& Queued)
+{
+	TWeakObjectPtr<ThisClass> Self = this;
+
+	Async(EAsyncExecution::ThreadPool, [Self, Queued]() -> void
+	{
+		LLM_SCOPE_BYTAG(BlueprintJson_SpaceTraders);
+
+		TSharedRef<FSpaceTradersResponse> Response = MakeShared<FSpaceTradersResponse>();
+
+		const double StartTime = FPlatformTime::Seconds();
+		const bool bLoaded = Queued->Cache->Load(Queued->CacheKey, *Response);
+		Queued->Metrics.ParseTime = FPlatformTime::Seconds() - StartTime;
+
+		AsyncTask(ENamedThreads::GameThread, [Self, Queued, Response, bLoaded]() -> void
+		{
+			if (!Self.IsValid())
+			{
+				return;
+			}
+
+			if (!bLoaded)
+			{
+				Self->Enqueue(Queued);
+				return;
+			}
+
+			Self->NumCacheHits++;
+			if (Self->ResponseCache)
+			{
+				Self->ResponseCache->Touch(Queued->CacheKey, false);
+			}
+
+			Self->Deliver(Queued, *Response, true);
+		});
+	});
+}
+
+int32 USpaceTradersApiClient::GetNumQueuedRequests() const
+{
+	int32 Num = 0;
+	for (const TDeque<FQueuedRequestRef>& Queue : Queues)
+	{
+		Num += Queue.Num();
+	}
+	return Num;
+}
+
+bool USpaceTradersApiClient::Pump(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	for (TDeque<FQueuedRequestRef>& Queue : Queues)
+	{
+		while (!Queue.IsEmpty() && PendingRequests.Num() < MaxConcurrentRequests && RateLimiter->TryAcquire(Now))
+		{
+			const FQueuedRequestRef Queued = Queue.First();
+			Queue.PopFirst();
+			Dispatch(Queued);
+		}
+	}
+
+	if (ResponseCache)
+	{
+		ResponseCache->Flush(Now);
+	}
+
+	return true;
+}
+
+void USpaceTradersApiClient::Dispatch(const FQueuedRequestRef& Queued)
+{
+	const FSpaceTradersRequest& Request = Queued->Request;
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> HttpRequest = FHttpModule::Get().CreateRequest();
+
+	HttpRequest->SetVerb(Request.Verb);
+	HttpRequest->SetURL(Request.BuildUrl(BaseUrl));
+	HttpRequest->SetHeader(TEXT("Accept"), TEXT("application/json"));
+	HttpRequest->SetHeader(TEXT("Connection"), TEXT("keep-alive"));
+
+	if (!Queued->CachedETag.IsEmpty())
+	{
+		HttpRequest->SetHeader(TEXT("If-None-Match"), Queued->CachedETag);
+	}
+
+	if (Request.bAuthenticated && !AgentToken.IsEmpty())
+	{
+		HttpRequest->SetHeader(TEXT("Authorization"), TEXT("Bearer ") + AgentToken);
+	}
+
+	Queued->Metrics = FSpaceTradersRequestMetrics();
+
+	if (Request.Body)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		FString Body;
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Body);
+		FBlueprintJsonWriter::Serialize(Request.Body.ToSharedRef(), Writer);
+
+		HttpRequest->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+		HttpRequest->SetContentAsString(Body);
+
+		Queued->Metrics.StringifyTime = FPlatformTime::Seconds() - StartTime;
+		Queued->Metrics.BytesSent     = HttpRequest->GetContentLength();
+	}
+
+	if (RequestTimeout > 0.f)
+	{
+		HttpRequest->SetTimeout(RequestTimeout);
+	}
+
+	Queued->Attempts++;
+	Queued->SendIndex = ++NumSentRequests;
+	Queued->SentTime  = FPlatformTime::Seconds();
+
+	// Completes on the HTTP thread so the body is never decoded on the game thread.
+	HttpRequest->SetDelegateThreadPolicy(EHttpRequestDelegateThreadPolicy::CompleteOnHttpThread);
+	HttpRequest->OnProcessRequestComplete().BindStatic(&ThisClass::OnRequestComplete, TWeakObjectPtr<ThisClass>(this), Queued);
+
+	PendingRequests.Add(HttpRequest);
+
+	if (!HttpRequest->ProcessRequest())
+	{
+		UE_LOG(LogSpaceTradersApi, Warning, TEXT("Failed to send %s %s."), *Request.Verb, *HttpRequest->GetURL());
+	}
+}
+
+/* static */ void USpaceTradersApiClient::OnRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bConnectedSuccessfully, TWeakObjectPtr<USpaceTradersApiClient> Self, FQueuedRequestRef Queued)
+{
+	const int32 HttpStatus = HttpResponse ? HttpResponse->GetResponseCode() : 0;
+	TArray<uint8> Body;
+	FSpaceTradersRateLimitHeaders RateLimit;
+	if (bConnectedSuccessfully && HttpResponse)
+	{
+		Body = HttpResponse->GetContent();
+		RateLimit.Read(*HttpResponse);
+		Queued->ResponseETag = HttpResponse->GetHeader(TEXT("ETag"));
+	}
+
+	Queued->Metrics.Latency       = FPlatformTime::Seconds() - Queued->SentTime;
+	Queued->Metrics.BytesReceived = Body.Num();
+
+	// The HTTP thread serves every request, decoding happens in the thread pool instead.
+	Async(EAsyncExecution::ThreadPool, [Self = MoveTemp(Self), HttpRequest = MoveTemp(HttpRequest), HttpStatus, bConnectedSuccessfully, Body = MoveTemp(Body), RateLimit, Queued = MoveTemp(Queued)]() mutable -> void
+	{
+		LLM_SCOPE_BYTAG(BlueprintJson_SpaceTraders);
+
+		TSharedRef<FSpaceTradersResponse> Response = MakeShared<FSpaceTradersResponse>();
+		const double StartTime = FPlatformTime::Seconds();
+
+		if (!bConnectedSuccessfully)
+		{
+			Response->Error.Message = TEXT("Failed to connect to the server.");
+		}
+		else if (HttpStatus == EHttpResponseCodes::NotModified && Queued->Cache)
+		{
+			// The expired cached response is still valid.
+			Queued->bRevalidated = Queued->Cache->Load(Queued->CacheKey, *Response);
+			if (!Queued->bRevalidated)
+			{
+				Response->Error.HttpStatus = HttpStatus;
+				Response->Error.Message    = TEXT("Cached response not found.");
+			}
+		}
+		else
+		{
+			DecodeResponse(HttpStatus, MoveTemp(Body), *Response);
+
+			if (Response->bSuccess && Queued->Cache)
+			{
+				Queued->StoredSize = Queued->Cache->Store(Queued->CacheKey, Queued->ResponseETag, *Response);
+			}
+		}
+
+		Queued->Metrics.ParseTime = FPlatformTime::Seconds() - StartTime;
+
+		AsyncTask(ENamedThreads::GameThread, [Self = MoveTemp(Self), HttpRequest = MoveTemp(HttpRequest), RateLimit, Response = MoveTemp(Response), Queued = MoveTemp(Queued)]() -> void
+		{
+			if (Self.IsValid())
+			{
+				Self->OnResponseReceived(HttpRequest, Queued, RateLimit, *Response);
+			}
+		});
+	});
+}
+
+void USpaceTradersApiClient::OnResponseReceived(const FHttpRequestPtr& HttpRequest, const FQueuedRequestRef& Queued, const FSpaceTradersRateLimitHeaders& RateLimit, const FSpaceTradersResponse& Response)
+{
+	PendingRequests.Remove(HttpRequest);
+
+	const double Now = FPlatformTime::Seconds();
+
+	if (RateLimit.RequestsPerSecond > 0. && RateLimit.BurstRequests >= 0)
+	{
+		RateLimiter->SetLimits(RateLimit.RequestsPerSecond, RateLimit.BurstRequests);
+	}
+
+	if (RateLimit.Remaining >= 0)
+	{
+		RateLimiter->OnServerState(Now, RateLimit.Remaining, RateLimit.ResetIn, static_cast<int32>(NumSentRequests - Queued->SendIndex));
+	}
+
+	if (Response.Error.HttpStatus == EHttpResponseCodes::TooManyRequests)
+	{
+		NumThrottledRequests++;
+		RateLimiter->OnThrottled(Now, FMath::Max3(Response.RetryAfter, RateLimit.RetryAfter, RateLimit.ResetIn));
+
+		if (Queued->Attempts <= MaxRetries)
+		{
+			UE_LOG(LogSpaceTradersApi, Verbose, TEXT("%s was rate limited, sending it again."), *HttpRequest->GetURL());
+			OnRequestCompleted.Broadcast(Queued->Request, Response, Queued->Metrics);
+
+			// Goes first so a throttled request doesn't lose its turn.
+			Enqueue(Queued, true);
+			return;
+		}
+	}
+
+	if (ResponseCache && Queued->Cache)
+	{
+		if (Queued->bRevalidated)
+		{
+			NumCacheHits++;
+			ResponseCache->Touch(Queued->CacheKey, true);
+		}
+		else if (Queued->StoredSize >= 0)
+		{
+			FSpaceTradersCacheEntry Entry;
+			Entry.StoredAt   = FDateTime::UtcNow();
+			Entry.LastAccess = Entry.StoredAt;
+			Entry.Size       = Queued->StoredSize;
+			Entry.ETag       = Queued->ResponseETag;
+			ResponseCache->OnStored(Queued->CacheKey, MoveTemp(Entry));
+		}
+		else if (Response.Error.HttpStatus == EHttpResponseCodes::NotModified && !Queued->CachedETag.IsEmpty())
+		{
+			// The cached file disappeared, asks for the whole response instead.
+			OnRequestCompleted.Broadcast(Queued->Request, Response, Queued->Metrics);
+			Queued->CachedETag.Empty();
+			Enqueue(Queued, true);
+			return;
+		}
+	}
+
+	if (!Response.bSuccess)
+	{
+		UE_LOG(LogSpaceTradersApi, Warning, TEXT("%s %s failed (%d): %s"), *HttpRequest->GetVerb(), *HttpRequest->GetURL(), Response.Error.HttpStatus, *Response.Error.Message);
+	}
+
+	Deliver(Queued, Response, false);
+
+	// A slot is free, the next request doesn't have to wait for the tick.
+	Pump(0.f);
+}
+
+void USpaceTradersApiClient::Deliver(const FQueuedRequestRef& Queued, const FSpaceTradersResponse& Response, const bool bFromCache)
+{
+	LLM_SCOPE_BYTAG(BlueprintJson_SpaceTraders);
+
+	// Wrappers are created on the game thread, those created meanwhile come from the callbacks.
+	const int64 WrappersBefore = FBlueprintJsonCounters::NumWrappersCreated.load(std::memory_order_relaxed);
+
+	OnResponseDelivered.Broadcast(Queued->Request, Response, bFromCache);
+	Queued->OnResponse.ExecuteIfBound(Response);
+
+	Queued->Metrics.WrappersCreated = FBlueprintJsonCounters::NumWrappersCreated.load(std::memory_order_relaxed) - WrappersBefore;
+	Queued->Metrics.bFromCache      = bFromCache;
+	OnRequestCompleted.Broadcast(Queued->Request, Response, Queued->Metrics);
+}
+
+/* static */ void USpaceTradersApiClient::DecodeResponse(const int32 HttpStatus, TArray<uint8>&& Body, FSpaceTradersResponse& OutResponse)
+{
+	OutResponse.Error.HttpStatus = HttpStatus;
+
+	if (Body.Num() == 0)
+	{
+		// 204 No Content and the like.
+		OutResponse.bSuccess = EHttpResponseCodes::IsOk(HttpStatus);
+		if (!OutResponse.bSuccess)
+		{
+			OutResponse.Error.Message = TEXT("Empty response.");
+		}
+		return;
+	}
+
+	FString ParseError;
+	const TSharedPtr<FJsonObject> Root = FBlueprintJsonParser::ParseObject(MoveTemp(Body),
+		EJsonParseOptions::LazyNumbers | EJsonParseOptions::LazyStrings | EJsonParseOptions::FlatObjects, &ParseError);
+
+	if (!Root)
+	{
+		OutResponse.Error.Message = FString::Printf(TEXT("Invalid JSON response: %s"), *ParseError);
+		return;
+	}
+
+	const TSharedPtr<FJsonObject>* ErrorObject = nullptr;
+	if (Root->TryGetObjectField(TEXT("error"), ErrorObject))
+	{
+		(*ErrorObject)->TryGetNumberField(TEXT("code"),    OutResponse.Error.Code);
+		(*ErrorObject)->TryGetStringField(TEXT("message"), OutResponse.Error.Message);
+
+		// 429 responses tell how long to wait in error.data.retryAfter.
+		const TSharedPtr<FJsonObject>* ErrorData = nullptr;
+		if ((*ErrorObject)->TryGetObjectField(TEXT("data"), ErrorData))
+		{
+			(*ErrorData)->TryGetNumberField(TEXT("retryAfter"), OutResponse.RetryAfter);
+		}
+		return;
+	}
+
+	if (!EHttpResponseCodes::IsOk(HttpStatus))
+	{
+		OutResponse.Error.Message = FString::Printf(TEXT("HTTP status %d."), HttpStatus);
+		return;
+	}
+
+	// Every endpoint wraps its result in "data", except the server status at the root.
+	OutResponse.Data = Root->TryGetField(TEXT("data"));
+	if (!OutResponse.Data)
+	{
+		OutResponse.Data = MakeShared<FJsonValueObject>(Root);
+	}
+
+	const TSharedPtr<FJsonObject>* Meta = nullptr;
+	if (Root->TryGetObjectField(TEXT("meta"), Meta))
+	{
+		OutResponse.Meta = *Meta;
+	}
+
+	OutResponse.bSuccess = true;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdRateLimitTest(
+	TEXT("SpaceTraders.RateLimitTest"),
+	TEXT("Sends Count background requests for the server status and logs the throughput and the number of 429 responses.\n")
+	TEXT("Meant to be run against the mock server in Tools/SpaceTradersMock, which enforces the same limits as the live API.\n")
+	TEXT("Usage: SpaceTraders.RateLimitTest [Count=100]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		USpaceTradersApiClient* const Client = USpaceTradersApiClient::Get(World);
+		if (!Client)
+		{
+			UE_LOG(LogSpaceTradersApi, Warning, TEXT("No SpaceTraders API client for this world."));
+			return;
+		}
+
+		int32 Count = 100;
+		if (Args.Num() > 0)
+		{
+			LexFromString(Count, *Args[0]);
+		}
+		Count = FMath::Max(Count, 1);
+
+		struct FTestState
+		{
+			int32  Remaining;
+			int32  Failed = 0;
+			int64  ThrottledBefore;
+			double StartTime;
+		};
+
+		const TSharedRef<FTestState> State = MakeShared<FTestState>();
+		State->Remaining       = Count;
+		State->ThrottledBefore = Client->GetNumThrottledRequests();
+		State->StartTime       = FPlatformTime::Seconds();
+
+		TWeakObjectPtr<USpaceTradersApiClient> WeakClient = Client;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			FSpaceTradersRequest Request;
+			Request.Path           = TEXT("/");
+			Request.bAuthenticated = false;
+			Request.Priority       = ESpaceTradersPriority::Background;
+
+			Client->Send(MoveTemp(Request), FOnSpaceTradersResponse::CreateLambda([State, Count, WeakClient](const FSpaceTradersResponse& Response)
+			{
+				State->Failed += Response.bSuccess ? 0 : 1;
+
+				if (--State->Remaining == 0 && WeakClient.IsValid())
+				{
+					const double Elapsed = FPlatformTime::Seconds() - State->StartTime;
+					UE_LOG(LogSpaceTradersApi, Display, TEXT("Rate limit test: %d requests in %.2fs (%.2f/s), %d failed, %lld rejected with 429."),
+						Count, Elapsed, Count / FMath::Max(Elapsed, UE_SMALL_NUMBER), State->Failed,
+						WeakClient->GetNumThrottledRequests() - State->ThrottledBefore);
+				}
+			}));
+		}
+	}));
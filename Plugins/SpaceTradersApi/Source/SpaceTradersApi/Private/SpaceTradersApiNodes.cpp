@@ -0,0 +1,236 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersApiNodes.h"
+#include "SpaceTradersApi.h"
+#include "BlueprintJsonWrapper.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+
+namespace
+{
+	/* Returns a URL path segment from a symbol. */
+	FString Segment(const FString& Symbol)
+	{
+		return TEXT("/") + FGenericPlatformHttp::UrlEncode(Symbol);
+	}
+}
+
+
+void USpaceTradersRequestProxyBase::Activate()
+{
+	if (!Client.IsValid())
+	{
+		UE_LOG(LogSpaceTradersApi, Warning, TEXT("Can't send %s because there is no SpaceTraders API client for this world."), *Request.Path);
+
+		FSpaceTradersResponse Response;
+		Response.Error.Message = TEXT("No API client.");
+		HandleResponse(Response);
+		SetReadyToDestroy();
+		return;
+	}
+
+	Client->Send(MoveTemp(Request), FOnSpaceTradersResponse::CreateUObject(this, &ThisClass::OnResponse));
+}
+
+void USpaceTradersRequestProxyBase::OnResponse(const FSpaceTradersResponse& Response)
+{
+	HandleResponse(Response);
+	SetReadyToDestroy();
+}
+
+/* static */ USpaceTradersObjectRequestProxy* USpaceTradersObjectRequestProxy::GetStatus(UObject* WorldContextObject)
+{
+	FSpaceTradersRequest Request;
+	Request.Path = TEXT("/");
+	Request.bAuthenticated = false;
+
+	return CreateProxy<ThisClass>(WorldContextObject, MoveTemp(Request));
+}
+
+/* static */ USpaceTradersObjectRequestProxy* USpaceTradersObjectRequestProxy::RegisterAgent(UObject* WorldContextObject, const FString& Symbol, const FString& Faction, const FString& Email)
+{
+	FSpaceTradersRequest Request;
+	Request.Verb = TEXT("POST");
+	Request.Path = TEXT("/register");
+	Request.Body = MakeShared<FJsonObject>();
+	Request.Body->SetStringField(TEXT("symbol"),  Symbol);
+	Request.Body->SetStringField(TEXT("faction"), Faction);
+	if (!Email.IsEmpty())
+	{
+		Request.Body->SetStringField(TEXT("email"), Email);
+	}
+
+	ThisClass* const Proxy = CreateProxy<ThisClass>(WorldContextObject, MoveTemp(Request));
+	Proxy->bStoreAgentToken = true;
+	return Proxy;
+}
+
+/* static */ USpaceTradersObjectRequestProxy* USpaceTradersObjectRequestProxy::GetMyAgent(UObject* WorldContextObject)
+{
+	FSpaceTradersRequest Request;
+	Request.Path = TEXT("/my/agent");
+
+	return CreateProxy<ThisClass>(WorldContextObject, MoveTemp(Request));
+}
+
+/* static */ USpaceTradersObjectRequestProxy* USpaceTradersObjectRequestProxy::GetFaction(UObject* WorldContextObject, const FString& FactionSymbol)
+{
+	FSpaceTradersRequest Request;
+	Request.Path = TEXT("/factions") + Segment(FactionSymbol);
+
+	return CreateProxy<ThisClass>(WorldContextObject, MoveTemp(Request));
+}
+
+/* static */ USpaceTradersObjectRequestProxy* USpaceTradersObjectRequestProxy::GetSystem(UObject* WorldContextObject, const FString& SystemSymbol)
+{
+	FSpaceTradersRequest Request;
+	Request.Path = TEXT("/systems") + Segment(SystemSymbol);
+
+	return CreateProxy<ThisClass>(WorldContextObject, MoveTemp(Request));
+}
+
+/* static */ USpaceTradersObjectRequestProxy* USpaceTradersObjectRequestProxy::GetWaypoint(UObject* WorldContextObject, const FString& SystemSymbol, const FString& WaypointSymbol)
+{
+	FSpaceTradersRequest Request;
+	Request.Path = TEXT("/systems") + Segment(SystemSymbol) + TEXT("/waypoints") + Segment(WaypointSymbol);
+
+	return CreateProxy<ThisClass>(WorldContextObject, MoveTemp(Request));
+}
+
+/* static */ USpaceTradersObjectRequestProxy* USpaceTradersObjectRequestProxy::GetMarket(UObject* WorldContextObject, const FString& SystemSymbol, const FString& WaypointSymbol)
+{
+	FSpaceTradersRequest Request;
+	Request.Path = TEXT("/systems") + Segment(SystemSymbol) + TEXT("/waypoints") + Segment(WaypointSymbol) + TEXT("/market");
+
+	return CreateProxy<ThisClass>(WorldContextObject, MoveTemp(Request));
+}
+
+/* static */ USpaceTradersObjectRequestProxy* USpaceTradersObjectRequestProxy::GetJumpGate(UObject* WorldContextObject, const FString& SystemSymbol, const FString& WaypointSymbol)
+{
+	FSpaceTradersRequest Request;
+	Request.Path = TEXT("/systems") + Segment(SystemSymbol) + TEXT("/waypoints") + Segment(WaypointSymbol) + TEXT("/jump-gate");
+
+	return CreateProxy<ThisClass>(WorldContextObject, MoveTemp(Request));
+}
+
+/* static */ USpaceTradersObjectRequestProxy* USpaceTradersObjectRequestProxy::GetMyShip(UObject* WorldContextObject, const FString& ShipSymbol)
+{
+	FSpaceTradersRequest Request;
+	Request.Path = TEXT("/my/ships") + Segment(ShipSymbol);
+
+	return CreateProxy<ThisClass>(WorldContextObject, MoveTemp(Request));
+}
+
+void USpaceTradersObjectRequestProxy::HandleResponse(const FSpaceTradersResponse& Response)
+{
+	UJsonObject* const Data = Response.bSuccess ? UJsonObject::CreateFromRawValue(Response.Data) : nullptr;
+
+	if (!Data)
+	{
+		Failed.Broadcast(nullptr, Response.Error);
+		return;
+	}
+
+	// A registered agent is the one playing from now on.
+	FString Token;
+	if (bStoreAgentToken && Client.IsValid() && Data->GetRawObject()->TryGetStringField(TEXT("token"), Token))
+	{
+		Client->SetAgentToken(Token);
+	}
+
+	Success.Broadcast(Data, Response.Error);
+}
+
+/* static */ USpaceTradersListRequestProxy* USpaceTradersListRequestProxy::CreateListProxy(UObject* const WorldContextObject, FString&& Path, const int32 Page, const int32 Limit)
+{
+	FSpaceTradersRequest Request;
+	Request.Path = MoveTemp(Path);
+	Request.Query.Emplace(TEXT("page"),  LexToString(FMath::Max(Page, 1)));
+	Request.Query.Emplace(TEXT("limit"), LexToString(FMath::Clamp(Limit, 1, 20)));
+
+	return CreateProxy<ThisClass>(WorldContextObject, MoveTemp(Request));
+}
+
+/* static */ USpaceTradersListRequestProxy* USpaceTradersListRequestProxy::ListFactions(UObject* WorldContextObject, const int32 Page, const int32 Limit)
+{
+	return CreateListProxy(WorldContextObject, TEXT("/factions"), Page, Limit);
+}
+
+/* static */ USpaceTradersListRequestProxy* USpaceTradersListRequestProxy::ListSystems(UObject* WorldContextObject, const int32 Page, const int32 Limit)
+{
+	return CreateListProxy(WorldContextObject, TEXT("/systems"), Page, Limit);
+}
+
+/* static */ USpaceTradersListRequestProxy* USpaceTradersListRequestProxy::ListWaypoints(UObject* WorldContextObject, const FString& SystemSymbol, const int32 Page, const int32 Limit)
+{
+	return CreateListProxy(WorldContextObject, TEXT("/systems") + Segment(SystemSymbol) + TEXT("/waypoints"), Page, Limit);
+}
+
+/* static */ USpaceTradersListRequestProxy* USpaceTradersListRequestProxy::ListMyShips(UObject* WorldContextObject, const int32 Page, const int32 Limit)
+{
+	return CreateListProxy(WorldContextObject, TEXT("/my/ships"), Page, Limit);
+}
+
+/* static */ USpaceTradersListRequestProxy* USpaceTradersListRequestProxy::ListMyContracts(UObject* WorldContextObject, const int32 Page, const int32 Limit)
+{
+	return CreateListProxy(WorldContextObject, TEXT("/my/contracts"), Page, Limit);
+}
+
+void USpaceTradersListRequestProxy::HandleResponse(const FSpaceTradersResponse& Response)
+{
+	TArray<UJsonObject*> Items;
+	int32 Total = 0;
+	int32 Page  = 0;
+
+	const TArray<TSharedPtr<FJsonValue>>* RawItems = nullptr;
+	if (!Response.bSuccess || !Response.Data || !Response.Data->TryGetArray(RawItems))
+	{
+		Failed.Broadcast(Items, Total, Page, Response.Error);
+		return;
+	}
+
+	Items.Reserve(RawItems->Num());
+	for (const TSharedPtr<FJsonValue>& RawItem : *RawItems)
+	{
+		if (UJsonObject* const Item = UJsonObject::CreateFromRawValue(RawItem))
+		{
+			Items.Add(Item);
+		}
+	}
+
+	if (Response.Meta)
+	{
+		Response.Meta->TryGetNumberField(TEXT("total"), Total);
+		Response.Meta->TryGetNumberField(TEXT("page"),  Page);
+	}
+
+	Success.Broadcast(Items, Total, Page, Response.Error);
+}
+
+/* static */ USpaceTradersLightRequestProxy* USpaceTradersLightRequestProxy::SendLightRequest(UObject* WorldContextObject, const FString& Verb, const FString& Path, const FLightJsonObject& Body, const bool bAuthenticated)
+{
+	FSpaceTradersRequest Request;
+	Request.Verb = Verb.IsEmpty() ? TEXT("GET") : Verb.ToUpper();
+	Request.Path = Path;
+	Request.bAuthenticated = bAuthenticated;
+
+	if (Body.IsValid())
+	{
+		// The fields are shared, only the object itself is copied.
+		Request.Body = MakeShared<FJsonObject>(*Body.GetRawObject());
+	}
+
+	return CreateProxy<ThisClass>(WorldContextObject, MoveTemp(Request));
+}
+
+void USpaceTradersLightRequestProxy::HandleResponse(const FSpaceTradersResponse& Response)
+{
+	if (!Response.bSuccess)
+	{
+		Failed.Broadcast(FLightJsonValue(), FLightJsonObject(), Response.Error);
+		return;
+	}
+
+	Success.Broadcast(FLightJsonValue(Response.Data), FLightJsonObject(Response.Meta), Response.Error);
+}
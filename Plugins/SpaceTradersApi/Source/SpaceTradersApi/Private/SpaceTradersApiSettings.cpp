@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersApiSettings.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+
+USpaceTradersApiSettings::USpaceTradersApiSettings()
+	: BaseUrl(TEXT("https://api.spacetraders.io/v2"))
+	, RequestTimeout(30.f)
+	, RequestsPerSecond(2.f)
+	, BurstRequests(30)
+	, BurstWindow(60.f)
+	, MaxConcurrentRequests(4)
+	, MaxRetries(3)
+	, bEnableCache(true)
+	, MaxCacheSizeMB(256)
+	, MarketHistorySize(64)
+	, MarketSmoothing(0.2f)
+	, TelemetryWindow(60)
+{
+	const auto AddPolicy = [this](const TCHAR* const PathPattern, const float TimeToLive)
+	{
+		FSpaceTradersCachePolicy& Policy = CachePolicies.AddDefaulted_GetRef();
+		Policy.PathPattern = PathPattern;
+		Policy.TimeToLive  = TimeToLive;
+	};
+
+	// Markets, shipyards and construction sites change all the time. Waypoints change when
+	// they're charted or built on, they're kept a short while and then revalidated with their
+	// ETag. Systems and jump gate connections only change on server resets.
+	AddPolicy(TEXT("/systems/*/market"),       0.f);
+	AddPolicy(TEXT("/systems/*/shipyard"),     0.f);
+	AddPolicy(TEXT("/systems/*/construction"), 0.f);
+	AddPolicy(TEXT("/systems/*/jump-gate"),    7.f * 24.f * 3600.f);
+	AddPolicy(TEXT("/systems/*/waypoints*"),   3600.f);
+	AddPolicy(TEXT("/systems*"),               7.f * 24.f * 3600.f);
+	AddPolicy(TEXT("/factions*"),          24.f * 3600.f);
+}
+
+double USpaceTradersApiSettings::GetTimeToLive(const FString& Path) const
+{
+	for (const FSpaceTradersCachePolicy& Policy : CachePolicies)
+	{
+		if (Path.MatchesWildcard(Policy.PathPattern))
+		{
+			return Policy.TimeToLive;
+		}
+	}
+	return 0.;
+}
+
+FString USpaceTradersApiSettings::GetBaseUrl() const
+{
+	FString Url;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("SpaceTradersBaseUrl="), Url))
+	{
+		Url = BaseUrl;
+	}
+
+	Url.RemoveFromEnd(TEXT("/"));
+
+	return Url;
+}
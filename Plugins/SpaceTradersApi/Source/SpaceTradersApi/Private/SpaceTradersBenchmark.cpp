@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersApi.h"
+#include "SpaceTradersSpatialGrid.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+	/* Builds a grid of Count points spread like the galaxy, runs each query against it and a linear scan, and logs the timings. */
+	void BenchmarkSpatialGrid(const int32 Count)
+	{
+		constexpr int32  NumQueries = 1000;
+		constexpr double Radius     = 2000.;
+		constexpr int32  Nearest    = 8;
+
+		// The galaxy is about 100k units wide with 10k systems, denser galaxies keep the same extent.
+		FRandomStream Random(Count);
+
+		TArray<FIntPoint> Points;
+		Points.SetNumUninitialized(Count);
+		for (FIntPoint& Point : Points)
+		{
+			Point = FIntPoint(Random.RandRange(-50000, 50000), Random.RandRange(-50000, 50000));
+		}
+
+		TArray<FVector2D> Centers;
+		Centers.SetNumUninitialized(NumQueries);
+		for (FVector2D& Center : Centers)
+		{
+			Center = FVector2D(Random.FRandRange(-50000., 50000.), Random.FRandRange(-50000., 50000.));
+		}
+
+		double StartTime = FPlatformTime::Seconds();
+
+		FSpaceTradersSpatialGrid Grid(1000);
+		for (int32 i = 0; i < Count; ++i)
+		{
+			Grid.Add(i, Points[i]);
+		}
+
+		const double BuildTime = FPlatformTime::Seconds() - StartTime;
+
+		TArray<int32> Result;
+		int64 NumFound = 0;
+
+		StartTime = FPlatformTime::Seconds();
+		for (const FVector2D& Center : Centers)
+		{
+			Result.Reset();
+			Grid.QueryRadius(Center, Radius, Result);
+			NumFound += Result.Num();
+		}
+		const double RadiusTime = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		int64 NumScanned = 0;
+		for (const FVector2D& Center : Centers)
+		{
+			for (const FIntPoint& Point : Points)
+			{
+				NumScanned += FVector2D::DistSquared(Center, FVector2D(Point)) <= Radius * Radius ? 1 : 0;
+			}
+		}
+		const double ScanTime = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (const FVector2D& Center : Centers)
+		{
+			Grid.QueryNearest(Center, Nearest, Result);
+		}
+		const double NearestTime = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (const FVector2D& Center : Centers)
+		{
+			Result.Reset();
+			Grid.QueryRectangle(Center - FVector2D(Radius), Center + FVector2D(Radius), Result);
+		}
+		const double RectangleTime = FPlatformTime::Seconds() - StartTime;
+
+		TArray<TArray<int32>> BatchResult;
+		StartTime = FPlatformTime::Seconds();
+		Grid.QueryRadiusBatch(Centers, Radius, BatchResult);
+		const double BatchTime = FPlatformTime::Seconds() - StartTime;
+
+		UE_LOG(LogSpaceTradersApi, Display, TEXT("Spatial grid, %d points: build %.2fms, %.1f KB. Per query: radius %.2fus (linear scan %.2fus, %s), %d nearest %.2fus, rectangle %.2fus, radius in parallel %.2fus."),
+			Count, BuildTime * 1000., Grid.GetAllocatedSize() / 1024.,
+			RadiusTime * 1e6 / NumQueries, ScanTime * 1e6 / NumQueries, NumFound == NumScanned ? TEXT("same results") : TEXT("DIFFERENT RESULTS"),
+			Nearest, NearestTime * 1e6 / NumQueries, RectangleTime * 1e6 / NumQueries, BatchTime * 1e6 / NumQueries);
+	}
+}
+
+static FAutoConsoleCommand CmdBenchmarkSpatialGrid(
+	TEXT("SpaceTraders.BenchmarkSpatialGrid"),
+	TEXT("Times building the spatial grid and querying it by radius, nearest neighbours and rectangle, compared to a linear scan.\n")
+	TEXT("Usage: SpaceTraders.BenchmarkSpatialGrid [Count...], 10000 and 100000 points by default."),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		TArray<int32> Counts = { 10000, 100000 };
+		if (Args.Num() > 0)
+		{
+			Counts.Reset();
+			for (const FString& Arg : Args)
+			{
+				int32 Count = 0;
+				LexFromString(Count, *Arg);
+				Counts.Add(FMath::Max(Count, 1));
+			}
+		}
+
+		for (const int32 Count : Counts)
+		{
+			BenchmarkSpatialGrid(Count);
+		}
+	}));
@@ -0,0 +1,471 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersCrawler.h"
+#include "SpaceTradersApi.h"
+#include "BlueprintJsonBinary.h"
+#include "BlueprintJsonValues.h"
+#include "BlueprintJsonWrapper.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+
+namespace
+{
+	constexpr uint32 CheckpointMagic   = 0x50435453; // STCP
+	constexpr int32  CheckpointVersion = 1;
+
+	/* Largest page size allowed by the API. */
+	constexpr int32 PageLimit = 20;
+
+	/* Number of times a page is requested again after an error other than 429, which the client already retries. */
+	constexpr int32 MaxPageRetries = 3;
+
+	/* Returns the "symbol" field of an item, or an empty string. */
+	FString GetItemSymbol(const TSharedPtr<FJsonValue>& Item)
+	{
+		TSharedPtr<FJsonValue> Symbol;
+		const TSharedPtr<FJsonObject>* Object = nullptr;
+
+		if (const FJsonValueFlatObject* const FlatObject = FJsonValueFlatObject::Cast(Item.Get()))
+		{
+			Symbol = FlatObject->TryGetField(TEXT("symbol"));
+		}
+		else if (Item && Item->TryGetObject(Object))
+		{
+			Symbol = (*Object)->TryGetField(TEXT("symbol"));
+		}
+
+		FString Result;
+		if (Symbol)
+		{
+			Symbol->TryGetString(Result);
+		}
+		return Result;
+	}
+}
+
+
+/* static */ USpaceTradersCrawler* USpaceTradersCrawler::CrawlSystems(UObject* WorldContextObject)
+{
+	return Create(USpaceTradersApiClient::Get(WorldContextObject), TEXT("/systems"));
+}
+
+/* static */ USpaceTradersCrawler* USpaceTradersCrawler::CrawlWaypoints(UObject* WorldContextObject, const FString& SystemSymbol)
+{
+	return Create(USpaceTradersApiClient::Get(WorldContextObject), TEXT("/systems/") + FGenericPlatformHttp::UrlEncode(SystemSymbol) + TEXT("/waypoints"));
+}
+
+/* static */ USpaceTradersCrawler* USpaceTradersCrawler::Create(USpaceTradersApiClient* const Client, const FString& Path)
+{
+	if (!Client)
+	{
+		UE_LOG(LogSpaceTradersApi, Warning, TEXT("Can't crawl %s because there is no SpaceTraders API client for this world."), *Path);
+		return nullptr;
+	}
+
+	USpaceTradersCrawler* const Crawler = NewObject<USpaceTradersCrawler>(Client);
+	Crawler->Client = Client;
+	Crawler->Path   = Path;
+
+	// The checkpoint of the live server must not be used with the mock, and the other way around.
+	const FString Url = Client->GetBaseUrl() + Path;
+	Crawler->CheckpointPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SpaceTraders"), TEXT("Crawl"),
+		FString::Printf(TEXT("%016llx.bin"), CityHash64(reinterpret_cast<const char*>(*Url), Url.Len() * sizeof(TCHAR))));
+
+	return Crawler;
+}
+
+void USpaceTradersCrawler::Start()
+{
+	if (bRunning)
+	{
+		return;
+	}
+
+	if (!Client.IsValid())
+	{
+		FSpaceTradersError Error;
+		Error.Message = TEXT("No API client.");
+		Finish(false, Error);
+		return;
+	}
+
+	bRunning = true;
+	NextPage = 1;
+
+	if (NumPagesDone == 0)
+	{
+		LoadCheckpoint();
+	}
+
+	RequestPages();
+}
+
+void USpaceTradersCrawler::Stop()
+{
+	// Pages already queued are still added when they arrive.
+	bRunning = false;
+	PendingPages.Empty();
+
+	// Reopened in append mode if a page queued before still arrives.
+	CloseCheckpoint();
+}
+
+bool USpaceTradersCrawler::IsComplete() const
+{
+	return NumPages >= 0 && NumPagesDone >= NumPages;
+}
+
+UJsonObject* USpaceTradersCrawler::FindItem(const FString& Symbol) const
+{
+	const TSharedPtr<FJsonValue>* const Item = Items.Find(Symbol);
+	return Item ? UJsonObject::CreateFromRawValue(*Item) : nullptr;
+}
+
+TArray<FString> USpaceTradersCrawler::GetSymbols() const
+{
+	TArray<FString> Symbols;
+	Items.GenerateKeyArray(Symbols);
+	return Symbols;
+}
+
+void USpaceTradersCrawler::BeginDestroy()
+{
+	bRunning = false;
+	CloseCheckpoint();
+
+	Super::BeginDestroy();
+}
+
+void USpaceTradersCrawler::RequestPages()
+{
+	if (!bRunning)
+	{
+		return;
+	}
+
+	if (IsComplete())
+	{
+		Finish(true, FSpaceTradersError());
+		return;
+	}
+
+	// The number of pages is only known once the first one is received.
+	if (NumPages < 0)
+	{
+		if (PendingPages.Num() == 0)
+		{
+			RequestPage(1);
+		}
+		return;
+	}
+
+	const int32 MaxPending = FMath::Max(MaxPagesInFlight, 1);
+	for (; NextPage <= NumPages && PendingPages.Num() < MaxPending; ++NextPage)
+	{
+		if (!DonePages[NextPage - 1] && !PendingPages.Contains(NextPage))
+		{
+			RequestPage(NextPage);
+		}
+	}
+}
+
+void USpaceTradersCrawler::RequestPage(const int32 Page)
+{
+	PendingPages.FindOrAdd(Page, 0);
+
+	FSpaceTradersRequest Request;
+	Request.Path     = Path;
+	Request.Priority = ESpaceTradersPriority::Background;
+	Request.Query.Emplace(TEXT("page"),  LexToString(Page));
+	Request.Query.Emplace(TEXT("limit"), LexToString(PageLimit));
+
+	Client->Send(MoveTemp(Request), FOnSpaceTradersResponse::CreateWeakLambda(this, [this, Page](const FSpaceTradersResponse& Response) -> void
+	{
+		OnPageReceived(Page, Response);
+	}));
+}
+
+void USpaceTradersCrawler::OnPageReceived(const int32 Page, const FSpaceTradersResponse& Response)
+{
+	if (!Response.bSuccess)
+	{
+		int32* const NumFailures = PendingPages.Find(Page);
+		if (!bRunning || !NumFailures)
+		{
+			return;
+		}
+
+		if (++(*NumFailures) > MaxPageRetries || !Client.IsValid())
+		{
+			UE_LOG(LogSpaceTradersApi, Warning, TEXT("Crawl of %s stopped, page %d failed: %s"), *Path, Page, *Response.Error.Message);
+			Finish(false, Response.Error);
+			return;
+		}
+
+		RequestPage(Page);
+		return;
+	}
+
+	PendingPages.Remove(Page);
+
+	double Total = 0.;
+	double Limit = PageLimit;
+	if (Response.Meta && Response.Meta->TryGetNumberField(TEXT("total"), Total))
+	{
+		Response.Meta->TryGetNumberField(TEXT("limit"), Limit);
+		NumPages = FMath::DivideAndRoundUp(FMath::Max(static_cast<int32>(Total), 0), FMath::Max(static_cast<int32>(Limit), 1));
+	}
+	else if (NumPages < 0)
+	{
+		// Not a paginated endpoint, this page is all there is.
+		NumPages = 1;
+	}
+
+	SaveCheckpoint(Page, Response.Data);
+	AddPage(Page, Response.Data);
+
+	RequestPages();
+}
+
+void USpaceTradersCrawler::AddPage(const int32 Page, const TSharedPtr<FJsonValue>& Data)
+{
+	if (Page < 1)
+	{
+		return;
+	}
+
+	if (DonePages.Num() < FMath::Max(NumPages, Page))
+	{
+		DonePages.SetNum(FMath::Max(NumPages, Page), false);
+	}
+
+	if (DonePages[Page - 1])
+	{
+		return;
+	}
+
+	DonePages[Page - 1] = true;
+	++NumPagesDone;
+
+	const TArray<TSharedPtr<FJsonValue>>* PageItems = nullptr;
+	if (Data && Data->TryGetArray(PageItems))
+	{
+		Items.Reserve(Items.Num() + PageItems->Num());
+		for (const TSharedPtr<FJsonValue>& Item : *PageItems)
+		{
+			FString Symbol = GetItemSymbol(Item);
+			if (!Symbol.IsEmpty())
+			{
+				Items.Add(MoveTemp(Symbol), Item);
+			}
+		}
+
+		OnPage.Broadcast(Page, *PageItems);
+	}
+
+	Progress.Broadcast(NumPagesDone, GetNumPages());
+}
+
+void USpaceTradersCrawler::Finish(const bool bSuccess, const FSpaceTradersError& Error)
+{
+	bRunning = false;
+	PendingPages.Empty();
+
+	// A failed crawl keeps its checkpoint so it can be resumed.
+	CloseCheckpoint();
+	if (bSuccess)
+	{
+		IFileManager::Get().Delete(*CheckpointPath, false, false, true);
+	}
+
+	Completed.Broadcast(bSuccess, Error);
+}
+
+void USpaceTradersCrawler::LoadCheckpoint()
+{
+	TArray<uint8> File;
+	if (!FFileHelper::LoadFileToArray(File, *CheckpointPath, FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(File);
+
+	uint32  Magic   = 0;
+	int32   Version = 0;
+	FString CheckpointOf;
+	Reader << Magic << Version << CheckpointOf;
+
+	if (Reader.IsError() || Magic != CheckpointMagic || Version != CheckpointVersion || CheckpointOf != Path)
+	{
+		IFileManager::Get().Delete(*CheckpointPath, false, false, true);
+		return;
+	}
+
+	int64 ValidSize = Reader.Tell();
+	int32 NumLoaded = 0;
+
+	while (!Reader.AtEnd())
+	{
+		int32 Page       = 0;
+		int32 PagesTotal = 0;
+		TArray<uint8> Data;
+		Reader << Page << PagesTotal << Data;
+
+		// The game may have been closed while a page was being written.
+		const TSharedPtr<FJsonValue> Value = Reader.IsError() ? nullptr : FBlueprintJsonBinary::Read(Data, EJsonParseOptions::FlatObjects);
+		if (!Value)
+		{
+			break;
+		}
+
+		NumPages = PagesTotal;
+		AddPage(Page, Value);
+
+		ValidSize = Reader.Tell();
+		++NumLoaded;
+	}
+
+	if (ValidSize < File.Num())
+	{
+		File.SetNum(ValidSize);
+		FFileHelper::SaveArrayToFile(File, *CheckpointPath);
+	}
+
+	UE_LOG(LogSpaceTradersApi, Log, TEXT("Resuming crawl of %s: %d pages loaded from the checkpoint."), *Path, NumLoaded);
+}
+
+void USpaceTradersCrawler::SaveCheckpoint(const int32 Page, const TSharedPtr<FJsonValue>& Data)
+{
+	if (!CheckpointWriter)
+	{
+		const bool bAppend = IFileManager::Get().FileSize(*CheckpointPath) > 0;
+
+		CheckpointWriter.Reset(IFileManager::Get().CreateFileWriter(*CheckpointPath, bAppend ? FILEWRITE_Append : FILEWRITE_None));
+		if (!CheckpointWriter)
+		{
+			UE_LOG(LogSpaceTradersApi, Warning, TEXT("Failed to create the crawl checkpoint %s."), *CheckpointPath);
+			return;
+		}
+
+		if (!bAppend)
+		{
+			uint32 Magic   = CheckpointMagic;
+			int32  Version = CheckpointVersion;
+			*CheckpointWriter << Magic << Version << Path;
+		}
+	}
+
+	TArray<uint8> Binary;
+	FBlueprintJsonBinary::Write(Data, Binary);
+
+	int32 PageIndex  = Page;
+	int32 PagesTotal = NumPages;
+	*CheckpointWriter << PageIndex << PagesTotal << Binary;
+
+	// Pages arrive a few times per second at most, flushing each one keeps the file usable after a crash.
+	CheckpointWriter->Flush();
+}
+
+void USpaceTradersCrawler::CloseCheckpoint()
+{
+	if (CheckpointWriter)
+	{
+		CheckpointWriter->Close();
+		CheckpointWriter.Reset();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdCrawl(
+	TEXT("SpaceTraders.Crawl"),
+	TEXT("Crawls every system of the galaxy, or every waypoint of a system, and logs the throughput once done.\n")
+	TEXT("Meant to be run against the mock server in Tools/SpaceTradersMock. Running it again while a crawl is in progress stops it.\n")
+	TEXT("Usage: SpaceTraders.Crawl [SystemSymbol]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		// Owned by the client until it completes, so it never outlives the game instance.
+		static TWeakObjectPtr<USpaceTradersCrawler> Crawler;
+
+		if (Crawler.IsValid() && Crawler->IsRunning())
+		{
+			Crawler->Stop();
+			UE_LOG(LogSpaceTradersApi, Display, TEXT("Crawl stopped after %d of %d pages."), Crawler->GetNumPagesDone(), Crawler->GetNumPages());
+			Crawler.Reset();
+			return;
+		}
+
+		USpaceTradersApiClient* const Client = USpaceTradersApiClient::Get(World);
+		Crawler = Args.Num() > 0 ? USpaceTradersCrawler::CrawlWaypoints(World, Args[0]) : USpaceTradersCrawler::CrawlSystems(World);
+		if (!Crawler.IsValid())
+		{
+			return;
+		}
+
+		Client->RetainCrawler(Crawler.Get());
+
+		struct FCrawlStats
+		{
+			double StartTime;
+			int64  SentBefore;
+			int64  ThrottledBefore;
+			int64  CacheHitsBefore;
+			int32  ReportedDecile = 0;
+		};
+
+		const TSharedRef<FCrawlStats> Stats = MakeShared<FCrawlStats>();
+		Stats->StartTime       = FPlatformTime::Seconds();
+		Stats->SentBefore      = Client->GetNumSentRequests();
+		Stats->ThrottledBefore = Client->GetNumThrottledRequests();
+		Stats->CacheHitsBefore = Client->GetNumCacheHits();
+
+		TWeakObjectPtr<USpaceTradersApiClient> WeakClient = Client;
+		TWeakObjectPtr<USpaceTradersCrawler>   WeakCrawler = Crawler.Get();
+
+		Crawler->OnPage.AddLambda([Stats, WeakCrawler](int32 Page, const TArray<TSharedPtr<FJsonValue>>& Items)
+		{
+			const int32 NumPages = WeakCrawler.IsValid() ? WeakCrawler->GetNumPages() : 0;
+			const int32 Decile   = NumPages > 0 ? WeakCrawler->GetNumPagesDone() * 10 / NumPages : 0;
+			if (Decile > Stats->ReportedDecile)
+			{
+				Stats->ReportedDecile = Decile;
+				UE_LOG(LogSpaceTradersApi, Display, TEXT("Crawl: %d of %d pages after %.1fs."), WeakCrawler->GetNumPagesDone(), NumPages, FPlatformTime::Seconds() - Stats->StartTime);
+			}
+		});
+
+		// Completion is polled, dynamic delegates can't bind lambdas.
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([Stats, WeakClient, WeakCrawler](float) -> bool
+		{
+			if (!WeakCrawler.IsValid() || !WeakClient.IsValid())
+			{
+				return false;
+			}
+
+			if (WeakCrawler->IsRunning())
+			{
+				return true;
+			}
+
+			WeakClient->ReleaseCrawler(WeakCrawler.Get());
+
+			const double Elapsed  = FMath::Max(FPlatformTime::Seconds() - Stats->StartTime, UE_SMALL_NUMBER);
+			const int32  NumItems = WeakCrawler->GetNumItems();
+			const int32  NumPages = WeakCrawler->GetNumPagesDone();
+
+			UE_LOG(LogSpaceTradersApi, Display, TEXT("Crawl %s: %d pages and %d items in %.2fs (%.2f pages/s, %.1f items/s), %lld requests sent, %lld rejected with 429, %lld cache hits."),
+				WeakCrawler->IsComplete() ? TEXT("completed") : TEXT("stopped"), NumPages, NumItems, Elapsed, NumPages / Elapsed, NumItems / Elapsed,
+				WeakClient->GetNumSentRequests() - Stats->SentBefore,
+				WeakClient->GetNumThrottledRequests() - Stats->ThrottledBefore,
+				WeakClient->GetNumCacheHits() - Stats->CacheHitsBefore);
+
+			return false;
+		}), 0.25f);
+
+		Crawler->Start();
+	}));
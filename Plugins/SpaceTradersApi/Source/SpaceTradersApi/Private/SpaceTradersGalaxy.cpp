@@ -0,0 +1,345 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersGalaxy.h"
+#include "SpaceTradersApi.h"
+#include "SpaceTradersCrawler.h"
+#include "BlueprintJsonWrapper.h"
+#include "Dom/JsonValue.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	/* Returns the raw values of Objects, skipping nulls. */
+	TArray<TSharedPtr<FJsonValue>> ToRawValues(const TArray<UJsonObject*>& Objects)
+	{
+		TArray<TSharedPtr<FJsonValue>> Values;
+		Values.Reserve(Objects.Num());
+		for (const UJsonObject* const Object : Objects)
+		{
+			if (Object)
+			{
+				Values.Add(Object->GetRawValue());
+			}
+		}
+		return Values;
+	}
+}
+
+
+/* static */ USpaceTradersGalaxy* USpaceTradersGalaxy::Get(const UObject* const WorldContextObject)
+{
+	const UWorld* const World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	const UGameInstance* const GameInstance = World ? World->GetGameInstance() : nullptr;
+
+	return GameInstance ? GameInstance->GetSubsystem<USpaceTradersGalaxy>() : nullptr;
+}
+
+void USpaceTradersGalaxy::AddCrawler(USpaceTradersCrawler* Crawler)
+{
+	if (!Crawler)
+	{
+		return;
+	}
+
+	const bool bWaypoints = Crawler->GetPath().EndsWith(TEXT("/waypoints"));
+
+	// Items received before, e.g. loaded from the checkpoint, are added in one go.
+	if (Crawler->GetNumItems() > 0)
+	{
+		TArray<TSharedPtr<FJsonValue>> Items;
+		Crawler->GetItems().GenerateValueArray(Items);
+		OnCrawlerPage(0, Items, bWaypoints);
+	}
+
+	Crawler->OnPage.AddUObject(this, &ThisClass::OnCrawlerPage, bWaypoints);
+}
+
+void USpaceTradersGalaxy::AddSystems(const TArray<UJsonObject*>& Systems)
+{
+	AddSystemItems(ToRawValues(Systems));
+}
+
+void USpaceTradersGalaxy::AddWaypoints(const TArray<UJsonObject*>& Waypoints)
+{
+	AddWaypointItems(ToRawValues(Waypoints));
+}
+
+void USpaceTradersGalaxy::AddJumpGates(const TArray<UJsonObject*>& JumpGates)
+{
+	AddJumpGateItems(ToRawValues(JumpGates));
+}
+
+void USpaceTradersGalaxy::AddSystemItems(TConstArrayView<TSharedPtr<FJsonValue>> Items)
+{
+	TArray<int32> Systems;
+	TArray<int32> Waypoints;
+	Store.AddSystems(Items, &Systems, &Waypoints);
+
+	Broadcast(Systems, Waypoints);
+}
+
+void USpaceTradersGalaxy::AddWaypointItems(TConstArrayView<TSharedPtr<FJsonValue>> Items)
+{
+	const int32 NumSystemsBefore = Store.NumSystems();
+
+	TArray<int32> Waypoints;
+	Store.AddWaypoints(Items, &Waypoints);
+
+	// Systems are added for waypoints of unknown systems.
+	TArray<int32> Systems;
+	for (int32 System = NumSystemsBefore; System < Store.NumSystems(); ++System)
+	{
+		Systems.Add(System);
+	}
+
+	Broadcast(Systems, Waypoints);
+}
+
+void USpaceTradersGalaxy::AddJumpGateItems(TConstArrayView<TSharedPtr<FJsonValue>> Items)
+{
+	const int32 NumSystemsBefore = Store.NumSystems();
+
+	TArray<int32> Waypoints;
+	Store.AddJumpGates(Items, &Waypoints);
+
+	TArray<int32> Systems;
+	for (int32 System = NumSystemsBefore; System < Store.NumSystems(); ++System)
+	{
+		Systems.Add(System);
+	}
+
+	Broadcast(Systems, Waypoints);
+}
+
+void USpaceTradersGalaxy::OnCrawlerPage(int32 Page, const TArray<TSharedPtr<FJsonValue>>& Items, const bool bWaypoints)
+{
+	if (bWaypoints)
+	{
+		AddWaypointItems(Items);
+	}
+	else
+	{
+		AddSystemItems(Items);
+	}
+}
+
+void USpaceTradersGalaxy::Broadcast(const TArray<int32>& AddedSystems, const TArray<int32>& Waypoints)
+{
+	// Systems known from their waypoints alone would all sit at the origin, they're
+	// left out of the grid, the clusters and listeners until their page arrives.
+	TArray<int32> Systems;
+	Systems.Reserve(AddedSystems.Num());
+	for (const int32 System : AddedSystems)
+	{
+		if (Store.IsSystemPlaced(System))
+		{
+			Systems.Add(System);
+		}
+	}
+
+	if (Systems.Num() == 0 && Waypoints.Num() == 0)
+	{
+		return;
+	}
+
+	for (const int32 System : Systems)
+	{
+		SystemGrid.Add(System, FIntPoint(Store.GetSystemX()[System], Store.GetSystemY()[System]));
+	}
+
+	// Distances between the waypoints of these systems may have changed.
+	TSet<int32> ChangedSystems;
+	for (const int32 Waypoint : Waypoints)
+	{
+		ChangedSystems.Add(Store.GetWaypointSystems()[Waypoint]);
+	}
+	RoutePlanner.Invalidate(ChangedSystems.Array());
+
+	if (Systems.Num() > 0)
+	{
+		TArray<TArray<int32>> ChangedClusters;
+		Clusters.Update(Store, Systems, &ChangedClusters);
+		OnClustersUpdated.Broadcast(ChangedClusters);
+	}
+
+	OnUpdated.Broadcast(Systems, Waypoints);
+	Updated.Broadcast(Store.NumSystems(), Store.NumWaypoints());
+}
+
+FString USpaceTradersGalaxy::GetSystemSymbol(const int32 System) const
+{
+	return Store.GetSystemX().IsValidIndex(System) ? Store.GetSystemSymbol(System) : FString();
+}
+
+bool USpaceTradersGalaxy::IsSystemPlaced(const int32 System) const
+{
+	return Store.GetSystemX().IsValidIndex(System) && Store.IsSystemPlaced(System);
+}
+
+FIntPoint USpaceTradersGalaxy::GetSystemLocation(const int32 System) const
+{
+	return Store.GetSystemX().IsValidIndex(System) ? FIntPoint(Store.GetSystemX()[System], Store.GetSystemY()[System]) : FIntPoint::ZeroValue;
+}
+
+ESpaceTradersSystemType USpaceTradersGalaxy::GetSystemType(const int32 System) const
+{
+	return Store.GetSystemTypes().IsValidIndex(System) ? Store.GetSystemTypes()[System] : ESpaceTradersSystemType::Unknown;
+}
+
+TArray<int32> USpaceTradersGalaxy::GetSystemWaypoints(const int32 System) const
+{
+	return Store.GetSystemX().IsValidIndex(System) ? TArray<int32>(Store.GetSystemWaypoints(System)) : TArray<int32>();
+}
+
+TArray<FIntPoint> USpaceTradersGalaxy::GetSystemLocations() const
+{
+	const TConstArrayView<int32> X = Store.GetSystemX();
+	const TConstArrayView<int32> Y = Store.GetSystemY();
+
+	TArray<FIntPoint> Locations;
+	Locations.SetNumUninitialized(X.Num());
+	for (int32 i = 0; i < X.Num(); ++i)
+	{
+		Locations[i] = FIntPoint(X[i], Y[i]);
+	}
+	return Locations;
+}
+
+FString USpaceTradersGalaxy::GetWaypointSymbol(const int32 Waypoint) const
+{
+	return Store.GetWaypointX().IsValidIndex(Waypoint) ? Store.GetWaypointSymbol(Waypoint) : FString();
+}
+
+FIntPoint USpaceTradersGalaxy::GetWaypointLocation(const int32 Waypoint) const
+{
+	return Store.GetWaypointX().IsValidIndex(Waypoint) ? FIntPoint(Store.GetWaypointX()[Waypoint], Store.GetWaypointY()[Waypoint]) : FIntPoint::ZeroValue;
+}
+
+ESpaceTradersWaypointType USpaceTradersGalaxy::GetWaypointType(const int32 Waypoint) const
+{
+	return Store.GetWaypointTypes().IsValidIndex(Waypoint) ? Store.GetWaypointTypes()[Waypoint] : ESpaceTradersWaypointType::Unknown;
+}
+
+int32 USpaceTradersGalaxy::GetWaypointSystem(const int32 Waypoint) const
+{
+	return Store.GetWaypointSystems().IsValidIndex(Waypoint) ? Store.GetWaypointSystems()[Waypoint] : INDEX_NONE;
+}
+
+bool USpaceTradersGalaxy::HasWaypointTrait(const int32 Waypoint, const FString& Trait) const
+{
+	const int32 Bit = Store.FindTrait(Trait);
+	return Bit != INDEX_NONE && Store.GetWaypointTraits().IsValidIndex(Waypoint) && (Store.GetWaypointTraits()[Waypoint] & (uint64(1) << Bit)) != 0;
+}
+
+TArray<FString> USpaceTradersGalaxy::GetWaypointTraits(const int32 Waypoint) const
+{
+	TArray<FString> Traits;
+	if (Store.GetWaypointTraits().IsValidIndex(Waypoint))
+	{
+		const uint64 Mask = Store.GetWaypointTraits()[Waypoint];
+		for (int32 Bit = 0; Bit < Store.NumTraits(); ++Bit)
+		{
+			if (Mask & (uint64(1) << Bit))
+			{
+				Traits.Add(Store.GetTraitName(Bit));
+			}
+		}
+	}
+	return Traits;
+}
+
+TArray<int32> USpaceTradersGalaxy::FindSystemsInRadius(const FVector2D& Center, const float Radius) const
+{
+	TArray<int32> Systems;
+	SystemGrid.QueryRadius(Center, Radius, Systems);
+	return Systems;
+}
+
+TArray<int32> USpaceTradersGalaxy::FindNearestSystems(const FVector2D& Center, const int32 Count) const
+{
+	TArray<int32> Systems;
+	SystemGrid.QueryNearest(Center, Count, Systems);
+	return Systems;
+}
+
+TArray<int32> USpaceTradersGalaxy::FindSystemsInRectangle(const FVector2D& Min, const FVector2D& Max) const
+{
+	TArray<int32> Systems;
+	SystemGrid.QueryRectangle(Min.ComponentMin(Max), Min.ComponentMax(Max), Systems);
+	return Systems;
+}
+
+TArray<int32> USpaceTradersGalaxy::FindSystemsInPolygon(const TArray<FVector2D>& Polygon) const
+{
+	TArray<int32> Systems;
+	SystemGrid.QueryPolygon(Polygon, Systems);
+	return Systems;
+}
+
+int32 USpaceTradersGalaxy::GetClusterLevel(const float Distance, const float GalaxyScale, const float Detail) const
+{
+	return Clusters.GetLevelForDistance(Distance, GalaxyScale, Detail);
+}
+
+TArray<FSpaceTradersSystemCluster> USpaceTradersGalaxy::FindClustersInRectangle(const int32 Level, const FVector2D& Min, const FVector2D& Max) const
+{
+	TArray<FSpaceTradersSystemCluster> Result;
+	if (Level < 0 || Level >= Clusters.NumLevels())
+	{
+		return Result;
+	}
+
+	TArray<int32> Indices;
+	Clusters.QueryRectangle(Level, Min.ComponentMin(Max), Min.ComponentMax(Max), Indices);
+
+	Result.Reserve(Indices.Num());
+	for (const int32 Cluster : Indices)
+	{
+		Result.Add(Clusters.GetCluster(Level, Cluster));
+	}
+	return Result;
+}
+
+TArray<FSpaceTradersRoute> USpaceTradersGalaxy::PlanRoutes(const TArray<FSpaceTradersRouteQuery>& Queries) const
+{
+	TArray<FSpaceTradersRoute> Routes;
+	RoutePlanner.PlanRoutes(Queries, Routes);
+	return Routes;
+}
+
+/* static */ UJsonObject* USpaceTradersGalaxy::RouteToJson(const FSpaceTradersRoute& Route)
+{
+	return UJsonObject::CreateFromRaw(Route.ToJson());
+}
+
+void USpaceTradersGalaxy::Reset()
+{
+	Store.Reset();
+	SystemGrid.Reset();
+	Clusters.Reset();
+	RoutePlanner.Reset();
+	OnReset.Broadcast();
+	Updated.Broadcast(0, 0);
+}
+
+static FAutoConsoleCommandWithWorld CmdGalaxyStats(
+	TEXT("SpaceTraders.GalaxyStats"),
+	TEXT("Logs the number of systems and waypoints in the galaxy store and the memory they use."),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+	{
+		const USpaceTradersGalaxy* const Galaxy = USpaceTradersGalaxy::Get(World);
+		if (!Galaxy)
+		{
+			return;
+		}
+
+		const FSpaceTradersGalaxyStore& Store = Galaxy->GetStore();
+		const SIZE_T Size = Galaxy->GetAllocatedSize();
+
+		UE_LOG(LogSpaceTradersApi, Display, TEXT("Galaxy: %d systems, %d waypoints, %d symbols, %d traits, %.2f MB (%.1f bytes per body)."),
+			Store.NumSystems(), Store.NumWaypoints(), Store.GetSymbols().Num(), Store.NumTraits(),
+			Size / (1024. * 1024.), Size / double(FMath::Max(Store.NumSystems() + Store.NumWaypoints(), 1)));
+	}));
@@ -0,0 +1,245 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersGalaxyClusters.h"
+#include "Algo/Unique.h"
+
+
+FSpaceTradersGalaxyClusters::FSpaceTradersGalaxyClusters(const int32 InCellSize, const int32 InNumLevels)
+	: CellSize(FMath::Max(InCellSize, 1))
+{
+	// Cells of the top level must still fit in int64 sums and int32 cell coordinates.
+	Levels.SetNum(FMath::Clamp(InNumLevels, 1, 24));
+}
+
+FIntPoint FSpaceTradersGalaxyClusters::GetCell(const int32 Level, const FIntPoint Location) const
+{
+	const double Size = double(GetCellSize(Level));
+	return FIntPoint(FMath::FloorToInt32(Location.X / Size), FMath::FloorToInt32(Location.Y / Size));
+}
+
+int32 FSpaceTradersGalaxyClusters::AddToCluster(const int32 Level, const FIntPoint Location, const ESpaceTradersSystemType Type)
+{
+	FLevel& Data = Levels[Level];
+	const FIntPoint Cell = GetCell(Level, Location);
+
+	int32 Cluster;
+	if (const int32* const Existing = Data.CellClusters.Find(Cell))
+	{
+		Cluster = *Existing;
+	}
+	else
+	{
+		Cluster = Data.Cells.Add(Cell);
+		Data.SumX.Add(0);
+		Data.SumY.Add(0);
+		Data.Counts.Add(0);
+		Data.TypeCounts.AddZeroed(NumTypes);
+		Data.CellClusters.Add(Cell, Cluster);
+	}
+
+	Data.SumX[Cluster] += Location.X;
+	Data.SumY[Cluster] += Location.Y;
+	++Data.Counts[Cluster];
+	++Data.TypeCounts[Cluster * NumTypes + static_cast<int32>(Type)];
+
+	return Cluster;
+}
+
+void FSpaceTradersGalaxyClusters::RemoveFromCluster(const int32 Level, const int32 Cluster, const FIntPoint Location, const ESpaceTradersSystemType Type)
+{
+	// Empty clusters stay, so their index keeps pointing at the same cell.
+	FLevel& Data = Levels[Level];
+	Data.SumX[Cluster] -= Location.X;
+	Data.SumY[Cluster] -= Location.Y;
+	--Data.Counts[Cluster];
+	--Data.TypeCounts[Cluster * NumTypes + static_cast<int32>(Type)];
+}
+
+void FSpaceTradersGalaxyClusters::Update(const FSpaceTradersGalaxyStore& Store, TConstArrayView<int32> Systems, TArray<TArray<int32>>* OutChanged)
+{
+	const int32 NumLevelsCount = Levels.Num();
+
+	TArray<int32> FirstChanged;
+	if (OutChanged)
+	{
+		OutChanged->SetNum(NumLevelsCount);
+		FirstChanged.SetNumUninitialized(NumLevelsCount);
+		for (int32 Level = 0; Level < NumLevelsCount; ++Level)
+		{
+			FirstChanged[Level] = (*OutChanged)[Level].Num();
+		}
+	}
+
+	if (Store.NumSystems() > Present.Num())
+	{
+		SystemLocations.SetNumZeroed(Store.NumSystems());
+		SystemTypes.SetNumZeroed(Store.NumSystems());
+		SystemClusters.SetNum(Store.NumSystems() * NumLevelsCount);
+		Present.SetNum(Store.NumSystems(), false);
+	}
+
+	for (const int32 System : Systems)
+	{
+		if (!Present.IsValidIndex(System) || !Store.IsSystemPlaced(System))
+		{
+			continue;
+		}
+
+		const FIntPoint Location(Store.GetSystemX()[System], Store.GetSystemY()[System]);
+		const ESpaceTradersSystemType Type = Store.GetSystemTypes()[System];
+
+		const bool bWasPresent = Present[System];
+		if (bWasPresent && SystemLocations[System] == Location && SystemTypes[System] == Type)
+		{
+			continue;
+		}
+
+		int32* const Clusters = &SystemClusters[System * NumLevelsCount];
+		for (int32 Level = 0; Level < NumLevelsCount; ++Level)
+		{
+			if (bWasPresent)
+			{
+				RemoveFromCluster(Level, Clusters[Level], SystemLocations[System], SystemTypes[System]);
+				if (OutChanged)
+				{
+					(*OutChanged)[Level].Add(Clusters[Level]);
+				}
+			}
+
+			Clusters[Level] = AddToCluster(Level, Location, Type);
+			if (OutChanged)
+			{
+				(*OutChanged)[Level].Add(Clusters[Level]);
+			}
+		}
+
+		SystemLocations[System] = Location;
+		SystemTypes[System]     = Type;
+		Present[System]         = true;
+	}
+
+	// Pages of neighbouring systems change the same coarse clusters over and over.
+	if (OutChanged)
+	{
+		for (int32 Level = 0; Level < NumLevelsCount; ++Level)
+		{
+			TArray<int32>& Changed = (*OutChanged)[Level];
+			TArrayView<int32> Appended = TArrayView<int32>(Changed).RightChop(FirstChanged[Level]);
+			Appended.Sort();
+			Changed.SetNum(FirstChanged[Level] + Algo::Unique(Appended), EAllowShrinking::No);
+		}
+	}
+}
+
+void FSpaceTradersGalaxyClusters::Reset()
+{
+	for (FLevel& Level : Levels)
+	{
+		Level = FLevel();
+	}
+
+	SystemLocations.Reset();
+	SystemTypes.Reset();
+	SystemClusters.Reset();
+	Present.Reset();
+}
+
+int32 FSpaceTradersGalaxyClusters::GetLevelForDistance(const double Distance, const double GalaxyScale, const double Detail) const
+{
+	const double Width = Distance * Detail / FMath::Max(GalaxyScale, UE_SMALL_NUMBER);
+	if (Width < CellSize)
+	{
+		return INDEX_NONE;
+	}
+
+	return FMath::Min(FMath::FloorToInt32(FMath::Log2(Width / CellSize)), Levels.Num() - 1);
+}
+
+FSpaceTradersSystemCluster FSpaceTradersGalaxyClusters::GetCluster(const int32 Level, const int32 Cluster) const
+{
+	FSpaceTradersSystemCluster Result;
+
+	const FLevel& Data = Levels[Level];
+	Result.NumSystems = Data.Counts[Cluster];
+	if (Result.NumSystems == 0)
+	{
+		return Result;
+	}
+
+	Result.Location = FVector2D(double(Data.SumX[Cluster]) / Result.NumSystems, double(Data.SumY[Cluster]) / Result.NumSystems);
+
+	// Systems of unknown type are only known from their waypoints, they don't outvote known ones.
+	const int32* const TypeCounts = &Data.TypeCounts[Cluster * NumTypes];
+	int32 BestCount = 0;
+	for (int32 TypeIndex = 1; TypeIndex < NumTypes; ++TypeIndex)
+	{
+		if (TypeCounts[TypeIndex] > BestCount)
+		{
+			BestCount           = TypeCounts[TypeIndex];
+			Result.DominantType = static_cast<ESpaceTradersSystemType>(TypeIndex);
+		}
+	}
+
+	return Result;
+}
+
+int32 FSpaceTradersGalaxyClusters::GetSystemCluster(const int32 Level, const int32 System) const
+{
+	return Present.IsValidIndex(System) && Present[System] ? SystemClusters[System * Levels.Num() + Level] : INDEX_NONE;
+}
+
+void FSpaceTradersGalaxyClusters::QueryRectangle(const int32 Level, const FVector2D& Min, const FVector2D& Max, TArray<int32>& OutClusters) const
+{
+	const FLevel& Data = Levels[Level];
+	const double Size = double(GetCellSize(Level));
+
+	const FIntPoint MinCell(FMath::FloorToInt32(FMath::Clamp(Min.X / Size, double(MIN_int32 / 2), double(MAX_int32 / 2))),
+		FMath::FloorToInt32(FMath::Clamp(Min.Y / Size, double(MIN_int32 / 2), double(MAX_int32 / 2))));
+	const FIntPoint MaxCell(FMath::FloorToInt32(FMath::Clamp(Max.X / Size, double(MIN_int32 / 2), double(MAX_int32 / 2))),
+		FMath::FloorToInt32(FMath::Clamp(Max.Y / Size, double(MIN_int32 / 2), double(MAX_int32 / 2))));
+
+	if (MinCell.X > MaxCell.X || MinCell.Y > MaxCell.Y)
+	{
+		return;
+	}
+
+	// Same trade-off as the spatial grid, large ranges are mostly empty.
+	const int64 NumRangeCells = int64(MaxCell.X - MinCell.X + 1) * int64(MaxCell.Y - MinCell.Y + 1);
+	if (NumRangeCells > Data.Cells.Num())
+	{
+		for (int32 Cluster = 0; Cluster < Data.Cells.Num(); ++Cluster)
+		{
+			const FIntPoint Cell = Data.Cells[Cluster];
+			if (Data.Counts[Cluster] > 0 && Cell.X >= MinCell.X && Cell.X <= MaxCell.X && Cell.Y >= MinCell.Y && Cell.Y <= MaxCell.Y)
+			{
+				OutClusters.Add(Cluster);
+			}
+		}
+		return;
+	}
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			const int32* const Cluster = Data.CellClusters.Find(FIntPoint(X, Y));
+			if (Cluster && Data.Counts[*Cluster] > 0)
+			{
+				OutClusters.Add(*Cluster);
+			}
+		}
+	}
+}
+
+SIZE_T FSpaceTradersGalaxyClusters::GetAllocatedSize() const
+{
+	SIZE_T Size = Levels.GetAllocatedSize() + SystemLocations.GetAllocatedSize() + SystemTypes.GetAllocatedSize()
+		+ Present.GetAllocatedSize() + SystemClusters.GetAllocatedSize();
+
+	for (const FLevel& Level : Levels)
+	{
+		Size += Level.CellClusters.GetAllocatedSize() + Level.Cells.GetAllocatedSize() + Level.SumX.GetAllocatedSize()
+			+ Level.SumY.GetAllocatedSize() + Level.Counts.GetAllocatedSize() + Level.TypeCounts.GetAllocatedSize();
+	}
+	return Size;
+}
@@ -0,0 +1,458 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersGalaxyMeshComponent.h"
+#include "SpaceTradersGalaxy.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/GameInstance.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+
+namespace
+{
+	constexpr int32 NumSystemTypes = static_cast<int32>(ESpaceTradersSystemType::MAX);
+}
+
+
+USpaceTradersGalaxyMeshComponent::USpaceTradersGalaxyMeshComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+void USpaceTradersGalaxyMeshComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	const UGameInstance* const GameInstance = GetWorld() ? GetWorld()->GetGameInstance() : nullptr;
+	Galaxy = GameInstance ? GameInstance->GetSubsystem<USpaceTradersGalaxy>() : nullptr;
+
+	if (Galaxy)
+	{
+		Galaxy->OnUpdated.AddUObject(this, &ThisClass::OnGalaxyUpdated);
+		Galaxy->OnReset  .AddUObject(this, &ThisClass::OnGalaxyReset);
+		Galaxy->OnClustersUpdated.AddUObject(this, &ThisClass::OnClustersUpdated);
+		Rebuild();
+	}
+}
+
+void USpaceTradersGalaxyMeshComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (Galaxy)
+	{
+		Galaxy->OnUpdated.RemoveAll(this);
+		Galaxy->OnReset  .RemoveAll(this);
+		Galaxy->OnClustersUpdated.RemoveAll(this);
+		Galaxy = nullptr;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USpaceTradersGalaxyMeshComponent::OnGalaxyUpdated(TConstArrayView<int32> Systems, TConstArrayView<int32> Waypoints)
+{
+	UpdateSystemIndices(Systems);
+}
+
+void USpaceTradersGalaxyMeshComponent::OnGalaxyReset()
+{
+	ClearInstances();
+}
+
+const FSpaceTradersSystemMesh* USpaceTradersGalaxyMeshComponent::FindMesh(const ESpaceTradersSystemType Type) const
+{
+	const FSpaceTradersSystemMesh* const Mesh = TypeMeshes.Find(Type);
+	return Mesh ? Mesh : &DefaultMesh;
+}
+
+FTransform USpaceTradersGalaxyMeshComponent::GetSystemTransform(const int32 System, const ESpaceTradersSystemType Type) const
+{
+	const FSpaceTradersGalaxyStore& Store = Galaxy->GetStore();
+	const FVector Location(Store.GetSystemX()[System] * GalaxyScale, Store.GetSystemY()[System] * GalaxyScale, 0.);
+
+	return FTransform(FQuat::Identity, Location, FindMesh(Type)->Scale);
+}
+
+UInstancedStaticMeshComponent* USpaceTradersGalaxyMeshComponent::CreateComponent(const FSpaceTradersSystemMesh& Mesh, const FString& Name)
+{
+	UClass* const ComponentClass = bUseHierarchicalInstances ? UHierarchicalInstancedStaticMeshComponent::StaticClass() : UInstancedStaticMeshComponent::StaticClass();
+
+	UInstancedStaticMeshComponent* const Component = NewObject<UInstancedStaticMeshComponent>(GetOwner(), ComponentClass,
+		MakeUniqueObjectName(GetOwner(), ComponentClass, *FString::Printf(TEXT("%s_%s"), *GetName(), *Name)));
+
+	Component->SetStaticMesh(Mesh.Mesh);
+	if (Mesh.Material)
+	{
+		Component->SetMaterial(0, Mesh.Material);
+	}
+	Component->SetCollisionEnabled(bEnableCollision ? ECollisionEnabled::QueryOnly : ECollisionEnabled::NoCollision);
+	Component->SetupAttachment(this);
+	Component->RegisterComponent();
+
+	return Component;
+}
+
+UInstancedStaticMeshComponent* USpaceTradersGalaxyMeshComponent::GetOrCreateComponent(const ESpaceTradersSystemType Type)
+{
+	TypeComponents.SetNum(NumSystemTypes);
+
+	const int32 TypeIndex = static_cast<int32>(Type);
+	if (TypeComponents[TypeIndex])
+	{
+		return TypeComponents[TypeIndex];
+	}
+
+	const FSpaceTradersSystemMesh* const Mesh = FindMesh(Type);
+	if (!Mesh->Mesh)
+	{
+		return nullptr;
+	}
+
+	UInstancedStaticMeshComponent* const Component = CreateComponent(*Mesh, StaticEnum<ESpaceTradersSystemType>()->GetNameStringByValue(TypeIndex));
+	Component->SetVisibility(ClusterLevel == INDEX_NONE);
+
+	TypeComponents[TypeIndex] = Component;
+	return Component;
+}
+
+void USpaceTradersGalaxyMeshComponent::UpdateSystems(const TArray<int32>& Systems)
+{
+	UpdateSystemIndices(Systems);
+}
+
+void USpaceTradersGalaxyMeshComponent::UpdateSystemIndices(TConstArrayView<int32> Systems)
+{
+	if (!Galaxy)
+	{
+		return;
+	}
+
+	const FSpaceTradersGalaxyStore& Store = Galaxy->GetStore();
+	SystemInstances.SetNum(Store.NumSystems());
+
+	// Sorts the systems by what happens to them, per type, so each type gets one call of each kind.
+	TArray<int32> Removed[NumSystemTypes];
+	TArray<int32> Moved  [NumSystemTypes];
+	TArray<int32> Added  [NumSystemTypes];
+
+	TBitArray<> Seen(false, SystemInstances.Num());
+
+	for (const int32 System : Systems)
+	{
+		// Systems that aren't placed would all be drawn at the origin.
+		if (!SystemInstances.IsValidIndex(System) || Seen[System] || !Store.IsSystemPlaced(System))
+		{
+			continue;
+		}
+		Seen[System] = true;
+
+		const ESpaceTradersSystemType Type = Store.GetSystemTypes()[System];
+		const FSystemInstance& Entry = SystemInstances[System];
+
+		if (Entry.Instance != INDEX_NONE && Entry.Type == Type)
+		{
+			Moved[static_cast<int32>(Type)].Add(System);
+			continue;
+		}
+
+		// The type changed, e.g. a system first known from one of its waypoints was crawled.
+		if (Entry.Instance != INDEX_NONE)
+		{
+			Removed[static_cast<int32>(Entry.Type)].Add(System);
+		}
+
+		if (GetOrCreateComponent(Type))
+		{
+			Added[static_cast<int32>(Type)].Add(System);
+		}
+	}
+
+	// Removals move instances around, so they go first and moves use the indices they leave.
+	for (int32 TypeIndex = 0; TypeIndex < NumSystemTypes; ++TypeIndex)
+	{
+		if (Removed[TypeIndex].Num() > 0)
+		{
+			RemoveInstances(static_cast<ESpaceTradersSystemType>(TypeIndex), Removed[TypeIndex]);
+		}
+	}
+
+	TArray<FTransform> Transforms;
+
+	for (int32 TypeIndex = 0; TypeIndex < NumSystemTypes; ++TypeIndex)
+	{
+		const ESpaceTradersSystemType Type = static_cast<ESpaceTradersSystemType>(TypeIndex);
+		UInstancedStaticMeshComponent* const Component = TypeComponents.IsValidIndex(TypeIndex) ? TypeComponents[TypeIndex].Get() : nullptr;
+		if (!Component)
+		{
+			continue;
+		}
+
+		if (Moved[TypeIndex].Num() > 0)
+		{
+			// One batch per run of consecutive instances. Crawled pages are added in order, so runs are long.
+			TArray<int32>& MovedSystems = Moved[TypeIndex];
+			MovedSystems.Sort([this](const int32 A, const int32 B) { return SystemInstances[A].Instance < SystemInstances[B].Instance; });
+
+			for (int32 RunStart = 0; RunStart < MovedSystems.Num();)
+			{
+				int32 RunEnd = RunStart + 1;
+				while (RunEnd < MovedSystems.Num() && SystemInstances[MovedSystems[RunEnd]].Instance == SystemInstances[MovedSystems[RunEnd - 1]].Instance + 1)
+				{
+					++RunEnd;
+				}
+
+				Transforms.Reset();
+				for (int32 i = RunStart; i < RunEnd; ++i)
+				{
+					Transforms.Add(GetSystemTransform(MovedSystems[i], Type));
+				}
+
+				Component->BatchUpdateInstancesTransforms(SystemInstances[MovedSystems[RunStart]].Instance, Transforms, false, false, true);
+				RunStart = RunEnd;
+			}
+
+			Component->MarkRenderStateDirty();
+		}
+
+		if (Added[TypeIndex].Num() > 0)
+		{
+			TArray<int32>& TypeSystems = InstanceSystems[TypeIndex];
+
+			Transforms.Reset();
+			for (const int32 System : Added[TypeIndex])
+			{
+				Transforms.Add(GetSystemTransform(System, Type));
+
+				SystemInstances[System].Type     = Type;
+				SystemInstances[System].Instance = TypeSystems.Add(System);
+			}
+
+			// Instances are appended in order, so their indices are the ones given above.
+			Component->AddInstances(Transforms, false, false, false);
+		}
+	}
+}
+
+void USpaceTradersGalaxyMeshComponent::RemoveInstances(const ESpaceTradersSystemType Type, TConstArrayView<int32> Systems)
+{
+	const int32 TypeIndex = static_cast<int32>(Type);
+	UInstancedStaticMeshComponent* const Component = TypeComponents[TypeIndex];
+	TArray<int32>& TypeSystems = InstanceSystems[TypeIndex];
+
+	for (const int32 System : Systems)
+	{
+		const int32 Instance = SystemInstances[System].Instance;
+		const int32 Last     = TypeSystems.Num() - 1;
+
+		// Removing the last instance doesn't move the others, whichever way the component removes them.
+		if (Instance != Last)
+		{
+			FTransform LastTransform;
+			Component->GetInstanceTransform(Last, LastTransform);
+			Component->BatchUpdateInstancesTransforms(Instance, { LastTransform }, false, false, true);
+
+			TypeSystems[Instance] = TypeSystems[Last];
+			SystemInstances[TypeSystems[Instance]].Instance = Instance;
+		}
+
+		Component->RemoveInstance(Last);
+		TypeSystems.Pop(EAllowShrinking::No);
+
+		SystemInstances[System].Instance = INDEX_NONE;
+	}
+
+	Component->MarkRenderStateDirty();
+}
+
+void USpaceTradersGalaxyMeshComponent::RemoveSystems(const TArray<int32>& Systems)
+{
+	TArray<int32> Removed[NumSystemTypes];
+	for (const int32 System : Systems)
+	{
+		if (SystemInstances.IsValidIndex(System) && SystemInstances[System].Instance != INDEX_NONE)
+		{
+			Removed[static_cast<int32>(SystemInstances[System].Type)].AddUnique(System);
+		}
+	}
+
+	for (int32 TypeIndex = 0; TypeIndex < NumSystemTypes; ++TypeIndex)
+	{
+		if (Removed[TypeIndex].Num() > 0)
+		{
+			RemoveInstances(static_cast<ESpaceTradersSystemType>(TypeIndex), Removed[TypeIndex]);
+		}
+	}
+}
+
+void USpaceTradersGalaxyMeshComponent::ClearInstances()
+{
+	for (UInstancedStaticMeshComponent* const Component : TypeComponents)
+	{
+		if (Component)
+		{
+			Component->ClearInstances();
+		}
+	}
+
+	if (ClusterComponent)
+	{
+		ClusterComponent->ClearInstances();
+	}
+
+	for (TArray<int32>& TypeSystems : InstanceSystems)
+	{
+		TypeSystems.Reset();
+	}
+
+	SystemInstances.Reset();
+}
+
+void USpaceTradersGalaxyMeshComponent::Rebuild()
+{
+	ClearInstances();
+
+	// Meshes may have changed since the components were created.
+	for (UInstancedStaticMeshComponent* const Component : TypeComponents)
+	{
+		if (Component)
+		{
+			Component->DestroyComponent();
+		}
+	}
+	TypeComponents.Reset();
+
+	if (ClusterComponent)
+	{
+		ClusterComponent->DestroyComponent();
+		ClusterComponent = nullptr;
+	}
+
+	const int32 Level = ClusterLevel;
+	ClusterLevel = INDEX_NONE;
+
+	if (!Galaxy)
+	{
+		return;
+	}
+
+	TArray<int32> Systems;
+	Systems.SetNumUninitialized(Galaxy->GetStore().NumSystems());
+	for (int32 i = 0; i < Systems.Num(); ++i)
+	{
+		Systems[i] = i;
+	}
+
+	UpdateSystemIndices(Systems);
+	SetClusterLevel(Level);
+}
+
+void USpaceTradersGalaxyMeshComponent::SetViewDistance(const float Distance)
+{
+	SetClusterLevel(Galaxy && ClusterMesh.Mesh ? Galaxy->GetClusters().GetLevelForDistance(Distance, GalaxyScale, ClusterDetail) : INDEX_NONE);
+}
+
+void USpaceTradersGalaxyMeshComponent::SetClusterLevel(const int32 Level)
+{
+	if (Level == ClusterLevel)
+	{
+		return;
+	}
+
+	ClusterLevel = Level;
+
+	for (UInstancedStaticMeshComponent* const Component : TypeComponents)
+	{
+		if (Component)
+		{
+			Component->SetVisibility(ClusterLevel == INDEX_NONE);
+		}
+	}
+
+	if (ClusterLevel == INDEX_NONE)
+	{
+		if (ClusterComponent)
+		{
+			ClusterComponent->ClearInstances();
+			ClusterComponent->SetVisibility(false);
+		}
+		return;
+	}
+
+	if (!ClusterComponent)
+	{
+		ClusterComponent = CreateComponent(ClusterMesh, TEXT("Clusters"));
+		ClusterComponent->SetNumCustomDataFloats(1);
+	}
+
+	// Levels have their own clusters, instances are made again from the first one.
+	ClusterComponent->ClearInstances();
+	ClusterComponent->SetVisibility(true);
+	UpdateClusterInstances({});
+}
+
+void USpaceTradersGalaxyMeshComponent::OnClustersUpdated(TConstArrayView<TArray<int32>> Clusters)
+{
+	if (ClusterLevel != INDEX_NONE && ClusterComponent && Clusters.IsValidIndex(ClusterLevel))
+	{
+		UpdateClusterInstances(Clusters[ClusterLevel]);
+	}
+}
+
+FTransform USpaceTradersGalaxyMeshComponent::GetClusterTransform(const int32 Cluster) const
+{
+	const FSpaceTradersSystemCluster Data = Galaxy->GetClusters().GetCluster(ClusterLevel, Cluster);
+
+	// The area grows with the number of systems. Empty clusters keep their instance, scaled down to nothing.
+	return FTransform(FQuat::Identity, FVector(Data.Location * GalaxyScale, 0.), ClusterMesh.Scale * FMath::Sqrt(double(Data.NumSystems)));
+}
+
+void USpaceTradersGalaxyMeshComponent::UpdateClusterInstances(TConstArrayView<int32> Clusters)
+{
+	const FSpaceTradersGalaxyClusters& GalaxyClusters = Galaxy->GetClusters();
+	const int32 NumInstances = ClusterComponent->GetInstanceCount();
+
+	for (const int32 Cluster : Clusters)
+	{
+		if (Cluster < NumInstances)
+		{
+			ClusterComponent->UpdateInstanceTransform(Cluster, GetClusterTransform(Cluster), false, false, true);
+			ClusterComponent->SetCustomDataValue(Cluster, 0, static_cast<float>(GalaxyClusters.GetCluster(ClusterLevel, Cluster).DominantType));
+		}
+	}
+
+	// Clusters created since the last update are the last ones, so they're appended in one go.
+	const int32 NumClusters = GalaxyClusters.NumClusters(ClusterLevel);
+	if (NumClusters > NumInstances)
+	{
+		TArray<FTransform> Transforms;
+		Transforms.Reserve(NumClusters - NumInstances);
+		for (int32 Cluster = NumInstances; Cluster < NumClusters; ++Cluster)
+		{
+			Transforms.Add(GetClusterTransform(Cluster));
+		}
+
+		ClusterComponent->AddInstances(Transforms, false, false, false);
+
+		for (int32 Cluster = NumInstances; Cluster < NumClusters; ++Cluster)
+		{
+			ClusterComponent->SetCustomDataValue(Cluster, 0, static_cast<float>(GalaxyClusters.GetCluster(ClusterLevel, Cluster).DominantType));
+		}
+	}
+
+	ClusterComponent->MarkRenderStateDirty();
+}
+
+int32 USpaceTradersGalaxyMeshComponent::GetSystemOfInstance(const UInstancedStaticMeshComponent* Component, const int32 Instance) const
+{
+	const int32 TypeIndex = Component ? TypeComponents.IndexOfByKey(Component) : INDEX_NONE;
+	return TypeIndex != INDEX_NONE && InstanceSystems[TypeIndex].IsValidIndex(Instance) ? InstanceSystems[TypeIndex][Instance] : INDEX_NONE;
+}
+
+int32 USpaceTradersGalaxyMeshComponent::GetNumInstances() const
+{
+	int32 Num = 0;
+	for (const TArray<int32>& TypeSystems : InstanceSystems)
+	{
+		Num += TypeSystems.Num();
+	}
+	return Num;
+}
@@ -0,0 +1,392 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersGalaxyStore.h"
+#include "SpaceTradersApi.h"
+#include "SpaceTradersJson.h"
+
+namespace
+{
+	using namespace SpaceTradersJson;
+
+	const TCHAR* const SystemTypeNames[] =
+	{
+		TEXT(""),
+		TEXT("NEUTRON_STAR"),
+		TEXT("RED_STAR"),
+		TEXT("ORANGE_STAR"),
+		TEXT("BLUE_STAR"),
+		TEXT("YOUNG_STAR"),
+		TEXT("WHITE_DWARF"),
+		TEXT("BLACK_HOLE"),
+		TEXT("HYPERGIANT"),
+		TEXT("NEBULA"),
+		TEXT("UNSTABLE"),
+	};
+	static_assert(UE_ARRAY_COUNT(SystemTypeNames) == static_cast<int32>(ESpaceTradersSystemType::MAX), "Missing system type name.");
+
+	const TCHAR* const WaypointTypeNames[] =
+	{
+		TEXT(""),
+		TEXT("PLANET"),
+		TEXT("GAS_GIANT"),
+		TEXT("MOON"),
+		TEXT("ORBITAL_STATION"),
+		TEXT("JUMP_GATE"),
+		TEXT("ASTEROID_FIELD"),
+		TEXT("ASTEROID"),
+		TEXT("ENGINEERED_ASTEROID"),
+		TEXT("ASTEROID_BASE"),
+		TEXT("NEBULA"),
+		TEXT("DEBRIS_FIELD"),
+		TEXT("GRAVITY_WELL"),
+		TEXT("ARTIFICIAL_GRAVITY_WELL"),
+		TEXT("FUEL_STATION"),
+	};
+	static_assert(UE_ARRAY_COUNT(WaypointTypeNames) == static_cast<int32>(ESpaceTradersWaypointType::MAX), "Missing waypoint type name.");
+
+	/* Fields of a system or waypoint item. */
+	struct FItemFields
+	{
+		FString Symbol;
+		FString SystemSymbol;
+		FString Type;
+		int32   X = 0;
+		int32   Y = 0;
+		TSharedPtr<FJsonValue> Waypoints;
+		TSharedPtr<FJsonValue> Traits;
+
+		explicit FItemFields(const TSharedPtr<FJsonValue>& Item)
+		{
+			// Walks the fields once instead of looking each one up.
+			ForEachField(Item, [this](const FStringView Name, const TSharedPtr<FJsonValue>& Value)
+			{
+				if      (Name == TEXTVIEW("symbol"))       Symbol       = ReadString(Value);
+				else if (Name == TEXTVIEW("systemSymbol")) SystemSymbol = ReadString(Value);
+				else if (Name == TEXTVIEW("type"))         Type         = ReadString(Value);
+				else if (Name == TEXTVIEW("x"))            X            = ReadInt(Value);
+				else if (Name == TEXTVIEW("y"))            Y            = ReadInt(Value);
+				else if (Name == TEXTVIEW("waypoints"))    Waypoints    = Value;
+				else if (Name == TEXTVIEW("traits"))       Traits       = Value;
+			});
+		}
+	};
+}
+
+
+int32 FSpaceTradersSymbolTable::Add(const FString& Symbol)
+{
+	return Symbols.Add(Symbol).AsInteger();
+}
+
+int32 FSpaceTradersSymbolTable::Find(const FString& Symbol) const
+{
+	const FSetElementId Id = Symbols.FindId(Symbol);
+	return Id.IsValidId() ? Id.AsInteger() : INDEX_NONE;
+}
+
+SIZE_T FSpaceTradersSymbolTable::GetAllocatedSize() const
+{
+	SIZE_T Size = Symbols.GetAllocatedSize();
+	for (const FString& Symbol : Symbols)
+	{
+		Size += Symbol.GetAllocatedSize();
+	}
+	return Size;
+}
+
+/* static */ ESpaceTradersSystemType FSpaceTradersGalaxyStore::ParseSystemType(const FString& Type)
+{
+	return static_cast<ESpaceTradersSystemType>(FindName(SystemTypeNames, Type));
+}
+
+/* static */ ESpaceTradersWaypointType FSpaceTradersGalaxyStore::ParseWaypointType(const FString& Type)
+{
+	return static_cast<ESpaceTradersWaypointType>(FindName(WaypointTypeNames, Type));
+}
+
+void FSpaceTradersGalaxyStore::AddSystems(TConstArrayView<TSharedPtr<FJsonValue>> Items, TArray<int32>* const OutSystems, TArray<int32>* const OutWaypoints)
+{
+	SystemSymbols.Reserve(SystemSymbols.Num() + Items.Num());
+
+	for (const TSharedPtr<FJsonValue>& Item : Items)
+	{
+		const FItemFields Fields(Item);
+		if (Fields.Symbol.IsEmpty())
+		{
+			continue;
+		}
+
+		const int32 System = FindOrAddSystem(Fields.Symbol);
+		SystemX[System]     = Fields.X;
+		SystemY[System]     = Fields.Y;
+		SystemTypes[System] = ParseSystemType(Fields.Type);
+		SystemPlaced[System] = true;
+
+		if (OutSystems)
+		{
+			OutSystems->Add(System);
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>* Waypoints = nullptr;
+		if (!Fields.Waypoints || !Fields.Waypoints->TryGetArray(Waypoints))
+		{
+			continue;
+		}
+
+		for (const TSharedPtr<FJsonValue>& WaypointItem : *Waypoints)
+		{
+			const FItemFields WaypointFields(WaypointItem);
+			if (WaypointFields.Symbol.IsEmpty())
+			{
+				continue;
+			}
+
+			const int32 Waypoint = FindOrAddWaypoint(WaypointFields.Symbol, System);
+			WaypointX[Waypoint]     = WaypointFields.X;
+			WaypointY[Waypoint]     = WaypointFields.Y;
+			WaypointTypes[Waypoint] = ParseWaypointType(WaypointFields.Type);
+
+			if (OutWaypoints)
+			{
+				OutWaypoints->Add(Waypoint);
+			}
+		}
+	}
+}
+
+void FSpaceTradersGalaxyStore::AddWaypoints(TConstArrayView<TSharedPtr<FJsonValue>> Items, TArray<int32>* const OutWaypoints)
+{
+	for (const TSharedPtr<FJsonValue>& Item : Items)
+	{
+		const FItemFields Fields(Item);
+		if (Fields.Symbol.IsEmpty() || Fields.SystemSymbol.IsEmpty())
+		{
+			continue;
+		}
+
+		// Waypoints of a system that wasn't crawled yet still get a system, without coordinates.
+		const int32 System   = FindOrAddSystem(Fields.SystemSymbol);
+		const int32 Waypoint = FindOrAddWaypoint(Fields.Symbol, System);
+
+		WaypointX[Waypoint]      = Fields.X;
+		WaypointY[Waypoint]      = Fields.Y;
+		WaypointTypes[Waypoint]  = ParseWaypointType(Fields.Type);
+		WaypointTraits[Waypoint] = ParseTraits(Fields.Traits);
+
+		if (OutWaypoints)
+		{
+			OutWaypoints->Add(Waypoint);
+		}
+	}
+}
+
+void FSpaceTradersGalaxyStore::AddJumpGates(TConstArrayView<TSharedPtr<FJsonValue>> Items, TArray<int32>* const OutWaypoints)
+{
+	for (const TSharedPtr<FJsonValue>& Item : Items)
+	{
+		FString Symbol;
+		TSharedPtr<FJsonValue> Connections;
+		ForEachField(Item, [&Symbol, &Connections](const FStringView Name, const TSharedPtr<FJsonValue>& Value)
+		{
+			if      (Name == TEXTVIEW("symbol"))      Symbol      = ReadString(Value);
+			else if (Name == TEXTVIEW("connections")) Connections = Value;
+		});
+
+		const TArray<TSharedPtr<FJsonValue>>* ConnectionArray = nullptr;
+		if (Symbol.IsEmpty() || !Connections || !Connections->TryGetArray(ConnectionArray))
+		{
+			continue;
+		}
+
+		const int32 Gate = FindOrAddWaypoint(Symbol);
+		WaypointTypes[Gate] = ESpaceTradersWaypointType::JumpGate;
+
+		TArray<int32> Connected;
+		Connected.Reserve(ConnectionArray->Num());
+		for (const TSharedPtr<FJsonValue>& Connection : *ConnectionArray)
+		{
+			const FString ConnectionSymbol = ReadString(Connection);
+			if (!ConnectionSymbol.IsEmpty())
+			{
+				const int32 ConnectedGate = FindOrAddWaypoint(ConnectionSymbol);
+				WaypointTypes[ConnectedGate] = ESpaceTradersWaypointType::JumpGate;
+				Connected.Add(ConnectedGate);
+			}
+		}
+
+		JumpGateConnections.Add(Gate, MoveTemp(Connected));
+
+		if (OutWaypoints)
+		{
+			OutWaypoints->Add(Gate);
+		}
+	}
+}
+
+TConstArrayView<int32> FSpaceTradersGalaxyStore::GetJumpGateConnections(const int32 Waypoint) const
+{
+	const TArray<int32>* const Connections = JumpGateConnections.Find(Waypoint);
+	return Connections ? TConstArrayView<int32>(*Connections) : TConstArrayView<int32>();
+}
+
+int32 FSpaceTradersGalaxyStore::FindSystem(const FString& Symbol) const
+{
+	const int32 Id = Symbols.Find(Symbol);
+	return Id != INDEX_NONE ? SystemOfSymbol[Id] : INDEX_NONE;
+}
+
+int32 FSpaceTradersGalaxyStore::FindWaypoint(const FString& Symbol) const
+{
+	const int32 Id = Symbols.Find(Symbol);
+	return Id != INDEX_NONE ? WaypointOfSymbol[Id] : INDEX_NONE;
+}
+
+int32 FSpaceTradersGalaxyStore::FindTrait(const FString& Trait) const
+{
+	const int32* const Bit = TraitBits.Find(Trait);
+	return Bit ? *Bit : INDEX_NONE;
+}
+
+int32 FSpaceTradersGalaxyStore::FindOrAddSystem(const FString& Symbol)
+{
+	const int32 Id = Symbols.Add(Symbol);
+	if (Id >= SystemOfSymbol.Num())
+	{
+		SystemOfSymbol  .SetNum(Id + 1);
+		WaypointOfSymbol.SetNum(Id + 1);
+		SystemOfSymbol  [Id] = INDEX_NONE;
+		WaypointOfSymbol[Id] = INDEX_NONE;
+	}
+
+	if (SystemOfSymbol[Id] != INDEX_NONE)
+	{
+		return SystemOfSymbol[Id];
+	}
+
+	const int32 System = SystemSymbols.Add(Id);
+	SystemX        .Add(0);
+	SystemY        .Add(0);
+	SystemTypes    .Add(ESpaceTradersSystemType::Unknown);
+	SystemWaypoints.AddDefaulted();
+	SystemPlaced   .Add(false);
+
+	SystemOfSymbol[Id] = System;
+	return System;
+}
+
+int32 FSpaceTradersGalaxyStore::FindOrAddWaypoint(const FString& Symbol, const int32 System)
+{
+	const int32 Id = Symbols.Add(Symbol);
+	if (Id >= WaypointOfSymbol.Num())
+	{
+		SystemOfSymbol  .SetNum(Id + 1);
+		WaypointOfSymbol.SetNum(Id + 1);
+		SystemOfSymbol  [Id] = INDEX_NONE;
+		WaypointOfSymbol[Id] = INDEX_NONE;
+	}
+
+	if (WaypointOfSymbol[Id] != INDEX_NONE)
+	{
+		return WaypointOfSymbol[Id];
+	}
+
+	const int32 Waypoint = WaypointSymbols.Add(Id);
+	WaypointSystems.Add(System);
+	WaypointX      .Add(0);
+	WaypointY      .Add(0);
+	WaypointTraits .Add(0);
+	WaypointTypes  .Add(ESpaceTradersWaypointType::Unknown);
+
+	SystemWaypoints[System].Add(Waypoint);
+
+	WaypointOfSymbol[Id] = Waypoint;
+	return Waypoint;
+}
+
+int32 FSpaceTradersGalaxyStore::FindOrAddWaypoint(const FString& Symbol)
+{
+	const int32 Waypoint = FindWaypoint(Symbol);
+	if (Waypoint != INDEX_NONE)
+	{
+		return Waypoint;
+	}
+
+	// Waypoint symbols are the symbol of their system followed by their own, e.g. X1-DF55-A1.
+	int32 SystemEnd = INDEX_NONE;
+	Symbol.FindLastChar(TEXT('-'), SystemEnd);
+
+	return FindOrAddWaypoint(Symbol, FindOrAddSystem(SystemEnd > 0 ? Symbol.Left(SystemEnd) : Symbol));
+}
+
+uint64 FSpaceTradersGalaxyStore::ParseTraits(const TSharedPtr<FJsonValue>& Traits)
+{
+	const TArray<TSharedPtr<FJsonValue>>* Array = nullptr;
+	if (!Traits || !Traits->TryGetArray(Array))
+	{
+		return 0;
+	}
+
+	uint64 Mask = 0;
+	for (const TSharedPtr<FJsonValue>& Trait : *Array)
+	{
+		FString Name;
+		ForEachField(Trait, [&Name](const FStringView FieldName, const TSharedPtr<FJsonValue>& Value)
+		{
+			if (FieldName == TEXTVIEW("symbol"))
+			{
+				Name = ReadString(Value);
+			}
+		});
+
+		if (Name.IsEmpty())
+		{
+			continue;
+		}
+
+		int32* Bit = TraitBits.Find(Name);
+		if (!Bit)
+		{
+			if (TraitNames.Num() >= MaxTraits)
+			{
+				UE_LOG(LogSpaceTradersApi, Warning, TEXT("Waypoint trait %s ignored, there are already %d traits."), *Name, MaxTraits);
+				continue;
+			}
+
+			Bit = &TraitBits.Add(Name, TraitNames.Add(Name));
+		}
+
+		Mask |= uint64(1) << *Bit;
+	}
+
+	return Mask;
+}
+
+void FSpaceTradersGalaxyStore::Reset()
+{
+	*this = FSpaceTradersGalaxyStore();
+}
+
+SIZE_T FSpaceTradersGalaxyStore::GetAllocatedSize() const
+{
+	SIZE_T Size = Symbols.GetAllocatedSize()
+		+ SystemOfSymbol.GetAllocatedSize() + WaypointOfSymbol.GetAllocatedSize()
+		+ TraitNames.GetAllocatedSize() + TraitBits.GetAllocatedSize()
+		+ SystemSymbols.GetAllocatedSize() + SystemX.GetAllocatedSize() + SystemY.GetAllocatedSize()
+		+ SystemTypes.GetAllocatedSize() + SystemWaypoints.GetAllocatedSize() + SystemPlaced.GetAllocatedSize()
+		+ WaypointSymbols.GetAllocatedSize() + WaypointSystems.GetAllocatedSize()
+		+ WaypointX.GetAllocatedSize() + WaypointY.GetAllocatedSize()
+		+ WaypointTraits.GetAllocatedSize() + WaypointTypes.GetAllocatedSize()
+		+ JumpGateConnections.GetAllocatedSize();
+
+	for (const TPair<int32, TArray<int32>>& Pair : JumpGateConnections)
+	{
+		Size += Pair.Value.GetAllocatedSize();
+	}
+
+	for (const TArray<int32>& Waypoints : SystemWaypoints)
+	{
+		Size += Waypoints.GetAllocatedSize();
+	}
+
+	return Size;
+}
@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlueprintJsonValues.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+
+/* Readers of API items shared by the stores, for values parsed with lazy values and flat objects or not. */
+namespace SpaceTradersJson
+{
+	/* Calls Functor(FStringView Name, const TSharedPtr<FJsonValue>& Value) for each field of an object value, flat or not. */
+	template<typename FunctorType>
+	void ForEachField(const TSharedPtr<FJsonValue>& Value, FunctorType&& Functor)
+	{
+		int32 Cursor = 0;
+		FStringView Name;
+		TSharedPtr<FJsonValue> Field;
+
+		if (const FJsonValueFlatObject* const FlatObject = FJsonValueFlatObject::Cast(Value.Get()))
+		{
+			while (FlatObject->NextField(Cursor, Name, Field))
+			{
+				Functor(Name, Field);
+			}
+			return;
+		}
+
+		const TSharedPtr<FJsonObject>* Object = nullptr;
+		if (Value && Value->TryGetObject(Object))
+		{
+			while (FJsonValueFlatObject::NextField(**Object, Cursor, Name, Field))
+			{
+				Functor(Name, Field);
+			}
+		}
+	}
+
+	inline int32 ReadInt(const TSharedPtr<FJsonValue>& Value)
+	{
+		double Number = 0.;
+		return Value && Value->TryGetNumber(Number) ? static_cast<int32>(Number) : 0;
+	}
+
+	inline FString ReadString(const TSharedPtr<FJsonValue>& Value)
+	{
+		FString String;
+		if (Value)
+		{
+			Value->TryGetString(String);
+		}
+		return String;
+	}
+
+	/* Returns the index of Name in Names, or 0 which is the unknown value of the enums. */
+	template<int32 N>
+	uint8 FindName(const TCHAR* const (&Names)[N], const FString& Name)
+	{
+		for (int32 i = 1; i < N; ++i)
+		{
+			if (Name.Equals(Names[i], ESearchCase::CaseSensitive))
+			{
+				return static_cast<uint8>(i);
+			}
+		}
+		return 0;
+	}
+}
@@ -0,0 +1,262 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersMarketStore.h"
+#include "SpaceTradersJson.h"
+
+namespace
+{
+	using namespace SpaceTradersJson;
+
+	const TCHAR* const SupplyNames[] =
+	{
+		TEXT(""),
+		TEXT("SCARCE"),
+		TEXT("LIMITED"),
+		TEXT("MODERATE"),
+		TEXT("HIGH"),
+		TEXT("ABUNDANT"),
+	};
+	static_assert(UE_ARRAY_COUNT(SupplyNames) == static_cast<int32>(ESpaceTradersSupply::MAX), "Missing supply name.");
+
+	/* Values of a sample tracked by the aggregates. */
+	double GetPurchasePrice(const FSpaceTradersMarketSample& Sample) { return Sample.PurchasePrice; }
+	double GetSellPrice    (const FSpaceTradersMarketSample& Sample) { return Sample.SellPrice; }
+	double GetSupply       (const FSpaceTradersMarketSample& Sample) { return static_cast<double>(Sample.Supply); }
+
+	void AddToExtremes(FSpaceTradersRollingStats& Stats, const double Value, const bool bFirst)
+	{
+		Stats.Min = bFirst ? Value : FMath::Min(Stats.Min, Value);
+		Stats.Max = bFirst ? Value : FMath::Max(Stats.Max, Value);
+	}
+
+	void AddToAverage(FSpaceTradersRollingStats& Stats, const double Value, const double Smoothing, const bool bFirst)
+	{
+		Stats.Average = bFirst ? Value : Stats.Average + Smoothing * (Value - Stats.Average);
+	}
+
+	bool IsExtreme(const FSpaceTradersRollingStats& Stats, const double Value)
+	{
+		return Value == Stats.Min || Value == Stats.Max;
+	}
+}
+
+
+FSpaceTradersMarketStore::FSpaceTradersMarketStore(const int32 InCapacity, const double InSmoothing)
+	: Capacity (FMath::Max(InCapacity, 1))
+	, Smoothing(FMath::Clamp(InSmoothing, 0., 1.))
+{
+}
+
+/* static */ ESpaceTradersSupply FSpaceTradersMarketStore::ParseSupply(const FString& Supply)
+{
+	return static_cast<ESpaceTradersSupply>(FindName(SupplyNames, Supply));
+}
+
+void FSpaceTradersMarketStore::AddMarket(const TSharedPtr<FJsonValue>& Market, const FDateTime& Timestamp, TArray<int32>* const OutSeries)
+{
+	FString Waypoint;
+	TSharedPtr<FJsonValue> TradeGoods;
+	ForEachField(Market, [&Waypoint, &TradeGoods](const FStringView Name, const TSharedPtr<FJsonValue>& Value)
+	{
+		if      (Name == TEXTVIEW("symbol"))     Waypoint   = ReadString(Value);
+		else if (Name == TEXTVIEW("tradeGoods")) TradeGoods = Value;
+	});
+
+	const TArray<TSharedPtr<FJsonValue>>* Goods = nullptr;
+	if (Waypoint.IsEmpty() || !TradeGoods || !TradeGoods->TryGetArray(Goods))
+	{
+		return;
+	}
+
+	for (const TSharedPtr<FJsonValue>& Good : *Goods)
+	{
+		FString Symbol;
+		FSpaceTradersMarketSample Sample;
+		Sample.Timestamp = Timestamp;
+
+		ForEachField(Good, [&Symbol, &Sample](const FStringView Name, const TSharedPtr<FJsonValue>& Value)
+		{
+			if      (Name == TEXTVIEW("symbol"))        Symbol               = ReadString(Value);
+			else if (Name == TEXTVIEW("purchasePrice")) Sample.PurchasePrice = ReadInt(Value);
+			else if (Name == TEXTVIEW("sellPrice"))     Sample.SellPrice     = ReadInt(Value);
+			else if (Name == TEXTVIEW("tradeVolume"))   Sample.TradeVolume   = ReadInt(Value);
+			else if (Name == TEXTVIEW("supply"))        Sample.Supply        = ParseSupply(ReadString(Value));
+		});
+
+		if (Symbol.IsEmpty())
+		{
+			continue;
+		}
+
+		const int32 Index = AddSample(Waypoint, Symbol, Sample);
+		if (OutSeries)
+		{
+			OutSeries->Add(Index);
+		}
+	}
+}
+
+int32 FSpaceTradersMarketStore::AddSample(const FString& Waypoint, const FString& Good, const FSpaceTradersMarketSample& Sample)
+{
+	const int32 WaypointId = Symbols.Add(Waypoint);
+	const int32 GoodId     = Symbols.Add(Good);
+
+	const int32* const Found = SeriesByKey.Find(MakeKey(WaypointId, GoodId));
+	int32 Index = Found ? *Found : INDEX_NONE;
+	if (Index == INDEX_NONE)
+	{
+		Index = Series.AddDefaulted();
+		Series[Index].Waypoint = WaypointId;
+		Series[Index].Good     = GoodId;
+
+		Samples.AddDefaulted(Capacity);
+
+		SeriesByKey.Add(MakeKey(WaypointId, GoodId), Index);
+		SeriesOfGood    .FindOrAdd(GoodId)    .Add(Index);
+		SeriesOfWaypoint.FindOrAdd(WaypointId).Add(Index);
+	}
+
+	FSeries& Entry = Series[Index];
+	FSpaceTradersMarketAggregates& Aggregates = Entry.Aggregates;
+	FSpaceTradersMarketSample* const Ring = GetRing(Index);
+
+	const bool bFirst = Aggregates.NumSamples == 0;
+	bool bEvictedExtreme = false;
+
+	if (Aggregates.NumSamples < Capacity)
+	{
+		Ring[(Entry.Head + Aggregates.NumSamples) % Capacity] = Sample;
+		Aggregates.NumSamples++;
+	}
+	else
+	{
+		// Overwrites the oldest sample. The extremes only need a new pass if it was one of them.
+		const FSpaceTradersMarketSample& Evicted = Ring[Entry.Head];
+		bEvictedExtreme = IsExtreme(Aggregates.PurchasePrice, GetPurchasePrice(Evicted))
+			|| IsExtreme(Aggregates.SellPrice, GetSellPrice(Evicted))
+			|| IsExtreme(Aggregates.Supply,    GetSupply(Evicted));
+
+		Ring[Entry.Head] = Sample;
+		Entry.Head = (Entry.Head + 1) % Capacity;
+	}
+
+	if (bEvictedExtreme)
+	{
+		RecomputeExtremes(Index);
+	}
+	else
+	{
+		AddToExtremes(Aggregates.PurchasePrice, GetPurchasePrice(Sample), bFirst);
+		AddToExtremes(Aggregates.SellPrice,     GetSellPrice(Sample),     bFirst);
+		AddToExtremes(Aggregates.Supply,        GetSupply(Sample),        bFirst);
+	}
+
+	AddToAverage(Aggregates.PurchasePrice, GetPurchasePrice(Sample), Smoothing, bFirst);
+	AddToAverage(Aggregates.SellPrice,     GetSellPrice(Sample),     Smoothing, bFirst);
+	AddToAverage(Aggregates.Supply,        GetSupply(Sample),        Smoothing, bFirst);
+
+	Aggregates.LastUpdate = Sample.Timestamp;
+	Entry.Latest = Sample;
+
+	return Index;
+}
+
+void FSpaceTradersMarketStore::RecomputeExtremes(const int32 Index)
+{
+	const FSeries& Entry = Series[Index];
+	FSpaceTradersMarketAggregates& Aggregates = Series[Index].Aggregates;
+	const FSpaceTradersMarketSample* const Ring = GetRing(Index);
+
+	for (int32 i = 0; i < Aggregates.NumSamples; ++i)
+	{
+		const FSpaceTradersMarketSample& Sample = Ring[(Entry.Head + i) % Capacity];
+		AddToExtremes(Aggregates.PurchasePrice, GetPurchasePrice(Sample), i == 0);
+		AddToExtremes(Aggregates.SellPrice,     GetSellPrice(Sample),     i == 0);
+		AddToExtremes(Aggregates.Supply,        GetSupply(Sample),        i == 0);
+	}
+}
+
+int32 FSpaceTradersMarketStore::FindSeries(const FString& Waypoint, const FString& Good) const
+{
+	const int32 WaypointId = Symbols.Find(Waypoint);
+	const int32 GoodId     = Symbols.Find(Good);
+
+	const int32* const Found = WaypointId != INDEX_NONE && GoodId != INDEX_NONE ? SeriesByKey.Find(MakeKey(WaypointId, GoodId)) : nullptr;
+	return Found ? *Found : INDEX_NONE;
+}
+
+void FSpaceTradersMarketStore::GetHistory(const int32 Index, TArray<FSpaceTradersMarketSample>& OutSamples) const
+{
+	const FSeries& Entry = Series[Index];
+	const FSpaceTradersMarketSample* const Ring = GetRing(Index);
+
+	OutSamples.Reserve(OutSamples.Num() + Entry.Aggregates.NumSamples);
+	for (int32 i = 0; i < Entry.Aggregates.NumSamples; ++i)
+	{
+		OutSamples.Add(Ring[(Entry.Head + i) % Capacity]);
+	}
+}
+
+TConstArrayView<int32> FSpaceTradersMarketStore::GetGoodSeries(const FString& Good) const
+{
+	const TArray<int32>* const Found = SeriesOfGood.Find(Symbols.Find(Good));
+	return Found ? TConstArrayView<int32>(*Found) : TConstArrayView<int32>();
+}
+
+TConstArrayView<int32> FSpaceTradersMarketStore::GetWaypointSeries(const FString& Waypoint) const
+{
+	const TArray<int32>* const Found = SeriesOfWaypoint.Find(Symbols.Find(Waypoint));
+	return Found ? TConstArrayView<int32>(*Found) : TConstArrayView<int32>();
+}
+
+int32 FSpaceTradersMarketStore::FindBestPrice(const FString& Good, const bool bPurchase, TFunctionRef<bool(int32)> Filter) const
+{
+	int32 Best      = INDEX_NONE;
+	int32 BestPrice = 0;
+
+	for (const int32 Index : GetGoodSeries(Good))
+	{
+		const FSpaceTradersMarketSample& Latest = Series[Index].Latest;
+		const int32 Price = bPurchase ? Latest.PurchasePrice : Latest.SellPrice;
+
+		const bool bBetter = Best == INDEX_NONE || (bPurchase ? Price < BestPrice : Price > BestPrice);
+		if (bBetter && Filter(Index))
+		{
+			Best      = Index;
+			BestPrice = Price;
+		}
+	}
+
+	return Best;
+}
+
+void FSpaceTradersMarketStore::Reset()
+{
+	Symbols.Reset();
+	Series.Reset();
+	Samples.Reset();
+	SeriesByKey.Reset();
+	SeriesOfGood.Reset();
+	SeriesOfWaypoint.Reset();
+}
+
+SIZE_T FSpaceTradersMarketStore::GetAllocatedSize() const
+{
+	SIZE_T Size = Symbols.GetAllocatedSize()
+		+ Series.GetAllocatedSize()
+		+ Samples.GetAllocatedSize()
+		+ SeriesByKey.GetAllocatedSize()
+		+ SeriesOfGood.GetAllocatedSize()
+		+ SeriesOfWaypoint.GetAllocatedSize();
+
+	for (const TPair<int32, TArray<int32>>& Pair : SeriesOfGood)
+	{
+		Size += Pair.Value.GetAllocatedSize();
+	}
+	for (const TPair<int32, TArray<int32>>& Pair : SeriesOfWaypoint)
+	{
+		Size += Pair.Value.GetAllocatedSize();
+	}
+
+	return Size;
+}
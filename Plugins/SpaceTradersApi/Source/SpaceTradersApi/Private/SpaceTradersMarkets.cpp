@@ -0,0 +1,222 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersMarkets.h"
+#include "SpaceTradersApi.h"
+#include "SpaceTradersApiClient.h"
+#include "SpaceTradersApiSettings.h"
+#include "SpaceTradersGalaxy.h"
+#include "BlueprintJsonWrapper.h"
+#include "Dom/JsonValue.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+/* static */ USpaceTradersMarkets* USpaceTradersMarkets::Get(const UObject* const WorldContextObject)
+{
+	const UWorld* const World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	const UGameInstance* const GameInstance = World ? World->GetGameInstance() : nullptr;
+
+	return GameInstance ? GameInstance->GetSubsystem<USpaceTradersMarkets>() : nullptr;
+}
+
+void USpaceTradersMarkets::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const USpaceTradersApiSettings* const Settings = GetDefault<USpaceTradersApiSettings>();
+	Store = FSpaceTradersMarketStore(Settings->MarketHistorySize, Settings->MarketSmoothing);
+
+	USpaceTradersGalaxy* const Galaxy = Collection.InitializeDependency<USpaceTradersGalaxy>();
+	TradeOptimizer = MakeShared<FSpaceTradersTradeOptimizer, ESPMode::ThreadSafe>(Store, Galaxy->GetStore());
+
+	// Markets are placed with the galaxy, routes are estimated again once it changes.
+	Galaxy->OnUpdated.AddWeakLambda(this, [this](TConstArrayView<int32>, TConstArrayView<int32>)
+	{
+		TradeOptimizer->InvalidateAll();
+	});
+	Galaxy->OnReset.AddWeakLambda(this, [this]()
+	{
+		TradeOptimizer->InvalidateAll();
+	});
+
+	if (USpaceTradersApiClient* const Client = Collection.InitializeDependency<USpaceTradersApiClient>())
+	{
+		Client->OnResponseDelivered.AddUObject(this, &ThisClass::OnResponseDelivered);
+	}
+}
+
+void USpaceTradersMarkets::OnResponseDelivered(const FSpaceTradersRequest& Request, const FSpaceTradersResponse& Response, const bool bFromCache)
+{
+	// Cached markets were already added when they were received.
+	if (!bFromCache && Response.bSuccess && Request.Verb == TEXT("GET") && Request.Path.EndsWith(TEXT("/market")))
+	{
+		AddMarketValue(Response.Data, FDateTime::UtcNow());
+	}
+}
+
+void USpaceTradersMarkets::AddMarket(UJsonObject* Market)
+{
+	if (Market)
+	{
+		AddMarketValue(Market->GetRawValue(), FDateTime::UtcNow());
+	}
+}
+
+void USpaceTradersMarkets::AddMarketValue(const TSharedPtr<FJsonValue>& Market, const FDateTime& Timestamp)
+{
+	TArray<int32> Series;
+	Store.AddMarket(Market, Timestamp, &Series);
+
+	if (Series.Num() > 0)
+	{
+		TradeOptimizer->Invalidate(Series);
+
+		OnUpdated.Broadcast(Series);
+		Updated.Broadcast(Store.GetSeriesWaypoint(Series[0]));
+	}
+}
+
+TArray<FSpaceTradersMarketSample> USpaceTradersMarkets::GetHistory(const FString& Waypoint, const FString& Good) const
+{
+	TArray<FSpaceTradersMarketSample> Samples;
+
+	const int32 Series = Store.FindSeries(Waypoint, Good);
+	if (Series != INDEX_NONE)
+	{
+		Store.GetHistory(Series, Samples);
+	}
+
+	return Samples;
+}
+
+bool USpaceTradersMarkets::GetLatest(const FString& Waypoint, const FString& Good, FSpaceTradersMarketSample& Sample) const
+{
+	const int32 Series = Store.FindSeries(Waypoint, Good);
+	if (Series == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Sample = Store.GetLatest(Series);
+	return true;
+}
+
+bool USpaceTradersMarkets::GetAggregates(const FString& Waypoint, const FString& Good, FSpaceTradersMarketAggregates& Aggregates) const
+{
+	const int32 Series = Store.FindSeries(Waypoint, Good);
+	if (Series == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Aggregates = Store.GetAggregates(Series);
+	return true;
+}
+
+TArray<FString> USpaceTradersMarkets::GetGoods(const FString& Waypoint) const
+{
+	TArray<FString> Goods;
+	for (const int32 Series : Store.GetWaypointSeries(Waypoint))
+	{
+		Goods.Add(Store.GetSeriesGood(Series));
+	}
+	return Goods;
+}
+
+bool USpaceTradersMarkets::FindBestSellPrice(const FString& Good, const FVector2D& Center, const float Radius, const float MaxAge, FString& Waypoint, int32& Price) const
+{
+	return FindBestPrice(Good, false, Center, Radius, MaxAge, Waypoint, Price);
+}
+
+bool USpaceTradersMarkets::FindBestPurchasePrice(const FString& Good, const FVector2D& Center, const float Radius, const float MaxAge, FString& Waypoint, int32& Price) const
+{
+	return FindBestPrice(Good, true, Center, Radius, MaxAge, Waypoint, Price);
+}
+
+bool USpaceTradersMarkets::FindBestPrice(const FString& Good, const bool bPurchase, const FVector2D& Center, const float Radius, const float MaxAge, FString& OutWaypoint, int32& OutPrice) const
+{
+	const USpaceTradersGalaxy* const Galaxy = Radius > 0.f ? GetGameInstance()->GetSubsystem<USpaceTradersGalaxy>() : nullptr;
+	if (Radius > 0.f && !Galaxy)
+	{
+		return false;
+	}
+
+	const FDateTime OldestTimestamp = MaxAge > 0.f ? FDateTime::UtcNow() - FTimespan::FromSeconds(MaxAge) : FDateTime::MinValue();
+
+	const int32 Best = Store.FindBestPrice(Good, bPurchase, [&](const int32 Series) -> bool
+	{
+		if (Store.GetLatest(Series).Timestamp < OldestTimestamp)
+		{
+			return false;
+		}
+
+		if (!Galaxy)
+		{
+			return true;
+		}
+
+		// Markets of waypoints the galaxy doesn't know can't be placed.
+		const FSpaceTradersGalaxyStore& GalaxyStore = Galaxy->GetStore();
+		const int32 Waypoint = GalaxyStore.FindWaypoint(Store.GetSeriesWaypoint(Series));
+		if (Waypoint == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const int32 System = GalaxyStore.GetWaypointSystems()[Waypoint];
+		if (!GalaxyStore.IsSystemPlaced(System))
+		{
+			return false;
+		}
+		return FVector2D::DistSquared(Center, FVector2D(GalaxyStore.GetSystemX()[System], GalaxyStore.GetSystemY()[System])) <= FMath::Square(Radius);
+	});
+
+	if (Best == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutWaypoint = Store.GetSeriesWaypoint(Best);
+	OutPrice    = bPurchase ? Store.GetLatest(Best).PurchasePrice : Store.GetLatest(Best).SellPrice;
+	return true;
+}
+
+UJsonObject* USpaceTradersMarkets::FindTradeRoutes(const TArray<FSpaceTradersTradeShip>& Ships, const int32 Count)
+{
+	TArray<TArray<FSpaceTradersTradeRoute>> Routes;
+	TradeOptimizer->FindRoutes(Ships, Count, Routes);
+
+	return UJsonObject::CreateFromRaw(FSpaceTradersTradeOptimizer::RoutesToJson(Ships, Routes));
+}
+
+void USpaceTradersMarkets::FindTradeRoutesAsync(const TArray<FSpaceTradersTradeShip>& Ships, const int32 Count, FOnSpaceTradersTradeRoutesFound OnFound)
+{
+	TradeOptimizer->FindRoutesAsync(Ships, Count, [Ships, OnFound](TArray<TArray<FSpaceTradersTradeRoute>>&& Routes) -> void
+	{
+		OnFound.ExecuteIfBound(UJsonObject::CreateFromRaw(FSpaceTradersTradeOptimizer::RoutesToJson(Ships, Routes)));
+	});
+}
+
+void USpaceTradersMarkets::Reset()
+{
+	Store.Reset();
+	TradeOptimizer->Reset();
+}
+
+static FAutoConsoleCommandWithWorld CmdMarketStats(
+	TEXT("SpaceTraders.MarketStats"),
+	TEXT("Logs the number of markets and price series in the market history and the memory they use."),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+	{
+		const USpaceTradersMarkets* const Markets = USpaceTradersMarkets::Get(World);
+		if (!Markets)
+		{
+			return;
+		}
+
+		const FSpaceTradersMarketStore& Store = Markets->GetStore();
+
+		UE_LOG(LogSpaceTradersApi, Display, TEXT("Markets: %d price series of up to %d samples, %.2f MB, %d profitable trades."),
+			Store.NumSeries(), Store.GetCapacity(), Store.GetAllocatedSize() / (1024. * 1024.), Markets->GetTradeOptimizer().NumCandidates());
+	}));
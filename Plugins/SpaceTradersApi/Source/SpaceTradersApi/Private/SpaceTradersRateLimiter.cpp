@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersRateLimiter.h"
+
+
+FSpaceTradersRateLimiter::FSpaceTradersRateLimiter(const double InRequestsPerSecond, const int32 InBurstRequests, const double InBurstWindow)
+	: BurstWindow(FMath::Max(InBurstWindow, 1.))
+{
+	SetLimits(InRequestsPerSecond, InBurstRequests);
+
+	// Starts full, like the server's buckets for a new client.
+	SteadyTokens = SteadyCapacity;
+	BurstTokens  = BurstCapacity;
+}
+
+void FSpaceTradersRateLimiter::SetLimits(const double InRequestsPerSecond, const int32 InBurstRequests)
+{
+	SteadyRate     = FMath::Max(InRequestsPerSecond, 0.01);
+	SteadyCapacity = FMath::Max(SteadyRate, 1.);
+	BurstCapacity  = FMath::Max(InBurstRequests, 0);
+	BurstRate      = BurstCapacity / BurstWindow;
+
+	SteadyTokens = FMath::Min(SteadyTokens, SteadyCapacity);
+	BurstTokens  = FMath::Min(BurstTokens,  BurstCapacity);
+}
+
+void FSpaceTradersRateLimiter::Refill(const double Now)
+{
+	const double Elapsed = FMath::Max(Now - LastRefill, 0.);
+	LastRefill = Now;
+
+	SteadyTokens = FMath::Min(SteadyTokens + Elapsed * SteadyRate, SteadyCapacity);
+	BurstTokens  = FMath::Min(BurstTokens  + Elapsed * BurstRate,  BurstCapacity);
+}
+
+bool FSpaceTradersRateLimiter::TryAcquire(const double Now)
+{
+	if (Now < PausedUntil)
+	{
+		return false;
+	}
+
+	Refill(Now);
+
+	if (SteadyTokens >= 1.)
+	{
+		SteadyTokens -= 1.;
+		return true;
+	}
+
+	if (BurstTokens >= 1.)
+	{
+		BurstTokens -= 1.;
+		return true;
+	}
+
+	return false;
+}
+
+double FSpaceTradersRateLimiter::GetWaitTime(const double Now)
+{
+	if (Now < PausedUntil)
+	{
+		return PausedUntil - Now;
+	}
+
+	Refill(Now);
+
+	if (SteadyTokens >= 1. || BurstTokens >= 1.)
+	{
+		return 0.;
+	}
+
+	const double SteadyWait = (1. - SteadyTokens) / SteadyRate;
+	const double BurstWait  = BurstRate > 0. ? (1. - BurstTokens) / BurstRate : SteadyWait;
+
+	return FMath::Min(SteadyWait, BurstWait);
+}
+
+void FSpaceTradersRateLimiter::OnServerState(const double Now, const int32 Remaining, const double ResetIn, const int32 RequestsSentSince)
+{
+	Refill(Now);
+
+	const double Available = FMath::Max(Remaining - RequestsSentSince, 0);
+
+	if (SteadyTokens + BurstTokens > Available)
+	{
+		SteadyTokens = FMath::Min(SteadyTokens, Available);
+		BurstTokens  = FMath::Min(BurstTokens,  Available - SteadyTokens);
+	}
+
+	if (Available <= 0. && ResetIn > 0.)
+	{
+		PausedUntil = FMath::Max(PausedUntil, Now + FMath::Min(ResetIn, BurstWindow));
+	}
+}
+
+void FSpaceTradersRateLimiter::OnThrottled(const double Now, const double RetryAfter)
+{
+	Refill(Now);
+
+	SteadyTokens = 0.;
+	BurstTokens  = 0.;
+	PausedUntil  = FMath::Max(PausedUntil, Now + FMath::Clamp(RetryAfter, 1. / SteadyRate, BurstWindow));
+}
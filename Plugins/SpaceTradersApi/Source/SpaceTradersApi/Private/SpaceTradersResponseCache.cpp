@@ -0,0 +1,443 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersResponseCache.h"
+#include "SpaceTradersApi.h"
+#include "SpaceTradersApiClient.h"
+#include "BlueprintJsonBinary.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	constexpr uint32 CacheMagic   = 0x43525453; // STRC
+	constexpr int32  CacheVersion = 2;
+
+	constexpr uint32 IndexMagic   = 0x49525453; // STRI
+	constexpr int32  IndexVersion = 1;
+
+	/* Seconds between the first change of the index and its save, so a burst of responses saves it once. */
+	constexpr double IndexSaveDelay = 5.;
+
+	/* Returns the key of a response file name, e.g. 0123456789abcdef.bin. */
+	bool ParseKey(const FString& FileName, uint64& OutKey)
+	{
+		const FString Name = FPaths::GetBaseFilename(FileName);
+		if (Name.Len() != 16)
+		{
+			return false;
+		}
+
+		for (const TCHAR Character : Name)
+		{
+			if (!FChar::IsHexDigit(Character))
+			{
+				return false;
+			}
+		}
+
+		OutKey = FCString::Strtoui64(*Name, nullptr, 16);
+		return true;
+	}
+
+	/* Writes Data to Path through a temporary file, so a reader never sees a partial file. */
+	bool SaveFileAtomically(const TArray<uint8>& Data, const FString& Path)
+	{
+		const FString TempPath = Path + TEXT(".") + FGuid::NewGuid().ToString() + TEXT(".tmp");
+
+		if (!FFileHelper::SaveArrayToFile(Data, *TempPath))
+		{
+			return false;
+		}
+
+		if (!IFileManager::Get().Move(*Path, *TempPath, true, true))
+		{
+			IFileManager::Get().Delete(*TempPath);
+			return false;
+		}
+
+		return true;
+	}
+}
+
+FSpaceTradersResponseCache::FSpaceTradersResponseCache(const FString& InDirectory, const int64 InMaxSize)
+	: Directory(InDirectory)
+	, MaxSize(InMaxSize)
+{
+	IFileManager::Get().MakeDirectory(*Directory, true);
+	LoadIndex();
+}
+
+FSpaceTradersResponseCache::~FSpaceTradersResponseCache()
+{
+	if (DirtySince > 0.)
+	{
+		SaveIndex();
+	}
+}
+
+/* static */ uint64 FSpaceTradersResponseCache::MakeKey(const FString& Verb, const FString& Url, const FString& AgentToken)
+{
+	const FString KeyString = Verb + TEXT(' ') + Url + TEXT('\n') + AgentToken;
+	return CityHash64(reinterpret_cast<const char*>(*KeyString), KeyString.Len() * sizeof(TCHAR));
+}
+
+FString FSpaceTradersResponseCache::GetPath(const uint64 Key) const
+{
+	return FPaths::Combine(Directory, FString::Printf(TEXT("%016llx.bin"), Key));
+}
+
+const FSpaceTradersCacheEntry* FSpaceTradersResponseCache::Find(const uint64 Key) const
+{
+	return Entries.Find(Key);
+}
+
+void FSpaceTradersResponseCache::Touch(const uint64 Key, const bool bRevalidated)
+{
+	if (FSpaceTradersCacheEntry* const Entry = Entries.Find(Key))
+	{
+		Entry->LastAccess = FDateTime::UtcNow();
+		if (bRevalidated)
+		{
+			Entry->StoredAt = Entry->LastAccess;
+		}
+		MarkDirty();
+	}
+}
+
+void FSpaceTradersResponseCache::OnStored(const uint64 Key, FSpaceTradersCacheEntry&& Entry)
+{
+	if (const FSpaceTradersCacheEntry* const Previous = Entries.Find(Key))
+	{
+		TotalSize -= Previous->Size;
+	}
+
+	TotalSize += Entry.Size;
+	Entries.Add(Key, MoveTemp(Entry));
+	MarkDirty();
+
+	EvictIfNeeded();
+}
+
+void FSpaceTradersResponseCache::EvictIfNeeded()
+{
+	if (TotalSize <= MaxSize)
+	{
+		return;
+	}
+
+	// Evicts down to 90% of the maximum size so it doesn't happen again on the next response.
+	TArray<TPair<FDateTime, uint64>> ByAccess;
+	ByAccess.Reserve(Entries.Num());
+	for (const TPair<uint64, FSpaceTradersCacheEntry>& Pair : Entries)
+	{
+		ByAccess.Emplace(Pair.Value.LastAccess, Pair.Key);
+	}
+	ByAccess.Sort([](const TPair<FDateTime, uint64>& A, const TPair<FDateTime, uint64>& B) { return A.Key < B.Key; });
+
+	const int64 TargetSize = MaxSize / 10 * 9;
+	for (const TPair<FDateTime, uint64>& Pair : ByAccess)
+	{
+		if (TotalSize <= TargetSize)
+		{
+			break;
+		}
+		Remove(Pair.Value);
+	}
+}
+
+void FSpaceTradersResponseCache::Remove(const uint64 Key)
+{
+	FSpaceTradersCacheEntry Entry;
+	if (Entries.RemoveAndCopyValue(Key, Entry))
+	{
+		TotalSize -= Entry.Size;
+		IFileManager::Get().Delete(*GetPath(Key), false, false, true);
+		MarkDirty();
+	}
+}
+
+void FSpaceTradersResponseCache::Clear()
+{
+	Entries.Empty();
+	TotalSize = 0;
+
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	IFileManager::Get().MakeDirectory(*Directory, true);
+	MarkDirty();
+}
+
+void FSpaceTradersResponseCache::Flush(const double Now)
+{
+	if (DirtySince > 0. && Now - DirtySince >= IndexSaveDelay)
+	{
+		SaveIndex();
+	}
+}
+
+void FSpaceTradersResponseCache::MarkDirty()
+{
+	if (DirtySince == 0.)
+	{
+		DirtySince = FPlatformTime::Seconds();
+	}
+}
+
+bool FSpaceTradersResponseCache::Load(const uint64 Key, FSpaceTradersResponse& OutResponse) const
+{
+	TArray<uint8> File;
+	if (!FFileHelper::LoadFileToArray(File, *GetPath(Key), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(File);
+
+	uint32 Magic = 0;
+	int32  Version = 0;
+	int32  HttpStatus = 0;
+	FString ETag;
+	TArray<uint8> Data;
+	TArray<uint8> Meta;
+
+	Reader << Magic << Version;
+	if (Magic != CacheMagic || Version != CacheVersion)
+	{
+		return false;
+	}
+
+	Reader << HttpStatus << ETag << Data << Meta;
+	if (Reader.IsError())
+	{
+		return false;
+	}
+
+	FString Error;
+	OutResponse.Data = FBlueprintJsonBinary::Read(Data, EJsonParseOptions::FlatObjects, &Error);
+	if (!OutResponse.Data)
+	{
+		UE_LOG(LogSpaceTradersApi, Warning, TEXT("Invalid cached response %016llx: %s"), Key, *Error);
+		return false;
+	}
+
+	if (Meta.Num() > 0)
+	{
+		const TSharedPtr<FJsonValue> MetaValue = FBlueprintJsonBinary::Read(Meta);
+		OutResponse.Meta = MetaValue ? MetaValue->AsObject() : nullptr;
+	}
+
+	OutResponse.Error = FSpaceTradersError();
+	OutResponse.Error.HttpStatus = HttpStatus;
+	OutResponse.bSuccess = true;
+
+	return true;
+}
+
+int64 FSpaceTradersResponseCache::Store(const uint64 Key, const FString& ETag, const FSpaceTradersResponse& Response) const
+{
+	if (!Response.bSuccess || !Response.Data)
+	{
+		return -1;
+	}
+
+	TArray<uint8> Data;
+	FBlueprintJsonBinary::Write(Response.Data, Data);
+
+	TArray<uint8> Meta;
+	if (Response.Meta)
+	{
+		FBlueprintJsonBinary::Write(MakeShared<FJsonValueObject>(Response.Meta), Meta);
+	}
+
+	TArray<uint8> File;
+	File.Reserve(Data.Num() + Meta.Num() + ETag.Len() + 32);
+
+	FMemoryWriter Writer(File);
+
+	uint32  Magic      = CacheMagic;
+	int32   Version    = CacheVersion;
+	int32   HttpStatus = Response.Error.HttpStatus;
+	FString FileETag   = ETag;
+
+	// The ETag is also in the file so the entry can be rebuilt if the index wasn't saved.
+	Writer << Magic << Version << HttpStatus << FileETag << Data << Meta;
+
+	if (!SaveFileAtomically(File, GetPath(Key)))
+	{
+		UE_LOG(LogSpaceTradersApi, Warning, TEXT("Failed to write cached response %016llx."), Key);
+		return -1;
+	}
+
+	return File.Num();
+}
+
+void FSpaceTradersResponseCache::LoadIndex()
+{
+	bool bIndexLoaded = false;
+
+	TArray<uint8> File;
+	if (FFileHelper::LoadFileToArray(File, *FPaths::Combine(Directory, TEXT("Index.bin")), FILEREAD_Silent))
+	{
+		FMemoryReader Reader(File);
+
+		uint32 Magic   = 0;
+		int32  Version = 0;
+		int32  Num     = 0;
+		Reader << Magic << Version << Num;
+
+		if (Magic == IndexMagic && Version == IndexVersion && Num >= 0)
+		{
+			Entries.Reserve(Num);
+			for (int32 i = 0; i < Num && !Reader.IsError(); ++i)
+			{
+				uint64 Key = 0;
+				FSpaceTradersCacheEntry Entry;
+				Reader << Key << Entry.StoredAt << Entry.LastAccess << Entry.Size << Entry.ETag;
+
+				Entries.Add(Key, MoveTemp(Entry));
+			}
+
+			bIndexLoaded = !Reader.IsError();
+		}
+	}
+
+	if (!bIndexLoaded)
+	{
+		Entries.Empty();
+	}
+
+	// The index can be missing or older than the files, e.g. the game crashed before saving it.
+	const int32 NumChanged = ReconcileWithFiles();
+
+	TotalSize = 0;
+	for (const TPair<uint64, FSpaceTradersCacheEntry>& Pair : Entries)
+	{
+		TotalSize += Pair.Value.Size;
+	}
+
+	UE_LOG(LogSpaceTradersApi, Log, TEXT("Loaded response cache index: %d responses, %.1f MB, %d entries rebuilt from the files."),
+		Entries.Num(), TotalSize / (1024. * 1024.), NumChanged);
+
+	if (NumChanged > 0 || !bIndexLoaded)
+	{
+		MarkDirty();
+	}
+
+	EvictIfNeeded();
+}
+
+int32 FSpaceTradersResponseCache::ReconcileWithFiles()
+{
+	IFileManager& FileManager = IFileManager::Get();
+
+	int32 NumChanged = 0;
+
+	// Temporary files of writes that never completed.
+	TArray<FString> TempFiles;
+	FileManager.FindFiles(TempFiles, *Directory, TEXT(".tmp"));
+	for (const FString& TempFile : TempFiles)
+	{
+		FileManager.Delete(*FPaths::Combine(Directory, TempFile), false, false, true);
+	}
+
+	TArray<FString> Files;
+	FileManager.FindFiles(Files, *Directory, TEXT(".bin"));
+
+	TSet<uint64> Found;
+	Found.Reserve(Files.Num());
+
+	for (const FString& FileName : Files)
+	{
+		uint64 Key = 0;
+		if (!ParseKey(FileName, Key))
+		{
+			continue;
+		}
+
+		const FString Path = FPaths::Combine(Directory, FileName);
+
+		uint32  Magic      = 0;
+		int32   Version    = 0;
+		int32   HttpStatus = 0;
+		FString ETag;
+		int64   Size       = 0;
+
+		// Only the header is read, the ETag is needed if the file isn't in the index.
+		if (TUniquePtr<FArchive> Reader = TUniquePtr<FArchive>(FileManager.CreateFileReader(*Path, FILEREAD_Silent)))
+		{
+			*Reader << Magic << Version;
+			if (Magic == CacheMagic && Version == CacheVersion)
+			{
+				*Reader << HttpStatus << ETag;
+			}
+			Size = Reader->IsError() ? 0 : Reader->TotalSize();
+		}
+
+		if (Size == 0 || Magic != CacheMagic || Version != CacheVersion)
+		{
+			// Unreadable or written by another version of the cache.
+			FileManager.Delete(*Path, false, false, true);
+			Entries.Remove(Key);
+			++NumChanged;
+			continue;
+		}
+
+		Found.Add(Key);
+
+		if (FSpaceTradersCacheEntry* const Entry = Entries.Find(Key))
+		{
+			Entry->Size = Size;
+			continue;
+		}
+
+		FSpaceTradersCacheEntry& Entry = Entries.Add(Key);
+		Entry.Size       = Size;
+		Entry.ETag       = MoveTemp(ETag);
+		Entry.StoredAt   = FileManager.GetTimeStamp(*Path);
+		Entry.LastAccess = Entry.StoredAt;
+		++NumChanged;
+	}
+
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (!Found.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+			++NumChanged;
+		}
+	}
+
+	return NumChanged;
+}
+
+void FSpaceTradersResponseCache::SaveIndex()
+{
+	DirtySince = 0.;
+
+	TArray<uint8> File;
+	FMemoryWriter Writer(File);
+
+	uint32 Magic   = IndexMagic;
+	int32  Version = IndexVersion;
+	int32  Num     = Entries.Num();
+	Writer << Magic << Version << Num;
+
+	for (const TPair<uint64, FSpaceTradersCacheEntry>& Pair : Entries)
+	{
+		uint64 Key = Pair.Key;
+		FSpaceTradersCacheEntry Entry = Pair.Value;
+		Writer << Key << Entry.StoredAt << Entry.LastAccess << Entry.Size << Entry.ETag;
+	}
+
+	if (!SaveFileAtomically(File, FPaths::Combine(Directory, TEXT("Index.bin"))))
+	{
+		UE_LOG(LogSpaceTradersApi, Warning, TEXT("Failed to save the response cache index."));
+		MarkDirty();
+	}
+}
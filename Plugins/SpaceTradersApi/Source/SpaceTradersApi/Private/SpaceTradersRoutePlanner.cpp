@@ -0,0 +1,302 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersRoutePlanner.h"
+#include "SpaceTradersGalaxyStore.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Reverse.h"
+#include "Misc/ScopeRWLock.h"
+
+namespace
+{
+	/* Travel time multiplier of each flight mode, from the API. */
+	constexpr double FlightModeMultipliers[] = { 25., 12.5, 250. };
+	static_assert(UE_ARRAY_COUNT(FlightModeMultipliers) == static_cast<int32>(ESpaceTradersFlightMode::MAX), "Missing flight mode multiplier.");
+
+	const TCHAR* const FlightModeNames[] = { TEXT("CRUISE"), TEXT("BURN"), TEXT("DRIFT") };
+	static_assert(UE_ARRAY_COUNT(FlightModeNames) == static_cast<int32>(ESpaceTradersFlightMode::MAX), "Missing flight mode name.");
+
+	/* A ship at a waypoint with some fuel, and how it got there. */
+	struct FRouteLabel
+	{
+		int32  Waypoint;
+		int32  Fuel;
+		double Time;
+
+		/* Label of the previous waypoint, INDEX_NONE for the origin. */
+		int32 Parent;
+
+		ESpaceTradersFlightMode Mode;
+		bool  bJump;
+		bool  bRefuelAtParent;
+		int32 FuelCost;
+	};
+
+	struct FLowestFirst
+	{
+		FORCEINLINE bool operator()(const TPair<double, int32>& A, const TPair<double, int32>& B) const
+		{
+			return A.Key < B.Key;
+		}
+	};
+}
+
+
+TSharedRef<FJsonObject> FSpaceTradersRoute::ToJson() const
+{
+	TArray<TSharedPtr<FJsonValue>> StepValues;
+	StepValues.Reserve(Steps.Num());
+
+	for (const FSpaceTradersRouteStep& Step : Steps)
+	{
+		const TSharedRef<FJsonObject> StepObject = MakeShared<FJsonObject>();
+		StepObject->SetStringField(TEXT("from"),       Step.From);
+		StepObject->SetStringField(TEXT("to"),         Step.To);
+		StepObject->SetStringField(TEXT("action"),     Step.bJump ? TEXT("JUMP") : TEXT("NAVIGATE"));
+		StepObject->SetStringField(TEXT("flightMode"), FlightModeNames[static_cast<int32>(Step.FlightMode)]);
+		StepObject->SetBoolField  (TEXT("refuel"),     Step.bRefuel);
+		StepObject->SetNumberField(TEXT("fuelCost"),   Step.FuelCost);
+		StepObject->SetNumberField(TEXT("fuelAfter"),  Step.FuelAfter);
+		StepObject->SetNumberField(TEXT("duration"),   Step.Duration);
+		StepValues.Add(MakeShared<FJsonValueObject>(StepObject));
+	}
+
+	const TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetBoolField  (TEXT("found"),    bFound);
+	Object->SetNumberField(TEXT("duration"), Duration);
+	Object->SetNumberField(TEXT("fuelUsed"), FuelUsed);
+	Object->SetNumberField(TEXT("refuels"),  NumRefuels);
+	Object->SetArrayField (TEXT("steps"),    MoveTemp(StepValues));
+	return Object;
+}
+
+FSpaceTradersRoutePlanner::FSpaceTradersRoutePlanner(const FSpaceTradersGalaxyStore& InStore)
+	: Store(InStore)
+{
+}
+
+/* static */ int32 FSpaceTradersRoutePlanner::GetFuelCost(const double Distance, const ESpaceTradersFlightMode Mode)
+{
+	const int32 Units = FMath::Max(FMath::RoundToInt32(Distance), 1);
+
+	switch (Mode)
+	{
+	case ESpaceTradersFlightMode::Burn:  return Units * 2;
+	case ESpaceTradersFlightMode::Drift: return 1;
+	default:                             return Units;
+	}
+}
+
+/* static */ double FSpaceTradersRoutePlanner::GetTravelTime(const double Distance, const ESpaceTradersFlightMode Mode, const int32 Speed)
+{
+	const double Units = FMath::Max(FMath::RoundToDouble(Distance), 1.);
+	return FMath::RoundToDouble(Units * FlightModeMultipliers[static_cast<int32>(Mode)] / FMath::Max(Speed, 1) + 15.);
+}
+
+FSpaceTradersRoutePlanner::FDistanceMatrixPtr FSpaceTradersRoutePlanner::GetDistanceMatrix(const int32 System) const
+{
+	{
+		FReadScopeLock ReadLock(MatricesLock);
+		if (const FDistanceMatrixPtr* const Matrix = Matrices.Find(System))
+		{
+			return *Matrix;
+		}
+	}
+
+	const TSharedRef<FDistanceMatrix, ESPMode::ThreadSafe> Matrix = MakeShared<FDistanceMatrix, ESPMode::ThreadSafe>();
+	Matrix->Waypoints = Store.GetSystemWaypoints(System);
+
+	const int32 Num = Matrix->Waypoints.Num();
+	const TConstArrayView<int32> X = Store.GetWaypointX();
+	const TConstArrayView<int32> Y = Store.GetWaypointY();
+
+	Matrix->Distances.SetNumUninitialized(Num * Num);
+	for (int32 From = 0; From < Num; ++From)
+	{
+		const FVector2D FromLocation(X[Matrix->Waypoints[From]], Y[Matrix->Waypoints[From]]);
+		for (int32 To = 0; To < Num; ++To)
+		{
+			const FVector2D ToLocation(X[Matrix->Waypoints[To]], Y[Matrix->Waypoints[To]]);
+			Matrix->Distances[From * Num + To] = static_cast<float>(FVector2D::Distance(FromLocation, ToLocation));
+		}
+	}
+
+	// Another thread may have computed it meanwhile, both are the same.
+	FWriteScopeLock WriteLock(MatricesLock);
+	return Matrices.Add(System, Matrix);
+}
+
+void FSpaceTradersRoutePlanner::Invalidate(TConstArrayView<int32> Systems)
+{
+	FWriteScopeLock WriteLock(MatricesLock);
+	for (const int32 System : Systems)
+	{
+		Matrices.Remove(System);
+	}
+}
+
+void FSpaceTradersRoutePlanner::Reset()
+{
+	FWriteScopeLock WriteLock(MatricesLock);
+	Matrices.Reset();
+}
+
+FSpaceTradersRoute FSpaceTradersRoutePlanner::PlanRoute(const FSpaceTradersRouteQuery& Query) const
+{
+	FSpaceTradersRoute Route;
+
+	const int32 Origin      = Store.FindWaypoint(Query.Origin);
+	const int32 Destination = Store.FindWaypoint(Query.Destination);
+	if (Origin == INDEX_NONE || Destination == INDEX_NONE)
+	{
+		return Route;
+	}
+
+	const TConstArrayView<int32>  WaypointSystems = Store.GetWaypointSystems();
+	const TConstArrayView<int32>  WaypointX       = Store.GetWaypointX();
+	const TConstArrayView<int32>  WaypointY       = Store.GetWaypointY();
+	const TConstArrayView<uint64> WaypointTraits  = Store.GetWaypointTraits();
+
+	const int32  Capacity          = FMath::Max(Query.FuelCapacity, 0);
+	const int32  DestinationSystem = WaypointSystems[Destination];
+	const int32  MarketplaceBit    = Store.FindTrait(TEXT("MARKETPLACE"));
+	const uint64 MarketplaceMask   = MarketplaceBit != INDEX_NONE && Query.bRefuelAtMarketplaces ? uint64(1) << MarketplaceBit : 0;
+
+	TArray<ESpaceTradersFlightMode, TInlineAllocator<3>> Modes = { ESpaceTradersFlightMode::Cruise };
+	if (Query.bAllowBurn)
+	{
+		Modes.Add(ESpaceTradersFlightMode::Burn);
+	}
+	if (Query.bAllowDrift)
+	{
+		Modes.Add(ESpaceTradersFlightMode::Drift);
+	}
+
+	// Lower bound of the time left, from the straight line to the destination at the fastest allowed speed.
+	const double SecondsPerUnit = FlightModeMultipliers[static_cast<int32>(Query.bAllowBurn ? ESpaceTradersFlightMode::Burn : ESpaceTradersFlightMode::Cruise)] / FMath::Max(Query.Speed, 1);
+	const auto Heuristic = [&](const int32 Waypoint) -> double
+	{
+		if (Waypoint == Destination || WaypointSystems[Waypoint] != DestinationSystem)
+		{
+			return 0.;
+		}
+		return FVector2D::Distance(FVector2D(WaypointX[Waypoint], WaypointY[Waypoint]), FVector2D(WaypointX[Destination], WaypointY[Destination])) * SecondsPerUnit;
+	};
+
+	TArray<FRouteLabel> Labels;
+	TArray<TPair<double, int32>> Open;
+
+	// Most fuel a waypoint was left with, a later arrival with less fuel can't do better.
+	TMap<int32, int32> BestFuel;
+
+	const auto Push = [&](FRouteLabel&& Label)
+	{
+		if (const int32* const Best = BestFuel.Find(Label.Waypoint); Best && *Best >= Label.Fuel)
+		{
+			return;
+		}
+		const double Estimate = Label.Time + Heuristic(Label.Waypoint);
+		Open.HeapPush(TPair<double, int32>(Estimate, Labels.Add(MoveTemp(Label))), FLowestFirst());
+	};
+
+	Push(FRouteLabel{ Origin, FMath::Clamp(Query.Fuel, 0, Capacity), 0., INDEX_NONE, ESpaceTradersFlightMode::Cruise, false, false, 0 });
+
+	int32 Found = INDEX_NONE;
+	for (int32 NumExpanded = 0; Open.Num() > 0 && NumExpanded < MaxExpandedStates; ++NumExpanded)
+	{
+		TPair<double, int32> Top;
+		Open.HeapPop(Top, FLowestFirst(), EAllowShrinking::No);
+
+		const FRouteLabel Label = Labels[Top.Value];
+
+		int32& Best = BestFuel.FindOrAdd(Label.Waypoint, -1);
+		if (Best >= Label.Fuel)
+		{
+			continue;
+		}
+		Best = Label.Fuel;
+
+		if (Label.Waypoint == Destination)
+		{
+			Found = Top.Value;
+			break;
+		}
+
+		const bool  bRefuel   = (WaypointTraits[Label.Waypoint] & MarketplaceMask) != 0 && Label.Fuel < Capacity;
+		const int32 FuelAtDeparture = bRefuel ? Capacity : Label.Fuel;
+		if (bRefuel)
+		{
+			Best = Capacity;
+		}
+
+		// Navigation to the other waypoints of the system.
+		const FDistanceMatrixPtr Matrix = GetDistanceMatrix(WaypointSystems[Label.Waypoint]);
+		const int32 From = Matrix->Waypoints.Find(Label.Waypoint);
+
+		for (int32 To = 0; From != INDEX_NONE && To < Matrix->Waypoints.Num(); ++To)
+		{
+			if (To == From)
+			{
+				continue;
+			}
+
+			const double Distance = Matrix->Get(From, To);
+			for (const ESpaceTradersFlightMode Mode : Modes)
+			{
+				const int32 FuelCost = Capacity > 0 ? GetFuelCost(Distance, Mode) : 0;
+				if (FuelCost > FuelAtDeparture)
+				{
+					continue;
+				}
+
+				Push(FRouteLabel{ Matrix->Waypoints[To], FuelAtDeparture - FuelCost, Label.Time + GetTravelTime(Distance, Mode, Query.Speed), Top.Value, Mode, false, bRefuel, FuelCost });
+			}
+		}
+
+		// Jumps don't use fuel.
+		for (const int32 Gate : Store.GetJumpGateConnections(Label.Waypoint))
+		{
+			Push(FRouteLabel{ Gate, FuelAtDeparture, Label.Time + Query.JumpDuration, Top.Value, ESpaceTradersFlightMode::Cruise, true, bRefuel, 0 });
+		}
+	}
+
+	if (Found == INDEX_NONE)
+	{
+		return Route;
+	}
+
+	for (int32 Index = Found; Labels[Index].Parent != INDEX_NONE; Index = Labels[Index].Parent)
+	{
+		const FRouteLabel& Label  = Labels[Index];
+		const FRouteLabel& Parent = Labels[Label.Parent];
+
+		FSpaceTradersRouteStep& Step = Route.Steps.AddDefaulted_GetRef();
+		Step.From       = Store.GetWaypointSymbol(Parent.Waypoint);
+		Step.To         = Store.GetWaypointSymbol(Label.Waypoint);
+		Step.bJump      = Label.bJump;
+		Step.FlightMode = Label.Mode;
+		Step.bRefuel    = Label.bRefuelAtParent;
+		Step.FuelCost   = Label.FuelCost;
+		Step.FuelAfter  = Label.Fuel;
+		Step.Duration   = Label.Time - Parent.Time;
+
+		Route.FuelUsed   += Step.FuelCost;
+		Route.NumRefuels += Step.bRefuel ? 1 : 0;
+	}
+
+	Algo::Reverse(Route.Steps);
+
+	Route.bFound   = true;
+	Route.Duration = Labels[Found].Time;
+	return Route;
+}
+
+void FSpaceTradersRoutePlanner::PlanRoutes(TConstArrayView<FSpaceTradersRouteQuery> Queries, TArray<FSpaceTradersRoute>& OutRoutes) const
+{
+	OutRoutes.SetNum(Queries.Num());
+	ParallelFor(Queries.Num(), [&](const int32 Index)
+	{
+		OutRoutes[Index] = PlanRoute(Queries[Index]);
+	});
+}
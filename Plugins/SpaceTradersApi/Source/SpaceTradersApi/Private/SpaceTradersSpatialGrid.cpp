@@ -0,0 +1,356 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersSpatialGrid.h"
+#include "ConvexVolume.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	/* Returns the squared distance between a query position and a point. */
+	FORCEINLINE double DistSquared(const FVector2D& A, const FIntPoint B)
+	{
+		const double X = A.X - B.X;
+		const double Y = A.Y - B.Y;
+		return X * X + Y * Y;
+	}
+
+	/* Max-heap predicate, the farthest candidate is on top. */
+	struct FFartherFirst
+	{
+		FORCEINLINE bool operator()(const TPair<double, int32>& A, const TPair<double, int32>& B) const
+		{
+			return A.Key > B.Key;
+		}
+	};
+}
+
+
+FSpaceTradersSpatialGrid::FSpaceTradersSpatialGrid(const int32 InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1))
+{
+}
+
+FIntPoint FSpaceTradersSpatialGrid::GetCell(const FVector2D& Location) const
+{
+	return FIntPoint(
+		FMath::FloorToInt32(FMath::Clamp(Location.X / CellSize, double(MIN_int32 / 2), double(MAX_int32 / 2))),
+		FMath::FloorToInt32(FMath::Clamp(Location.Y / CellSize, double(MIN_int32 / 2), double(MAX_int32 / 2))));
+}
+
+FIntPoint FSpaceTradersSpatialGrid::GetCell(const FIntPoint Location) const
+{
+	return FIntPoint(FMath::FloorToInt32(double(Location.X) / CellSize), FMath::FloorToInt32(double(Location.Y) / CellSize));
+}
+
+template<typename FunctorType>
+void FSpaceTradersSpatialGrid::ForEachCell(FIntPoint MinCell, FIntPoint MaxCell, FunctorType&& Functor) const
+{
+	MinCell = FIntPoint(FMath::Max(MinCell.X, MinOccupiedCell.X), FMath::Max(MinCell.Y, MinOccupiedCell.Y));
+	MaxCell = FIntPoint(FMath::Min(MaxCell.X, MaxOccupiedCell.X), FMath::Min(MaxCell.Y, MaxOccupiedCell.Y));
+
+	if (MinCell.X > MaxCell.X || MinCell.Y > MaxCell.Y)
+	{
+		return;
+	}
+
+	// Large ranges are mostly empty, walking the occupied cells is cheaper than looking each one up.
+	const int64 NumRangeCells = int64(MaxCell.X - MinCell.X + 1) * int64(MaxCell.Y - MinCell.Y + 1);
+	if (NumRangeCells > Cells.Num())
+	{
+		for (const TPair<FIntPoint, FCell>& Pair : Cells)
+		{
+			if (Pair.Key.X >= MinCell.X && Pair.Key.X <= MaxCell.X && Pair.Key.Y >= MinCell.Y && Pair.Key.Y <= MaxCell.Y)
+			{
+				Functor(Pair.Value);
+			}
+		}
+		return;
+	}
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			if (const FCell* const Cell = Cells.Find(FIntPoint(X, Y)))
+			{
+				Functor(*Cell);
+			}
+		}
+	}
+}
+
+void FSpaceTradersSpatialGrid::Add(const int32 Id, const FIntPoint Location)
+{
+	check(Id >= 0);
+
+	if (Contains(Id))
+	{
+		if (Locations[Id] == Location)
+		{
+			return;
+		}
+		Remove(Id);
+	}
+
+	if (Id >= Present.Num())
+	{
+		Present.SetNum(Id + 1, false);
+		Locations.SetNumUninitialized(Id + 1);
+	}
+
+	const FIntPoint CellKey = GetCell(Location);
+
+	FCell& Cell = Cells.FindOrAdd(CellKey);
+	Cell.Ids.Add(Id);
+	Cell.Locations.Add(Location);
+
+	MinOccupiedCell = FIntPoint(FMath::Min(MinOccupiedCell.X, CellKey.X), FMath::Min(MinOccupiedCell.Y, CellKey.Y));
+	MaxOccupiedCell = FIntPoint(FMath::Max(MaxOccupiedCell.X, CellKey.X), FMath::Max(MaxOccupiedCell.Y, CellKey.Y));
+
+	Locations[Id] = Location;
+	Present[Id]   = true;
+	++NumPoints;
+}
+
+void FSpaceTradersSpatialGrid::Remove(const int32 Id)
+{
+	if (!Contains(Id))
+	{
+		return;
+	}
+
+	const FIntPoint CellKey = GetCell(Locations[Id]);
+	if (FCell* const Cell = Cells.Find(CellKey))
+	{
+		const int32 Index = Cell->Ids.Find(Id);
+		if (Index != INDEX_NONE)
+		{
+			Cell->Ids.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			Cell->Locations.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+
+		// The occupied bounds are kept, they only need to contain every cell.
+		if (Cell->Ids.Num() == 0)
+		{
+			Cells.Remove(CellKey);
+		}
+	}
+
+	Present[Id] = false;
+	--NumPoints;
+}
+
+void FSpaceTradersSpatialGrid::Reset()
+{
+	Cells.Reset();
+	Locations.Reset();
+	Present.Reset();
+	NumPoints = 0;
+
+	MinOccupiedCell = FIntPoint(MAX_int32, MAX_int32);
+	MaxOccupiedCell = FIntPoint(MIN_int32, MIN_int32);
+}
+
+void FSpaceTradersSpatialGrid::QueryRadius(const FVector2D& Center, const double Radius, TArray<int32>& OutIds) const
+{
+	const double RadiusSquared = Radius * Radius;
+
+	ForEachCell(GetCell(Center - FVector2D(Radius)), GetCell(Center + FVector2D(Radius)), [&](const FCell& Cell)
+	{
+		for (int32 i = 0; i < Cell.Ids.Num(); ++i)
+		{
+			if (DistSquared(Center, Cell.Locations[i]) <= RadiusSquared)
+			{
+				OutIds.Add(Cell.Ids[i]);
+			}
+		}
+	});
+}
+
+void FSpaceTradersSpatialGrid::QueryRectangle(const FVector2D& Min, const FVector2D& Max, TArray<int32>& OutIds) const
+{
+	ForEachCell(GetCell(Min), GetCell(Max), [&](const FCell& Cell)
+	{
+		for (int32 i = 0; i < Cell.Ids.Num(); ++i)
+		{
+			const FIntPoint Location = Cell.Locations[i];
+			if (Location.X >= Min.X && Location.X <= Max.X && Location.Y >= Min.Y && Location.Y <= Max.Y)
+			{
+				OutIds.Add(Cell.Ids[i]);
+			}
+		}
+	});
+}
+
+void FSpaceTradersSpatialGrid::QueryPolygon(TConstArrayView<FVector2D> Polygon, TArray<int32>& OutIds) const
+{
+	if (Polygon.Num() < 3)
+	{
+		return;
+	}
+
+	FBox2D Bounds(ForceInit);
+	double SignedArea = 0.;
+	for (int32 i = 0; i < Polygon.Num(); ++i)
+	{
+		Bounds += Polygon[i];
+		SignedArea += FVector2D::CrossProduct(Polygon[i], Polygon[(i + 1) % Polygon.Num()]);
+	}
+
+	// Points are inside when they are on the same side of every edge.
+	const double Winding = SignedArea >= 0. ? 1. : -1.;
+
+	ForEachCell(GetCell(Bounds.Min), GetCell(Bounds.Max), [&](const FCell& Cell)
+	{
+		for (int32 i = 0; i < Cell.Ids.Num(); ++i)
+		{
+			const FVector2D Point(Cell.Locations[i]);
+
+			bool bInside = true;
+			for (int32 Edge = 0; Edge < Polygon.Num() && bInside; ++Edge)
+			{
+				const FVector2D& A = Polygon[Edge];
+				const FVector2D& B = Polygon[(Edge + 1) % Polygon.Num()];
+				bInside = FVector2D::CrossProduct(B - A, Point - A) * Winding >= 0.;
+			}
+
+			if (bInside)
+			{
+				OutIds.Add(Cell.Ids[i]);
+			}
+		}
+	});
+}
+
+void FSpaceTradersSpatialGrid::QueryFrustum(const FConvexVolume& Frustum, const FTransform& GridToWorld, TArray<int32>& OutIds) const
+{
+	// The frustum can be infinite, so cells are culled one by one instead of intersecting it with the plane.
+	for (const TPair<FIntPoint, FCell>& Pair : Cells)
+	{
+		const FVector2D CellMin = FVector2D(Pair.Key) * CellSize;
+		const FVector2D CellMax = CellMin + FVector2D(CellSize);
+
+		FBox CellBox(ForceInit);
+		CellBox += GridToWorld.TransformPosition(FVector(CellMin.X, CellMin.Y, 0.));
+		CellBox += GridToWorld.TransformPosition(FVector(CellMax.X, CellMin.Y, 0.));
+		CellBox += GridToWorld.TransformPosition(FVector(CellMin.X, CellMax.Y, 0.));
+		CellBox += GridToWorld.TransformPosition(FVector(CellMax.X, CellMax.Y, 0.));
+
+		bool bFullyContained = false;
+		if (!Frustum.IntersectBox(CellBox.GetCenter(), CellBox.GetExtent(), bFullyContained))
+		{
+			continue;
+		}
+
+		const FCell& Cell = Pair.Value;
+		if (bFullyContained)
+		{
+			OutIds.Append(Cell.Ids);
+			continue;
+		}
+
+		for (int32 i = 0; i < Cell.Ids.Num(); ++i)
+		{
+			const FIntPoint Location = Cell.Locations[i];
+			if (Frustum.IntersectPoint(GridToWorld.TransformPosition(FVector(Location.X, Location.Y, 0.))))
+			{
+				OutIds.Add(Cell.Ids[i]);
+			}
+		}
+	}
+}
+
+void FSpaceTradersSpatialGrid::QueryNearest(const FVector2D& Center, const int32 Count, TArray<int32>& OutIds) const
+{
+	OutIds.Reset();
+
+	if (Count <= 0 || NumPoints == 0)
+	{
+		return;
+	}
+
+	TArray<TPair<double, int32>, TInlineAllocator<32>> Heap;
+	Heap.Reserve(Count);
+
+	const auto AddCell = [&](const FCell& Cell)
+	{
+		for (int32 i = 0; i < Cell.Ids.Num(); ++i)
+		{
+			const double Distance = DistSquared(Center, Cell.Locations[i]);
+			if (Heap.Num() < Count)
+			{
+				Heap.HeapPush(TPair<double, int32>(Distance, Cell.Ids[i]), FFartherFirst());
+			}
+			else if (Distance < Heap.HeapTop().Key)
+			{
+				Heap.HeapPopDiscard(FFartherFirst(), EAllowShrinking::No);
+				Heap.HeapPush(TPair<double, int32>(Distance, Cell.Ids[i]), FFartherFirst());
+			}
+		}
+	};
+
+	// Visits rings of cells around the center. Points beyond ring R are at least R cells away.
+	const FIntPoint CenterCell = GetCell(Center);
+	const int32 MaxRing = FMath::Max(
+		FMath::Max(FMath::Abs(CenterCell.X - MinOccupiedCell.X), FMath::Abs(MaxOccupiedCell.X - CenterCell.X)),
+		FMath::Max(FMath::Abs(CenterCell.Y - MinOccupiedCell.Y), FMath::Abs(MaxOccupiedCell.Y - CenterCell.Y)));
+
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		if (Ring == 0)
+		{
+			ForEachCell(CenterCell, CenterCell, AddCell);
+		}
+		else
+		{
+			// Top and bottom rows, then left and right columns without the corners.
+			ForEachCell(CenterCell + FIntPoint(-Ring, -Ring),    CenterCell + FIntPoint(Ring, -Ring),     AddCell);
+			ForEachCell(CenterCell + FIntPoint(-Ring,  Ring),    CenterCell + FIntPoint(Ring,  Ring),     AddCell);
+			ForEachCell(CenterCell + FIntPoint(-Ring, -Ring + 1), CenterCell + FIntPoint(-Ring, Ring - 1), AddCell);
+			ForEachCell(CenterCell + FIntPoint( Ring, -Ring + 1), CenterCell + FIntPoint( Ring, Ring - 1), AddCell);
+		}
+
+		const double Reach = double(Ring) * CellSize;
+		if (Heap.Num() == Count && Heap.HeapTop().Key <= Reach * Reach)
+		{
+			break;
+		}
+	}
+
+	Heap.Sort([](const TPair<double, int32>& A, const TPair<double, int32>& B) { return A.Key < B.Key; });
+
+	OutIds.Reserve(Heap.Num());
+	for (const TPair<double, int32>& Candidate : Heap)
+	{
+		OutIds.Add(Candidate.Value);
+	}
+}
+
+void FSpaceTradersSpatialGrid::QueryRadiusBatch(TConstArrayView<FVector2D> Centers, const double Radius, TArray<TArray<int32>>& OutIds) const
+{
+	OutIds.SetNum(Centers.Num());
+	ParallelFor(Centers.Num(), [&](const int32 Index)
+	{
+		OutIds[Index].Reset();
+		QueryRadius(Centers[Index], Radius, OutIds[Index]);
+	});
+}
+
+void FSpaceTradersSpatialGrid::QueryNearestBatch(TConstArrayView<FVector2D> Centers, const int32 Count, TArray<TArray<int32>>& OutIds) const
+{
+	OutIds.SetNum(Centers.Num());
+	ParallelFor(Centers.Num(), [&](const int32 Index)
+	{
+		QueryNearest(Centers[Index], Count, OutIds[Index]);
+	});
+}
+
+SIZE_T FSpaceTradersSpatialGrid::GetAllocatedSize() const
+{
+	SIZE_T Size = Cells.GetAllocatedSize() + Locations.GetAllocatedSize() + Present.GetAllocatedSize();
+	for (const TPair<FIntPoint, FCell>& Pair : Cells)
+	{
+		Size += Pair.Value.Ids.GetAllocatedSize() + Pair.Value.Locations.GetAllocatedSize();
+	}
+	return Size;
+}
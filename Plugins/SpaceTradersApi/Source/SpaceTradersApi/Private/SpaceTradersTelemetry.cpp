@@ -0,0 +1,464 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersTelemetry.h"
+#include "SpaceTradersApi.h"
+#include "SpaceTradersApiClient.h"
+#include "SpaceTradersApiSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	/* Names of the path parameters following each collection, as in the API reference. */
+	const TCHAR* FindParameterName(const FStringView Collection)
+	{
+		static const TPair<const TCHAR*, const TCHAR*> Parameters[] =
+		{
+			{ TEXT("systems"),   TEXT("{systemSymbol}")   },
+			{ TEXT("waypoints"), TEXT("{waypointSymbol}") },
+			{ TEXT("ships"),     TEXT("{shipSymbol}")     },
+			{ TEXT("contracts"), TEXT("{contractId}")     },
+			{ TEXT("factions"),  TEXT("{factionSymbol}")  },
+			{ TEXT("agents"),    TEXT("{agentSymbol}")    },
+		};
+
+		for (const TPair<const TCHAR*, const TCHAR*>& Parameter : Parameters)
+		{
+			if (Collection.Equals(Parameter.Key, ESearchCase::IgnoreCase))
+			{
+				return Parameter.Value;
+			}
+		}
+		return nullptr;
+	}
+
+	constexpr double MillisecondsPerMicrosecond = 1. / 1000.;
+}
+
+
+void FSpaceTradersHdrHistogram::Record(const int64 Value, const int64 Count)
+{
+	if (Counts.Num() == 0)
+	{
+		Counts.SetNumZeroed(NumBuckets);
+	}
+
+	const int64 Clamped = FMath::Clamp<int64>(Value, 0, MaxValue);
+	Counts[GetIndex(Clamped)] += static_cast<uint32>(Count);
+	TotalCount += Count;
+	Sum        += Clamped * Count;
+}
+
+void FSpaceTradersHdrHistogram::Add(const FSpaceTradersHdrHistogram& Other)
+{
+	if (Other.TotalCount == 0)
+	{
+		return;
+	}
+
+	if (Counts.Num() == 0)
+	{
+		Counts.SetNumZeroed(NumBuckets);
+	}
+
+	for (int32 Index = 0; Index < NumBuckets; ++Index)
+	{
+		Counts[Index] += Other.Counts[Index];
+	}
+	TotalCount += Other.TotalCount;
+	Sum        += Other.Sum;
+}
+
+void FSpaceTradersHdrHistogram::Subtract(const FSpaceTradersHdrHistogram& Other)
+{
+	if (Other.TotalCount == 0)
+	{
+		return;
+	}
+
+	check(Counts.Num() == NumBuckets);
+	for (int32 Index = 0; Index < NumBuckets; ++Index)
+	{
+		Counts[Index] -= Other.Counts[Index];
+	}
+	TotalCount -= Other.TotalCount;
+	Sum        -= Other.Sum;
+}
+
+void FSpaceTradersHdrHistogram::Reset()
+{
+	// Keeps the counts allocated, slices are reused every window.
+	if (TotalCount > 0)
+	{
+		FMemory::Memzero(Counts.GetData(), Counts.Num() * sizeof(uint32));
+	}
+	TotalCount = 0;
+	Sum        = 0;
+}
+
+/* static */ int32 FSpaceTradersHdrHistogram::GetIndex(const int64 Value)
+{
+	if (Value < SubBucketCount)
+	{
+		return static_cast<int32>(Value);
+	}
+
+	// Values of [2^n, 2^(n+1)) share Shift, and Value >> Shift is in the upper half of the sub-buckets.
+	const int32 Shift = static_cast<int32>(FPlatformMath::FloorLog2_64(static_cast<uint64>(Value))) - (SubBucketBits - 1);
+	return SubBucketHalf * Shift + static_cast<int32>(Value >> Shift);
+}
+
+/* static */ int64 FSpaceTradersHdrHistogram::GetHighestValue(const int32 Index)
+{
+	if (Index < SubBucketCount)
+	{
+		return Index;
+	}
+
+	const int32 Shift = Index / SubBucketHalf - 1;
+	const int64 SubBucket = Index - SubBucketHalf * Shift;
+	return ((SubBucket + 1) << Shift) - 1;
+}
+
+int64 FSpaceTradersHdrHistogram::GetValueAtPercentile(const double Percentile) const
+{
+	if (TotalCount == 0)
+	{
+		return 0;
+	}
+
+	const int64 Target = FMath::Max<int64>(FMath::CeilToInt64(FMath::Clamp(Percentile, 0., 100.) / 100. * TotalCount), 1);
+
+	int64 Cumulated = 0;
+	for (int32 Index = 0; Index < NumBuckets; ++Index)
+	{
+		Cumulated += Counts[Index];
+		if (Cumulated >= Target)
+		{
+			return GetHighestValue(Index);
+		}
+	}
+	return MaxValue;
+}
+
+void USpaceTradersTelemetry::FCounters::Add(const FCounters& Other, const int32 Sign)
+{
+	Requests      += Sign * Other.Requests;
+	Errors        += Sign * Other.Errors;
+	Throttled     += Sign * Other.Throttled;
+	CacheHits     += Sign * Other.CacheHits;
+	BytesIn       += Sign * Other.BytesIn;
+	BytesOut      += Sign * Other.BytesOut;
+	Wrappers      += Sign * Other.Wrappers;
+	ParseTime     += Sign * Other.ParseTime;
+	StringifyTime += Sign * Other.StringifyTime;
+}
+
+/* static */ USpaceTradersTelemetry* USpaceTradersTelemetry::Get(const UObject* const WorldContextObject)
+{
+	const UWorld* const World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	const UGameInstance* const GameInstance = World ? World->GetGameInstance() : nullptr;
+
+	return GameInstance ? GameInstance->GetSubsystem<USpaceTradersTelemetry>() : nullptr;
+}
+
+void USpaceTradersTelemetry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	NumSlices = FMath::Clamp(GetDefault<USpaceTradersApiSettings>()->TelemetryWindow, 1, 3600);
+	Reset();
+
+	// The client has to exist first to measure its requests.
+	if (USpaceTradersApiClient* const Client = Collection.InitializeDependency<USpaceTradersApiClient>())
+	{
+		Client->OnRequestCompleted.AddUObject(this, &ThisClass::OnRequestCompleted);
+	}
+}
+
+void USpaceTradersTelemetry::Reset()
+{
+	Endpoints.Reset();
+	EndpointIndices.Reset();
+
+	FEndpoint& All = Endpoints.AddDefaulted_GetRef();
+	All.Name = TEXT("*");
+	All.Slices.SetNum(NumSlices);
+
+	StartTime = FPlatformTime::Seconds();
+}
+
+/* static */ FString USpaceTradersTelemetry::GetEndpointName(const FSpaceTradersRequest& Request)
+{
+	TStringBuilder<128> Name;
+	Name << Request.Verb << TEXT(' ');
+
+	FStringView Previous;
+	FStringView Path = Request.Path;
+	while (Path.Len() > 0)
+	{
+		Path.RightChopInline(1);
+
+		int32 End = INDEX_NONE;
+		if (!Path.FindChar(TEXT('/'), End))
+		{
+			End = Path.Len();
+		}
+		const FStringView Segment = Path.Left(End);
+		Path.RightChopInline(End);
+
+		const TCHAR* const Parameter = FindParameterName(Previous);
+		Name << TEXT('/') << (Parameter ? FStringView(Parameter) : Segment);
+
+		// A parameter isn't a collection, e.g. a ship named "SYSTEMS".
+		Previous = Parameter ? FStringView() : Segment;
+	}
+
+	return FString(Name.ToView());
+}
+
+int64 USpaceTradersTelemetry::GetCurrentSecond() const
+{
+	return FMath::FloorToInt64(FPlatformTime::Seconds() - StartTime);
+}
+
+void USpaceTradersTelemetry::OnRequestCompleted(const FSpaceTradersRequest& Request, const FSpaceTradersResponse& Response, const FSpaceTradersRequestMetrics& Metrics)
+{
+	FCounters Counters;
+	Counters.Requests      = 1;
+	Counters.Errors        = Response.bSuccess ? 0 : 1;
+	Counters.Throttled     = Response.Error.HttpStatus == EHttpResponseCodes::TooManyRequests ? 1 : 0;
+	Counters.CacheHits     = Metrics.bFromCache ? 1 : 0;
+	Counters.BytesIn       = Metrics.BytesReceived;
+	Counters.BytesOut      = Metrics.BytesSent;
+	Counters.Wrappers      = Metrics.WrappersCreated;
+	Counters.ParseTime     = Metrics.ParseTime;
+	Counters.StringifyTime = Metrics.StringifyTime;
+
+	// Reading the cache isn't a round trip, it would hide the latency of the server.
+	const int64 Latency = Metrics.bFromCache ? -1 : FMath::RoundToInt64(Metrics.Latency * 1000000.);
+
+	const FString Name = GetEndpointName(Request);
+	int32 Index;
+	if (const int32* const Existing = EndpointIndices.Find(Name))
+	{
+		Index = *Existing;
+	}
+	else
+	{
+		Index = Endpoints.AddDefaulted();
+		Endpoints[Index].Name = Name;
+		Endpoints[Index].Slices.SetNum(NumSlices);
+		EndpointIndices.Add(Name, Index);
+	}
+
+	const int64 Second = GetCurrentSecond();
+	Record(Endpoints[0],     Second, Counters, Latency);
+	Record(Endpoints[Index], Second, Counters, Latency);
+}
+
+void USpaceTradersTelemetry::Record(FEndpoint& Endpoint, const int64 Second, const FCounters& Counters, const int64 Latency)
+{
+	Expire(Endpoint, Second);
+
+	FSlice& Slice = Endpoint.Slices[Second % NumSlices];
+	Slice.Second = Second;
+
+	Slice.Counters.Add(Counters, 1);
+	Endpoint.Window.Add(Counters, 1);
+	Endpoint.Total.Add(Counters, 1);
+
+	if (Latency >= 0)
+	{
+		Slice.Latency.Record(Latency);
+		Endpoint.WindowLatency.Record(Latency);
+		Endpoint.TotalLatency.Record(Latency);
+	}
+}
+
+void USpaceTradersTelemetry::Expire(FEndpoint& Endpoint, const int64 Second)
+{
+	for (FSlice& Slice : Endpoint.Slices)
+	{
+		if (Slice.Second != INDEX_NONE && Slice.Second <= Second - NumSlices)
+		{
+			Endpoint.Window.Add(Slice.Counters, -1);
+			Endpoint.WindowLatency.Subtract(Slice.Latency);
+
+			Slice.Second   = INDEX_NONE;
+			Slice.Counters = FCounters();
+			Slice.Latency.Reset();
+		}
+	}
+}
+
+void USpaceTradersTelemetry::ExpireAll()
+{
+	const int64 Second = GetCurrentSecond();
+	for (FEndpoint& Endpoint : Endpoints)
+	{
+		Expire(Endpoint, Second);
+	}
+}
+
+FSpaceTradersEndpointStats USpaceTradersTelemetry::MakeStats(const FEndpoint& Endpoint, const FCounters& Counters, const FSpaceTradersHdrHistogram& Latency, const double Seconds) const
+{
+	FSpaceTradersEndpointStats Stats;
+	Stats.Endpoint          = Endpoint.Name;
+	Stats.Requests          = static_cast<int32>(Counters.Requests);
+	Stats.RequestsPerSecond = static_cast<float>(Counters.Requests / FMath::Max(Seconds, 1.));
+	Stats.Errors            = static_cast<int32>(Counters.Errors);
+	Stats.Throttled         = static_cast<int32>(Counters.Throttled);
+	Stats.CacheHits         = static_cast<int32>(Counters.CacheHits);
+	Stats.LatencyP50        = static_cast<float>(Latency.GetValueAtPercentile(50.) * MillisecondsPerMicrosecond);
+	Stats.LatencyP95        = static_cast<float>(Latency.GetValueAtPercentile(95.) * MillisecondsPerMicrosecond);
+	Stats.LatencyP99        = static_cast<float>(Latency.GetValueAtPercentile(99.) * MillisecondsPerMicrosecond);
+	Stats.LatencyMean       = static_cast<float>(Latency.GetMean() * MillisecondsPerMicrosecond);
+	Stats.BytesIn           = Counters.BytesIn;
+	Stats.BytesOut          = Counters.BytesOut;
+	Stats.ParseTime         = static_cast<float>(Counters.ParseTime * 1000.);
+	Stats.StringifyTime     = static_cast<float>(Counters.StringifyTime * 1000.);
+	Stats.WrappersCreated   = static_cast<int32>(Counters.Wrappers);
+	return Stats;
+}
+
+TArray<FSpaceTradersEndpointStats> USpaceTradersTelemetry::GetEndpointStats()
+{
+	ExpireAll();
+
+	// The window isn't full until NumSlices seconds after the start.
+	const double Seconds = FMath::Min<double>(NumSlices, FPlatformTime::Seconds() - StartTime);
+
+	TArray<FSpaceTradersEndpointStats> Stats;
+	for (int32 Index = 1; Index < Endpoints.Num(); ++Index)
+	{
+		const FEndpoint& Endpoint = Endpoints[Index];
+		if (Endpoint.Window.Requests > 0)
+		{
+			Stats.Add(MakeStats(Endpoint, Endpoint.Window, Endpoint.WindowLatency, Seconds));
+		}
+	}
+
+	Stats.Sort([](const FSpaceTradersEndpointStats& A, const FSpaceTradersEndpointStats& B) { return A.Requests > B.Requests; });
+	return Stats;
+}
+
+FSpaceTradersEndpointStats USpaceTradersTelemetry::GetTotalStats()
+{
+	FEndpoint& All = Endpoints[0];
+	Expire(All, GetCurrentSecond());
+
+	return MakeStats(All, All.Window, All.WindowLatency, FMath::Min<double>(NumSlices, FPlatformTime::Seconds() - StartTime));
+}
+
+TArray<int32> USpaceTradersTelemetry::GetRequestHistory(const FString& Endpoint)
+{
+	TArray<int32> History;
+	History.SetNumZeroed(NumSlices);
+
+	const int32* const Index = Endpoint.IsEmpty() ? nullptr : EndpointIndices.Find(Endpoint);
+	if (!Endpoint.IsEmpty() && !Index)
+	{
+		return History;
+	}
+
+	const int64 Second = GetCurrentSecond();
+	for (const FSlice& Slice : Endpoints[Index ? *Index : 0].Slices)
+	{
+		const int64 Age = Second - Slice.Second;
+		if (Slice.Second != INDEX_NONE && Age >= 0 && Age < NumSlices)
+		{
+			History[NumSlices - 1 - Age] = static_cast<int32>(Slice.Counters.Requests);
+		}
+	}
+	return History;
+}
+
+bool USpaceTradersTelemetry::ExportCsv(const FString& FilePath)
+{
+	ExpireAll();
+
+	const FString Path = !FilePath.IsEmpty() ? FilePath
+		: FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SpaceTraders"), FString::Printf(TEXT("Telemetry-%s.csv"), *FDateTime::Now().ToString()));
+
+	TStringBuilder<4096> Csv;
+	Csv << TEXT("Second,Endpoint,Requests,Errors,Throttled,CacheHits,LatencyP50Ms,LatencyP95Ms,LatencyP99Ms,LatencyMeanMs,BytesIn,BytesOut,ParseMs,StringifyMs,Wrappers\n");
+
+	const auto AddRow = [&Csv](const FString& Second, const FSpaceTradersEndpointStats& Stats)
+	{
+		// Quoted, paths may contain commas.
+		Csv.Appendf(TEXT("%s,\"%s\",%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%lld,%lld,%.3f,%.3f,%d\n"),
+			*Second, *Stats.Endpoint, Stats.Requests, Stats.Errors, Stats.Throttled, Stats.CacheHits,
+			Stats.LatencyP50, Stats.LatencyP95, Stats.LatencyP99, Stats.LatencyMean,
+			Stats.BytesIn, Stats.BytesOut, Stats.ParseTime, Stats.StringifyTime, Stats.WrappersCreated);
+	};
+
+	for (const FEndpoint& Endpoint : Endpoints)
+	{
+		TArray<const FSlice*> Slices;
+		for (const FSlice& Slice : Endpoint.Slices)
+		{
+			if (Slice.Second != INDEX_NONE)
+			{
+				Slices.Add(&Slice);
+			}
+		}
+		Slices.Sort([](const FSlice& A, const FSlice& B) { return A.Second < B.Second; });
+
+		for (const FSlice* const Slice : Slices)
+		{
+			AddRow(LexToString(Slice->Second), MakeStats(Endpoint, Slice->Counters, Slice->Latency, 1.));
+		}
+	}
+
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+	for (const FEndpoint& Endpoint : Endpoints)
+	{
+		AddRow(TEXT("Total"), MakeStats(Endpoint, Endpoint.Total, Endpoint.TotalLatency, Elapsed));
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv.ToView(), *Path))
+	{
+		UE_LOG(LogSpaceTradersApi, Warning, TEXT("Failed to write the telemetry to %s."), *Path);
+		return false;
+	}
+
+	UE_LOG(LogSpaceTradersApi, Log, TEXT("Telemetry written to %s."), *Path);
+	return true;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdTelemetry(
+	TEXT("SpaceTraders.Telemetry"),
+	TEXT("Logs the stats of each endpoint over the telemetry window, or writes every stat to a CSV file.\n")
+	TEXT("Usage: SpaceTraders.Telemetry [csv [FilePath]]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		USpaceTradersTelemetry* const Telemetry = USpaceTradersTelemetry::Get(World);
+		if (!Telemetry)
+		{
+			return;
+		}
+
+		if (Args.Num() > 0 && Args[0] == TEXT("csv"))
+		{
+			Telemetry->ExportCsv(Args.Num() > 1 ? Args[1] : FString());
+			return;
+		}
+
+		TArray<FSpaceTradersEndpointStats> Stats = Telemetry->GetEndpointStats();
+		Stats.Insert(Telemetry->GetTotalStats(), 0);
+
+		UE_LOG(LogSpaceTradersApi, Display, TEXT("Requests of the last %ds:"), Telemetry->GetWindow());
+		for (const FSpaceTradersEndpointStats& Endpoint : Stats)
+		{
+			UE_LOG(LogSpaceTradersApi, Display, TEXT("  %-56s %6d req %6.2f/s  p50 %7.1fms  p95 %7.1fms  p99 %7.1fms  in %8lld B  out %6lld B  parse %6.1fms  stringify %5.1fms  %6d wrappers  %4d err  %4d 429  %4d cached"),
+				*Endpoint.Endpoint, Endpoint.Requests, Endpoint.RequestsPerSecond, Endpoint.LatencyP50, Endpoint.LatencyP95, Endpoint.LatencyP99,
+				Endpoint.BytesIn, Endpoint.BytesOut, Endpoint.ParseTime, Endpoint.StringifyTime, Endpoint.WrappersCreated,
+				Endpoint.Errors, Endpoint.Throttled, Endpoint.CacheHits);
+		}
+	}));
@@ -0,0 +1,428 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SpaceTradersTradeOptimizer.h"
+#include "SpaceTradersGalaxyStore.h"
+#include "SpaceTradersMarketStore.h"
+#include "SpaceTradersRoutePlanner.h"
+#include "Dom/JsonValue.h"
+#include "Dom/JsonObject.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	bool IsSameShip(const FSpaceTradersTradeShip& A, const FSpaceTradersTradeShip& B)
+	{
+		return A.Symbol        == B.Symbol
+			&& A.Waypoint      == B.Waypoint
+			&& A.CargoCapacity == B.CargoCapacity
+			&& A.Speed         == B.Speed
+			&& A.FuelCapacity  == B.FuelCapacity
+			&& A.FuelPrice     == B.FuelPrice
+			&& A.MaxDistance   == B.MaxDistance;
+	}
+
+	/* A scored candidate, turned into a FSpaceTradersTradeRoute only if it makes the top. */
+	struct FScoredCandidate
+	{
+		double ProfitPerSecond;
+		double Duration;
+		int32  Candidate;
+		int32  Profit;
+		int32  Units;
+		int32  FuelCost;
+	};
+
+	struct FLowestScoreFirst
+	{
+		FORCEINLINE bool operator()(const FScoredCandidate& A, const FScoredCandidate& B) const
+		{
+			return A.ProfitPerSecond < B.ProfitPerSecond;
+		}
+	};
+}
+
+
+TSharedRef<FJsonObject> FSpaceTradersTradeRoute::ToJson() const
+{
+	const TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+	Object->SetStringField(TEXT("good"),            Good);
+	Object->SetStringField(TEXT("buyWaypoint"),     BuyWaypoint);
+	Object->SetStringField(TEXT("sellWaypoint"),    SellWaypoint);
+	Object->SetNumberField(TEXT("purchasePrice"),   PurchasePrice);
+	Object->SetNumberField(TEXT("sellPrice"),       SellPrice);
+	Object->SetNumberField(TEXT("units"),           Units);
+	Object->SetNumberField(TEXT("fuelCost"),        FuelCost);
+	Object->SetNumberField(TEXT("duration"),        Duration);
+	Object->SetNumberField(TEXT("profit"),          Profit);
+	Object->SetNumberField(TEXT("profitPerSecond"), ProfitPerSecond);
+	return Object;
+}
+
+FSpaceTradersTradeOptimizer::FSpaceTradersTradeOptimizer(const FSpaceTradersMarketStore& InMarkets, const FSpaceTradersGalaxyStore& InGalaxy)
+	: Markets(InMarkets)
+	, Galaxy (InGalaxy)
+{
+}
+
+void FSpaceTradersTradeOptimizer::Invalidate(TConstArrayView<int32> Series)
+{
+	for (const int32 Index : Series)
+	{
+		const FString& Good = Markets.GetSeriesGood(Index);
+
+		int32* GoodIndex = GoodIndices.Find(Good);
+		if (!GoodIndex)
+		{
+			GoodIndex = &GoodIndices.Add(Good, Goods.Add(nullptr));
+			DirtyGoods.Add(true);
+		}
+
+		DirtyGoods[*GoodIndex] = true;
+	}
+}
+
+void FSpaceTradersTradeOptimizer::InvalidateAll()
+{
+	TArray<int32> Series;
+	Series.SetNumUninitialized(Markets.NumSeries());
+	for (int32 i = 0; i < Series.Num(); ++i)
+	{
+		Series[i] = i;
+	}
+
+	Invalidate(Series);
+}
+
+void FSpaceTradersTradeOptimizer::Reset()
+{
+	// Versions keep increasing so routes of a job started before can't be taken for new ones.
+	GoodIndices.Reset();
+	Goods.Reset();
+	DirtyGoods.Reset();
+	ShipCaches.Reset();
+}
+
+int32 FSpaceTradersTradeOptimizer::NumCandidates() const
+{
+	int32 Num = 0;
+	for (const FGoodPtr& Good : Goods)
+	{
+		Num += Good ? Good->Candidates.Num() : 0;
+	}
+	return Num;
+}
+
+bool FSpaceTradersTradeOptimizer::FindPlace(const FString& Waypoint, FPlace& OutPlace) const
+{
+	const int32 Index = Galaxy.FindWaypoint(Waypoint);
+	if (Index == INDEX_NONE || !Galaxy.IsSystemPlaced(Galaxy.GetWaypointSystems()[Index]))
+	{
+		return false;
+	}
+
+	OutPlace.System         = Galaxy.GetWaypointSystems()[Index];
+	OutPlace.SystemLocation = FVector2D(Galaxy.GetSystemX()[OutPlace.System], Galaxy.GetSystemY()[OutPlace.System]);
+	OutPlace.Location       = FVector2D(Galaxy.GetWaypointX()[Index], Galaxy.GetWaypointY()[Index]);
+	return true;
+}
+
+/* static */ double FSpaceTradersTradeOptimizer::GetDistance(const FPlace& From, const FPlace& To)
+{
+	// Waypoint coordinates are relative to their system.
+	return From.System == To.System ? FVector2D::Distance(From.Location, To.Location) : FVector2D::Distance(From.SystemLocation, To.SystemLocation);
+}
+
+TSharedRef<FSpaceTradersTradeOptimizer::FGood> FSpaceTradersTradeOptimizer::BuildGood(const FString& GoodSymbol, const uint32 Version) const
+{
+	const TSharedRef<FGood> Good = MakeShared<FGood>();
+	Good->Good    = GoodSymbol;
+	Good->Version = Version;
+
+	const TConstArrayView<int32> Series = Markets.GetGoodSeries(GoodSymbol);
+	Good->Markets.Reserve(Series.Num());
+
+	for (const int32 Index : Series)
+	{
+		FMarket Market;
+		if (!FindPlace(Markets.GetSeriesWaypoint(Index), Market.Place))
+		{
+			// Can't estimate travel to markets whose waypoint or system isn't placed in the galaxy.
+			continue;
+		}
+
+		const FSpaceTradersMarketSample& Latest = Markets.GetLatest(Index);
+		Market.Waypoint      = Markets.GetSeriesWaypoint(Index);
+		Market.PurchasePrice = Latest.PurchasePrice;
+		Market.SellPrice     = Latest.SellPrice;
+		Market.TradeVolume   = Latest.TradeVolume;
+		Good->Markets.Add(MoveTemp(Market));
+	}
+
+	for (int32 Buy = 0; Buy < Good->Markets.Num(); ++Buy)
+	{
+		for (int32 Sell = 0; Sell < Good->Markets.Num(); ++Sell)
+		{
+			const int32 Margin = Good->Markets[Sell].SellPrice - Good->Markets[Buy].PurchasePrice;
+			if (Buy != Sell && Margin > 0)
+			{
+				Good->Candidates.Add(FCandidate{ Buy, Sell, Margin, static_cast<float>(GetDistance(Good->Markets[Buy].Place, Good->Markets[Sell].Place)) });
+			}
+		}
+	}
+
+	return Good;
+}
+
+TSharedRef<FSpaceTradersTradeOptimizer::FJob> FSpaceTradersTradeOptimizer::PrepareJob(TArray<FSpaceTradersTradeShip>&& Ships, const int32 Count)
+{
+	// Rebuilds the goods whose markets changed since the last query.
+	TArray<int32> Dirty;
+	for (TConstSetBitIterator<> It(DirtyGoods); It; ++It)
+	{
+		Dirty.Add(It.GetIndex());
+	}
+
+	if (Dirty.Num() > 0)
+	{
+		TArray<FString> Symbols;
+		Symbols.SetNum(Goods.Num());
+		for (const TPair<FString, int32>& Pair : GoodIndices)
+		{
+			Symbols[Pair.Value] = Pair.Key;
+		}
+
+		const uint32 FirstVersion = NextVersion;
+		NextVersion += Dirty.Num();
+
+		ParallelFor(Dirty.Num(), [&](const int32 i)
+		{
+			Goods[Dirty[i]] = BuildGood(Symbols[Dirty[i]], FirstVersion + i);
+		});
+
+		DirtyGoods.SetRange(0, DirtyGoods.Num(), false);
+	}
+
+	const TSharedRef<FJob> Job = MakeShared<FJob>();
+	Job->Ships = MoveTemp(Ships);
+	Job->Goods = Goods;
+	Job->Count = FMath::Max(Count, 1);
+
+	Job->ShipPlaces.SetNum(Job->Ships.Num());
+	Job->Caches    .SetNum(Job->Ships.Num());
+
+	for (int32 i = 0; i < Job->Ships.Num(); ++i)
+	{
+		const FSpaceTradersTradeShip& Ship = Job->Ships[i];
+		FindPlace(Ship.Waypoint, Job->ShipPlaces[i]);
+
+		FShipCache& Cache = Job->Caches[i];
+
+		const FShipCache* const Cached = Ship.Symbol.IsEmpty() ? nullptr : ShipCaches.Find(Ship.Symbol);
+		if (Cached && Cached->Count == Job->Count && IsSameShip(Cached->Ship, Ship))
+		{
+			Cache = *Cached;
+		}
+
+		Cache.Ship  = Ship;
+		Cache.Count = Job->Count;
+		Cache.Versions.SetNumZeroed(Job->Goods.Num());
+		Cache.Routes  .SetNum(Job->Goods.Num());
+	}
+
+	return Job;
+}
+
+/* static */ void FSpaceTradersTradeOptimizer::RunJob(FJob& Job)
+{
+	const int32 NumGoods = Job.Goods.Num();
+
+	ParallelFor(Job.Ships.Num() * NumGoods, [&Job, NumGoods](const int32 Index)
+	{
+		const int32 ShipIndex = Index / NumGoods;
+		const int32 GoodIndex = Index % NumGoods;
+
+		const FGood& Good = *Job.Goods[GoodIndex];
+		FShipCache& Cache = Job.Caches[ShipIndex];
+
+		if (Cache.Versions[GoodIndex] != Good.Version)
+		{
+			ScoreGood(Good, Job.Ships[ShipIndex], Job.ShipPlaces[ShipIndex], Job.Count, Cache.Routes[GoodIndex]);
+			Cache.Versions[GoodIndex] = Good.Version;
+		}
+	});
+}
+
+/* static */ void FSpaceTradersTradeOptimizer::ScoreGood(const FGood& Good, const FSpaceTradersTradeShip& Ship, const FPlace& ShipPlace, const int32 Count, TArray<FSpaceTradersTradeRoute>& OutRoutes)
+{
+	OutRoutes.Reset();
+
+	const TArray<FMarket>& GoodMarkets = Good.Markets;
+	const bool bUsesFuel = Ship.FuelCapacity > 0;
+
+	// The first leg only depends on the buying market.
+	TArray<double> TimeToMarket;
+	TArray<int32>  FuelToMarket;
+	TimeToMarket.SetNumUninitialized(GoodMarkets.Num());
+	FuelToMarket.SetNumUninitialized(GoodMarkets.Num());
+
+	for (int32 i = 0; i < GoodMarkets.Num(); ++i)
+	{
+		// Ships at a waypoint the galaxy doesn't know are scored from the buying market.
+		const bool bThere = ShipPlace.System == INDEX_NONE || GoodMarkets[i].Waypoint == Ship.Waypoint;
+		const double Distance = bThere ? 0. : GetDistance(ShipPlace, GoodMarkets[i].Place);
+
+		TimeToMarket[i] = bThere ? 0. : FSpaceTradersRoutePlanner::GetTravelTime(Distance, ESpaceTradersFlightMode::Cruise, Ship.Speed);
+		FuelToMarket[i] = bThere || !bUsesFuel ? 0 : FSpaceTradersRoutePlanner::GetFuelCost(Distance, ESpaceTradersFlightMode::Cruise);
+	}
+
+	TArray<FScoredCandidate> Best;
+	Best.Reserve(Count + 1);
+
+	for (int32 CandidateIndex = 0; CandidateIndex < Good.Candidates.Num(); ++CandidateIndex)
+	{
+		const FCandidate& Candidate = Good.Candidates[CandidateIndex];
+		if (Ship.MaxDistance > 0.f && Candidate.Distance > Ship.MaxDistance)
+		{
+			continue;
+		}
+
+		const FMarket& Buy  = GoodMarkets[Candidate.Buy];
+		const FMarket& Sell = GoodMarkets[Candidate.Sell];
+
+		const int32 SellFuel = bUsesFuel ? FSpaceTradersRoutePlanner::GetFuelCost(Candidate.Distance, ESpaceTradersFlightMode::Cruise) : 0;
+		if (bUsesFuel && (FuelToMarket[Candidate.Buy] > Ship.FuelCapacity || SellFuel > Ship.FuelCapacity))
+		{
+			continue;
+		}
+
+		// Prices move past the trade volume, so more than that isn't worth counting on.
+		int32 Units = FMath::Max(Ship.CargoCapacity, 0);
+		if (Buy.TradeVolume > 0)
+		{
+			Units = FMath::Min(Units, Buy.TradeVolume);
+		}
+		if (Sell.TradeVolume > 0)
+		{
+			Units = FMath::Min(Units, Sell.TradeVolume);
+		}
+
+		const int32  FuelCost = FuelToMarket[Candidate.Buy] + SellFuel;
+		const int32  Profit   = Units * Candidate.Margin - FMath::RoundToInt32(FuelCost * Ship.FuelPrice);
+		const double Duration = TimeToMarket[Candidate.Buy] + FSpaceTradersRoutePlanner::GetTravelTime(Candidate.Distance, ESpaceTradersFlightMode::Cruise, Ship.Speed);
+
+		if (Profit <= 0)
+		{
+			continue;
+		}
+
+		const double ProfitPerSecond = Profit / FMath::Max(Duration, 1.);
+		if (Best.Num() == Count && ProfitPerSecond <= Best.HeapTop().ProfitPerSecond)
+		{
+			continue;
+		}
+
+		Best.HeapPush(FScoredCandidate{ ProfitPerSecond, Duration, CandidateIndex, Profit, Units, FuelCost }, FLowestScoreFirst());
+		if (Best.Num() > Count)
+		{
+			Best.HeapPopDiscard(FLowestScoreFirst(), EAllowShrinking::No);
+		}
+	}
+
+	OutRoutes.Reserve(Best.Num());
+	for (const FScoredCandidate& Scored : Best)
+	{
+		const FCandidate& Candidate = Good.Candidates[Scored.Candidate];
+
+		FSpaceTradersTradeRoute& Route = OutRoutes.AddDefaulted_GetRef();
+		Route.Good            = Good.Good;
+		Route.BuyWaypoint     = GoodMarkets[Candidate.Buy].Waypoint;
+		Route.SellWaypoint    = GoodMarkets[Candidate.Sell].Waypoint;
+		Route.PurchasePrice   = GoodMarkets[Candidate.Buy].PurchasePrice;
+		Route.SellPrice       = GoodMarkets[Candidate.Sell].SellPrice;
+		Route.Units           = Scored.Units;
+		Route.FuelCost        = Scored.FuelCost;
+		Route.Duration        = Scored.Duration;
+		Route.Profit          = Scored.Profit;
+		Route.ProfitPerSecond = Scored.ProfitPerSecond;
+	}
+}
+
+void FSpaceTradersTradeOptimizer::FinishJob(FJob& Job, TArray<TArray<FSpaceTradersTradeRoute>>& OutRoutes)
+{
+	OutRoutes.SetNum(Job.Ships.Num());
+
+	for (int32 i = 0; i < Job.Ships.Num(); ++i)
+	{
+		FShipCache& Cache = Job.Caches[i];
+
+		TArray<FSpaceTradersTradeRoute>& Routes = OutRoutes[i];
+		Routes.Reset();
+		for (const TArray<FSpaceTradersTradeRoute>& GoodRoutes : Cache.Routes)
+		{
+			Routes.Append(GoodRoutes);
+		}
+
+		Routes.Sort([](const FSpaceTradersTradeRoute& A, const FSpaceTradersTradeRoute& B)
+		{
+			return A.ProfitPerSecond > B.ProfitPerSecond;
+		});
+
+		if (Routes.Num() > Job.Count)
+		{
+			Routes.SetNum(Job.Count);
+		}
+
+		if (!Job.Ships[i].Symbol.IsEmpty())
+		{
+			ShipCaches.Add(Job.Ships[i].Symbol, MoveTemp(Cache));
+		}
+	}
+}
+
+void FSpaceTradersTradeOptimizer::FindRoutes(TConstArrayView<FSpaceTradersTradeShip> Ships, const int32 Count, TArray<TArray<FSpaceTradersTradeRoute>>& OutRoutes)
+{
+	const TSharedRef<FJob> Job = PrepareJob(TArray<FSpaceTradersTradeShip>(Ships), Count);
+	RunJob(*Job);
+	FinishJob(*Job, OutRoutes);
+}
+
+void FSpaceTradersTradeOptimizer::FindRoutesAsync(TArray<FSpaceTradersTradeShip> Ships, const int32 Count, TUniqueFunction<void(TArray<TArray<FSpaceTradersTradeRoute>>&&)>&& OnFound)
+{
+	const TSharedRef<FJob> Job = PrepareJob(MoveTemp(Ships), Count);
+	TWeakPtr<FSpaceTradersTradeOptimizer, ESPMode::ThreadSafe> WeakThis = AsShared();
+
+	Async(EAsyncExecution::ThreadPool, [Job, WeakThis, OnFound = MoveTemp(OnFound)]() mutable -> void
+	{
+		RunJob(*Job);
+
+		AsyncTask(ENamedThreads::GameThread, [Job, WeakThis, OnFound = MoveTemp(OnFound)]() mutable -> void
+		{
+			if (const TSharedPtr<FSpaceTradersTradeOptimizer, ESPMode::ThreadSafe> This = WeakThis.Pin())
+			{
+				TArray<TArray<FSpaceTradersTradeRoute>> Routes;
+				This->FinishJob(*Job, Routes);
+				OnFound(MoveTemp(Routes));
+			}
+		});
+	});
+}
+
+/* static */ TSharedRef<FJsonObject> FSpaceTradersTradeOptimizer::RoutesToJson(TConstArrayView<FSpaceTradersTradeShip> Ships, TConstArrayView<TArray<FSpaceTradersTradeRoute>> Routes)
+{
+	const TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+
+	for (int32 i = 0; i < Ships.Num() && i < Routes.Num(); ++i)
+	{
+		TArray<TSharedPtr<FJsonValue>> Values;
+		Values.Reserve(Routes[i].Num());
+		for (const FSpaceTradersTradeRoute& Route : Routes[i])
+		{
+			Values.Add(MakeShared<FJsonValueObject>(Route.ToJson()));
+		}
+
+		Object->SetArrayField(Ships[i].Symbol.IsEmpty() ? FString::FromInt(i) : Ships[i].Symbol, MoveTemp(Values));
+	}
+
+	return Object;
+}
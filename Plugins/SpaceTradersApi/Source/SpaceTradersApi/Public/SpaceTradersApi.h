@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+#include "HAL/LowLevelMemTracker.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogSpaceTradersApi, Log, All);
+
+/* LLM tag of the requests and responses of the API client, under the BlueprintJson tag. */
+LLM_DECLARE_TAG(BlueprintJson_SpaceTraders);
+
+class FSpaceTradersApiModule : public IModuleInterface
+{
+public:
+
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+};
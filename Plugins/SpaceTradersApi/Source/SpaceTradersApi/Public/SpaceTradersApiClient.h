@@ -0,0 +1,277 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Containers/Deque.h"
+#include "Containers/Ticker.h"
+#include "SpaceTradersRateLimiter.h"
+#include "SpaceTradersResponseCache.h"
+#include "SpaceTradersApiClient.generated.h"
+
+class FJsonValue;
+class FJsonObject;
+class USpaceTradersCrawler;
+
+/* Error returned by the API, or by the transport when there is no API response. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersError
+{
+    GENERATED_BODY()
+public:
+    /* HTTP status of the response, 0 if the request didn't reach the server. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders")
+    int32 HttpStatus = 0;
+
+    /* SpaceTraders error code, e.g. 4214 when a ship is in transit. 0 if the API didn't return one. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders")
+    int32 Code = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders")
+    FString Message;
+};
+
+/* Order in which queued requests are sent when the rate limit is reached. */
+UENUM(BlueprintType)
+enum class ESpaceTradersPriority : uint8
+{
+    /* Actions the player is waiting for. */
+    Player,
+    /* Automated fleet actions. */
+    Fleet,
+    /* Background data collection, e.g. crawling the galaxy. */
+    Background,
+
+    MAX UMETA(Hidden)
+};
+
+/**
+ *  A call to an API endpoint. Path is relative to the base URL, e.g. "/systems/X1-DF55".
+ **/
+struct SPACETRADERSAPI_API FSpaceTradersRequest
+{
+    FString Verb = TEXT("GET");
+    FString Path;
+
+    /* Query parameters, appended URL-encoded. */
+    TArray<TPair<FString, FString>> Query;
+
+    /* Body sent as JSON, POST and PATCH only. */
+    TSharedPtr<FJsonObject> Body;
+
+    /* Sends the agent token in the Authorization header if one is set. */
+    bool bAuthenticated = true;
+
+    ESpaceTradersPriority Priority = ESpaceTradersPriority::Player;
+
+    /* Always asks the server, even if the endpoint is cached. The response still updates the cache. */
+    bool bBypassCache = false;
+
+    /* Returns the full URL of the request. */
+    FString BuildUrl(const FString& BaseUrl) const;
+};
+
+/**
+ *  Decoded response of a request. The JSON is parsed on a worker thread with
+ *  lazy values and flat objects, the response is then delivered on the game thread.
+ **/
+struct SPACETRADERSAPI_API FSpaceTradersResponse
+{
+    /* The "data" field of the response, or the whole document if it has none. */
+    TSharedPtr<FJsonValue> Data;
+
+    /* The "meta" field of paginated responses. */
+    TSharedPtr<FJsonObject> Meta;
+
+    /* Set when the request failed. Error.HttpStatus is always the response status. */
+    FSpaceTradersError Error;
+
+    /* Seconds to wait before retrying, from a 429 response. */
+    double RetryAfter = 0.;
+
+    bool bSuccess = false;
+};
+
+/* Rate limit state reported by the server in the x-ratelimit-* headers of a response. */
+struct SPACETRADERSAPI_API FSpaceTradersRateLimitHeaders
+{
+    double RequestsPerSecond = 0.;
+    int32  BurstRequests     = -1;
+    int32  Remaining         = -1;
+    double ResetIn           = 0.;
+    double RetryAfter        = 0.;
+
+    /* Reads the headers of Response. Fields of missing headers are left untouched. */
+    void Read(const class IHttpResponse& Response);
+};
+
+/* Measurements of a request, for telemetry. Times are in seconds. */
+struct SPACETRADERSAPI_API FSpaceTradersRequestMetrics
+{
+    /* From sending the request to receiving the whole response. 0 for responses read from the cache. */
+    double Latency = 0.;
+
+    /* Time to write the body of the request and to parse the response, or to read it from the cache. */
+    double StringifyTime = 0.;
+    double ParseTime     = 0.;
+
+    int64 BytesSent     = 0;
+    int64 BytesReceived = 0;
+
+    /* UJsonObject and UJsonValue created by the callbacks of the response. */
+    int64 WrappersCreated = 0;
+
+    bool bFromCache = false;
+};
+
+DECLARE_DELEGATE_OneParam(FOnSpaceTradersResponse, const FSpaceTradersResponse&);
+
+/* Called for every response, before its own callback. bFromCache is true if the server wasn't asked. */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnSpaceTradersResponseDelivered, const FSpaceTradersRequest& /* Request */, const FSpaceTradersResponse& /* Response */, const bool /* bFromCache */);
+
+/* Called once per response received, those sent again after a 429 included, after its callbacks. */
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnSpaceTradersRequestCompleted, const FSpaceTradersRequest& /* Request */, const FSpaceTradersResponse& /* Response */, const FSpaceTradersRequestMetrics& /* Metrics */);
+
+/**
+ *  Client of the SpaceTraders API, one per game instance. All requests go through
+ *  the engine's HTTP manager, which keeps connections to the server alive between
+ *  requests, and are decoded outside of the game thread.
+ *
+ *  Requests are queued by priority and only sent when the rate limiter has a token,
+ *  so the server's limit is used fully without being exceeded. Requests rejected
+ *  with 429 anyway pause the queue and are sent again first.
+ **/
+UCLASS()
+class SPACETRADERSAPI_API USpaceTradersApiClient : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+public:
+    /* Returns the client of the game instance of WorldContextObject, or null. */
+    static USpaceTradersApiClient* Get(const UObject* const WorldContextObject);
+
+    /* Sets the token sent with authenticated requests. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders")
+    void SetAgentToken(const FString& Token);
+
+    /* Returns the token sent with authenticated requests. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders")
+    const FString& GetAgentToken() const { return AgentToken; }
+
+    /* Returns the URL requests are sent to. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders")
+    const FString& GetBaseUrl() const { return BaseUrl; }
+
+    /* Queues the request. OnResponse is called on the game thread, unless the client is destroyed first. */
+    void Send(FSpaceTradersRequest&& Request, FOnSpaceTradersResponse&& OnResponse);
+
+    /* Returns the number of requests waiting for a rate limit token. */
+    int32 GetNumQueuedRequests() const;
+
+    /* Returns the number of requests sent since the client was created, retries included. */
+    int64 GetNumSentRequests() const { return NumSentRequests; }
+
+    /* Returns the number of requests the server rejected with 429 Too Many Requests. */
+    int64 GetNumThrottledRequests() const { return NumThrottledRequests; }
+
+    /* Returns the number of responses read from the cache, revalidated ones included. */
+    int64 GetNumCacheHits() const { return NumCacheHits; }
+
+    /* Removes every cached response. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders")
+    void ClearCache();
+
+    /* Keeps a crawler alive until it's released or the client is deinitialized, e.g. the one of SpaceTraders.Crawl. */
+    void RetainCrawler(USpaceTradersCrawler* const Crawler);
+
+    void ReleaseCrawler(USpaceTradersCrawler* const Crawler);
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    /* Lets other systems see the responses of every request, e.g. to keep the markets up to date. */
+    FOnSpaceTradersResponseDelivered OnResponseDelivered;
+
+    /* Lets telemetry measure every exchange with the server and the cache. */
+    FOnSpaceTradersRequestCompleted OnRequestCompleted;
+
+private:
+    struct FQueuedRequest
+    {
+        FSpaceTradersRequest    Request;
+        FOnSpaceTradersResponse OnResponse;
+        int32 Attempts = 0;
+
+        /* NumSentRequests when this request was sent, to know how many were sent after it. */
+        int64 SendIndex = 0;
+
+        /* Set when the response is cached, with its key. */
+        TSharedPtr<FSpaceTradersResponseCache, ESPMode::ThreadSafe> Cache;
+        uint64 CacheKey = 0;
+
+        /* ETag of the expired cached response, sent in If-None-Match. */
+        FString CachedETag;
+
+        /* Set on a worker thread before the response reaches the game thread. */
+        FString ResponseETag;
+        int64   StoredSize   = -1;
+        bool    bRevalidated = false;
+
+        /* Measurements of the last attempt, filled as it goes through the threads. */
+        FSpaceTradersRequestMetrics Metrics;
+        double SentTime = 0.;
+    };
+
+    using FQueuedRequestRef = TSharedRef<FQueuedRequest, ESPMode::ThreadSafe>;
+
+    /* Sends queued requests while the rate limiter has tokens. */
+    bool Pump(float DeltaTime);
+
+    void Dispatch(const FQueuedRequestRef& Queued);
+
+    /* Adds the request to its priority queue. */
+    void Enqueue(const FQueuedRequestRef& Queued, const bool bFirst = false);
+
+    /* Reads the response of Queued from the cache on a worker thread, and sends the request if that fails. */
+    void LoadFromCache(const FQueuedRequestRef& Queued);
+
+    /* Called on the HTTP thread when a request completes. */
+    static void OnRequestComplete(FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bConnectedSuccessfully, TWeakObjectPtr<USpaceTradersApiClient> Self, FQueuedRequestRef Queued);
+
+    /* Delivers a response to the delegates and its callback, then reports its metrics. */
+    void Deliver(const FQueuedRequestRef& Queued, const FSpaceTradersResponse& Response, const bool bFromCache);
+
+    /* Called on the game thread with the decoded response. */
+    void OnResponseReceived(const FHttpRequestPtr& HttpRequest, const FQueuedRequestRef& Queued, const FSpaceTradersRateLimitHeaders& RateLimit, const FSpaceTradersResponse& Response);
+
+    /* Parses the body of a response. Thread safe. */
+    static void DecodeResponse(const int32 HttpStatus, TArray<uint8>&& Body, FSpaceTradersResponse& OutResponse);
+
+    FString BaseUrl;
+    float   RequestTimeout = 0.f;
+    int32   MaxConcurrentRequests = 1;
+    int32   MaxRetries = 0;
+    FString AgentToken;
+
+    TUniquePtr<FSpaceTradersRateLimiter> RateLimiter;
+
+    /* Shared with the worker threads reading and writing responses. Null if caching is disabled. */
+    TSharedPtr<FSpaceTradersResponseCache, ESPMode::ThreadSafe> ResponseCache;
+
+    /* Requests waiting for a token, one queue per priority. */
+    TDeque<FQueuedRequestRef> Queues[static_cast<int32>(ESpaceTradersPriority::MAX)];
+
+    FTSTicker::FDelegateHandle PumpHandle;
+
+    int64 NumSentRequests      = 0;
+    int64 NumThrottledRequests = 0;
+    int64 NumCacheHits         = 0;
+
+    /* Requests sent and not completed yet, cancelled on Deinitialize. Game thread only. */
+    TSet<FHttpRequestPtr> PendingRequests;
+
+    /* Crawlers owned by the client, stopped on Deinitialize. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<USpaceTradersCrawler>> RetainedCrawlers;
+};
@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "SpaceTradersApiClient.h"
+#include "BlueprintJsonWrapper.h"
+#include "SpaceTradersApiNodes.generated.h"
+
+class UJsonObject;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSpaceTradersObjectEvent, UJsonObject*, Data, const FSpaceTradersError&, Error);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FSpaceTradersListEvent, const TArray<UJsonObject*>&, Items, int32, Total, int32, Page, const FSpaceTradersError&, Error);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FSpaceTradersLightEvent, const FLightJsonValue&, Data, const FLightJsonObject&, Meta, const FSpaceTradersError&, Error);
+
+/**
+ *  Base class of the asynchronous API nodes. Sends its request through the
+ *  game instance's USpaceTradersApiClient when activated.
+ **/
+UCLASS(Abstract)
+class SPACETRADERSAPI_API USpaceTradersRequestProxyBase : public UBlueprintAsyncActionBase
+{
+    GENERATED_BODY()
+public:
+    virtual void Activate() override;
+
+protected:
+    /* Creates a proxy of type T sending Request. */
+    template<class T>
+    static T* CreateProxy(UObject* const WorldContextObject, FSpaceTradersRequest&& Request)
+    {
+        T* const Proxy = NewObject<T>();
+        Proxy->Client  = USpaceTradersApiClient::Get(WorldContextObject);
+        Proxy->Request = MoveTemp(Request);
+        Proxy->RegisterWithGameInstance(WorldContextObject);
+        return Proxy;
+    }
+
+    /* Called on the game thread with the decoded response. */
+    virtual void HandleResponse(const FSpaceTradersResponse& Response) PURE_VIRTUAL(USpaceTradersRequestProxyBase::HandleResponse, );
+
+    FSpaceTradersRequest Request;
+
+    TWeakObjectPtr<USpaceTradersApiClient> Client;
+
+private:
+    void OnResponse(const FSpaceTradersResponse& Response);
+};
+
+/**
+ *  Asynchronous node calling an endpoint that returns a single object.
+ **/
+UCLASS()
+class SPACETRADERSAPI_API USpaceTradersObjectRequestProxy final : public USpaceTradersRequestProxyBase
+{
+    GENERATED_BODY()
+public:
+    /* Called with the "data" object of the response. */
+    UPROPERTY(BlueprintAssignable)
+    FSpaceTradersObjectEvent Success;
+
+    /* Called when the request failed. */
+    UPROPERTY(BlueprintAssignable)
+    FSpaceTradersObjectEvent Failed;
+
+    /* Gets the status of the server, its reset date and leaderboards. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Get Server Status"))
+    static USpaceTradersObjectRequestProxy* GetStatus(UObject* WorldContextObject);
+
+    /* Registers a new agent. On success its token is used by every following request. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Register Agent"))
+    static USpaceTradersObjectRequestProxy* RegisterAgent(UObject* WorldContextObject, const FString& Symbol, const FString& Faction, const FString& Email);
+
+    /* Gets the agent of the current token. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Get My Agent"))
+    static USpaceTradersObjectRequestProxy* GetMyAgent(UObject* WorldContextObject);
+
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Get Faction"))
+    static USpaceTradersObjectRequestProxy* GetFaction(UObject* WorldContextObject, const FString& FactionSymbol);
+
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Get System"))
+    static USpaceTradersObjectRequestProxy* GetSystem(UObject* WorldContextObject, const FString& SystemSymbol);
+
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Get Waypoint"))
+    static USpaceTradersObjectRequestProxy* GetWaypoint(UObject* WorldContextObject, const FString& SystemSymbol, const FString& WaypointSymbol);
+
+    /* Gets the market at a waypoint. Prices are only included when one of the agent's ships is there. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Get Market"))
+    static USpaceTradersObjectRequestProxy* GetMarket(UObject* WorldContextObject, const FString& SystemSymbol, const FString& WaypointSymbol);
+
+    /* Gets the gates a jump gate connects to. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Get Jump Gate"))
+    static USpaceTradersObjectRequestProxy* GetJumpGate(UObject* WorldContextObject, const FString& SystemSymbol, const FString& WaypointSymbol);
+
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Get My Ship"))
+    static USpaceTradersObjectRequestProxy* GetMyShip(UObject* WorldContextObject, const FString& ShipSymbol);
+
+protected:
+    virtual void HandleResponse(const FSpaceTradersResponse& Response) override;
+
+private:
+    /* Set by RegisterAgent, the token of the new agent is given to the client. */
+    bool bStoreAgentToken = false;
+};
+
+/**
+ *  Asynchronous node calling a paginated endpoint. Page starts at 1, Limit is at most 20.
+ **/
+UCLASS()
+class SPACETRADERSAPI_API USpaceTradersListRequestProxy final : public USpaceTradersRequestProxyBase
+{
+    GENERATED_BODY()
+public:
+    /* Called with the items of the page and the total number of items. */
+    UPROPERTY(BlueprintAssignable)
+    FSpaceTradersListEvent Success;
+
+    /* Called when the request failed. */
+    UPROPERTY(BlueprintAssignable)
+    FSpaceTradersListEvent Failed;
+
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "List Factions"))
+    static USpaceTradersListRequestProxy* ListFactions(UObject* WorldContextObject, const int32 Page = 1, const int32 Limit = 20);
+
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "List Systems"))
+    static USpaceTradersListRequestProxy* ListSystems(UObject* WorldContextObject, const int32 Page = 1, const int32 Limit = 20);
+
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "List Waypoints"))
+    static USpaceTradersListRequestProxy* ListWaypoints(UObject* WorldContextObject, const FString& SystemSymbol, const int32 Page = 1, const int32 Limit = 20);
+
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "List My Ships"))
+    static USpaceTradersListRequestProxy* ListMyShips(UObject* WorldContextObject, const int32 Page = 1, const int32 Limit = 20);
+
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "List My Contracts"))
+    static USpaceTradersListRequestProxy* ListMyContracts(UObject* WorldContextObject, const int32 Page = 1, const int32 Limit = 20);
+
+protected:
+    virtual void HandleResponse(const FSpaceTradersResponse& Response) override;
+
+private:
+    static USpaceTradersListRequestProxy* CreateListProxy(UObject* const WorldContextObject, FString&& Path, const int32 Page, const int32 Limit);
+};
+
+/**
+ *  Asynchronous node calling any endpoint with a light JSON body and returning the
+ *  response as light JSON, so neither creates JSON UObjects.
+ **/
+UCLASS()
+class SPACETRADERSAPI_API USpaceTradersLightRequestProxy final : public USpaceTradersRequestProxyBase
+{
+    GENERATED_BODY()
+public:
+    /* Called with the "data" field of the response, and its "meta" field if it is paginated. */
+    UPROPERTY(BlueprintAssignable)
+    FSpaceTradersLightEvent Success;
+
+    /* Called when the request failed. */
+    UPROPERTY(BlueprintAssignable)
+    FSpaceTradersLightEvent Failed;
+
+    /**
+     * Calls an endpoint, e.g. Verb POST and Path "/my/ships/{shipSymbol}/orbit". Body is sent if it is valid,
+     * it is copied so it can be modified once the node is called.
+     */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders", meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "Send Request (Light)", AutoCreateRefTerm = "Body"))
+    static USpaceTradersLightRequestProxy* SendLightRequest(UObject* WorldContextObject, const FString& Verb, const FString& Path, const FLightJsonObject& Body, const bool bAuthenticated = true);
+
+protected:
+    virtual void HandleResponse(const FSpaceTradersResponse& Response) override;
+};
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "SpaceTradersApiSettings.generated.h"
+
+/* Time to live of cached responses of the endpoints matching PathPattern. */
+USTRUCT()
+struct SPACETRADERSAPI_API FSpaceTradersCachePolicy
+{
+    GENERATED_BODY()
+public:
+    /* Wildcard pattern matched against the path of GET requests, e.g. "/systems/*". */
+    UPROPERTY(EditAnywhere, Category = "Cache")
+    FString PathPattern;
+
+    /* Seconds a response is used without asking the server. 0 disables caching of these endpoints. */
+    UPROPERTY(EditAnywhere, Category = "Cache", meta = (ClampMin = "0"))
+    float TimeToLive = 0.f;
+};
+
+/**
+ *  Project settings of the SpaceTraders API client, stored in DefaultGame.ini.
+ **/
+UCLASS(Config = Game, DefaultConfig, meta = (DisplayName = "SpaceTraders API"))
+class SPACETRADERSAPI_API USpaceTradersApiSettings : public UDeveloperSettings
+{
+    GENERATED_BODY()
+public:
+    USpaceTradersApiSettings();
+
+    /* URL every endpoint path is appended to. Point it to a local mock server to test without the live API. */
+    UPROPERTY(Config, EditAnywhere, Category = "Connection")
+    FString BaseUrl;
+
+    /* Seconds before a request without response fails. 0 uses the engine's default. */
+    UPROPERTY(Config, EditAnywhere, Category = "Connection", meta = (ClampMin = "0"))
+    float RequestTimeout;
+
+    /* Requests per second allowed by the server. Updated from the x-ratelimit-limit-per-second header. */
+    UPROPERTY(Config, EditAnywhere, Category = "Rate Limit", meta = (ClampMin = "0.1"))
+    float RequestsPerSecond;
+
+    /* Requests allowed above the steady rate over BurstWindow. Updated from the x-ratelimit-limit-burst header. */
+    UPROPERTY(Config, EditAnywhere, Category = "Rate Limit", meta = (ClampMin = "0"))
+    int32 BurstRequests;
+
+    /* Seconds over which burst requests are refilled. */
+    UPROPERTY(Config, EditAnywhere, Category = "Rate Limit", meta = (ClampMin = "1"))
+    float BurstWindow;
+
+    /* Requests waiting for their response at the same time, to keep the number of connections low. */
+    UPROPERTY(Config, EditAnywhere, Category = "Rate Limit", meta = (ClampMin = "1"))
+    int32 MaxConcurrentRequests;
+
+    /* Times a request rejected with 429 Too Many Requests is sent again before failing. */
+    UPROPERTY(Config, EditAnywhere, Category = "Rate Limit", meta = (ClampMin = "0"))
+    int32 MaxRetries;
+
+    /* Stores responses of static endpoints on disk, so they're not requested again in the next sessions. */
+    UPROPERTY(Config, EditAnywhere, Category = "Cache")
+    bool bEnableCache;
+
+    /* Size above which the least recently used responses are removed from the cache, in megabytes. */
+    UPROPERTY(Config, EditAnywhere, Category = "Cache", meta = (ClampMin = "1", EditCondition = "bEnableCache"))
+    int32 MaxCacheSizeMB;
+
+    /**
+     * Cached endpoints. The first pattern matching the path of a request is used, paths matching
+     * none aren't cached. Expired responses are revalidated with their ETag instead of downloaded again.
+     */
+    UPROPERTY(Config, EditAnywhere, Category = "Cache", meta = (EditCondition = "bEnableCache"))
+    TArray<FSpaceTradersCachePolicy> CachePolicies;
+
+    /* Samples of price history kept per trade good and market. Memory doesn't grow past it. */
+    UPROPERTY(Config, EditAnywhere, Category = "Markets", meta = (ClampMin = "1"))
+    int32 MarketHistorySize;
+
+    /* Weight of a new sample in the moving average of market prices, from 0 to 1. */
+    UPROPERTY(Config, EditAnywhere, Category = "Markets", meta = (ClampMin = "0", ClampMax = "1"))
+    float MarketSmoothing;
+
+    /* Seconds of requests summarized by the telemetry, in slices of one second. */
+    UPROPERTY(Config, EditAnywhere, Category = "Telemetry", meta = (ClampMin = "1", ClampMax = "3600"))
+    int32 TelemetryWindow;
+
+    /* Returns the time to live of responses of Path, 0 if they aren't cached. */
+    double GetTimeToLive(const FString& Path) const;
+
+    /**
+     * Returns the base URL without trailing slash. The -SpaceTradersBaseUrl= command line
+     * argument overrides the project setting, e.g. for automated runs against a mock server.
+     */
+    FString GetBaseUrl() const;
+
+    virtual FName GetCategoryName() const override { return TEXT("Plugins"); }
+};
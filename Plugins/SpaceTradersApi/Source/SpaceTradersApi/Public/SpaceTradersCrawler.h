@@ -0,0 +1,150 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "SpaceTradersApiClient.h"
+#include "SpaceTradersCrawler.generated.h"
+
+class UJsonObject;
+class FJsonValue;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSpaceTradersCrawlProgress, int32, PagesDone, int32, TotalPages);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSpaceTradersCrawlCompleted, bool, bSuccess, const FSpaceTradersError&, Error);
+
+/* Called with the items of each page, in the order pages arrive. */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnSpaceTradersCrawlPage, int32 /* Page */, const TArray<TSharedPtr<FJsonValue>>& /* Items */);
+
+/**
+ *  Downloads every page of a paginated endpoint, e.g. /systems, into memory.
+ *
+ *  Pages are requested several at a time with background priority, so the client
+ *  sends them as fast as the rate limit allows while requests of the player go
+ *  first. Pages are parsed on worker threads by the client and their items are
+ *  added to the crawler as they arrive, in any order.
+ *
+ *  Each page received is appended to a checkpoint file in Saved/SpaceTraders/Crawl.
+ *  A crawl of the same endpoint started later, e.g. after the game was closed,
+ *  loads the pages from it and only requests the missing ones. The checkpoint is
+ *  deleted once the crawl completes.
+ *
+ *  Keep a reference to the crawler while it runs, it stops when destroyed.
+ **/
+UCLASS(BlueprintType)
+class SPACETRADERSAPI_API USpaceTradersCrawler final : public UObject
+{
+    GENERATED_BODY()
+public:
+    /* Creates a crawler of every system of the galaxy. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Crawler", meta = (WorldContext = "WorldContextObject"))
+    static USpaceTradersCrawler* CrawlSystems(UObject* WorldContextObject);
+
+    /* Creates a crawler of every waypoint of a system. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Crawler", meta = (WorldContext = "WorldContextObject"))
+    static USpaceTradersCrawler* CrawlWaypoints(UObject* WorldContextObject, const FString& SystemSymbol);
+
+    /* Creates a crawler of a paginated endpoint. Path is relative to the base URL. */
+    static USpaceTradersCrawler* Create(USpaceTradersApiClient* const Client, const FString& Path);
+
+    /* Starts or resumes the crawl. Items already received are kept. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Crawler")
+    void Start();
+
+    /* Stops requesting pages. The checkpoint is kept so the crawl can be resumed. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Crawler")
+    void Stop();
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Crawler")
+    bool IsRunning() const { return bRunning; }
+
+    /* Returns true once every page has been received. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Crawler")
+    bool IsComplete() const;
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Crawler")
+    int32 GetNumPagesDone() const { return NumPagesDone; }
+
+    /* Returns the number of pages of the endpoint, 0 until the first page is received. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Crawler")
+    int32 GetNumPages() const { return FMath::Max(NumPages, 0); }
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Crawler")
+    int32 GetNumItems() const { return Items.Num(); }
+
+    /* Returns the item with the specified symbol, or null if it hasn't been received. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Crawler")
+    UJsonObject* FindItem(const FString& Symbol) const;
+
+    /* Returns the symbols of the items received so far. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Crawler")
+    TArray<FString> GetSymbols() const;
+
+    /* Returns the crawled endpoint, relative to the base URL. */
+    const FString& GetPath() const { return Path; }
+
+    /* Returns the items received so far, by symbol. */
+    const TMap<FString, TSharedPtr<FJsonValue>>& GetItems() const { return Items; }
+
+    /* Number of pages requested at the same time. Higher values only help if the rate limit isn't reached. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Crawler")
+    int32 MaxPagesInFlight = 8;
+
+    /* Called each time a page is received or loaded from the checkpoint. */
+    UPROPERTY(BlueprintAssignable)
+    FSpaceTradersCrawlProgress Progress;
+
+    /* Called once every page has been received, or when a page failed too many times. */
+    UPROPERTY(BlueprintAssignable)
+    FSpaceTradersCrawlCompleted Completed;
+
+    /* Native version of Progress, with the items of the page. */
+    FOnSpaceTradersCrawlPage OnPage;
+
+    virtual void BeginDestroy() override;
+
+private:
+    /* Requests pages until MaxPagesInFlight are pending. */
+    void RequestPages();
+
+    void RequestPage(const int32 Page);
+
+    void OnPageReceived(const int32 Page, const FSpaceTradersResponse& Response);
+
+    /* Adds the items of a page and marks it as done. */
+    void AddPage(const int32 Page, const TSharedPtr<FJsonValue>& Data);
+
+    void Finish(const bool bSuccess, const FSpaceTradersError& Error);
+
+    /* Loads the pages saved by a previous crawl of the same endpoint. */
+    void LoadCheckpoint();
+
+    /* Appends a page to the checkpoint file. */
+    void SaveCheckpoint(const int32 Page, const TSharedPtr<FJsonValue>& Data);
+
+    void CloseCheckpoint();
+
+    TWeakObjectPtr<USpaceTradersApiClient> Client;
+
+    FString Path;
+    FString CheckpointPath;
+
+    TUniquePtr<FArchive> CheckpointWriter;
+
+    /* Total number of pages, -1 until the first page is received. */
+    int32 NumPages     = -1;
+    int32 NumPagesDone = 0;
+
+    /* Pages received, indexed by page - 1. */
+    TBitArray<> DonePages;
+
+    /* Pages requested and not received yet, with their number of failures. */
+    TMap<int32, int32> PendingPages;
+
+    /* Next page to look at when requesting pages. */
+    int32 NextPage = 1;
+
+    bool bRunning = false;
+
+    TMap<FString, TSharedPtr<FJsonValue>> Items;
+};
@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "SpaceTradersGalaxyStore.h"
+#include "SpaceTradersSpatialGrid.h"
+#include "SpaceTradersGalaxyClusters.h"
+#include "SpaceTradersRoutePlanner.h"
+#include "SpaceTradersGalaxy.generated.h"
+
+class UJsonObject;
+class USpaceTradersCrawler;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FSpaceTradersGalaxyUpdated, int32, NumSystems, int32, NumWaypoints);
+
+/* Called with the indices of the systems and waypoints added or updated. */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnSpaceTradersGalaxyUpdated, TConstArrayView<int32> /* Systems */, TConstArrayView<int32> /* Waypoints */);
+
+/* Called with the clusters that changed, per level. */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSpaceTradersClustersUpdated, TConstArrayView<TArray<int32>> /* Clusters */);
+
+/**
+ *  Systems and waypoints known by the game instance, in a FSpaceTradersGalaxyStore.
+ *  Fed by crawlers or by JSON objects from Blueprint, and read by index: look a
+ *  symbol up once, then use the index with the accessors below.
+ **/
+UCLASS()
+class SPACETRADERSAPI_API USpaceTradersGalaxy : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+public:
+    /* Returns the galaxy of the game instance of WorldContextObject, or null. */
+    static USpaceTradersGalaxy* Get(const UObject* const WorldContextObject);
+
+    const FSpaceTradersGalaxyStore& GetStore() const { return Store; }
+
+    /* Returns the spatial index of the systems, by system index. */
+    const FSpaceTradersSpatialGrid& GetSystemGrid() const { return SystemGrid; }
+
+    /* Returns the clusters of systems drawn when zoomed out. */
+    const FSpaceTradersGalaxyClusters& GetClusters() const { return Clusters; }
+
+    /* Adds the systems or waypoints of a crawler, those already received and those to come. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Galaxy")
+    void AddCrawler(USpaceTradersCrawler* Crawler);
+
+    /* Adds or updates systems, as returned by the /systems endpoint. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Galaxy")
+    void AddSystems(const TArray<UJsonObject*>& Systems);
+
+    /* Adds or updates waypoints, as returned by the /systems/{system}/waypoints endpoint. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Galaxy")
+    void AddWaypoints(const TArray<UJsonObject*>& Waypoints);
+
+    /* Sets the connections of jump gates, as returned by the /systems/{system}/waypoints/{waypoint}/jump-gate endpoint. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Galaxy")
+    void AddJumpGates(const TArray<UJsonObject*>& JumpGates);
+
+    /* Native versions of the above. */
+    void AddSystemItems(TConstArrayView<TSharedPtr<FJsonValue>> Items);
+    void AddWaypointItems(TConstArrayView<TSharedPtr<FJsonValue>> Items);
+    void AddJumpGateItems(TConstArrayView<TSharedPtr<FJsonValue>> Items);
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    int32 GetNumSystems() const { return Store.NumSystems(); }
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    int32 GetNumWaypoints() const { return Store.NumWaypoints(); }
+
+    /* Returns the index of a system, or -1 if it isn't known. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    int32 FindSystem(const FString& Symbol) const { return Store.FindSystem(Symbol); }
+
+    /* Returns the index of a waypoint, or -1 if it isn't known. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    int32 FindWaypoint(const FString& Symbol) const { return Store.FindWaypoint(Symbol); }
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    FString GetSystemSymbol(const int32 System) const;
+
+    /* Returns false while a system is only known from its waypoints, its location is then 0. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    bool IsSystemPlaced(const int32 System) const;
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    FIntPoint GetSystemLocation(const int32 System) const;
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    ESpaceTradersSystemType GetSystemType(const int32 System) const;
+
+    /* Returns the indices of the waypoints of a system. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    TArray<int32> GetSystemWaypoints(const int32 System) const;
+
+    /* Returns the location of every system, by index. Faster than one call per system. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    TArray<FIntPoint> GetSystemLocations() const;
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    FString GetWaypointSymbol(const int32 Waypoint) const;
+
+    /* Returns the location of a waypoint, relative to its system. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    FIntPoint GetWaypointLocation(const int32 Waypoint) const;
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    ESpaceTradersWaypointType GetWaypointType(const int32 Waypoint) const;
+
+    /* Returns the index of the system of a waypoint. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    int32 GetWaypointSystem(const int32 Waypoint) const;
+
+    /* Returns true if the waypoint has the trait, e.g. MARKETPLACE. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    bool HasWaypointTrait(const int32 Waypoint, const FString& Trait) const;
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    TArray<FString> GetWaypointTraits(const int32 Waypoint) const;
+
+    /* Returns the systems at most Radius away from Center. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    TArray<int32> FindSystemsInRadius(const FVector2D& Center, const float Radius) const;
+
+    /* Returns the Count systems closest to Center, closest first. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    TArray<int32> FindNearestSystems(const FVector2D& Center, const int32 Count) const;
+
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    TArray<int32> FindSystemsInRectangle(const FVector2D& Min, const FVector2D& Max) const;
+
+    /* Returns the systems inside a convex polygon, e.g. the footprint of the camera on the galaxy plane. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    TArray<int32> FindSystemsInPolygon(const TArray<FVector2D>& Polygon) const;
+
+    /**
+     * Returns the cluster level to draw with the camera Distance world units away from the galaxy plane, or -1 to draw
+     * every system. Detail is the width of the clusters relative to the distance, GalaxyScale the world units per galaxy unit.
+     */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    int32 GetClusterLevel(const float Distance, const float GalaxyScale = 10.f, const float Detail = 0.05f) const;
+
+    /* Returns the clusters of a level overlapping a rectangle, e.g. the footprint of the camera. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    TArray<FSpaceTradersSystemCluster> FindClustersInRectangle(const int32 Level, const FVector2D& Min, const FVector2D& Max) const;
+
+    /* Returns the fastest route between two waypoints within the fuel of the ship. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Galaxy")
+    FSpaceTradersRoute PlanRoute(const FSpaceTradersRouteQuery& Query) const { return RoutePlanner.PlanRoute(Query); }
+
+    /* Plans the routes of several ships in parallel, in the order of the queries. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Galaxy")
+    TArray<FSpaceTradersRoute> PlanRoutes(const TArray<FSpaceTradersRouteQuery>& Queries) const;
+
+    /* Returns a route as a JSON object. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    static UJsonObject* RouteToJson(const FSpaceTradersRoute& Route);
+
+    const FSpaceTradersRoutePlanner& GetRoutePlanner() const { return RoutePlanner; }
+
+    /* Returns the memory used by the galaxy, in bytes. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    int64 GetAllocatedSize() const { return Store.GetAllocatedSize() + SystemGrid.GetAllocatedSize() + Clusters.GetAllocatedSize(); }
+
+    /* Removes every system and waypoint. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Galaxy")
+    void Reset();
+
+    /* Called after systems or waypoints are added or updated. */
+    UPROPERTY(BlueprintAssignable)
+    FSpaceTradersGalaxyUpdated Updated;
+
+    /* Native version of Updated, with the indices that changed. Systems are only passed once placed. */
+    FOnSpaceTradersGalaxyUpdated OnUpdated;
+
+    /* Called after systems are added or updated, before OnUpdated. */
+    FOnSpaceTradersClustersUpdated OnClustersUpdated;
+
+    /* Called after Reset(), indices of the previous systems and waypoints are invalid. */
+    FSimpleMulticastDelegate OnReset;
+
+private:
+    void OnCrawlerPage(int32 Page, const TArray<TSharedPtr<FJsonValue>>& Items, const bool bWaypoints);
+
+    /* Updates the indices and calls the delegates. Systems that aren't placed yet are skipped. */
+    void Broadcast(const TArray<int32>& AddedSystems, const TArray<int32>& Waypoints);
+
+    FSpaceTradersGalaxyStore Store;
+
+    /* Cells of about the distance between neighbouring systems. */
+    FSpaceTradersSpatialGrid SystemGrid = FSpaceTradersSpatialGrid(1000);
+
+    /* Level 0 matches the grid, level 7 splits the galaxy in a handful of cells. */
+    FSpaceTradersGalaxyClusters Clusters = FSpaceTradersGalaxyClusters(1000, 8);
+
+    /* Reads Store, so it's declared after it. */
+    FSpaceTradersRoutePlanner RoutePlanner{ Store };
+};
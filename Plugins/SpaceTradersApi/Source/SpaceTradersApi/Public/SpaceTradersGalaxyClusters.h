@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpaceTradersGalaxyStore.h"
+#include "SpaceTradersGalaxyClusters.generated.h"
+
+/* Systems of a cell of the galaxy, drawn as one when zoomed out. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersSystemCluster
+{
+    GENERATED_BODY()
+public:
+    /* Average location of the systems. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Galaxy")
+    FVector2D Location = FVector2D::ZeroVector;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Galaxy")
+    int32 NumSystems = 0;
+
+    /* Most common type among the systems. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Galaxy")
+    ESpaceTradersSystemType DominantType = ESpaceTradersSystemType::Unknown;
+};
+
+/**
+ *  Quadtree pyramid of clusters over the systems of a galaxy store. Level 0
+ *  splits the galaxy in cells of CellSize, each level above in cells twice as
+ *  large, and every occupied cell of every level keeps the count, summed
+ *  location and type histogram of its systems.
+ *
+ *  Updating a system touches one cluster per level, so a page of systems costs
+ *  the same whatever the size of the galaxy, and a zoomed out view draws the
+ *  clusters of a coarse level instead of every system.
+ *
+ *  Clusters keep their index once created, even when they become empty, so a
+ *  view can map them to instances one to one.
+ **/
+class SPACETRADERSAPI_API FSpaceTradersGalaxyClusters
+{
+public:
+    explicit FSpaceTradersGalaxyClusters(const int32 InCellSize = 1000, const int32 InNumLevels = 8);
+
+    /**
+     * Adds systems, or moves them if their location or type changed in the store.
+     * Appends the clusters that changed, per level, to OutChanged if not null.
+     */
+    void Update(const FSpaceTradersGalaxyStore& Store, TConstArrayView<int32> Systems, TArray<TArray<int32>>* OutChanged = nullptr);
+
+    void Reset();
+
+    int32 NumLevels() const { return Levels.Num(); }
+
+    /* Returns the size of the cells of a level, in galaxy units. */
+    int64 GetCellSize(const int32 Level) const { return int64(CellSize) << Level; }
+
+    /**
+     * Returns the coarsest level whose cells are at most Detail times the distance of the camera wide,
+     * or INDEX_NONE if even the cells of level 0 are wider and systems should be drawn one by one.
+     * Distance is in world units, GalaxyScale the world units per galaxy unit.
+     */
+    int32 GetLevelForDistance(const double Distance, const double GalaxyScale, const double Detail) const;
+
+    /* Returns the number of clusters of a level, empty ones included. */
+    int32 NumClusters(const int32 Level) const { return Levels[Level].Counts.Num(); }
+
+    /* Returns a cluster, with no systems if it became empty. */
+    FSpaceTradersSystemCluster GetCluster(const int32 Level, const int32 Cluster) const;
+
+    /* Returns the cluster of a system at a level, or INDEX_NONE if the system wasn't added. */
+    int32 GetSystemCluster(const int32 Level, const int32 System) const;
+
+    /* Appends the non empty clusters of a level whose cell overlaps the rectangle. */
+    void QueryRectangle(const int32 Level, const FVector2D& Min, const FVector2D& Max, TArray<int32>& OutClusters) const;
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    struct FLevel
+    {
+        TMap<FIntPoint, int32> CellClusters;
+
+        /* Per cluster. */
+        TArray<FIntPoint> Cells;
+        TArray<int64>     SumX;
+        TArray<int64>     SumY;
+        TArray<int32>     Counts;
+
+        /* Systems of each type, NumTypes per cluster. */
+        TArray<int32> TypeCounts;
+    };
+
+    static constexpr int32 NumTypes = static_cast<int32>(ESpaceTradersSystemType::MAX);
+
+    FIntPoint GetCell(const int32 Level, const FIntPoint Location) const;
+
+    /* Adds or removes a system from the cluster of its cell, returns the cluster. */
+    int32 AddToCluster(const int32 Level, const FIntPoint Location, const ESpaceTradersSystemType Type);
+    void  RemoveFromCluster(const int32 Level, const int32 Cluster, const FIntPoint Location, const ESpaceTradersSystemType Type);
+
+    int32 CellSize;
+
+    TArray<FLevel> Levels;
+
+    /* What each system was added with, to remove it from its clusters when it changes. */
+    TArray<FIntPoint>               SystemLocations;
+    TArray<ESpaceTradersSystemType> SystemTypes;
+    TBitArray<>                     Present;
+
+    /* Cluster of each system at each level, NumLevels() per system. */
+    TArray<int32> SystemClusters;
+};
@@ -0,0 +1,169 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "SpaceTradersGalaxyStore.h"
+#include "SpaceTradersGalaxyMeshComponent.generated.h"
+
+class UStaticMesh;
+class UMaterialInterface;
+class UInstancedStaticMeshComponent;
+class USpaceTradersGalaxy;
+
+/* How systems of a type are drawn. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersSystemMesh
+{
+    GENERATED_BODY()
+public:
+    /* Systems of types without a mesh aren't drawn. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Galaxy")
+    TObjectPtr<UStaticMesh> Mesh;
+
+    /* Overrides the first material of the mesh if set. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Galaxy")
+    TObjectPtr<UMaterialInterface> Material;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Galaxy")
+    FVector Scale = FVector::OneVector;
+};
+
+/**
+ *  Draws the systems of the galaxy with one instanced static mesh component
+ *  per system type, fed straight from the galaxy store. Systems are added,
+ *  moved and removed in bulk as the galaxy changes, e.g. as a crawler streams
+ *  in pages, so a page of systems costs one AddInstances() per type instead of
+ *  one component or actor per system.
+ *
+ *  Instances are placed in the plane of the component, at the coordinates of
+ *  the system times GalaxyScale.
+ *
+ *  When zoomed out, see SetViewDistance(), the systems are hidden and the
+ *  clusters of the galaxy are drawn instead with ClusterMesh, one instance per
+ *  cluster of the level picked for the distance. The type index of the
+ *  dominant type of each cluster is in its first custom data float.
+ **/
+UCLASS(ClassGroup = (SpaceTraders), meta = (BlueprintSpawnableComponent))
+class SPACETRADERSAPI_API USpaceTradersGalaxyMeshComponent : public USceneComponent
+{
+    GENERATED_BODY()
+public:
+    USpaceTradersGalaxyMeshComponent();
+
+    /* Mesh of the system types not in TypeMeshes. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SpaceTraders|Galaxy")
+    FSpaceTradersSystemMesh DefaultMesh;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SpaceTraders|Galaxy")
+    TMap<ESpaceTradersSystemType, FSpaceTradersSystemMesh> TypeMeshes;
+
+    /* World units per galaxy unit. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SpaceTraders|Galaxy")
+    float GalaxyScale = 10.f;
+
+    /* Uses hierarchical instanced components, culled and LODed per cluster of instances. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SpaceTraders|Galaxy")
+    bool bUseHierarchicalInstances = true;
+
+    /* Lets traces hit the systems. Costly with many systems, FindNearestSystems() of the galaxy is cheaper for picking. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SpaceTraders|Galaxy")
+    bool bEnableCollision = false;
+
+    /* Mesh of the clusters, scaled up with the number of systems. Systems are always drawn one by one without it. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SpaceTraders|Galaxy")
+    FSpaceTradersSystemMesh ClusterMesh;
+
+    /* Width of the clusters drawn relative to the view distance. Smaller values keep systems longer. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SpaceTraders|Galaxy", meta = (ClampMin = "0"))
+    float ClusterDetail = 0.05f;
+
+    /* Picks between systems and a level of clusters, e.g. from the camera controller when it zooms. Distance is in world units. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Galaxy")
+    void SetViewDistance(const float Distance);
+
+    /* Returns the level of the clusters drawn, or -1 if systems are drawn. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    int32 GetClusterLevel() const { return ClusterLevel; }
+
+    /* Adds or moves the instances of systems, e.g. after their type or location changed. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Galaxy")
+    void UpdateSystems(const TArray<int32>& Systems);
+
+    /* Removes the instances of systems. They come back if the systems are updated again. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Galaxy")
+    void RemoveSystems(const TArray<int32>& Systems);
+
+    /* Removes every instance and adds one per system of the galaxy, e.g. after changing the meshes. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Galaxy")
+    void Rebuild();
+
+    /* Returns the system drawn by an instance of one of the components, or -1. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    int32 GetSystemOfInstance(const UInstancedStaticMeshComponent* Component, const int32 Instance) const;
+
+    /* Returns the number of systems drawn. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Galaxy")
+    int32 GetNumInstances() const;
+
+    /* Native version of UpdateSystems(). */
+    void UpdateSystemIndices(TConstArrayView<int32> Systems);
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+    /* Where a system is drawn. */
+    struct FSystemInstance
+    {
+        ESpaceTradersSystemType Type = ESpaceTradersSystemType::Unknown;
+        int32 Instance = INDEX_NONE;
+    };
+
+    void OnGalaxyUpdated(TConstArrayView<int32> Systems, TConstArrayView<int32> Waypoints);
+    void OnGalaxyReset();
+    void OnClustersUpdated(TConstArrayView<TArray<int32>> Clusters);
+
+    /* Shows the clusters of a level, or the systems for INDEX_NONE. */
+    void SetClusterLevel(const int32 Level);
+
+    /* Updates the instances of clusters of the current level, adding those created since. */
+    void UpdateClusterInstances(TConstArrayView<int32> Clusters);
+
+    FTransform GetClusterTransform(const int32 Cluster) const;
+
+    UInstancedStaticMeshComponent* CreateComponent(const FSpaceTradersSystemMesh& Mesh, const FString& Name);
+
+    /* Returns the component drawing systems of a type, creating it if needed. Null if the type has no mesh. */
+    UInstancedStaticMeshComponent* GetOrCreateComponent(const ESpaceTradersSystemType Type);
+
+    /* Removes the instances of Systems, all of the same type, moving the last instances in their place. */
+    void RemoveInstances(const ESpaceTradersSystemType Type, TConstArrayView<int32> Systems);
+
+    FTransform GetSystemTransform(const int32 System, const ESpaceTradersSystemType Type) const;
+
+    const FSpaceTradersSystemMesh* FindMesh(const ESpaceTradersSystemType Type) const;
+
+    void ClearInstances();
+
+    UPROPERTY(Transient)
+    TObjectPtr<USpaceTradersGalaxy> Galaxy;
+
+    /* One per system type, null for types without mesh or without systems yet. */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<UInstancedStaticMeshComponent>> TypeComponents;
+
+    /* Instance i draws cluster i of ClusterLevel. */
+    UPROPERTY(Transient)
+    TObjectPtr<UInstancedStaticMeshComponent> ClusterComponent;
+
+    int32 ClusterLevel = INDEX_NONE;
+
+    /* System of each instance, per system type. */
+    TArray<int32> InstanceSystems[static_cast<int32>(ESpaceTradersSystemType::MAX)];
+
+    /* Instance of each system, by system index. */
+    TArray<FSystemInstance> SystemInstances;
+};
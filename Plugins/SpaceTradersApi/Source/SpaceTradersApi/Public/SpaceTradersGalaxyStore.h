@@ -0,0 +1,199 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpaceTradersGalaxyStore.generated.h"
+
+class FJsonValue;
+
+UENUM(BlueprintType)
+enum class ESpaceTradersSystemType : uint8
+{
+    Unknown,
+    NeutronStar,
+    RedStar,
+    OrangeStar,
+    BlueStar,
+    YoungStar,
+    WhiteDwarf,
+    BlackHole,
+    Hypergiant,
+    Nebula,
+    Unstable,
+
+    MAX UMETA(Hidden)
+};
+
+UENUM(BlueprintType)
+enum class ESpaceTradersWaypointType : uint8
+{
+    Unknown,
+    Planet,
+    GasGiant,
+    Moon,
+    OrbitalStation,
+    JumpGate,
+    AsteroidField,
+    Asteroid,
+    EngineeredAsteroid,
+    AsteroidBase,
+    Nebula,
+    DebrisField,
+    GravityWell,
+    ArtificialGravityWell,
+    FuelStation,
+
+    MAX UMETA(Hidden)
+};
+
+/**
+ *  Interns symbols, e.g. "X1-DF55-A1", as dense integer ids. Ids are never reused.
+ **/
+class SPACETRADERSAPI_API FSpaceTradersSymbolTable
+{
+public:
+    /* Returns the id of Symbol, adding it if needed. */
+    int32 Add(const FString& Symbol);
+
+    /* Returns the id of Symbol, or INDEX_NONE. */
+    int32 Find(const FString& Symbol) const;
+
+    /* Returns the symbol of an id returned by Add(). */
+    const FString& Get(const int32 Id) const { return Symbols.Get(FSetElementId::FromInteger(Id)); }
+
+    int32 Num() const { return Symbols.Num(); }
+
+    void Reset() { Symbols.Reset(); }
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    /* Nothing is ever removed, so element ids are dense and double as symbol ids. */
+    TSet<FString> Symbols;
+};
+
+/**
+ *  Systems and waypoints of the galaxy as structure-of-arrays columns, indexed
+ *  by a dense system or waypoint index. Iterating one column, e.g. every X, reads
+ *  contiguous memory, and the whole galaxy takes a fraction of its JSON DOM.
+ *
+ *  Filled from the JSON of the /systems and /waypoints endpoints. Adding an item
+ *  whose symbol is already known updates it in place, so indices are stable.
+ *  Waypoints listed by a system only have a type and coordinates until the
+ *  waypoint itself is added, which also sets its traits. Systems first seen
+ *  through one of their waypoints aren't placed: their coordinates are 0 until
+ *  the system itself is added, so spatial users skip them until then.
+ *
+ *  Not thread safe.
+ **/
+class SPACETRADERSAPI_API FSpaceTradersGalaxyStore
+{
+public:
+    /* Maximum number of distinct waypoint traits, one bit each. Others are ignored. */
+    static constexpr int32 MaxTraits = 64;
+
+    /**
+     * Adds or updates systems from items of the /systems endpoint, and the waypoints they list.
+     * The indices of the systems and waypoints added or updated are appended to the arrays.
+     */
+    void AddSystems(TConstArrayView<TSharedPtr<FJsonValue>> Items, TArray<int32>* const OutSystems = nullptr, TArray<int32>* const OutWaypoints = nullptr);
+
+    /* Adds or updates waypoints from items of the /systems/{system}/waypoints endpoint. */
+    void AddWaypoints(TConstArrayView<TSharedPtr<FJsonValue>> Items, TArray<int32>* const OutWaypoints = nullptr);
+
+    /**
+     * Sets the connections of jump gates from responses of the /systems/{system}/waypoints/{waypoint}/jump-gate
+     * endpoint. Connected gates that aren't known yet are added, without coordinates.
+     */
+    void AddJumpGates(TConstArrayView<TSharedPtr<FJsonValue>> Items, TArray<int32>* const OutWaypoints = nullptr);
+
+    /* Returns the index of a system, or INDEX_NONE. */
+    int32 FindSystem(const FString& Symbol) const;
+
+    /* Returns the index of a waypoint, or INDEX_NONE. */
+    int32 FindWaypoint(const FString& Symbol) const;
+
+    /* Returns the bit of a trait in the trait masks, or INDEX_NONE if no waypoint has it. */
+    int32 FindTrait(const FString& Trait) const;
+
+    int32 NumSystems()   const { return SystemSymbols.Num(); }
+    int32 NumWaypoints() const { return WaypointSymbols.Num(); }
+
+    const FString& GetSystemSymbol(const int32 System)     const { return Symbols.Get(SystemSymbols[System]); }
+    const FString& GetWaypointSymbol(const int32 Waypoint) const { return Symbols.Get(WaypointSymbols[Waypoint]); }
+
+    /* Returns the name of a trait bit. */
+    const FString& GetTraitName(const int32 Trait) const { return TraitNames[Trait]; }
+    int32 NumTraits() const { return TraitNames.Num(); }
+
+    TConstArrayView<int32> GetSystemSymbolIds() const { return SystemSymbols; }
+    TConstArrayView<int32> GetSystemX()         const { return SystemX; }
+    TConstArrayView<int32> GetSystemY()         const { return SystemY; }
+    TConstArrayView<ESpaceTradersSystemType> GetSystemTypes() const { return SystemTypes; }
+
+    /* Returns true if the coordinates of a system are known, i.e. it was added by AddSystems(). */
+    bool IsSystemPlaced(const int32 System) const { return SystemPlaced[System]; }
+
+    /* Returns the waypoints of a system. */
+    TConstArrayView<int32> GetSystemWaypoints(const int32 System) const { return SystemWaypoints[System]; }
+
+    TConstArrayView<int32>  GetWaypointSymbolIds() const { return WaypointSymbols; }
+    TConstArrayView<int32>  GetWaypointSystems()   const { return WaypointSystems; }
+    TConstArrayView<int32>  GetWaypointX()         const { return WaypointX; }
+    TConstArrayView<int32>  GetWaypointY()         const { return WaypointY; }
+    TConstArrayView<uint64> GetWaypointTraits()    const { return WaypointTraits; }
+    TConstArrayView<ESpaceTradersWaypointType> GetWaypointTypes() const { return WaypointTypes; }
+
+    /* Returns the gates a jump gate connects to, empty if its connections aren't known. */
+    TConstArrayView<int32> GetJumpGateConnections(const int32 Waypoint) const;
+
+    const FSpaceTradersSymbolTable& GetSymbols() const { return Symbols; }
+
+    void Reset();
+
+    /* Returns the memory used by the store. */
+    SIZE_T GetAllocatedSize() const;
+
+    static ESpaceTradersSystemType   ParseSystemType(const FString& Type);
+    static ESpaceTradersWaypointType ParseWaypointType(const FString& Type);
+
+private:
+    /* Returns the index of the system, adding it if needed. */
+    int32 FindOrAddSystem(const FString& Symbol);
+
+    /* Returns the index of the waypoint, adding it to System if needed. */
+    int32 FindOrAddWaypoint(const FString& Symbol, const int32 System);
+
+    /* Returns the index of a waypoint from its symbol alone, adding it and its system if needed. */
+    int32 FindOrAddWaypoint(const FString& Symbol);
+
+    /* Returns the mask of the "traits" array of a waypoint. */
+    uint64 ParseTraits(const TSharedPtr<FJsonValue>& Traits);
+
+    FSpaceTradersSymbolTable Symbols;
+
+    /* Index by symbol id, INDEX_NONE if the symbol isn't one of a system or waypoint. */
+    TArray<int32> SystemOfSymbol;
+    TArray<int32> WaypointOfSymbol;
+
+    TArray<FString>    TraitNames;
+    TMap<FString, int32> TraitBits;
+
+    TArray<int32> SystemSymbols;
+    TArray<int32> SystemX;
+    TArray<int32> SystemY;
+    TArray<ESpaceTradersSystemType> SystemTypes;
+    TArray<TArray<int32>> SystemWaypoints;
+    TBitArray<> SystemPlaced;
+
+    TArray<int32>  WaypointSymbols;
+    TArray<int32>  WaypointSystems;
+    TArray<int32>  WaypointX;
+    TArray<int32>  WaypointY;
+    TArray<uint64> WaypointTraits;
+    TArray<ESpaceTradersWaypointType> WaypointTypes;
+
+    /* Connections of the jump gates, by waypoint index. Few waypoints are gates, so they aren't a column. */
+    TMap<int32, TArray<int32>> JumpGateConnections;
+};
@@ -0,0 +1,194 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpaceTradersGalaxyStore.h"
+#include "SpaceTradersMarketStore.generated.h"
+
+class FJsonValue;
+
+/* Supply of a trade good at a market, from scarce to abundant. */
+UENUM(BlueprintType)
+enum class ESpaceTradersSupply : uint8
+{
+    Unknown,
+    Scarce,
+    Limited,
+    Moderate,
+    High,
+    Abundant,
+
+    MAX UMETA(Hidden)
+};
+
+/* Prices of a trade good at a market at some point in time. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersMarketSample
+{
+    GENERATED_BODY()
+public:
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    FDateTime Timestamp;
+
+    /* Price paid by a ship buying one unit. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    int32 PurchasePrice = 0;
+
+    /* Price paid to a ship selling one unit. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    int32 SellPrice = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    int32 TradeVolume = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    ESpaceTradersSupply Supply = ESpaceTradersSupply::Unknown;
+};
+
+/* Rolling statistics of one value of a series. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersRollingStats
+{
+    GENERATED_BODY()
+public:
+    /* Smallest value in the history. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    double Min = 0.;
+
+    /* Largest value in the history. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    double Max = 0.;
+
+    /* Exponential moving average of every value added, more recent ones weighing more. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    double Average = 0.;
+};
+
+/* Statistics of the history of a trade good at a market. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersMarketAggregates
+{
+    GENERATED_BODY()
+public:
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    FSpaceTradersRollingStats PurchasePrice;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    FSpaceTradersRollingStats SellPrice;
+
+    /* Of the supply as a number, 1 for scarce to 5 for abundant. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    FSpaceTradersRollingStats Supply;
+
+    /* Number of samples in the history, at most the capacity of the store. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    int32 NumSamples = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Market")
+    FDateTime LastUpdate;
+};
+
+/**
+ *  Price history of each trade good at each market, a series per (waypoint, good)
+ *  pair. Each series keeps its last samples in a fixed-size ring buffer, so the
+ *  memory of a series never grows, along with the min, max and moving average of
+ *  its history updated as samples are added.
+ *
+ *  The latest sample of each series is kept apart from the history so queries
+ *  over every market of a good, e.g. the best place to sell it, read one sample
+ *  per market.
+ *
+ *  Not thread safe.
+ **/
+class SPACETRADERSAPI_API FSpaceTradersMarketStore
+{
+public:
+    /* Keeps Capacity samples per series. Smoothing is the weight of a new sample in the moving averages. */
+    explicit FSpaceTradersMarketStore(const int32 InCapacity = 64, const double InSmoothing = 0.2);
+
+    /**
+     * Adds a sample for each trade good of a market, as returned by the /systems/{system}/waypoints/{waypoint}/market
+     * endpoint. Markets without trade goods, i.e. without one of the agent's ships, are ignored.
+     * The indices of the series updated are appended to OutSeries.
+     */
+    void AddMarket(const TSharedPtr<FJsonValue>& Market, const FDateTime& Timestamp, TArray<int32>* const OutSeries = nullptr);
+
+    /* Adds a sample to the series of a good at a waypoint and returns the index of the series. */
+    int32 AddSample(const FString& Waypoint, const FString& Good, const FSpaceTradersMarketSample& Sample);
+
+    /* Returns the index of a series, or INDEX_NONE. */
+    int32 FindSeries(const FString& Waypoint, const FString& Good) const;
+
+    int32 NumSeries() const { return Series.Num(); }
+
+    /* Returns the maximum number of samples per series. */
+    int32 GetCapacity() const { return Capacity; }
+
+    const FString& GetSeriesWaypoint(const int32 Index) const { return Symbols.Get(Series[Index].Waypoint); }
+    const FString& GetSeriesGood(const int32 Index)     const { return Symbols.Get(Series[Index].Good); }
+
+    const FSpaceTradersMarketAggregates& GetAggregates(const int32 Index) const { return Series[Index].Aggregates; }
+    const FSpaceTradersMarketSample&     GetLatest(const int32 Index)     const { return Series[Index].Latest; }
+
+    /* Appends the history of a series to OutSamples, oldest first. */
+    void GetHistory(const int32 Index, TArray<FSpaceTradersMarketSample>& OutSamples) const;
+
+    /* Returns the series of a good, one per market trading it. */
+    TConstArrayView<int32> GetGoodSeries(const FString& Good) const;
+
+    /* Returns the series of a market, one per good it trades. */
+    TConstArrayView<int32> GetWaypointSeries(const FString& Waypoint) const;
+
+    /**
+     * Returns the series of Good with the highest latest sell price, or with the lowest purchase
+     * price if bPurchase is set, among those Filter returns true for. INDEX_NONE if there are none.
+     */
+    int32 FindBestPrice(const FString& Good, const bool bPurchase, TFunctionRef<bool(int32 /* Series */)> Filter) const;
+
+    void Reset();
+
+    /* Returns the memory used by the store. */
+    SIZE_T GetAllocatedSize() const;
+
+    static ESpaceTradersSupply ParseSupply(const FString& Supply);
+
+private:
+    struct FSeries
+    {
+        /* Symbol ids of the waypoint and the good. */
+        int32 Waypoint = INDEX_NONE;
+        int32 Good     = INDEX_NONE;
+
+        /* Index in the ring of the oldest sample. */
+        int32 Head = 0;
+
+        FSpaceTradersMarketSample     Latest;
+        FSpaceTradersMarketAggregates Aggregates;
+    };
+
+    /* Returns the ring of a series, Capacity samples whose first Aggregates.NumSamples from Head are valid. */
+    FSpaceTradersMarketSample*       GetRing(const int32 Index)       { return Samples.GetData() + Index * Capacity; }
+    const FSpaceTradersMarketSample* GetRing(const int32 Index) const { return Samples.GetData() + Index * Capacity; }
+
+    /* Recomputes the min and max of a series from its history, after the sample holding one was evicted. */
+    void RecomputeExtremes(const int32 Index);
+
+    static uint64 MakeKey(const int32 Waypoint, const int32 Good) { return (uint64(uint32(Waypoint)) << 32) | uint32(Good); }
+
+    int32  Capacity;
+    double Smoothing;
+
+    FSpaceTradersSymbolTable Symbols;
+
+    TArray<FSeries> Series;
+
+    /* Rings of every series, one after the other. */
+    TArray<FSpaceTradersMarketSample> Samples;
+
+    TMap<uint64, int32> SeriesByKey;
+
+    /* Series by symbol id of their good or waypoint. */
+    TMap<int32, TArray<int32>> SeriesOfGood;
+    TMap<int32, TArray<int32>> SeriesOfWaypoint;
+};
@@ -0,0 +1,111 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "SpaceTradersMarketStore.h"
+#include "SpaceTradersTradeOptimizer.h"
+#include "SpaceTradersMarkets.generated.h"
+
+class UJsonObject;
+struct FSpaceTradersRequest;
+struct FSpaceTradersResponse;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FSpaceTradersMarketUpdated, const FString&, Waypoint);
+
+/* Called with an object holding the trade routes of each ship in a field named after it. */
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnSpaceTradersTradeRoutesFound, UJsonObject*, Routes);
+
+/* Called with the indices of the series that got a new sample. */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSpaceTradersMarketsUpdated, TConstArrayView<int32> /* Series */);
+
+/**
+ *  Price history of the markets seen by the game instance, in a FSpaceTradersMarketStore.
+ *  Every successful market response received by the API client is added, so
+ *  the history fills up as ships visit markets without any Blueprint wiring.
+ **/
+UCLASS()
+class SPACETRADERSAPI_API USpaceTradersMarkets : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+public:
+    /* Returns the markets of the game instance of WorldContextObject, or null. */
+    static USpaceTradersMarkets* Get(const UObject* const WorldContextObject);
+
+    const FSpaceTradersMarketStore& GetStore() const { return Store; }
+
+    /* Adds the trade goods of a market, as returned by the /systems/{system}/waypoints/{waypoint}/market endpoint. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Market")
+    void AddMarket(UJsonObject* Market);
+
+    /* Native version of the above. */
+    void AddMarketValue(const TSharedPtr<FJsonValue>& Market, const FDateTime& Timestamp);
+
+    /* Returns the samples of a good at a market, oldest first. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Market")
+    TArray<FSpaceTradersMarketSample> GetHistory(const FString& Waypoint, const FString& Good) const;
+
+    /* Returns the latest sample of a good at a market, false if it was never seen there. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Market")
+    bool GetLatest(const FString& Waypoint, const FString& Good, FSpaceTradersMarketSample& Sample) const;
+
+    /* Returns the min, max and moving average of the prices of a good at a market, false if it was never seen there. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Market")
+    bool GetAggregates(const FString& Waypoint, const FString& Good, FSpaceTradersMarketAggregates& Aggregates) const;
+
+    /* Returns the goods traded at a market. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Market")
+    TArray<FString> GetGoods(const FString& Waypoint) const;
+
+    /**
+     * Finds the market paying the most for a good, among those whose system is at most Radius away from Center and
+     * whose price is at most MaxAge seconds old. A Radius or MaxAge of 0 doesn't filter. Returns false if there are none.
+     */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Market")
+    bool FindBestSellPrice(const FString& Good, const FVector2D& Center, const float Radius, const float MaxAge, FString& Waypoint, int32& Price) const;
+
+    /* Finds the market selling a good for the least, with the same filters as FindBestSellPrice(). */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Market")
+    bool FindBestPurchasePrice(const FString& Good, const FVector2D& Center, const float Radius, const float MaxAge, FString& Waypoint, int32& Price) const;
+
+    /**
+     * Returns the Count most profitable trade routes of each ship over the known markets, as an object with
+     * the routes of each ship in a field named after it. Only goods whose markets changed are scored again.
+     */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Market", meta = (AutoCreateRefTerm = "Ships"))
+    UJsonObject* FindTradeRoutes(const TArray<FSpaceTradersTradeShip>& Ships, const int32 Count = 5);
+
+    /* Same as FindTradeRoutes() but scores the routes in the background. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Market", meta = (AutoCreateRefTerm = "Ships"))
+    void FindTradeRoutesAsync(const TArray<FSpaceTradersTradeShip>& Ships, const int32 Count, FOnSpaceTradersTradeRoutesFound OnFound);
+
+    FSpaceTradersTradeOptimizer& GetTradeOptimizer() const { return *TradeOptimizer; }
+
+    /* Returns the memory used by the history, in bytes. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Market")
+    int64 GetAllocatedSize() const { return Store.GetAllocatedSize(); }
+
+    /* Removes the history of every market. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Market")
+    void Reset();
+
+    /* Called after the goods of a market got a new sample. */
+    UPROPERTY(BlueprintAssignable)
+    FSpaceTradersMarketUpdated Updated;
+
+    /* Native version of Updated, with the series that changed. */
+    FOnSpaceTradersMarketsUpdated OnUpdated;
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+private:
+    void OnResponseDelivered(const FSpaceTradersRequest& Request, const FSpaceTradersResponse& Response, const bool bFromCache);
+
+    bool FindBestPrice(const FString& Good, const bool bPurchase, const FVector2D& Center, const float Radius, const float MaxAge, FString& OutWaypoint, int32& OutPrice) const;
+
+    FSpaceTradersMarketStore Store;
+
+    /* Shared with the routes being scored in the background. */
+    TSharedPtr<FSpaceTradersTradeOptimizer, ESPMode::ThreadSafe> TradeOptimizer;
+};
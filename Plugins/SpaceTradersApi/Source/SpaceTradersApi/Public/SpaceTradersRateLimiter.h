@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *  Client side model of the SpaceTraders rate limit: a steady bucket refilled at
+ *  RequestsPerSecond, and a burst bucket of BurstRequests refilled over BurstWindow
+ *  seconds that is only drawn from once the steady bucket is empty.
+ *  The server's x-ratelimit-* headers are authoritative and lower the local count
+ *  when the server has seen more requests than accounted for, e.g. from another client.
+ *  Not thread safe, the API client only uses it on the game thread.
+ **/
+class SPACETRADERSAPI_API FSpaceTradersRateLimiter
+{
+public:
+    FSpaceTradersRateLimiter(const double InRequestsPerSecond, const int32 InBurstRequests, const double InBurstWindow);
+
+    /* Changes the limits, e.g. from the headers of a response. Both buckets keep their current tokens. */
+    void SetLimits(const double InRequestsPerSecond, const int32 InBurstRequests);
+
+    /* Takes a token if one is available. */
+    bool TryAcquire(const double Now);
+
+    /* Returns the number of seconds until a token is available, 0 if one is. */
+    double GetWaitTime(const double Now);
+
+    /**
+     * Lowers the local tokens to what the server reported in a response. RequestsSentSince is the
+     * number of requests sent after the one the response is for, they aren't counted by Remaining yet.
+     * When nothing remains, no token is handed out before ResetIn seconds.
+     */
+    void OnServerState(const double Now, const int32 Remaining, const double ResetIn, const int32 RequestsSentSince);
+
+    /* The server rejected a request, no token is handed out before RetryAfter seconds. */
+    void OnThrottled(const double Now, const double RetryAfter);
+
+private:
+    void Refill(const double Now);
+
+    double SteadyRate;
+    double SteadyCapacity;
+    double SteadyTokens = 0.;
+
+    double BurstWindow;
+    double BurstRate;
+    double BurstCapacity;
+    double BurstTokens  = 0.;
+
+    double LastRefill  = 0.;
+    double PausedUntil = 0.;
+};
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FSpaceTradersResponse;
+
+/* Index entry of a cached response. */
+struct SPACETRADERSAPI_API FSpaceTradersCacheEntry
+{
+    /* When the response was downloaded or last revalidated. */
+    FDateTime StoredAt;
+
+    /* When the response was last used, for LRU eviction. */
+    FDateTime LastAccess;
+
+    /* Size of the file, in bytes. */
+    int64 Size = 0;
+
+    /* ETag of the response, sent in If-None-Match once it expired. Can be empty. */
+    FString ETag;
+};
+
+/**
+ *  On-disk cache of API responses, one file per (method, URL, agent). Responses are
+ *  stored in the BlueprintJson binary format so loading them doesn't parse JSON.
+ *  The index is kept in memory and saved by Flush() a few seconds after it changed, and
+ *  when the cache is destroyed. On load, files the index doesn't list, e.g. written just
+ *  before a crash, are added back from their header and index entries without a file
+ *  are dropped, so the size limit also covers them.
+ *
+ *  The index functions are game thread only, Load and Store can be called from any
+ *  thread since each key has its own file.
+ **/
+class SPACETRADERSAPI_API FSpaceTradersResponseCache
+{
+public:
+    FSpaceTradersResponseCache(const FString& InDirectory, const int64 InMaxSize);
+    ~FSpaceTradersResponseCache();
+
+    /* Returns the key of a request. The agent token is hashed, it's never written to disk. */
+    static uint64 MakeKey(const FString& Verb, const FString& Url, const FString& AgentToken);
+
+    /* Returns the entry of Key, or null. */
+    const FSpaceTradersCacheEntry* Find(const uint64 Key) const;
+
+    /* Marks the entry as used. A revalidated entry is fresh again. */
+    void Touch(const uint64 Key, const bool bRevalidated);
+
+    /* Adds the entry of a response written with Store(), and evicts old entries if the cache is too large. */
+    void OnStored(const uint64 Key, FSpaceTradersCacheEntry&& Entry);
+
+    /* Removes every entry. */
+    void Clear();
+
+    /* Saves the index if it changed more than a few seconds ago. Called by the client on every tick. */
+    void Flush(const double Now);
+
+    /* Returns the size of the cached responses, in bytes. */
+    int64 GetTotalSize() const { return TotalSize; }
+
+    /* Reads a response. Returns false if it isn't cached or its file is invalid. Thread safe. */
+    bool Load(const uint64 Key, FSpaceTradersResponse& OutResponse) const;
+
+    /* Writes a response. Returns the size of its file, or -1 on failure. Thread safe. */
+    int64 Store(const uint64 Key, const FString& ETag, const FSpaceTradersResponse& Response) const;
+
+private:
+    FString GetPath(const uint64 Key) const;
+
+    void Remove(const uint64 Key);
+
+    /* Evicts the least recently used entries if the cache is larger than MaxSize. */
+    void EvictIfNeeded();
+
+    /* Marks the index as changed so the next Flush() saves it. */
+    void MarkDirty();
+
+    void LoadIndex();
+    void SaveIndex();
+
+    /* Matches the index with the files of the directory. Returns the number of entries added and dropped. */
+    int32 ReconcileWithFiles();
+
+    FString Directory;
+    int64   MaxSize;
+    int64   TotalSize = 0;
+
+    TMap<uint64, FSpaceTradersCacheEntry> Entries;
+
+    /* FPlatformTime::Seconds() of the first change since the index was saved, or 0 if it is saved. */
+    double DirtySince = 0.;
+};
@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "SpaceTradersRoutePlanner.generated.h"
+
+class FJsonObject;
+class FSpaceTradersGalaxyStore;
+
+/* Flight mode of a ship, trading fuel for travel time. */
+UENUM(BlueprintType)
+enum class ESpaceTradersFlightMode : uint8
+{
+    /* Default speed and fuel. */
+    Cruise,
+    /* Twice as fast for twice the fuel. */
+    Burn,
+    /* Very slow but uses a single unit of fuel. */
+    Drift,
+
+    MAX UMETA(Hidden)
+};
+
+/* A route to plan. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersRouteQuery
+{
+    GENERATED_BODY()
+public:
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Route")
+    FString Origin;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Route")
+    FString Destination;
+
+    /* Fuel in the tank when leaving Origin. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Route")
+    int32 Fuel = 0;
+
+    /* Size of the tank. Ships without a tank, e.g. probes, don't use fuel. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Route")
+    int32 FuelCapacity = 0;
+
+    /* Engine speed of the ship. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Route")
+    int32 Speed = 30;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Route")
+    bool bAllowBurn = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Route")
+    bool bAllowDrift = true;
+
+    /* Fills the tank at waypoints with a marketplace on the way. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Route")
+    bool bRefuelAtMarketplaces = true;
+
+    /* Seconds added by each jump, for the cooldown of the ship. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Route")
+    double JumpDuration = 60.;
+};
+
+/* A navigation or a jump of a route. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersRouteStep
+{
+    GENERATED_BODY()
+public:
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    FString From;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    FString To;
+
+    /* True for a jump between gates, the flight mode is then irrelevant. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    bool bJump = false;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    ESpaceTradersFlightMode FlightMode = ESpaceTradersFlightMode::Cruise;
+
+    /* True if the ship refuels at From before leaving. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    bool bRefuel = false;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    int32 FuelCost = 0;
+
+    /* Fuel in the tank once at To. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    int32 FuelAfter = 0;
+
+    /* In seconds. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    double Duration = 0.;
+};
+
+/* Result of a route query. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersRoute
+{
+    GENERATED_BODY()
+public:
+    /* False if the destination can't be reached, or a waypoint isn't known. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    bool bFound = false;
+
+    /* Total travel time, in seconds. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    double Duration = 0.;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    int32 FuelUsed = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    int32 NumRefuels = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Route")
+    TArray<FSpaceTradersRouteStep> Steps;
+
+    /* Returns the route as JSON, with the field names of the API. */
+    TSharedRef<FJsonObject> ToJson() const;
+};
+
+/**
+ *  Plans the fastest route between two waypoints over the systems and jump gates
+ *  of a FSpaceTradersGalaxyStore, with the travel time and fuel formulas of the
+ *  API for each flight mode.
+ *
+ *  The search is an A* over (waypoint, fuel) states. A state reaching a waypoint
+ *  later than another one with at least as much fuel is dropped, so each waypoint
+ *  is expanded a few times at most. The distances between the waypoints of a
+ *  system are computed once and cached until the system changes.
+ *
+ *  Planning is thread safe as long as the store isn't modified meanwhile.
+ **/
+class SPACETRADERSAPI_API FSpaceTradersRoutePlanner
+{
+public:
+    explicit FSpaceTradersRoutePlanner(const FSpaceTradersGalaxyStore& InStore);
+
+    FSpaceTradersRoute PlanRoute(const FSpaceTradersRouteQuery& Query) const;
+
+    /* Plans every route in parallel, e.g. one for each ship of the fleet. */
+    void PlanRoutes(TConstArrayView<FSpaceTradersRouteQuery> Queries, TArray<FSpaceTradersRoute>& OutRoutes) const;
+
+    /* Drops the cached distances of systems whose waypoints changed. */
+    void Invalidate(TConstArrayView<int32> Systems);
+
+    /* Drops every cached distance. */
+    void Reset();
+
+    /* Returns the fuel used to fly Distance units. */
+    static int32 GetFuelCost(const double Distance, const ESpaceTradersFlightMode Mode);
+
+    /* Returns the seconds it takes to fly Distance units. */
+    static double GetTravelTime(const double Distance, const ESpaceTradersFlightMode Mode, const int32 Speed);
+
+    /* Maximum number of states expanded by a query, to bound the time spent on unreachable destinations. */
+    static constexpr int32 MaxExpandedStates = 200000;
+
+private:
+    /* Distances between every pair of waypoints of a system, by their index in the system. */
+    struct FDistanceMatrix
+    {
+        TArray<int32> Waypoints;
+        TArray<float> Distances;
+
+        float Get(const int32 From, const int32 To) const { return Distances[From * Waypoints.Num() + To]; }
+    };
+
+    using FDistanceMatrixPtr = TSharedPtr<const FDistanceMatrix, ESPMode::ThreadSafe>;
+
+    FDistanceMatrixPtr GetDistanceMatrix(const int32 System) const;
+
+    const FSpaceTradersGalaxyStore& Store;
+
+    mutable FRWLock MatricesLock;
+    mutable TMap<int32, FDistanceMatrixPtr> Matrices;
+};
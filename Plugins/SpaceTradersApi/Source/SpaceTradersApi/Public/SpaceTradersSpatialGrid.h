@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FConvexVolume;
+
+/**
+ *  2D uniform grid over integer points identified by dense ids, e.g. system indices.
+ *  Only occupied cells are allocated, and each cell keeps the positions of its
+ *  points next to their ids so queries test them without indirection.
+ *
+ *  Points can be added or moved at any time, e.g. as a crawl streams them in.
+ *  Queries are const and can run on several threads at once, but not while
+ *  points are being added.
+ **/
+class SPACETRADERSAPI_API FSpaceTradersSpatialGrid
+{
+public:
+    /* CellSize should be close to the radius of the usual queries. */
+    explicit FSpaceTradersSpatialGrid(const int32 InCellSize = 1000);
+
+    /* Adds a point, or moves it if Id is already in the grid. */
+    void Add(const int32 Id, const FIntPoint Location);
+
+    /* Removes a point. */
+    void Remove(const int32 Id);
+
+    bool Contains(const int32 Id) const { return Present.IsValidIndex(Id) && Present[Id]; }
+
+    int32 Num() const { return NumPoints; }
+
+    void Reset();
+
+    /* Appends the points at most Radius away from Center. */
+    void QueryRadius(const FVector2D& Center, const double Radius, TArray<int32>& OutIds) const;
+
+    /* Appends the points inside the rectangle, bounds included. */
+    void QueryRectangle(const FVector2D& Min, const FVector2D& Max, TArray<int32>& OutIds) const;
+
+    /* Appends the points inside a convex polygon, its vertices in either winding order. */
+    void QueryPolygon(TConstArrayView<FVector2D> Polygon, TArray<int32>& OutIds) const;
+
+    /**
+     * Appends the points inside a frustum, e.g. the view of a camera. GridToWorld places
+     * the grid in the world, the grid being its XY plane.
+     */
+    void QueryFrustum(const FConvexVolume& Frustum, const FTransform& GridToWorld, TArray<int32>& OutIds) const;
+
+    /* Sets OutIds to the Count points closest to Center, closest first. */
+    void QueryNearest(const FVector2D& Center, const int32 Count, TArray<int32>& OutIds) const;
+
+    /* Runs QueryRadius() for each center in parallel. */
+    void QueryRadiusBatch(TConstArrayView<FVector2D> Centers, const double Radius, TArray<TArray<int32>>& OutIds) const;
+
+    /* Runs QueryNearest() for each center in parallel. */
+    void QueryNearestBatch(TConstArrayView<FVector2D> Centers, const int32 Count, TArray<TArray<int32>>& OutIds) const;
+
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    struct FCell
+    {
+        TArray<int32>     Ids;
+        TArray<FIntPoint> Locations;
+    };
+
+    FIntPoint GetCell(const FVector2D& Location) const;
+    FIntPoint GetCell(const FIntPoint Location) const;
+
+    /* Calls Functor(const FCell&) for each occupied cell in the inclusive range. */
+    template<typename FunctorType>
+    void ForEachCell(FIntPoint MinCell, FIntPoint MaxCell, FunctorType&& Functor) const;
+
+    int32 CellSize;
+    int32 NumPoints = 0;
+
+    /* Bounds of the occupied cells, to stop searching outside of them. */
+    FIntPoint MinOccupiedCell = FIntPoint(MAX_int32, MAX_int32);
+    FIntPoint MaxOccupiedCell = FIntPoint(MIN_int32, MIN_int32);
+
+    TMap<FIntPoint, FCell> Cells;
+
+    /* Location of each id, valid if Present. */
+    TArray<FIntPoint> Locations;
+    TBitArray<>       Present;
+};
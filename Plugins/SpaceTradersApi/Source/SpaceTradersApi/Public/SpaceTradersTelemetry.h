@@ -0,0 +1,227 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "SpaceTradersTelemetry.generated.h"
+
+struct FSpaceTradersRequest;
+struct FSpaceTradersResponse;
+struct FSpaceTradersRequestMetrics;
+
+/**
+ *  Histogram of positive integers with a bounded relative error, as in HdrHistogram:
+ *  values are bucketed by power of two, each power split in 64 linear sub-buckets,
+ *  so percentiles are within 1/64 of the recorded values whatever their range.
+ *
+ *  Counts are allocated on the first value. Histograms can be added to and
+ *  subtracted from each other, e.g. to keep the sum of a sliding window.
+ **/
+class SPACETRADERSAPI_API FSpaceTradersHdrHistogram
+{
+public:
+    /* Values above are recorded as MaxValue. */
+    static constexpr int64 MaxValue = (int64(1) << 36) - 1;
+
+    void Record(const int64 Value, const int64 Count = 1);
+
+    void Add(const FSpaceTradersHdrHistogram& Other);
+    void Subtract(const FSpaceTradersHdrHistogram& Other);
+
+    void Reset();
+
+    /* Returns the smallest value greater or equal to Percentile % of the values, 0 if empty. */
+    int64 GetValueAtPercentile(const double Percentile) const;
+
+    double GetMean() const { return TotalCount > 0 ? double(Sum) / TotalCount : 0.; }
+
+    int64 GetTotalCount() const { return TotalCount; }
+
+    SIZE_T GetAllocatedSize() const { return Counts.GetAllocatedSize(); }
+
+private:
+    static constexpr int32 SubBucketBits  = 7;
+    static constexpr int32 SubBucketCount = 1 << SubBucketBits;
+    static constexpr int32 SubBucketHalf  = SubBucketCount / 2;
+    static constexpr int32 NumBuckets     = SubBucketHalf * (36 - SubBucketBits + 2);
+
+    static int32 GetIndex(const int64 Value);
+
+    /* Returns the largest value of the bucket at Index. */
+    static int64 GetHighestValue(const int32 Index);
+
+    TArray<uint32> Counts;
+    int64 TotalCount = 0;
+    int64 Sum = 0;
+};
+
+/* Summary of the requests to an endpoint. Times are in milliseconds. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersEndpointStats
+{
+    GENERATED_BODY()
+public:
+    /* Verb and path, with the symbols replaced by the names of the API, e.g. "GET /systems/{systemSymbol}". "*" for every endpoint. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    FString Endpoint;
+
+    /* Responses received, those rejected with 429 included, and read from the cache. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    int32 Requests = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    float RequestsPerSecond = 0.f;
+
+    /* Failed responses, 429 included. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    int32 Errors = 0;
+
+    /* Responses rejected with 429 Too Many Requests. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    int32 Throttled = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    int32 CacheHits = 0;
+
+    /* Latency percentiles of the responses from the server. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    float LatencyP50 = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    float LatencyP95 = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    float LatencyP99 = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    float LatencyMean = 0.f;
+
+    /* Body bytes, headers excluded. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    int64 BytesIn = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    int64 BytesOut = 0;
+
+    /* Total time spent parsing the responses and writing the request bodies. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    float ParseTime = 0.f;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    float StringifyTime = 0.f;
+
+    /* UJsonObject and UJsonValue created by the callbacks of the responses. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Telemetry")
+    int32 WrappersCreated = 0;
+};
+
+/**
+ *  Measures the requests of the API client per endpoint: latency histograms,
+ *  bytes, JSON parse and stringify time, wrappers created and 429 responses.
+ *
+ *  Stats are kept over a sliding window, in one second slices whose sums are
+ *  added to the window as they're recorded and subtracted as they expire, so
+ *  reading them, e.g. from a widget every frame, doesn't depend on the traffic.
+ *  Totals since the start are kept as well for the CSV export.
+ **/
+UCLASS()
+class SPACETRADERSAPI_API USpaceTradersTelemetry : public UGameInstanceSubsystem
+{
+    GENERATED_BODY()
+public:
+    /* Returns the telemetry of the game instance of WorldContextObject, or null. */
+    static USpaceTradersTelemetry* Get(const UObject* const WorldContextObject);
+
+    /* Returns the stats of each endpoint over the window, busiest first. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Telemetry")
+    TArray<FSpaceTradersEndpointStats> GetEndpointStats();
+
+    /* Returns the stats of every endpoint together over the window. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Telemetry")
+    FSpaceTradersEndpointStats GetTotalStats();
+
+    /* Returns the requests of each second of the window, oldest first, of an endpoint or of all of them if empty. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Telemetry")
+    TArray<int32> GetRequestHistory(const FString& Endpoint);
+
+    /* Returns the length of the window, in seconds. */
+    UFUNCTION(BlueprintPure, Category = "SpaceTraders|Telemetry")
+    int32 GetWindow() const { return NumSlices; }
+
+    /**
+     * Writes a CSV with one row per endpoint and second of the window, then one row per endpoint for the totals
+     * since the start. Saved/SpaceTraders/Telemetry-{date}.csv if FilePath is empty. Returns false if it can't be written.
+     */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Telemetry")
+    bool ExportCsv(const FString& FilePath);
+
+    /* Forgets every request. */
+    UFUNCTION(BlueprintCallable, Category = "SpaceTraders|Telemetry")
+    void Reset();
+
+    /* Returns the endpoint of a request, its path with the symbols replaced by the names of the API. */
+    static FString GetEndpointName(const FSpaceTradersRequest& Request);
+
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+private:
+    struct FCounters
+    {
+        int64  Requests  = 0;
+        int64  Errors    = 0;
+        int64  Throttled = 0;
+        int64  CacheHits = 0;
+        int64  BytesIn   = 0;
+        int64  BytesOut  = 0;
+        int64  Wrappers  = 0;
+        double ParseTime     = 0.;
+        double StringifyTime = 0.;
+
+        /* Adds Other times Sign, 1 or -1. */
+        void Add(const FCounters& Other, const int32 Sign);
+    };
+
+    struct FSlice
+    {
+        /* Seconds since the start, INDEX_NONE if the slice is unused. */
+        int64 Second = INDEX_NONE;
+        FCounters Counters;
+        FSpaceTradersHdrHistogram Latency;
+    };
+
+    struct FEndpoint
+    {
+        FString Name;
+
+        /* Ring of the seconds of the window. */
+        TArray<FSlice> Slices;
+
+        /* Sums of the slices. */
+        FCounters Window;
+        FSpaceTradersHdrHistogram WindowLatency;
+
+        FCounters Total;
+        FSpaceTradersHdrHistogram TotalLatency;
+    };
+
+    void OnRequestCompleted(const FSpaceTradersRequest& Request, const FSpaceTradersResponse& Response, const FSpaceTradersRequestMetrics& Metrics);
+
+    /* Adds a request to an endpoint. Latency is in microseconds, negative if there is none. */
+    void Record(FEndpoint& Endpoint, const int64 Second, const FCounters& Counters, const int64 Latency);
+
+    /* Subtracts the slices older than the window from the window sums. */
+    void Expire(FEndpoint& Endpoint, const int64 Second);
+    void ExpireAll();
+
+    int64 GetCurrentSecond() const;
+
+    FSpaceTradersEndpointStats MakeStats(const FEndpoint& Endpoint, const FCounters& Counters, const FSpaceTradersHdrHistogram& Latency, const double Seconds) const;
+
+    /* Every endpoint together first, then one per endpoint. */
+    TArray<FEndpoint> Endpoints;
+    TMap<FString, int32> EndpointIndices;
+
+    int32  NumSlices = 60;
+    double StartTime = 0.;
+};
@@ -0,0 +1,219 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SpaceTradersTradeOptimizer.generated.h"
+
+class FJsonObject;
+class FSpaceTradersGalaxyStore;
+class FSpaceTradersMarketStore;
+
+/* A ship to find trade routes for. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersTradeShip
+{
+    GENERATED_BODY()
+public:
+    /* Routes of a ship are cached by symbol, and re-scored only for the goods whose markets changed. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Trade")
+    FString Symbol;
+
+    /* Where the ship is, the route starts with the flight to the market buying the goods. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Trade")
+    FString Waypoint;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Trade")
+    int32 CargoCapacity = 40;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Trade")
+    int32 Speed = 30;
+
+    /* Routes needing more fuel than the tank are skipped. Ships without a tank don't use fuel. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Trade")
+    int32 FuelCapacity = 0;
+
+    /* Credits per unit of fuel used, subtracted from the profit. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Trade")
+    float FuelPrice = 1.f;
+
+    /* Maximum distance between the two markets, 0 for any. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SpaceTraders|Trade")
+    float MaxDistance = 0.f;
+};
+
+/* Buying a good at a market and selling it at another. */
+USTRUCT(BlueprintType)
+struct SPACETRADERSAPI_API FSpaceTradersTradeRoute
+{
+    GENERATED_BODY()
+public:
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Trade")
+    FString Good;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Trade")
+    FString BuyWaypoint;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Trade")
+    FString SellWaypoint;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Trade")
+    int32 PurchasePrice = 0;
+
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Trade")
+    int32 SellPrice = 0;
+
+    /* Units bought, limited by the cargo and the trade volumes of both markets. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Trade")
+    int32 Units = 0;
+
+    /* Fuel used to fly to the first market then to the second one. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Trade")
+    int32 FuelCost = 0;
+
+    /* Seconds of flight, both legs. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Trade")
+    double Duration = 0.;
+
+    /* Credits earned, fuel deducted. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Trade")
+    int32 Profit = 0;
+
+    /* What the routes are ranked by. */
+    UPROPERTY(BlueprintReadOnly, Category = "SpaceTraders|Trade")
+    double ProfitPerSecond = 0.;
+
+    /* Returns the route as JSON, with the field names of the API. */
+    TSharedRef<FJsonObject> ToJson() const;
+};
+
+/**
+ *  Ranks trade routes, buying a good at one market and selling it at another,
+ *  for each ship from the latest prices of a FSpaceTradersMarketStore.
+ *
+ *  The profitable (buy, sell) market pairs of each good are computed once and
+ *  kept until one of the markets of the good changes. The routes of each
+ *  (ship, good) are cached as well, so a query after a single market update
+ *  only scores the goods of that market again. Scoring runs in parallel over
+ *  ships and goods.
+ *
+ *  Travel uses the cruise formulas of the route planner over the straight
+ *  distance between the markets, or between their systems if they differ.
+ *  It's an estimate to rank routes, plan the chosen one with the route planner.
+ *
+ *  Must be used on the thread writing the stores, except for the scoring of
+ *  FindRoutesAsync() that runs on a snapshot.
+ **/
+class SPACETRADERSAPI_API FSpaceTradersTradeOptimizer : public TSharedFromThis<FSpaceTradersTradeOptimizer, ESPMode::ThreadSafe>
+{
+public:
+    FSpaceTradersTradeOptimizer(const FSpaceTradersMarketStore& InMarkets, const FSpaceTradersGalaxyStore& InGalaxy);
+
+    /* Marks the goods of market series as changed. */
+    void Invalidate(TConstArrayView<int32> Series);
+
+    /* Marks every good as changed, e.g. after waypoints moved in the galaxy. */
+    void InvalidateAll();
+
+    /* Drops every good and cached route, e.g. after the market store was reset. */
+    void Reset();
+
+    /* Returns the Count most profitable routes of each ship, best first. */
+    void FindRoutes(TConstArrayView<FSpaceTradersTradeShip> Ships, const int32 Count, TArray<TArray<FSpaceTradersTradeRoute>>& OutRoutes);
+
+    /**
+     * Same as FindRoutes() but scores in the thread pool, then calls OnFound on the game thread.
+     * OnFound isn't called if the optimizer is destroyed first. The optimizer must be owned by a shared pointer.
+     */
+    void FindRoutesAsync(TArray<FSpaceTradersTradeShip> Ships, const int32 Count, TUniqueFunction<void(TArray<TArray<FSpaceTradersTradeRoute>>&&)>&& OnFound);
+
+    /* Returns an object with the routes of each ship in a field named after it. */
+    static TSharedRef<FJsonObject> RoutesToJson(TConstArrayView<FSpaceTradersTradeShip> Ships, TConstArrayView<TArray<FSpaceTradersTradeRoute>> Routes);
+
+    /* Returns the number of profitable market pairs over every good. */
+    int32 NumCandidates() const;
+
+private:
+    /* A position for travel estimates. */
+    struct FPlace
+    {
+        int32     System = INDEX_NONE;
+        FVector2D SystemLocation;
+        FVector2D Location;
+    };
+
+    struct FMarket
+    {
+        FString Waypoint;
+        FPlace  Place;
+        int32   PurchasePrice = 0;
+        int32   SellPrice     = 0;
+        int32   TradeVolume   = 0;
+    };
+
+    /* A market to buy at and another to sell at, by index in FGood::Markets. */
+    struct FCandidate
+    {
+        int32 Buy;
+        int32 Sell;
+        int32 Margin;
+        float Distance;
+    };
+
+    /* Markets of a good and its profitable pairs. Immutable once built, so jobs can share it. */
+    struct FGood
+    {
+        FString Good;
+        TArray<FMarket>    Markets;
+        TArray<FCandidate> Candidates;
+        uint32 Version = 0;
+    };
+
+    using FGoodPtr = TSharedPtr<const FGood, ESPMode::ThreadSafe>;
+
+    /* Routes of a ship for each good, valid while the ship and the version of the good don't change. */
+    struct FShipCache
+    {
+        FSpaceTradersTradeShip Ship;
+        int32 Count = 0;
+        TArray<uint32> Versions;
+        TArray<TArray<FSpaceTradersTradeRoute>> Routes;
+    };
+
+    /* Everything the scoring needs, so it doesn't read the stores. */
+    struct FJob
+    {
+        TArray<FSpaceTradersTradeShip> Ships;
+        TArray<FPlace> ShipPlaces;
+        TArray<FGoodPtr> Goods;
+        TArray<FShipCache> Caches;
+        int32 Count = 0;
+    };
+
+    /* Rebuilds the dirty goods and snapshots what the job needs. */
+    TSharedRef<FJob> PrepareJob(TArray<FSpaceTradersTradeShip>&& Ships, const int32 Count);
+
+    /* Scores the goods whose cached routes are out of date. Thread safe. */
+    static void RunJob(FJob& Job);
+
+    /* Stores the routes of the job in the ship caches and returns the best ones of each ship. */
+    void FinishJob(FJob& Job, TArray<TArray<FSpaceTradersTradeRoute>>& OutRoutes);
+
+    static void ScoreGood(const FGood& Good, const FSpaceTradersTradeShip& Ship, const FPlace& ShipPlace, const int32 Count, TArray<FSpaceTradersTradeRoute>& OutRoutes);
+
+    static double GetDistance(const FPlace& From, const FPlace& To);
+
+    bool FindPlace(const FString& Waypoint, FPlace& OutPlace) const;
+
+    TSharedRef<FGood> BuildGood(const FString& Good, const uint32 Version) const;
+
+    const FSpaceTradersMarketStore& Markets;
+    const FSpaceTradersGalaxyStore& Galaxy;
+
+    TMap<FString, int32> GoodIndices;
+    TArray<FGoodPtr> Goods;
+    TBitArray<> DirtyGoods;
+    uint32 NextVersion = 1;
+
+    TMap<FString, FShipCache> ShipCaches;
+};
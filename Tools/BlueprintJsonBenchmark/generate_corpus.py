@@ -0,0 +1,47 @@
+#!/usr/bin/env python3
+"""Writes the corpus of the BlueprintJsonBenchmark commandlet.
+
+The payloads are responses of the SpaceTraders API built from the synthetic
+galaxy of the mock server, so they have the same shape as the real traffic:
+
+    small.json   GET /systems/{systemSymbol}/waypoints/{waypointSymbol}/market
+    medium.json  GET /systems, 200 systems with their waypoints
+
+The commandlet builds the 100 MB payload by repeating the systems of
+medium.json. The files are checked in; regenerate them with
+
+    python3 generate_corpus.py
+"""
+
+import json
+import os
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "SpaceTradersMock"))
+
+from mock_server import Galaxy  # noqa: E402
+
+NUM_SYSTEMS = 200
+
+
+def main():
+    galaxy = Galaxy(NUM_SYSTEMS, seed=1)
+    corpus = os.path.join(os.path.dirname(os.path.abspath(__file__)), "Corpus")
+    os.makedirs(corpus, exist_ok=True)
+
+    system = galaxy.systems[0]
+    waypoint = system["waypoints"][0]["symbol"]
+    payloads = {
+        "small.json": {"data": galaxy.market(system["symbol"], waypoint)},
+        "medium.json": {"data": galaxy.systems, "meta": {"total": NUM_SYSTEMS, "page": 1, "limit": NUM_SYSTEMS}},
+    }
+
+    for name, payload in payloads.items():
+        path = os.path.join(corpus, name)
+        with open(path, "w", newline="\n") as file:
+            json.dump(payload, file, separators=(",", ":"))
+        print(f"{path}: {os.path.getsize(path)} bytes")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,390 @@
+#!/usr/bin/env python3
+"""Local stand-in for the SpaceTraders v2 API.
+
+Serves a synthetic, deterministic galaxy and enforces the same rate limits as
+the live server (2 requests per second plus a burst of 30 over 60 seconds, per
+client address), answering 429 with the same x-ratelimit-* headers and error
+body when they're exceeded.
+
+Run it, then start the game with -SpaceTradersBaseUrl=http://127.0.0.1:8080/v2
+
+    python3 mock_server.py --port 8080 --systems 10000
+
+The SpaceTraders.RateLimitTest and SpaceTraders.Crawl console commands log the
+throughput reached against it; crawling the default galaxy takes 500 pages.
+
+GET /_stats returns the number of requests served and rejected. It isn't rate
+limited, and /_stats?reset=1 clears the counters.
+
+Successful GET responses carry an ETag, and a request whose If-None-Match
+matches it is answered with an empty 304 so cache revalidation can be tested.
+"""
+
+import argparse
+import json
+import random
+import re
+import secrets
+import threading
+import time
+import zlib
+from datetime import datetime, timedelta, timezone
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import parse_qs, urlsplit
+
+FACTIONS = ["COSMIC", "VOID", "GALACTIC", "QUANTUM", "DOMINION", "ASTRO", "CORSAIRS", "OBSIDIAN",
+            "AEGIS", "UNITED", "SOLITARY", "COBALT", "OMEGA", "ECHO", "LORDS", "CULT", "ANCIENTS",
+            "SHADOW", "ETHEREAL"]
+SYSTEM_TYPES = ["NEUTRON_STAR", "RED_STAR", "ORANGE_STAR", "BLUE_STAR", "YOUNG_STAR", "WHITE_DWARF",
+                "BLACK_HOLE", "HYPERGIANT", "NEBULA", "UNSTABLE"]
+WAYPOINT_TYPES = ["PLANET", "GAS_GIANT", "MOON", "ORBITAL_STATION", "JUMP_GATE", "ASTEROID_FIELD",
+                  "ASTEROID", "ENGINEERED_ASTEROID", "ASTEROID_BASE", "NEBULA", "DEBRIS_FIELD",
+                  "GRAVITY_WELL", "ARTIFICIAL_GRAVITY_WELL", "FUEL_STATION"]
+TRADE_GOODS = ["FUEL", "IRON_ORE", "COPPER_ORE", "ALUMINUM_ORE", "QUARTZ_SAND", "ICE_WATER",
+               "ELECTRONICS", "MACHINERY", "FOOD", "MEDICINE", "EQUIPMENT", "PLASTICS"]
+
+
+class RateLimiter:
+    """Steady token bucket plus a burst bucket, like the live API."""
+
+    def __init__(self, per_second, burst, burst_window):
+        self.per_second = per_second
+        self.burst = burst
+        self.burst_window = burst_window
+        self.lock = threading.Lock()
+        self.clients = {}
+
+    def acquire(self, client):
+        """Returns (allowed, remaining, reset_in, retry_after)."""
+        now = time.monotonic()
+        with self.lock:
+            steady, burst, last = self.clients.get(client, (self.per_second, self.burst, now))
+            elapsed = now - last
+            steady = min(self.per_second, steady + elapsed * self.per_second)
+            burst = min(self.burst, burst + elapsed * self.burst / self.burst_window)
+
+            allowed = True
+            if steady >= 1:
+                steady -= 1
+            elif burst >= 1:
+                burst -= 1
+            else:
+                allowed = False
+
+            self.clients[client] = (steady, burst, now)
+
+            remaining = int(steady) + int(burst)
+            reset_in = (1 - (steady % 1)) / self.per_second if remaining == 0 else 0
+            retry_after = 0 if allowed else min((1 - steady) / self.per_second,
+                                                (1 - burst) * self.burst_window / self.burst if self.burst else 1e9)
+            return allowed, remaining, reset_in, retry_after
+
+
+class Galaxy:
+    """Deterministic synthetic galaxy, generated once at startup."""
+
+    def __init__(self, num_systems, seed):
+        rng = random.Random(seed)
+        self.systems = []
+        self.system_index = {}
+        self.waypoints = {}
+        self.gates = []
+        for index in range(num_systems):
+            sector = "X1"
+            symbol = f"{sector}-{self._code(index)}"
+            system_type = rng.choice(SYSTEM_TYPES)
+            x, y = rng.randint(-50000, 50000), rng.randint(-50000, 50000)
+            waypoints = []
+            for w in range(rng.randint(2, 12)):
+                waypoint_type = rng.choice(WAYPOINT_TYPES)
+                traits = [{"symbol": "MARKETPLACE", "name": "Marketplace", "description": "A thriving center of commerce."}] if rng.random() < 0.4 else []
+                waypoints.append({
+                    "symbol": f"{symbol}-{chr(65 + w % 26)}{w + 1}",
+                    "type": waypoint_type,
+                    "systemSymbol": symbol,
+                    "x": rng.randint(-800, 800),
+                    "y": rng.randint(-800, 800),
+                    "orbitals": [],
+                    "traits": traits,
+                    "isUnderConstruction": False,
+                })
+            system = {
+                "symbol": symbol,
+                "sectorSymbol": sector,
+                "type": system_type,
+                "x": x,
+                "y": y,
+                "waypoints": [{"symbol": w["symbol"], "type": w["type"], "x": w["x"], "y": w["y"], "orbitals": []} for w in waypoints],
+                "factions": [{"symbol": rng.choice(FACTIONS)}] if rng.random() < 0.1 else [],
+            }
+            self.system_index[symbol] = len(self.systems)
+            self.systems.append(system)
+            self.waypoints[symbol] = waypoints
+            self.gates += [(x, y, w["symbol"]) for w in waypoints if w["type"] == "JUMP_GATE"]
+
+    @staticmethod
+    def _code(index):
+        letters = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+        return f"{letters[(index // 26 // 100) % 26]}{letters[(index // 100) % 26]}{index % 100:02d}"
+
+    def jump_gate(self, system_symbol, waypoint_symbol):
+        """Connects a gate to the gates of the 3 closest other systems."""
+        system = self.systems[self.system_index[system_symbol]]
+        others = sorted(((gx - system["x"]) ** 2 + (gy - system["y"]) ** 2, symbol) for gx, gy, symbol in self.gates if not symbol.startswith(system_symbol + "-"))
+        return {"symbol": waypoint_symbol, "connections": [symbol for _, symbol in others[:3]]}
+
+    def market(self, system_symbol, waypoint_symbol):
+        rng = random.Random(zlib.crc32(waypoint_symbol.encode()))
+        goods = rng.sample(TRADE_GOODS, 5)
+        return {
+            "symbol": waypoint_symbol,
+            "exports": [{"symbol": g, "name": g.title(), "description": ""} for g in goods[:2]],
+            "imports": [{"symbol": g, "name": g.title(), "description": ""} for g in goods[2:4]],
+            "exchange": [{"symbol": goods[4], "name": goods[4].title(), "description": ""}],
+            "tradeGoods": [{
+                "symbol": g,
+                "type": "EXPORT" if i < 2 else "IMPORT" if i < 4 else "EXCHANGE",
+                "tradeVolume": rng.choice([10, 20, 40, 60]),
+                "supply": rng.choice(["SCARCE", "LIMITED", "MODERATE", "HIGH", "ABUNDANT"]),
+                "purchasePrice": (price := rng.randint(20, 4000)) + rng.randint(1, 50),
+                "sellPrice": price,
+            } for i, g in enumerate(goods)],
+        }
+
+
+class State:
+    def __init__(self, args):
+        self.args = args
+        self.galaxy = Galaxy(args.systems, args.seed)
+        self.limiter = RateLimiter(args.rate, args.burst, args.burst_window)
+        self.lock = threading.Lock()
+        self.agents = {}
+        self.served = 0
+        self.throttled = 0
+        self.not_modified = 0
+
+
+def paginate(items, query):
+    page = max(int(query.get("page", ["1"])[0]), 1)
+    limit = min(max(int(query.get("limit", ["10"])[0]), 1), 20)
+    start = (page - 1) * limit
+    return items[start:start + limit], {"total": len(items), "page": page, "limit": limit}
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    state: State = None
+
+    def log_message(self, format, *args):
+        if self.state.args.verbose:
+            super().log_message(format, *args)
+
+    def do_GET(self):
+        self.handle_request("GET")
+
+    def do_POST(self):
+        self.handle_request("POST")
+
+    def send_json(self, status, payload, headers=None):
+        body = json.dumps(payload, separators=(",", ":")).encode("utf-8")
+        headers = dict(headers or {})
+        if status == 200 and self.command == "GET":
+            etag = f'"{zlib.crc32(body):08x}"'
+            headers["ETag"] = etag
+            if self.headers.get("If-None-Match") == etag:
+                with self.state.lock:
+                    self.state.not_modified += 1
+                self.send_response(304)
+                self.send_header("Content-Length", "0")
+                for key, value in headers.items():
+                    self.send_header(key, value)
+                self.end_headers()
+                return
+        self.send_response(status)
+        self.send_header("Content-Type", "application/json; charset=utf-8")
+        self.send_header("Content-Length", str(len(body)))
+        for key, value in headers.items():
+            self.send_header(key, value)
+        self.end_headers()
+        self.wfile.write(body)
+
+    def error(self, status, code, message, headers=None, data=None):
+        payload = {"error": {"message": message, "code": code}}
+        if data is not None:
+            payload["error"]["data"] = data
+        self.send_json(status, payload, headers)
+
+    def handle_request(self, method):
+        url = urlsplit(self.path)
+        query = parse_qs(url.query)
+        length = int(self.headers.get("Content-Length", 0) or 0)
+        body = self.rfile.read(length) if length else b""
+
+        if url.path == "/_stats":
+            with self.state.lock:
+                stats = {"served": self.state.served, "throttled": self.state.throttled,
+                         "notModified": self.state.not_modified}
+                if "reset" in query:
+                    self.state.served = self.state.throttled = self.state.not_modified = 0
+            self.send_json(200, stats)
+            return
+
+        args = self.state.args
+        allowed, remaining, reset_in, retry_after = self.state.limiter.acquire(self.client_address[0])
+        now = datetime.now(timezone.utc)
+        reset = (now + timedelta(seconds=reset_in)).isoformat(timespec="milliseconds").replace("+00:00", "Z")
+        headers = {
+            "x-ratelimit-type": "IP-based",
+            "x-ratelimit-limit-per-second": f"{args.rate:g}",
+            "x-ratelimit-limit-burst": str(args.burst),
+            "x-ratelimit-remaining": str(remaining),
+            "x-ratelimit-reset": reset,
+        }
+
+        if not allowed:
+            with self.state.lock:
+                self.state.throttled += 1
+            headers["retry-after"] = f"{retry_after:.3f}"
+            self.error(429, 429, "You have reached your API limit.", headers, {
+                "type": "IP-based",
+                "retryAfter": retry_after,
+                "limitBurst": args.burst,
+                "limitPerSecond": args.rate,
+                "remaining": remaining,
+                "reset": reset,
+            })
+            return
+
+        with self.state.lock:
+            self.state.served += 1
+
+        if args.latency > 0:
+            time.sleep(args.latency / 1000.0)
+
+        path = url.path
+        if path.startswith("/v2"):
+            path = path[3:] or "/"
+        path = path.rstrip("/") or "/"
+
+        try:
+            self.route(method, path, query, body, headers)
+        except (ValueError, KeyError) as exception:
+            self.error(400, 400, f"Bad request: {exception}", headers)
+
+    def authenticated_agent(self):
+        token = self.headers.get("Authorization", "").removeprefix("Bearer ").strip()
+        with self.state.lock:
+            return self.state.agents.get(token)
+
+    def route(self, method, path, query, body, headers):
+        galaxy = self.state.galaxy
+
+        if path == "/" and method == "GET":
+            self.send_json(200, {
+                "status": "SpaceTraders mock server is online",
+                "version": "v2.3.0",
+                "resetDate": "2026-01-01",
+                "description": "Local stand-in for the SpaceTraders API.",
+                "stats": {"agents": len(self.state.agents), "ships": 0, "systems": len(galaxy.systems), "waypoints": sum(len(w) for w in galaxy.waypoints.values())},
+                "leaderboards": {"mostCredits": [], "mostSubmittedCharts": []},
+                "serverResets": {"next": "2026-01-01T00:00:00.000Z", "frequency": "weekly"},
+                "announcements": [],
+                "links": [],
+            }, headers)
+            return
+
+        if path == "/register" and method == "POST":
+            request = json.loads(body or b"{}")
+            symbol, faction = request["symbol"], request["faction"]
+            token = secrets.token_hex(32)
+            agent = {"accountId": secrets.token_hex(8), "symbol": symbol, "headquarters": galaxy.waypoints[galaxy.systems[0]["symbol"]][0]["symbol"],
+                     "credits": 175000, "startingFaction": faction, "shipCount": 0}
+            with self.state.lock:
+                self.state.agents[token] = agent
+            self.send_json(201, {"data": {"token": token, "agent": agent, "contract": None, "faction": {"symbol": faction}, "ships": []}}, headers)
+            return
+
+        if path == "/factions":
+            items, meta = paginate([{"symbol": f, "name": f.title(), "description": "", "headquarters": "", "traits": [], "isRecruiting": True} for f in FACTIONS], query)
+            self.send_json(200, {"data": items, "meta": meta}, headers)
+            return
+
+        if match := re.fullmatch(r"/factions/([^/]+)", path):
+            if match[1] not in FACTIONS:
+                self.error(404, 4008, f"Faction {match[1]} not found.", headers)
+                return
+            self.send_json(200, {"data": {"symbol": match[1], "name": match[1].title(), "description": "", "headquarters": "", "traits": [], "isRecruiting": True}}, headers)
+            return
+
+        if path.startswith("/my/"):
+            agent = self.authenticated_agent()
+            if agent is None:
+                self.error(401, 4100, "Missing or invalid agent token.", headers)
+                return
+            if path == "/my/agent":
+                self.send_json(200, {"data": agent}, headers)
+            elif path in ("/my/ships", "/my/contracts"):
+                self.send_json(200, {"data": [], "meta": {"total": 0, "page": 1, "limit": 10}}, headers)
+            else:
+                self.error(404, 404, "Not found.", headers)
+            return
+
+        if path == "/systems":
+            items, meta = paginate(galaxy.systems, query)
+            self.send_json(200, {"data": items, "meta": meta}, headers)
+            return
+
+        if match := re.fullmatch(r"/systems/([^/]+)(/waypoints(?:/([^/]+)(/market|/jump-gate)?)?)?", path):
+            system_symbol = match[1]
+            if system_symbol not in galaxy.system_index:
+                self.error(404, 4001, f"System {system_symbol} not found.", headers)
+                return
+            if not match[2]:
+                self.send_json(200, {"data": galaxy.systems[galaxy.system_index[system_symbol]]}, headers)
+                return
+            waypoints = galaxy.waypoints[system_symbol]
+            if not match[3]:
+                items, meta = paginate(waypoints, query)
+                self.send_json(200, {"data": items, "meta": meta}, headers)
+                return
+            waypoint = next((w for w in waypoints if w["symbol"] == match[3]), None)
+            if waypoint is None:
+                self.error(404, 404, f"Waypoint {match[3]} not found.", headers)
+                return
+            if match[4] == "/jump-gate":
+                if waypoint["type"] != "JUMP_GATE":
+                    self.error(400, 4203, f"Waypoint {match[3]} is not a jump gate.", headers)
+                    return
+                self.send_json(200, {"data": galaxy.jump_gate(system_symbol, match[3])}, headers)
+                return
+            self.send_json(200, {"data": galaxy.market(system_symbol, match[3]) if match[4] else waypoint}, headers)
+            return
+
+        self.error(404, 404, "Not found.", headers)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--systems", type=int, default=10000, help="number of systems in the synthetic galaxy")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--rate", type=float, default=2.0, help="requests per second")
+    parser.add_argument("--burst", type=int, default=30, help="burst requests per burst window")
+    parser.add_argument("--burst-window", type=float, default=60.0, help="seconds over which the burst is refilled")
+    parser.add_argument("--latency", type=float, default=0.0, help="added latency per request, in milliseconds")
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    Handler.state = State(args)
+    server = ThreadingHTTPServer((args.host, args.port), Handler)
+    print(f"SpaceTraders mock API on http://{args.host}:{args.port}/v2 with {args.systems} systems, "
+          f"{args.rate:g} req/s + {args.burst} burst per {args.burst_window:g}s")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()